@@ -6,6 +6,7 @@ COMPILER="gcc"
 DO_CLEAN=0
 DO_BUILD=0
 DO_TEST=0
+DO_PYTHON=0
 TEST_FILE=""
 CONFIG="release"
 VENV_DIR=".venv"
@@ -19,6 +20,7 @@ OPTIONS:
     --clean              Clean build directory and deactivate venv
     --build              Build the library
     --test [FILE]        Run tests (all or specific file)
+    --python             Build the Python extension module in python/
     --compiler COMPILER  Choose compiler: gcc or clang (default: gcc)
     --config CONFIG      Build configuration: debug or release (default: release)
     -h, --help           Show this help message
@@ -30,6 +32,18 @@ TEST FILES:
     test_binomial_tree        Run binomial tree pricing tests
     test_american_comparison  Run American option method comparison tests
     test_variance_reduction   Run variance reduction tests
+    test_method_selection     Run automatic method selection tests
+    test_instrument_descriptor Run generic instrument descriptor tests
+    test_exotic_barrier       Run double, window and Parisian barrier tests
+    test_autocallable         Run autocallable note tests
+    test_cliquet              Run forward-start and cliquet tests
+    test_analytic_exotics     Run closed-form barrier and lookback tests
+    test_parallel             Run parallel engine tests
+    test_normal_sampling      Run normal sampler tests
+    test_proxy                Run Chebyshev proxy tests
+    test_plan                 Run prepared pricing plan and Greeks tests
+    test_checkpoint           Run checkpoint and resume tests
+    test_python_bindings      Run Python extension tests (needs --python)
 EXAMPLES:
     ./build.sh --all
     ./build.sh --clean --build
@@ -104,6 +118,10 @@ while [[ $# -gt 0 ]]; do
                 shift
             fi
             ;;
+        --python)
+            DO_PYTHON=1
+            shift
+            ;;
         --compiler)
             COMPILER="$2"
             if [[ "$COMPILER" != "gcc" && "$COMPILER" != "clang" ]]; then
@@ -132,8 +150,8 @@ while [[ $# -gt 0 ]]; do
     esac
 done
 
-if [[ $DO_CLEAN -eq 0 && $DO_BUILD -eq 0 && $DO_TEST -eq 0 ]]; then
-    echo "Error: Must specify at least one action (--clean, --build, --test, or --all)"
+if [[ $DO_CLEAN -eq 0 && $DO_BUILD -eq 0 && $DO_TEST -eq 0 && $DO_PYTHON -eq 0 ]]; then
+    echo "Error: Must specify at least one action (--clean, --build, --test, --python, or --all)"
     show_usage
     exit 1
 fi
@@ -162,6 +180,7 @@ if [[ $DO_CLEAN -eq 1 ]]; then
     rm -f Makefile
     rm -f *.make
     rm -rf tests/__pycache__
+    rm -rf python/build python/*.so
     rm -rf .pytest_cache
     echo "✓ Clean complete"
     echo ""
@@ -182,6 +201,13 @@ if [[ $DO_BUILD -eq 1 ]]; then
     ls -lh build/libmcoptions.so 2>/dev/null || ls -lh build/libmcoptions.dylib 2>/dev/null || ls -lh build/mcoptions.dll 2>/dev/null
 fi
 
+if [[ $DO_PYTHON -eq 1 ]]; then
+    echo ""
+    echo ">>> Building Python extension..."
+    (cd python && python3 setup.py build_ext --inplace)
+    echo "✓ Python extension built in python/"
+fi
+
 if [[ $DO_TEST -eq 1 ]]; then
     echo ""
     echo "============================================"
@@ -230,5 +256,6 @@ echo "============================================"
 echo "Actions performed:"
 [[ $DO_CLEAN -eq 1 ]] && echo "  ✓ Clean"
 [[ $DO_BUILD -eq 1 ]] && echo "  ✓ Build"
+[[ $DO_PYTHON -eq 1 ]] && echo "  ✓ Python extension"
 [[ $DO_TEST -eq 1 ]] && echo "  ✓ Test"
 echo ""
@@ -1,11 +1,19 @@
 #ifndef MCOPTIONS_CONTEXT_HPP
 #define MCOPTIONS_CONTEXT_HPP
 
+#include "internal/random.hpp"
 #include <random>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 
 namespace mcoptions {
 
+class Checkpoint;
+class SimulationWorkspace;
+class WorkerPool;
+struct PathCache;
+
 class Context {
 public:
     enum class Model {
@@ -14,6 +22,17 @@ public:
         SABR
     };
 
+    enum class ThreadAffinity {
+        None,       // Threads float
+        Compact,    // Fill one NUMA node before the next
+        Spread      // Round-robin across NUMA nodes
+    };
+
+    enum class StreamMode {
+        Blocks,     // Counter-based stream per block of paths
+        Sequential  // The serial Mersenne Twister sequence, split by jump-ahead
+    };
+
     Context();
     ~Context() = default;
     
@@ -36,6 +55,9 @@ public:
     void set_importance_sampling(bool enabled, double drift_shift);
     bool get_importance_sampling() const;
     double get_drift_shift() const;
+
+    void set_normal_method(NormalMethod method);
+    NormalMethod get_normal_method() const;
     
     // Model settings
     void set_model(Model model);
@@ -51,9 +73,57 @@ public:
     void set_binomial_steps(size_t n);
     size_t get_binomial_steps() const;
     
+    // Parallel engine (0 threads = one per usable CPU)
+    void set_num_threads(size_t n);
+    size_t get_num_threads() const;
+
+    void set_thread_affinity(ThreadAffinity affinity);
+    ThreadAffinity get_thread_affinity() const;
+
+    // Pool kept by a prepared plan instead of the shared one; changing the
+    // thread count or affinity drops it
+    void set_worker_pool(std::shared_ptr<WorkerPool> pool);
+    const std::shared_ptr<WorkerPool>& get_worker_pool() const;
+
+    // Set by a reweighting plan around a full simulation: path-wise
+    // streaming kernels record their paths into it (see likelihood_ratio.hpp)
+    void set_path_cache(std::shared_ptr<PathCache> cache);
+    const std::shared_ptr<PathCache>& get_path_cache() const;
+
+    // Kept by a prepared plan on its private context: kernels reuse their
+    // grid, step tables and block buffers from it (see simulation_workspace.hpp)
+    void set_workspace(std::shared_ptr<SimulationWorkspace> workspace);
+    const std::shared_ptr<SimulationWorkspace>& get_workspace() const;
+
+    // Progress file of long jobs, shared by copies of the context (see
+    // engine/checkpoint.hpp); jobs recording a path cache do not checkpoint
+    void set_checkpoint(std::shared_ptr<Checkpoint> checkpoint);
+    const std::shared_ptr<Checkpoint>& get_checkpoint() const;
+
+    // What the next jobs price, set by the pricing functions; part of a
+    // job's checkpoint identity (see job_fingerprint)
+    void set_job_fingerprint(uint64_t fingerprint);
+    uint64_t get_job_fingerprint() const;
+
+    // Fixed-order reductions: bit-identical results for any thread count
+    void set_reproducible(bool enabled);
+    bool get_reproducible() const;
+
+    // Where engine jobs draw from (see engine/parallel.hpp)
+    void set_stream_mode(StreamMode mode);
+    StreamMode get_stream_mode() const;
+    
     // Random number generation
-    std::mt19937_64& get_rng();
-    void set_seed(unsigned int seed);
+    //
+    // get_rng() is the sequential Mersenne Twister stream of the legacy
+    // kernels, seeded exactly as before (mt19937_64::seed(seed)) but only on
+    // first use, so set_seed() itself is O(1). Engine jobs instead take one
+    // key each from next_stream_key() and run counter-based block streams,
+    // unless the stream mode is Sequential.
+    Mt19937_64& get_rng();
+    void set_seed(uint64_t seed);
+    uint64_t get_seed() const;
+    uint64_t next_stream_key();
 
 private:
     // Monte Carlo configuration
@@ -64,6 +134,7 @@ private:
     bool stratified_sampling_enabled_;
     bool importance_sampling_enabled_;
     double drift_shift_;
+    NormalMethod normal_method_;
     
     // Model configuration
     Model model_;
@@ -75,8 +146,22 @@ private:
     // Binomial tree configuration
     size_t binomial_steps_;
     
+    // Parallel engine configuration
+    size_t num_threads_;
+    ThreadAffinity thread_affinity_;
+    std::shared_ptr<WorkerPool> worker_pool_;
+    std::shared_ptr<PathCache> path_cache_;
+    std::shared_ptr<SimulationWorkspace> workspace_;
+    std::shared_ptr<Checkpoint> checkpoint_;
+    uint64_t job_fingerprint_;
+    bool reproducible_;
+    StreamMode stream_mode_;
+    
     // Random number generator
-    std::mt19937_64 rng_;
+    uint64_t seed_;
+    bool rng_stale_;
+    Mt19937_64 rng_;
+    Philox4x32 stream_keys_;
 };
 
 }
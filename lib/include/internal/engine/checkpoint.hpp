@@ -0,0 +1,141 @@
+#ifndef MCOPTIONS_CHECKPOINT_HPP
+#define MCOPTIONS_CHECKPOINT_HPP
+
+#include "internal/engine/sample_moments.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Progress of simulation jobs kept in a local file, so a run that is killed
+ * can be repeated and continue where it stopped
+ *
+ * A job (one simulate_blocks call) is identified by its stream mode, stream
+ * key, block count, draws per block, the fingerprint of what it prices (see
+ * job_fingerprint) and the moments of its first block. The fingerprint tells
+ * apart contracts whose first blocks agree bit for bit, such as two deep
+ * out-of-the-money options that pay nothing on block 0.
+ * While records loaded from the file are still unclaimed, a job recomputes
+ * its first block before looking itself up, so a different instrument or
+ * path count under the same seed never matches another job's record.
+ * Otherwise the job takes its first block from the run itself.
+ *
+ * What a record keeps is exactly what the job needs to go on as if it had
+ * never stopped (see simulate_blocks):
+ * - block streams: the partial sums of the finished blocks, already folded
+ *   into the complete subtrees of the pairwise reduction (one per set bit of
+ *   the block count done), so the file stays small and the final sum has the
+ *   same rounding as an uninterrupted run;
+ * - the sequential stream: the running sums in path order and the Mersenne
+ *   Twister state after the last finished block.
+ *
+ * A finished job leaves only its counts in the file header. A resumed run
+ * prices finished jobs again, which also puts the sequential stream back
+ * where the interrupted job started, so the file holds just the jobs in
+ * progress. It is rewritten whole (to a temporary file, then renamed over
+ * the old one) at most once per interval, so a crash leaves either the
+ * previous or the new checkpoint.
+ */
+
+struct CheckpointRecord {
+    // Identity
+    uint32_t stream_mode = 0;          // Context::StreamMode
+    uint64_t key = 0;                  // Job key; 0 for the sequential stream
+    uint64_t num_blocks = 0;
+    uint64_t draws_per_block = 0;
+    uint64_t fingerprint = 0;          // Context::get_job_fingerprint
+    SampleMoments first_block;
+
+    // Progress
+    uint64_t blocks_done = 0;
+    std::vector<SampleMoments> partials;
+    std::vector<uint64_t> rng_state;   // Sequential stream: 312 words, then the position
+
+    bool loaded = false;               // Read from the file and not yet claimed by a job
+
+    bool same_job(const CheckpointRecord& other) const;
+};
+
+/**
+ * Fingerprint of a contract for CheckpointRecord: FNV-1a over the kind and
+ * the bit patterns of every parameter its payoff depends on, then of any
+ * dates. Pricing functions set it on the context before they simulate
+ * (Context::set_job_fingerprint).
+ */
+inline uint64_t job_fingerprint(const char* kind, std::initializer_list<double> parameters,
+                                const std::vector<double>& dates = {}) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 1099511628211ull;
+    };
+    mix(kind, std::strlen(kind) + 1);
+    for (double parameter : parameters) mix(&parameter, sizeof(parameter));
+    if (!dates.empty()) mix(dates.data(), dates.size() * sizeof(double));
+    return hash;
+}
+
+class Checkpoint {
+public:
+    /**
+     * Checkpoints to `path` at most every `interval_seconds`
+     *
+     * With `resume` the records already in the file are loaded (a missing
+     * file is an empty checkpoint); otherwise they are dropped at the first
+     * write. Throws std::invalid_argument for a file that is not a
+     * checkpoint.
+     */
+    Checkpoint(std::string path, double interval_seconds, bool resume);
+
+    Checkpoint(const Checkpoint&) = delete;
+    Checkpoint& operator=(const Checkpoint&) = delete;
+
+    // Whether any record loaded from the file is still unclaimed
+    bool has_saved_jobs() const;
+
+    // Fills in the progress of a saved job with the same identity; false if there is none
+    bool find(CheckpointRecord& record) const;
+
+    /**
+     * Keeps the job's progress, or only counts it once the job has finished,
+     * and writes the file once the interval has passed. A failed write is
+     * remembered and retried at the next interval, never thrown: the job
+     * goes on without its checkpoint.
+     */
+    void update(const CheckpointRecord& record);
+
+    // Writes any progress not yet in the file; throws std::runtime_error if it cannot
+    void flush();
+
+    // Jobs in progress
+    std::vector<CheckpointRecord> records() const;
+
+    // Jobs finished since the file was started, and their blocks
+    uint64_t finished_jobs() const;
+    uint64_t finished_blocks() const;
+
+    const std::string& path() const { return path_; }
+    double interval() const { return interval_; }
+
+private:
+    void write_locked();
+
+    std::string path_;
+    double interval_;
+    mutable std::mutex mutex_;
+    std::vector<CheckpointRecord> records_;
+    uint64_t finished_jobs_ = 0;
+    uint64_t finished_blocks_ = 0;
+    std::chrono::steady_clock::time_point last_write_;
+    bool dirty_ = false;
+};
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_CHECKPOINT_HPP
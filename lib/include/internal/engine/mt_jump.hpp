@@ -0,0 +1,40 @@
+#ifndef MCOPTIONS_MT_JUMP_HPP
+#define MCOPTIONS_MT_JUMP_HPP
+
+#include "internal/random.hpp"
+#include <cstdint>
+
+namespace mcoptions {
+
+/**
+ * Jump-ahead for the 64-bit Mersenne Twister (Haramoto et al., 2008)
+ *
+ * The generator is linear over GF(2): one step is a fixed matrix T acting on
+ * the 19937-bit state, and T satisfies its characteristic polynomial phi.
+ * So T^n = p(T) with p(x) = x^n mod phi, a polynomial of degree < 19937, and
+ * T^n s is evaluated by stepping a copy of s 19937 times and adding up the
+ * states whose coefficient in p is set. That costs about as much as
+ * generating a million outputs, whatever n is.
+ *
+ * phi is found once per process by Berlekamp-Massey on the output bits.
+ * Computing p takes about log2(n) squarings modulo phi; the polynomials are
+ * kept per stride, so jobs that keep cutting the sequence in the same places
+ * (same path count, same worker count) only pay for the evaluation.
+ */
+
+/**
+ * Advance by `steps` outputs; the same as rng.discard(steps)
+ *
+ * Short distances are simply generated.
+ */
+void jump_ahead(Mt19937_64& rng, uint64_t steps);
+
+/**
+ * Advance by 2^exponent outputs (exponent <= 1024), e.g. 2^64 to start
+ * streams that cannot overlap
+ */
+void jump_ahead_pow2(Mt19937_64& rng, unsigned exponent);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_MT_JUMP_HPP
@@ -0,0 +1,434 @@
+#ifndef MCOPTIONS_PARALLEL_HPP
+#define MCOPTIONS_PARALLEL_HPP
+
+#include "internal/context.hpp"
+#include "internal/engine/checkpoint.hpp"
+#include "internal/engine/mt_jump.hpp"
+#include "internal/engine/sample_moments.hpp"
+#include "internal/engine/worker_pool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Block-parallel execution for the simulation kernels
+ *
+ * Work is cut into fixed blocks of paths. Every block draws from its own
+ * counter-based stream, keyed by one value taken from the context
+ * (Context::next_stream_key) and indexed by the block, so the paths do not
+ * depend on which worker runs a block or on the thread count, and a seeded
+ * context still reproduces its results.
+ *
+ * Blocks allocate their own buffers inside the task: with pinned workers the
+ * memory lands on the node that uses it. Partial results are kept per
+ * worker, summed within each NUMA node and only then across nodes; in
+ * reproducible mode they are kept per block instead (see parallel_reduce).
+ *
+ * With one thread (the context default) blocks run inline on the calling
+ * thread. Called from inside a pool task, a job forks into that task's pool
+ * whatever the context asks for, so nested parallelism (a batch of
+ * instruments, each splitting its paths) never oversubscribes the machine.
+ *
+ * In sequential stream mode (Context::StreamMode::Sequential) the blocks
+ * instead consume the context's Mersenne Twister in order, exactly as the
+ * serial kernels did, so a seed reproduces their prices. Each worker takes a
+ * contiguous run of blocks and jumps a copy of the generator to the start of
+ * its run (engine/mt_jump.hpp); the samples are summed in path order.
+ */
+
+const size_t kPathsPerBlock = 1024;
+
+inline size_t count_blocks(size_t count, size_t block_size) {
+    return (count + block_size - 1) / block_size;
+}
+
+/**
+ * Generator for one block of a job: stream `block` under the job's key
+ *
+ * Counter-based, so setting up a block costs nanoseconds (no state to fill).
+ */
+inline Philox4x32 block_rng(uint64_t job_key, size_t block) {
+    return Philox4x32(job_key, static_cast<uint64_t>(block));
+}
+
+namespace detail {
+
+// Pool for a job: the caller's own pool inside a task, else the context's
+// pinned pool or the shared one; null when the job should run inline
+inline std::shared_ptr<WorkerPool> job_pool(const Context& ctx, size_t num_blocks) {
+    if (ctx.get_num_threads() == 1 || num_blocks <= 1) return nullptr;
+    if (WorkerPool* current = WorkerPool::current()) {
+        // Non-owning: the running task keeps its pool alive
+        return std::shared_ptr<WorkerPool>(std::shared_ptr<WorkerPool>(), current);
+    }
+    if (ctx.get_worker_pool()) return ctx.get_worker_pool();
+    return shared_worker_pool(ctx.get_num_threads(), ctx.get_thread_affinity());
+}
+
+} // namespace detail
+
+/**
+ * Combine partials[0..n) by a pairwise tree of fixed shape; the result lands in partials[0]
+ *
+ * The grouping depends only on n, and the rounding error grows with
+ * log2(n) rather than n.
+ */
+template <typename Slot>
+void pairwise_combine(std::vector<Slot>& partials) {
+    for (size_t stride = 1; stride < partials.size(); stride *= 2) {
+        for (size_t i = 0; i + stride < partials.size(); i += 2 * stride) {
+            partials[i].acc.merge(partials[i + stride].acc);
+        }
+    }
+}
+
+/**
+ * Run fn(block, acc) for every block and return the merged accumulator
+ *
+ * Acc must be default constructible and provide `void merge(const Acc&)`.
+ *
+ * Fast mode (default): one accumulator per worker. Which blocks share an
+ * accumulator depends on scheduling, so the last bits of the sum can change
+ * from run to run with more than one thread. Blocks that fork nested jobs
+ * may also see other blocks of the same worker added to their accumulator
+ * meanwhile, so accumulation must be additive.
+ *
+ * Reproducible mode (Context::get_reproducible): one accumulator per block,
+ * reduced by pairwise_combine. The block decomposition does not depend on
+ * the thread count, so neither does any rounding.
+ */
+template <typename Acc, typename BlockFn>
+Acc parallel_reduce(const Context& ctx, size_t num_blocks, BlockFn&& fn) {
+    // One cache line per partial so concurrent blocks do not false-share
+    struct alignas(64) Slot { Acc acc; };
+    std::shared_ptr<WorkerPool> pool = detail::job_pool(ctx, num_blocks);
+
+    if (ctx.get_reproducible()) {
+        std::vector<Slot> partials(std::max<size_t>(num_blocks, 1));
+        if (pool) {
+            pool->run(num_blocks, [&](size_t block, size_t) { fn(block, partials[block].acc); });
+        } else {
+            for (size_t block = 0; block < num_blocks; ++block) fn(block, partials[block].acc);
+        }
+        pairwise_combine(partials);
+        return partials[0].acc;
+    }
+
+    if (!pool) {
+        Acc total;
+        for (size_t block = 0; block < num_blocks; ++block) fn(block, total);
+        return total;
+    }
+
+    std::vector<Slot> slots(pool->num_workers());
+    pool->run(num_blocks, [&](size_t block, size_t worker) { fn(block, slots[worker].acc); });
+
+    std::vector<Acc> nodes(pool->num_nodes());
+    for (size_t worker = 0; worker < slots.size(); ++worker) {
+        nodes[pool->worker_node(worker)].merge(slots[worker].acc);
+    }
+    Acc total;
+    for (const Acc& node : nodes) total.merge(node);
+    return total;
+}
+
+/**
+ * Run fn(block) for every block
+ */
+template <typename BlockFn>
+void parallel_for(const Context& ctx, size_t num_blocks, BlockFn&& fn) {
+    std::shared_ptr<WorkerPool> pool = detail::job_pool(ctx, num_blocks);
+    if (!pool) {
+        for (size_t block = 0; block < num_blocks; ++block) fn(block);
+        return;
+    }
+    pool->run(num_blocks, [&](size_t block, size_t) { fn(block); });
+}
+
+/**
+ * Samples of one block in the order they were drawn
+ *
+ * A block reports either plain samples or (sample, control) pairs throughout.
+ */
+struct SampleLog {
+    std::vector<double> y;
+    std::vector<double> x;
+
+    void add(double value) { y.push_back(value); }
+
+    void add(double value, double control) {
+        y.push_back(value);
+        x.push_back(control);
+    }
+
+    void replay(SampleMoments& moments) const {
+        for (size_t i = 0; i < y.size(); ++i) {
+            if (x.empty()) moments.add(y[i]);
+            else moments.add(y[i], x[i]);
+        }
+    }
+};
+
+namespace detail {
+
+// Runs of consecutive blocks for a sequential-stream job; one unless every
+// full block consumes the same number of outputs and the job has a pool
+inline size_t sequential_runs(const Context& ctx, size_t num_blocks, uint64_t draws_per_block,
+                              std::shared_ptr<WorkerPool>& pool) {
+    pool = draws_per_block ? job_pool(ctx, num_blocks) : nullptr;
+    return pool ? std::min(num_blocks, pool->num_workers()) : 1;
+}
+
+// Runs blocks [first, last) on the sequential stream: in order on the calling
+// thread, or with a pool (and a fixed draws_per_block) as runs of consecutive
+// blocks, each on a copy of the generator jumped to the start of its run
+template <typename BlockFn>
+void sequential_range(WorkerPool* pool, Mt19937_64& serial, size_t first, size_t last,
+                      uint64_t draws_per_block, BlockFn& fn) {
+    size_t count = last - first;
+    size_t runs = pool && draws_per_block ? std::min(count, pool->num_workers()) : 1;
+    if (runs <= 1) {
+        for (size_t block = first; block < last; ++block) fn(block, serial);
+        return;
+    }
+
+    Mt19937_64 end_state;
+    pool->run(runs, [&](size_t run, size_t) {
+        size_t begin = first + run * count / runs;
+        size_t end = first + (run + 1) * count / runs;
+        Mt19937_64 rng = serial;
+        jump_ahead(rng, (begin - first) * draws_per_block);
+        for (size_t block = begin; block < end; ++block) fn(block, rng);
+        if (run + 1 == runs) end_state = rng;
+    });
+    serial = end_state;
+}
+
+} // namespace detail
+
+/**
+ * Run fn(block, rng) for every block with the generator the stream mode asks for
+ *
+ * fn is generic in the generator: a Philox4x32 per block in block mode, the
+ * sequential Mersenne Twister (Mt19937_64) otherwise. `draws_per_block` is
+ * the number of outputs a full block takes from it, or 0 if that varies
+ * (rejection sampling, shuffles), in which case a sequential job runs its
+ * blocks in order on the calling thread. Either way the context's generator
+ * ends up where a serial loop would have left it.
+ */
+template <typename BlockFn>
+void parallel_for_streams(Context& ctx, size_t num_blocks, uint64_t draws_per_block, BlockFn&& fn) {
+    if (ctx.get_stream_mode() == Context::StreamMode::Blocks) {
+        uint64_t job_key = ctx.next_stream_key();
+        parallel_for(ctx, num_blocks, [&](size_t block) {
+            Philox4x32 rng = block_rng(job_key, block);
+            fn(block, rng);
+        });
+        return;
+    }
+
+    std::shared_ptr<WorkerPool> pool;
+    detail::sequential_runs(ctx, num_blocks, draws_per_block, pool);
+    detail::sequential_range(pool.get(), ctx.get_rng(), 0, num_blocks, draws_per_block, fn);
+}
+
+namespace detail {
+
+// Blocks per worker between two checkpoints of a job
+const size_t kCheckpointBlocksPerWorker = 64;
+
+// Start of each complete subtree of the pairwise reduction that covers blocks
+// [0, done): one per set bit of `done`, largest first
+inline std::vector<size_t> prefix_roots(size_t done) {
+    std::vector<size_t> roots;
+    size_t start = 0;
+    for (size_t size = ~(~size_t(0) >> 1); size > 0; size >>= 1) {
+        if (done & size) {
+            roots.push_back(start);
+            start += size;
+        }
+    }
+    return roots;
+}
+
+/*
+ * Combines, as pairwise_combine would, the subtrees completed by finishing
+ * blocks [from, to), and clears the partials merged away. pairwise_combine
+ * over the whole vector later only adds zeros to the folded roots, so the
+ * rounding is that of an unfolded reduction.
+ */
+template <typename Slot>
+void fold_prefix(std::vector<Slot>& partials, size_t from, size_t to) {
+    for (size_t stride = 1; 2 * stride <= to; stride *= 2) {
+        for (size_t i = from / (2 * stride) * (2 * stride); i + 2 * stride <= to; i += 2 * stride) {
+            partials[i].acc.merge(partials[i + stride].acc);
+            partials[i + stride].acc = SampleMoments();
+        }
+    }
+}
+
+inline std::invalid_argument corrupt_checkpoint(const Checkpoint& checkpoint) {
+    return std::invalid_argument("Checkpoint file is corrupt: " + checkpoint.path());
+}
+
+/*
+ * simulate_blocks with its progress saved to a checkpoint
+ *
+ * Blocks run in chunks; after each one the job's record is updated (see
+ * engine/checkpoint.hpp). A job found in the checkpoint starts after its
+ * last saved block. Only while the checkpoint holds unclaimed saved jobs is
+ * the first block simulated again on the side to look the job up; else the
+ * run's own first block identifies it. Block streams are counter-based and the sequential
+ * stream is restored from its saved state, so the remaining blocks draw
+ * exactly what they would have drawn, and the sums are resumed in the same
+ * order: the price is bit-identical to an uninterrupted run.
+ *
+ * Block-stream jobs always reduce per block as in reproducible mode, since
+ * per-worker partials could not be saved consistently.
+ */
+template <typename BlockFn>
+SampleMoments simulate_checkpointed(Context& ctx, Checkpoint& checkpoint, size_t num_blocks,
+                                    uint64_t draws_per_block, BlockFn& fn) {
+    bool block_streams = ctx.get_stream_mode() == Context::StreamMode::Blocks;
+    CheckpointRecord record;
+    record.stream_mode = static_cast<uint32_t>(ctx.get_stream_mode());
+    record.num_blocks = num_blocks;
+    record.draws_per_block = draws_per_block;
+    record.fingerprint = ctx.get_job_fingerprint();
+    if (block_streams) record.key = ctx.next_stream_key();
+    // The first block again, on the side, identifies a job that may be saved
+    bool identified = checkpoint.has_saved_jobs();
+    if (identified && block_streams) {
+        Philox4x32 rng = block_rng(record.key, 0);
+        fn(0, rng, record.first_block);
+    } else if (identified) {
+        Mt19937_64 rng = ctx.get_rng();
+        fn(0, rng, record.first_block);
+    }
+    bool resumed = identified && checkpoint.find(record);
+
+    std::shared_ptr<WorkerPool> pool =
+        block_streams || draws_per_block ? job_pool(ctx, num_blocks) : nullptr;
+    size_t chunk = kCheckpointBlocksPerWorker * (pool ? pool->num_workers() : 1);
+    size_t done = resumed ? record.blocks_done : 0;
+
+    if (block_streams) {
+        struct alignas(64) Slot { SampleMoments acc; };
+        std::vector<Slot> partials(num_blocks);
+        std::vector<size_t> roots = prefix_roots(done);
+        if (resumed && roots.size() != record.partials.size()) throw corrupt_checkpoint(checkpoint);
+        for (size_t r = 0; r < roots.size(); ++r) partials[roots[r]].acc = record.partials[r];
+
+        auto run_block = [&](size_t block) {
+            Philox4x32 rng = block_rng(record.key, block);
+            fn(block, rng, partials[block].acc);
+        };
+        while (done < num_blocks) {
+            size_t first = done;
+            size_t last = std::min(first + chunk, num_blocks);
+            if (pool) {
+                pool->run(last - first, [&](size_t i, size_t) { run_block(first + i); });
+            } else {
+                for (size_t block = first; block < last; ++block) run_block(block);
+            }
+            if (first == 0 && !identified) record.first_block = partials[0].acc;
+            fold_prefix(partials, first, last);
+            done = last;
+
+            record.blocks_done = done;
+            record.partials.clear();
+            for (size_t root : prefix_roots(done)) record.partials.push_back(partials[root].acc);
+            checkpoint.update(record);
+        }
+        pairwise_combine(partials);
+        return partials[0].acc;
+    }
+
+    Mt19937_64& serial = ctx.get_rng();
+    SampleMoments total;
+    if (resumed) {
+        if (record.partials.size() != 1 || record.rng_state.size() != Mt19937_64::kStateWords + 1) {
+            throw corrupt_checkpoint(checkpoint);
+        }
+        total = record.partials[0];
+        std::copy(record.rng_state.begin(), record.rng_state.end() - 1, serial.state());
+        serial.set_position(static_cast<size_t>(record.rng_state.back()));
+    }
+    while (done < num_blocks) {
+        size_t first = done;
+        // Sums start from zero, so after block 0 alone they are its moments
+        size_t last = first == 0 && !identified ? 1 : std::min(first + chunk, num_blocks);
+        if (pool && last - first > 1) {
+            std::vector<SampleLog> logs(last - first);
+            auto log_block = [&](size_t block, auto& rng) { fn(block, rng, logs[block - first]); };
+            sequential_range(pool.get(), serial, first, last, draws_per_block, log_block);
+            for (const SampleLog& log : logs) log.replay(total);
+        } else {
+            auto add_block = [&](size_t block, auto& rng) { fn(block, rng, total); };
+            sequential_range(nullptr, serial, first, last, draws_per_block, add_block);
+        }
+        done = last;
+        if (first == 0 && !identified) record.first_block = total;
+
+        record.blocks_done = done;
+        record.partials.assign(1, total);
+        record.rng_state.assign(serial.state(), serial.state() + Mt19937_64::kStateWords);
+        record.rng_state.push_back(serial.position());
+        checkpoint.update(record);
+    }
+    return total;
+}
+
+} // namespace detail
+
+/**
+ * Run fn(block, rng, sink) for every block and return the moments of all samples
+ *
+ * fn reports each sample with sink.add(y) or sink.add(y, x) and is generic in
+ * the sink as well as the generator. Block mode reduces like parallel_reduce;
+ * a sequential job split across workers logs every block's samples and sums
+ * them in path order afterwards, which reproduces the serial result bit for
+ * bit at the cost of two doubles per sample.
+ *
+ * With a checkpoint on the context (and no path cache to fill) the job saves
+ * its progress and resumes from it, see detail::simulate_checkpointed.
+ */
+template <typename BlockFn>
+SampleMoments simulate_blocks(Context& ctx, size_t num_blocks, uint64_t draws_per_block, BlockFn&& fn) {
+    std::shared_ptr<Checkpoint> checkpoint = ctx.get_checkpoint();
+    if (checkpoint && !ctx.get_path_cache() && num_blocks > 0) {
+        return detail::simulate_checkpointed(ctx, *checkpoint, num_blocks, draws_per_block, fn);
+    }
+
+    if (ctx.get_stream_mode() == Context::StreamMode::Blocks) {
+        uint64_t job_key = ctx.next_stream_key();
+        return parallel_reduce<SampleMoments>(ctx, num_blocks, [&](size_t block, SampleMoments& acc) {
+            Philox4x32 rng = block_rng(job_key, block);
+            fn(block, rng, acc);
+        });
+    }
+
+    std::shared_ptr<WorkerPool> pool;
+    SampleMoments total;
+    if (detail::sequential_runs(ctx, num_blocks, draws_per_block, pool) <= 1) {
+        parallel_for_streams(ctx, num_blocks, 0, [&](size_t block, auto& rng) {
+            fn(block, rng, total);
+        });
+        return total;
+    }
+
+    std::vector<SampleLog> logs(num_blocks);
+    parallel_for_streams(ctx, num_blocks, draws_per_block, [&](size_t block, auto& rng) {
+        fn(block, rng, logs[block]);
+    });
+    for (const SampleLog& log : logs) log.replay(total);
+    return total;
+}
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_PARALLEL_HPP
@@ -0,0 +1,44 @@
+#ifndef MCOPTIONS_SAMPLE_MOMENTS_HPP
+#define MCOPTIONS_SAMPLE_MOMENTS_HPP
+
+#include <cstddef>
+
+namespace mcoptions {
+
+/**
+ * Sums of per-path samples and of an optional control
+ */
+struct SampleMoments {
+    size_t count = 0;
+    double sum_y = 0.0;
+    double sum_yy = 0.0;
+    double sum_x = 0.0;
+    double sum_xx = 0.0;
+    double sum_xy = 0.0;
+
+    void add(double y) {
+        ++count;
+        sum_y += y;
+        sum_yy += y * y;
+    }
+
+    void add(double y, double x) {
+        add(y);
+        sum_x += x;
+        sum_xx += x * x;
+        sum_xy += x * y;
+    }
+
+    void merge(const SampleMoments& other) {
+        count += other.count;
+        sum_y += other.sum_y;
+        sum_yy += other.sum_yy;
+        sum_x += other.sum_x;
+        sum_xx += other.sum_xx;
+        sum_xy += other.sum_xy;
+    }
+};
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_SAMPLE_MOMENTS_HPP
@@ -0,0 +1,31 @@
+#ifndef MCOPTIONS_TOPOLOGY_HPP
+#define MCOPTIONS_TOPOLOGY_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * CPU / NUMA topology of the host, restricted to the CPUs this process may run on
+ *
+ * On Linux the NUMA nodes come from /sys/devices/system/node and are
+ * intersected with the process affinity mask (taskset, cgroups). Elsewhere,
+ * or when sysfs is unavailable, the host is reported as one node holding
+ * std::thread::hardware_concurrency() CPUs.
+ */
+struct CpuTopology {
+    std::vector<std::vector<int>> node_cpus;   // Non-empty nodes only, in node order
+
+    size_t num_nodes() const { return node_cpus.size(); }
+    size_t num_cpus() const;
+};
+
+/**
+ * Topology detected once per process
+ */
+const CpuTopology& system_topology();
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_TOPOLOGY_HPP
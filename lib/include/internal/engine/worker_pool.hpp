@@ -0,0 +1,130 @@
+#ifndef MCOPTIONS_WORKER_POOL_HPP
+#define MCOPTIONS_WORKER_POOL_HPP
+
+#include "internal/context.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Work-stealing pool of worker threads, optionally pinned to CPUs
+ *
+ * Placement follows the affinity mode:
+ * - None:    threads float; all workers count as one node
+ * - Compact: fill the CPUs of the first NUMA node before moving to the next
+ * - Spread:  deal workers round-robin across nodes (more memory bandwidth)
+ *
+ * A worker pins itself before running any task, so everything a task
+ * allocates and writes first (path blocks, scratch buffers) is placed in the
+ * memory of the worker's node by the kernel's first-touch policy.
+ *
+ * Scheduling is fork-join over block ranges. A range is split in halves; the
+ * upper half goes to the back of the running worker's deque and the lower
+ * half is processed, down to single blocks. Owners pop from the back (depth
+ * first, cache warm), idle workers steal from the front (the largest
+ * pending ranges), so uneven jobs balance without static partitioning.
+ *
+ * Jobs may nest: a task that calls run() on its own pool forks into the same
+ * deques and, while waiting, runs or steals other tasks instead of blocking.
+ * When there is nothing left to take it sleeps until its job finishes or a
+ * task is pushed to a deque, so it never spins against the workers running
+ * its blocks. A batch of instruments each splitting its paths therefore
+ * keeps exactly num_workers() threads busy. Threads outside the pool (API callers, server
+ * handlers) submit through a shared injection queue and sleep until done.
+ */
+class WorkerPool {
+public:
+    WorkerPool(size_t num_workers, Context::ThreadAffinity affinity);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t num_workers() const { return workers_.size(); }
+    Context::ThreadAffinity affinity() const { return affinity_; }
+
+    // Reduction groups: workers sharing a NUMA node, numbered from 0
+    size_t num_nodes() const { return num_nodes_; }
+    size_t worker_node(size_t worker) const { return workers_[worker]->node; }
+
+    /**
+     * Run task(block, worker) for every block in [0, num_blocks) and wait
+     *
+     * Ranges of at most `grain` blocks are not split further. The first
+     * exception thrown by a task is rethrown here; blocks not yet started
+     * when it is thrown are skipped.
+     */
+    void run(size_t num_blocks, const std::function<void(size_t, size_t)>& task, size_t grain = 1);
+
+    // Pool owning the calling thread, or nullptr outside any pool
+    static WorkerPool* current();
+
+private:
+    struct Job;
+
+    struct Task {
+        std::shared_ptr<Job> job;
+        size_t begin;
+        size_t end;
+    };
+
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        size_t node = 0;
+        int cpu = -1;
+        std::thread thread;
+    };
+
+    void worker_loop(size_t index);
+    void execute(Task task, size_t worker);
+    void push_local(size_t worker, Task task);
+    bool pop_local(size_t worker, Task& task);
+    bool steal(size_t thief, Task& task);
+    bool pop_injected(Task& task);
+    void notify_work();
+    void notify_helpers();
+
+    Context::ThreadAffinity affinity_;
+    size_t num_nodes_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex inject_mutex_;
+    std::deque<Task> injected_;
+
+    // Idle workers sleep until a task is queued anywhere
+    std::atomic<size_t> queued_;
+    std::atomic<size_t> sleepers_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+
+    // Workers waiting on a nested job sleep until it finishes or a deque
+    // gets a task they could steal
+    std::atomic<size_t> deque_tasks_;
+    std::atomic<size_t> helpers_;
+    std::condition_variable help_;
+};
+
+/**
+ * Process-wide pool for the given configuration
+ *
+ * num_workers = 0 means one worker per usable CPU. The pools of the last
+ * few configurations are kept, so callers that alternate between them (a
+ * server with mixed requests) neither rebuild nor re-pin threads. Callers
+ * hold a reference for the duration of their job, so an evicted pool
+ * drains before it is destroyed.
+ */
+std::shared_ptr<WorkerPool> shared_worker_pool(size_t num_workers, Context::ThreadAffinity affinity);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_WORKER_POOL_HPP
@@ -0,0 +1,56 @@
+#ifndef MCOPTIONS_AUTOCALLABLE_NOTE_HPP
+#define MCOPTIONS_AUTOCALLABLE_NOTE_HPP
+
+#include "internal/context.hpp"
+#include <vector>
+
+namespace mcoptions {
+
+// Autocallable / phoenix note on the worst performer of one or more assets.
+// Barriers and the put strike are fractions of the initial fixing.
+//
+// On each observation date t_i (the last one is maturity):
+//   - worst performance >= coupon_barrier: pay coupon_rate * notional,
+//     plus all previously missed coupons if `memory` is set
+//   - worst performance >= autocall_barrier (before maturity): redeem the
+//     notional and terminate
+// At maturity the notional is repaid unless the worst performance is below
+// knock_in_barrier, in which case the holder is short a put struck at
+// put_strike: redemption = notional * performance / put_strike.
+struct AutocallableTerms {
+    double notional;
+    double autocall_barrier;
+    double coupon_barrier;
+    double coupon_rate;
+    bool memory;
+    double knock_in_barrier;
+    double put_strike;
+    std::vector<double> observation_dates;
+};
+
+struct AutocallableNoteData {
+    std::vector<double> spots;
+    std::vector<double> initial_fixings;  // Empty = today's spots
+    std::vector<double> volatilities;
+    std::vector<double> correlation;      // Row-major n x n, empty = independent
+    double rate;
+    AutocallableTerms terms;
+};
+
+struct AutocallableResult {
+    double price;
+    double std_error;
+    double expected_observations;         // Mean observation dates simulated per path
+};
+
+// Paths are simulated observation date to observation date (GBM steps are
+// exact, so no intermediate steps are needed) in blocks of lanes. A path that
+// autocalls leaves the block: its cashflows are booked, it draws no further
+// normals, and the remaining active lanes are compacted to the front so the
+// per-date loops stay dense. Antithetic and stratified sampling are not
+// applied, since pairing does not survive compaction.
+AutocallableResult price_autocallable_note(Context& ctx, const AutocallableNoteData& note);
+
+}
+
+#endif
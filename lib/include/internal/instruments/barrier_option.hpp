@@ -23,10 +23,17 @@ struct BarrierOptionData {
     double barrier_level;
     BarrierType barrier_type;
     double rebate;
+    bool continuous_monitoring = false;  // false = monitored on the context's time steps
 };
 
+// Closed form for continuous monitoring under Black-Scholes (the context's
+// model), simulation otherwise
 double price_barrier_option(Context& ctx, const BarrierOptionData& option);
 
+// Simulation regardless of model. Discrete monitoring uses the BGK-shifted
+// continuous contract as control variate when control variates are enabled.
+double price_barrier_option_mc(Context& ctx, const BarrierOptionData& option);
+
 }
 
 #endif
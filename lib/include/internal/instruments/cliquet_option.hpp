@@ -0,0 +1,38 @@
+#ifndef MCOPTIONS_CLIQUET_OPTION_HPP
+#define MCOPTIONS_CLIQUET_OPTION_HPP
+
+#include "internal/context.hpp"
+#include <vector>
+
+namespace mcoptions {
+
+// Cliquet (ratchet) paying at the last reset date
+//
+//   notional * clamp(sum_i clamp(S(t_i) / S(t_{i-1}) - 1, local_floor, local_cap),
+//                    global_floor, global_cap)
+//
+// with t_0 = 0. Caps may be +infinity and floors -infinity.
+struct CliquetOptionData {
+    double rate;
+    double volatility;
+    std::vector<double> reset_dates;   // Increasing, last = maturity
+    double local_floor;
+    double local_cap;
+    double global_floor;
+    double global_cap;
+    double notional;
+};
+
+// Monte Carlo over the reset dates only (GBM steps are exact). With control
+// variates enabled on the context, the sum of locally capped/floored returns
+// is used as control: its expectation is a strip of forward-start call
+// spreads, known in closed form.
+double price_cliquet_option(Context& ctx, const CliquetOptionData& option);
+
+// Closed-form value of the locally capped/floored sum without global
+// cap/floor (the control variate's mean)
+double cliquet_local_sum_value(const CliquetOptionData& option);
+
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef MCOPTIONS_DOUBLE_BARRIER_OPTION_HPP
+#define MCOPTIONS_DOUBLE_BARRIER_OPTION_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument.hpp"
+
+namespace mcoptions {
+
+// Continuously monitored corridor; knocked when either barrier is touched
+struct DoubleBarrierOptionData {
+    double spot;
+    double strike;
+    double rate;
+    double volatility;
+    double time_to_maturity;
+    OptionType type;
+    double lower_barrier;
+    double upper_barrier;
+    bool knock_in;      // false = double knock-out, true = double knock-in
+    double rebate;      // Paid at maturity if knocked out / never knocked in
+};
+
+double price_double_barrier_option(Context& ctx, const DoubleBarrierOptionData& option);
+
+}
+
+#endif
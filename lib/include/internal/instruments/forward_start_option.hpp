@@ -0,0 +1,28 @@
+#ifndef MCOPTIONS_FORWARD_START_OPTION_HPP
+#define MCOPTIONS_FORWARD_START_OPTION_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument.hpp"
+
+namespace mcoptions {
+
+// Vanilla option whose strike is set at start_time to strike_ratio * S(start_time)
+struct ForwardStartOptionData {
+    double spot;
+    double strike_ratio;
+    double rate;
+    double volatility;
+    double start_time;
+    double time_to_maturity;
+    OptionType type;
+};
+
+// Closed form under Black-Scholes (the context's model), simulation otherwise
+double price_forward_start_option(Context& ctx, const ForwardStartOptionData& option);
+
+// Simulation through the streaming kernel, regardless of model
+double price_forward_start_option_mc(Context& ctx, const ForwardStartOptionData& option);
+
+}
+
+#endif
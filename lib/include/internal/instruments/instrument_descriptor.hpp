@@ -0,0 +1,111 @@
+#ifndef MCOPTIONS_INSTRUMENT_DESCRIPTOR_HPP
+#define MCOPTIONS_INSTRUMENT_DESCRIPTOR_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument.hpp"
+#include "internal/instruments/barrier_option.hpp"
+#include "internal/instruments/autocallable_note.hpp"
+#include "internal/instruments/cliquet_option.hpp"
+#include "internal/methods/method_selector.hpp"
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Generic instrument descriptor
+ *
+ * One tagged description for every product the library prices, so batch
+ * engines, caches and the server can handle instruments uniformly instead of
+ * going through a dedicated entry point per product. Common market and
+ * contract data lives in `option`; the remaining fields are only read for
+ * the kinds that use them.
+ */
+
+enum class InstrumentKind {
+    European = 0,
+    American = 1,
+    Asian = 2,
+    Barrier = 3,
+    Lookback = 4,
+    Bermudan = 5,
+    DoubleBarrier = 6,
+    WindowBarrier = 7,
+    Parisian = 8,
+    Autocallable = 9,
+    ForwardStart = 10,
+    Cliquet = 11
+};
+
+struct InstrumentDescriptor {
+    InstrumentKind kind;
+    OptionData option;
+    PricingMethod method;
+    double tolerance;            // Only used with PricingMethod::Auto
+
+    // American
+    size_t num_exercise_points;
+
+    // Asian
+    size_t num_observations;
+
+    // Barrier, window barrier, Parisian (rebate also for double barrier)
+    double barrier_level;
+    BarrierType barrier_type;
+    double rebate;
+
+    // Barrier and lookback: continuous monitoring instead of the context's time steps
+    bool continuous_monitoring;
+
+    // Double barrier
+    double lower_barrier;
+    double upper_barrier;
+    bool knock_in;
+
+    // Window barrier
+    double window_start;
+    double window_end;
+
+    // Parisian
+    double excursion_window;
+
+    // Autocallable (single asset, option.strike is the initial fixing)
+    AutocallableTerms autocallable;
+
+    // Forward start (option.strike is the strike ratio)
+    double start_time;
+
+    // Cliquet (rate and volatility from option)
+    CliquetOptionData cliquet;
+
+    // Lookback
+    bool fixed_strike;
+
+    // Bermudan
+    std::vector<double> exercise_dates;
+};
+
+/**
+ * Check market data and contract terms; throws std::invalid_argument
+ */
+void validate_instrument(const InstrumentDescriptor& instrument);
+
+/**
+ * The market part of validate_instrument() alone (spot and volatility), for
+ * an instrument whose contract terms were already checked
+ */
+void validate_market_inputs(const InstrumentDescriptor& instrument);
+
+/**
+ * Price any instrument with the requested (or automatically chosen) method
+ *
+ * Throws std::invalid_argument for malformed descriptors and
+ * std::domain_error when the method cannot price the instrument.
+ */
+PricingResult price_instrument(Context& ctx, const InstrumentDescriptor& instrument);
+
+// price_instrument() for an instrument that already passed validate_instrument()
+PricingResult price_validated_instrument(Context& ctx, const InstrumentDescriptor& instrument);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_INSTRUMENT_DESCRIPTOR_HPP
@@ -14,10 +14,18 @@ struct LookbackOptionData {
     double time_to_maturity;
     OptionType type;
     bool fixed_strike;  // true = fixed strike, false = floating strike
+    bool continuous_monitoring = false;  // false = extrema over the context's time steps
 };
 
+// Closed form for continuous monitoring under Black-Scholes (the context's
+// model), simulation otherwise
 double price_lookback_option(Context& ctx, const LookbackOptionData& option);
 
+// Simulation regardless of model. Continuous extrema are sampled from the
+// Brownian bridge of each step; discrete monitoring uses them (BGK-shifted)
+// as control variate when control variates are enabled.
+double price_lookback_option_mc(Context& ctx, const LookbackOptionData& option);
+
 }
 
 #endif
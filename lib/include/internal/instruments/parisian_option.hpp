@@ -0,0 +1,29 @@
+#ifndef MCOPTIONS_PARISIAN_OPTION_HPP
+#define MCOPTIONS_PARISIAN_OPTION_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument.hpp"
+#include "internal/instruments/barrier_option.hpp"
+
+namespace mcoptions {
+
+// Knocked only once the spot has stayed beyond the barrier for `window`
+// years in a row
+struct ParisianOptionData {
+    double spot;
+    double strike;
+    double rate;
+    double volatility;
+    double time_to_maturity;
+    OptionType type;
+    double barrier_level;
+    BarrierType barrier_type;
+    double window;
+    double rebate;
+};
+
+double price_parisian_option(Context& ctx, const ParisianOptionData& option);
+
+}
+
+#endif
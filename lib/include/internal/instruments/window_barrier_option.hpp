@@ -0,0 +1,30 @@
+#ifndef MCOPTIONS_WINDOW_BARRIER_OPTION_HPP
+#define MCOPTIONS_WINDOW_BARRIER_OPTION_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument.hpp"
+#include "internal/instruments/barrier_option.hpp"
+
+namespace mcoptions {
+
+// Single barrier that is only monitored (continuously) during
+// [window_start, window_end]
+struct WindowBarrierOptionData {
+    double spot;
+    double strike;
+    double rate;
+    double volatility;
+    double time_to_maturity;
+    OptionType type;
+    double barrier_level;
+    BarrierType barrier_type;
+    double window_start;
+    double window_end;
+    double rebate;
+};
+
+double price_window_barrier_option(Context& ctx, const WindowBarrierOptionData& option);
+
+}
+
+#endif
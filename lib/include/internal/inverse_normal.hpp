@@ -0,0 +1,149 @@
+#ifndef MCOPTIONS_INVERSE_NORMAL_HPP
+#define MCOPTIONS_INVERSE_NORMAL_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace mcoptions {
+
+/**
+ * Inverse of the standard normal CDF (Wichura 1988, algorithm AS241 PPND16)
+ *
+ * Rational approximations of degree 7 in three regions: the centre
+ * |p - 0.5| <= 0.425, and in the tails r = sqrt(-log(min(p, 1 - p))) up to
+ * 5 and beyond (p down to about 1e-300). The relative error is about 1e-16,
+ * against 1e-9 for Acklam's approximation used before.
+ *
+ * An optional Halley step against erfc() brings the result to within an ulp
+ * or two of the correctly rounded value; the error of the CDF itself then
+ * dominates.
+ *
+ * p = 0 and p = 1 map to -inf and +inf, anything outside [0, 1] to NaN.
+ */
+
+namespace detail {
+
+const double kSplitCentre = 0.425;
+const double kSplitTail = 5.0;
+
+inline double inverse_normal_centre(double q) {
+    double r = 0.180625 - q * q;
+    double num = (((((((2.5090809287301226727e+3 * r + 3.3430575583588128105e+4) * r +
+                       6.7265770927008700853e+4) * r + 4.5921953931549871457e+4) * r +
+                     1.3731693765509461125e+4) * r + 1.9715909503065514427e+3) * r +
+                   1.3314166789178437745e+2) * r + 3.3871328727963666080e+0) * q;
+    double den = (((((((5.2264952788528545610e+3 * r + 2.8729085735721942674e+4) * r +
+                       3.9307895800092710610e+4) * r + 2.1213794301586595867e+4) * r +
+                     5.3941960214247511077e+3) * r + 6.8718700749205790830e+2) * r +
+                   4.2313330701600911252e+1) * r + 1.0);
+    return num / den;
+}
+
+// Tails, for 0 < p < 1 with |p - 0.5| > 0.425
+inline double inverse_normal_tail(double p) {
+    double q = p - 0.5;
+    double r = std::sqrt(-std::log(q < 0.0 ? p : 1.0 - p));
+    double x;
+    if (r <= kSplitTail) {
+        r -= 1.6;
+        x = (((((((7.74545014278341407640e-4 * r + 2.27238449892691845833e-2) * r +
+                  2.41780725177450611770e-1) * r + 1.27045825245236838258e+0) * r +
+                3.64784832476320460504e+0) * r + 5.76949722146069140550e+0) * r +
+              4.63033784615654529590e+0) * r + 1.42343711074968357734e+0) /
+            (((((((1.05075007164441684324e-9 * r + 5.47593808499534494600e-4) * r +
+                  1.51986665636164571966e-2) * r + 1.48103976427480074590e-1) * r +
+                6.89767334985100004550e-1) * r + 1.67638483018380384940e+0) * r +
+              2.05319162663775882187e+0) * r + 1.0);
+    } else {
+        r -= 5.0;
+        x = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r +
+                  1.24266094738807843860e-3) * r + 2.65321895265761230930e-2) * r +
+                2.96560571828504891230e-1) * r + 1.78482653991729133580e+0) * r +
+              5.46378491116411436990e+0) * r + 6.65790464350110377720e+0) /
+            (((((((2.04426310338993978564e-15 * r + 1.42151175831644588870e-7) * r +
+                  1.84631831751005468180e-5) * r + 7.86869131145613259100e-4) * r +
+                1.48753612908506148525e-2) * r + 1.36929880922735805310e-1) * r +
+              5.99832206555887937690e-1) * r + 1.0);
+    }
+    return q < 0.0 ? -x : x;
+}
+
+// Anything the centre formula does not cover, edge cases included
+inline double inverse_normal_outer(double p) {
+    if (!(p >= 0.0 && p <= 1.0)) return std::numeric_limits<double>::quiet_NaN();
+    if (p == 0.0) return -std::numeric_limits<double>::infinity();
+    if (p == 1.0) return std::numeric_limits<double>::infinity();
+    return inverse_normal_tail(p);
+}
+
+/**
+ * One Halley step on Phi(x) = p
+ *
+ * The residual is taken on the side of the tail x lies in, where erfc() is
+ * accurate and 1 - p is exact for p >= 0.5.
+ */
+inline double halley_refine(double p, double x) {
+    if (!std::isfinite(x)) return x;
+    const double kSqrtHalf = 0.70710678118654752440;
+    const double kSqrtTwoPi = 2.50662827463100050242;
+    double e = x < 0.0 ? 0.5 * std::erfc(-x * kSqrtHalf) - p
+                       : (1.0 - p) - 0.5 * std::erfc(x * kSqrtHalf);
+    double u = e * kSqrtTwoPi * std::exp(0.5 * x * x);
+    return x - u / (1.0 + 0.5 * x * u);
+}
+
+} // namespace detail
+
+inline double inverse_normal_cdf(double p, bool refine = false) {
+    double q = p - 0.5;
+    double x = std::fabs(q) <= detail::kSplitCentre ? detail::inverse_normal_centre(q)
+                                                    : detail::inverse_normal_outer(p);
+    return refine ? detail::halley_refine(p, x) : x;
+}
+
+/**
+ * Map p[0..n) to normals in x[0..n); x may alias p
+ *
+ * Works in batches like ziggurat_normals(): the centre formula, which takes
+ * 85% of uniform inputs, runs over every lane without branches, and the lanes
+ * outside it are compacted and redone through the logarithmic tail.
+ */
+inline void inverse_normal_cdfs(const double* p, double* x, size_t n, bool refine = false) {
+    const size_t kBatch = 256;
+    double input[kBatch];
+    uint8_t outer[kBatch];
+    uint16_t outer_lanes[kBatch];
+
+    for (size_t first = 0; first < n; first += kBatch) {
+        size_t lanes = n - first < kBatch ? n - first : kBatch;
+        const double* in = p + first;
+        double* out = x + first;
+        for (size_t j = 0; j < lanes; ++j) input[j] = in[j];
+
+        for (size_t j = 0; j < lanes; ++j) {
+            double q = input[j] - 0.5;
+            out[j] = detail::inverse_normal_centre(q);
+            outer[j] = !(std::fabs(q) <= detail::kSplitCentre);
+        }
+
+        size_t count = 0;
+        for (size_t j = 0; j < lanes; ++j) {
+            outer_lanes[count] = static_cast<uint16_t>(j);
+            count += outer[j];
+        }
+        for (size_t i = 0; i < count; ++i) {
+            size_t j = outer_lanes[i];
+            out[j] = detail::inverse_normal_outer(input[j]);
+        }
+
+        if (refine) {
+            for (size_t j = 0; j < lanes; ++j) out[j] = detail::halley_refine(input[j], out[j]);
+        }
+    }
+}
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_INVERSE_NORMAL_HPP
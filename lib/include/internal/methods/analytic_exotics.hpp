@@ -0,0 +1,106 @@
+#ifndef MCOPTIONS_ANALYTIC_EXOTICS_HPP
+#define MCOPTIONS_ANALYTIC_EXOTICS_HPP
+
+#include "internal/instruments/instrument.hpp"
+#include "internal/instruments/barrier_option.hpp"
+#include <cstddef>
+
+namespace mcoptions {
+namespace analytic {
+
+/**
+ * Closed-form barrier and lookback prices under flat GBM (no dividends)
+ *
+ * Continuously monitored prices follow Reiner-Rubinstein (barriers) and
+ * Goldman-Sosin-Gatto / Conze-Viswanathan (floating / fixed strike
+ * lookbacks, for a contract starting today so the running extremum is the
+ * spot). Rebates are paid at maturity, matching the Monte Carlo pricer.
+ *
+ * For discrete monitoring at m equally spaced dates the Broadie-Glasserman-Kou
+ * correction is applied: the barrier is shifted away from the spot by
+ * exp(beta * sigma * sqrt(T / m)) with beta = -zeta(1/2)/sqrt(2*pi) ~ 0.5826,
+ * and lookback extrema are shifted towards it by the same factor.
+ * `monitoring_steps` = 0 means continuous monitoring.
+ */
+
+const double kBgkBeta = 0.5825971579390106;
+
+/**
+ * Log-shift beta * sigma * sqrt(T / m); 0 for continuous monitoring
+ */
+double bgk_shift(double volatility, double time_to_maturity, size_t monitoring_steps);
+
+/**
+ * Barrier option price
+ *
+ * If the spot is already at or beyond the barrier, knock-ins are worth the
+ * vanilla and knock-outs the discounted rebate.
+ */
+double barrier_price(
+    double spot,
+    double strike,
+    double rate,
+    double volatility,
+    double time_to_maturity,
+    double barrier_level,
+    BarrierType barrier_type,
+    double rebate,
+    OptionType type,
+    size_t monitoring_steps = 0
+);
+
+/**
+ * Lookback option price
+ *
+ * Fixed strike pays (max - K)+ / (K - min)+, floating strike pays
+ * S_T - min / max - S_T.
+ */
+double lookback_price(
+    double spot,
+    double strike,
+    double rate,
+    double volatility,
+    double time_to_maturity,
+    bool fixed_strike,
+    OptionType type,
+    size_t monitoring_steps = 0
+);
+
+/**
+ * Batch versions over structure-of-arrays inputs
+ *
+ * One pass per array, no allocation; intended for pricing whole barrier or
+ * lookback books at once.
+ */
+void barrier_price_batch(
+    size_t n,
+    const OptionType* types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times,
+    const double* barrier_levels,
+    const BarrierType* barrier_types,
+    const double* rebates,
+    size_t monitoring_steps,
+    double* prices
+);
+
+void lookback_price_batch(
+    size_t n,
+    const OptionType* types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times,
+    const bool* fixed_strikes,
+    size_t monitoring_steps,
+    double* prices
+);
+
+} // namespace analytic
+} // namespace mcoptions
+
+#endif // MCOPTIONS_ANALYTIC_EXOTICS_HPP
@@ -0,0 +1,58 @@
+#ifndef MCOPTIONS_BROWNIAN_BRIDGE_HPP
+#define MCOPTIONS_BROWNIAN_BRIDGE_HPP
+
+#include <cstddef>
+
+namespace mcoptions {
+
+/**
+ * Brownian-bridge barrier crossing probabilities
+ *
+ * Given the log-price at both ends of a time step, the path in between is a
+ * Brownian bridge. The probability that it touched a barrier can be computed
+ * in closed form, which turns a discretely monitored simulation into a
+ * continuously monitored one without refining the time grid.
+ *
+ * All arguments are in log space; `variance` is sigma^2 * dt of the step.
+ */
+
+/**
+ * Probability that the bridge from x0 to x1 crosses a single barrier
+ *
+ * @param upper true for a barrier above the path, false for one below
+ * @return 1 if either endpoint is already beyond the barrier
+ */
+double barrier_crossing_probability(
+    double x0,
+    double x1,
+    double barrier,
+    bool upper,
+    double variance
+);
+
+/**
+ * Probability that the bridge from x0 to x1 stays strictly inside (lower, upper)
+ *
+ * Method-of-images series
+ *
+ *   sum_k exp(-2kw(kw + x1 - x0) / v) - exp(-2(a + kw)(b + kw) / v)
+ *
+ * with w = upper - lower, a = x0 - lower, b = x1 - lower, v = variance.
+ * Terms decay like exp(-2 k^2 w^2 / v), so a handful suffice unless the step
+ * variance is large compared to the corridor; the series is truncated once
+ * both tails drop below 1e-14 or after `max_terms` images on each side.
+ *
+ * @return Survival probability in [0, 1]
+ */
+double double_barrier_survival_probability(
+    double x0,
+    double x1,
+    double lower,
+    double upper,
+    double variance,
+    size_t max_terms = 16
+);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_BROWNIAN_BRIDGE_HPP
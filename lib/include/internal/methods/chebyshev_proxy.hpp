@@ -0,0 +1,105 @@
+#ifndef MCOPTIONS_CHEBYSHEV_PROXY_HPP
+#define MCOPTIONS_CHEBYSHEV_PROXY_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument_descriptor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Chebyshev proxy of a pricer over (spot, volatility, time to maturity)
+ *
+ * The instrument is priced once at every node of a tensor grid of
+ * Chebyshev-Lobatto points, the nodes running as tasks of the engine. The
+ * values are turned into the coefficients of a tensor Chebyshev series,
+ * which is then evaluated with its first and second derivatives at any
+ * point of the domain, in well under a microsecond for small grids. For a
+ * price that is analytic in the domain the error falls geometrically with
+ * the number of nodes.
+ *
+ * Every node is priced on the same seed. For Monte Carlo pricers this is a
+ * common-random-numbers surface: the noise is mostly shared between nodes,
+ * so it shifts the surface instead of roughening it, and the Greeks stay
+ * smooth.
+ *
+ * The error estimate adds two terms. The first is the size of the two
+ * highest-order coefficients along each axis, an estimate of the truncation
+ * error. The second is the largest error estimate among the node prices; it
+ * is NaN when any node has no estimate, as for Monte Carlo kinds other than
+ * European and autocallable.
+ */
+
+struct ProxyAxis {
+    double lower;
+    double upper;
+    size_t nodes;                // 0: not interpolated, the instrument's own value is used
+};
+
+enum ProxyAxisIndex {
+    kProxySpot = 0,
+    kProxyVolatility = 1,
+    kProxyTime = 2,
+    kProxyAxes = 3
+};
+
+struct ProxyValue {
+    double price;
+    double delta;                // NaN when the axis is not interpolated
+    double gamma;
+    double vega;                 // Per unit of volatility
+    double theta;                // -dPrice / dTime to maturity
+    double error_estimate;
+};
+
+class ChebyshevProxy {
+public:
+    static constexpr size_t kMaxNodes = 64;
+
+    /**
+     * Price `instrument` on the grid; its spot, volatility and time to
+     * maturity are replaced by the node coordinates (other dates in the
+     * contract are not shifted).
+     *
+     * Throws std::invalid_argument for a malformed domain, for a time axis
+     * on a kind with a date schedule (Bermudan, autocallable, cliquet,
+     * window barrier) and whatever price_instrument() throws for a node.
+     */
+    static ChebyshevProxy build(Context& ctx, const InstrumentDescriptor& instrument,
+                                const ProxyAxis (&axes)[kProxyAxes]);
+
+    /**
+     * Arguments on axes that are not interpolated are ignored. Throws
+     * std::invalid_argument outside the domain.
+     */
+    ProxyValue evaluate(double spot, double volatility, double time_to_maturity) const;
+
+    /**
+     * Flat binary image: a versioned header, the domain and the
+     * coefficients, in native byte order. deserialize() rejects images that
+     * are truncated, from another version or written with another byte order
+     * (std::invalid_argument).
+     */
+    std::vector<unsigned char> serialize() const;
+    static ChebyshevProxy deserialize(const unsigned char* data, size_t size);
+
+    const ProxyAxis& axis(size_t index) const { return axes_[index]; }
+    double error_estimate() const { return error_estimate_; }
+
+private:
+    ChebyshevProxy() = default;
+
+    static void validate(const ProxyAxis& axis, size_t index);
+    size_t extent(size_t index) const { return axes_[index].nodes ? axes_[index].nodes : 1; }
+
+    ProxyAxis axes_[kProxyAxes];
+    double fixed_[kProxyAxes];                 // Coordinates used on axes without nodes
+    double error_estimate_;
+    std::vector<double> coefficients_;         // Row-major, spot outermost
+};
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_CHEBYSHEV_PROXY_HPP
@@ -0,0 +1,190 @@
+#ifndef MCOPTIONS_EXTREMUM_KERNEL_HPP
+#define MCOPTIONS_EXTREMUM_KERNEL_HPP
+
+#include "internal/context.hpp"
+#include "internal/engine/parallel.hpp"
+#include "internal/methods/simulation_workspace.hpp"
+#include "internal/random.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Fused running-extremum kernel for GBM on a uniform grid
+ *
+ * Evolves a block of paths in structure-of-arrays lanes and folds each new
+ * log-price into a running extremum in the same pass, so no path is ever
+ * stored. The state update and the extremum fold are straight loops over
+ * contiguous lanes that the compiler can vectorise; the normals (and bridge
+ * uniforms) are drawn into a lane buffer first.
+ *
+ * Minima are tracked as maxima of the mirrored path y = -x, which keeps the
+ * inner loop branch-free.
+ *
+ * With `sample_bridge`, the maximum of the Brownian bridge between grid
+ * points is also sampled: given the endpoints y0, y1 and step variance v,
+ *
+ *   max = (y0 + y1 + sqrt((y1 - y0)^2 - 2 v log U)) / 2,   U ~ U(0, 1]
+ *
+ * so the bridge extremum is exact for continuous monitoring at any step count.
+ *
+ * Antithetic pairs occupy the two halves of a block and share normals.
+ * Blocks are independent units of the parallel engine, each with its own
+ * generator and lane buffers (kept by the workspace of a prepared plan).
+ *
+ * On the sequential stream the kernel instead runs path by path, as the
+ * serial lookback loop did: each path draws all its normals (then its bridge
+ * uniforms), its antithetic partner follows it with uniforms of its own, and
+ * prices are stepped by S *= exp(...) as in simulate_gbm_path. Seeded prices
+ * then match that loop bit for bit.
+ */
+
+const size_t kExtremumLanes = 256;
+
+/**
+ * Simulate all paths of the context and report each finished one
+ *
+ * record(Sink& sink, double terminal, double grid_extreme, double bridge_extreme)
+ * calls sink.add(y) or sink.add(y, x) (see simulate_blocks). Paths are
+ * reported in order, antithetic partners next to each other, on the
+ * sequential stream only.
+ *
+ * Extremes are spot levels and include the starting point. `bridge_extreme`
+ * equals the grid extreme when the bridge is not sampled.
+ */
+template <typename Record>
+SampleMoments run_extremum_kernel(
+    Context& ctx,
+    double spot,
+    double rate,
+    double volatility,
+    double time_to_maturity,
+    size_t num_steps,
+    bool track_max,
+    bool sample_bridge,
+    Record&& record
+) {
+    const double dt = time_to_maturity / static_cast<double>(num_steps);
+    const double sign = track_max ? 1.0 : -1.0;
+    const double spot_drift = (rate - 0.5 * volatility * volatility) * dt;
+    const double drift = sign * spot_drift;
+    const double diffusion = volatility * std::sqrt(dt);
+    const double two_variance = 2.0 * volatility * volatility * dt;
+    const double y_start = sign * std::log(spot);
+
+    const bool antithetic = ctx.get_antithetic();
+    const bool path_major = ctx.get_stream_mode() == Context::StreamMode::Sequential;
+    const size_t num_paths = antithetic ? 2 * (ctx.get_num_simulations() / 2)
+                                        : ctx.get_num_simulations();
+    // Per step: two uniforms per drawn Box-Muller normal and one per lane for
+    // the bridge; the ziggurat's count varies
+    const NormalMethod normal_method = ctx.get_normal_method();
+    const size_t drawn_per_block = antithetic ? kExtremumLanes / 2 : kExtremumLanes;
+    const uint64_t draws_per_block = normal_method == NormalMethod::BoxMuller
+        ? num_steps * (2 * drawn_per_block + (sample_bridge ? kExtremumLanes : 0))
+        : 0;
+
+    const size_t num_blocks = count_blocks(num_paths, kExtremumLanes);
+    SimulationWorkspace* workspace = ctx.get_workspace().get();
+    if (workspace) workspace->reserve_blocks(num_blocks);
+
+    return simulate_blocks(ctx, num_blocks, draws_per_block,
+        [&](size_t block, auto& rng, auto& acc) {
+            std::uniform_real_distribution<double> uniform(0.0, 1.0);
+            const size_t lanes = std::min(kExtremumLanes, num_paths - block * kExtremumLanes);
+            const size_t drawn = antithetic ? lanes / 2 : lanes;
+            std::vector<double> local;
+
+            if (path_major) {
+                // One path's normals and bridge uniforms
+                double* z = block_scratch(workspace, block, 2 * num_steps, local);
+                double* path_log_u = z + num_steps;
+                auto run_path = [&](double flip) {
+                    double s = spot;
+                    double extreme = spot;
+                    double bridge = y_start;
+                    for (size_t step = 0; step < num_steps; ++step) {
+                        double s1 = s * std::exp(spot_drift + diffusion * (flip * z[step]));
+                        extreme = track_max ? std::max(extreme, s1) : std::min(extreme, s1);
+                        if (sample_bridge) {
+                            double y0 = sign * std::log(s);
+                            double y1 = sign * std::log(s1);
+                            double dy = y1 - y0;
+                            double peak = 0.5 * (y0 + y1 + std::sqrt(dy * dy - two_variance * path_log_u[step]));
+                            bridge = std::max(bridge, peak);
+                        }
+                        s = s1;
+                    }
+                    record(acc, s, extreme, sample_bridge ? std::exp(sign * bridge) : extreme);
+                };
+
+                // Each path, partners too, samples its own bridge
+                auto draw_bridge = [&] {
+                    if (!sample_bridge) return;
+                    for (size_t step = 0; step < num_steps; ++step) {
+                        path_log_u[step] = std::log(1.0 - uniform(rng));
+                    }
+                };
+                for (size_t path = 0; path < drawn; ++path) {
+                    fill_normals(rng, normal_method, z, num_steps);
+                    draw_bridge();
+                    run_path(1.0);
+                    if (antithetic) {
+                        draw_bridge();
+                        run_path(-1.0);
+                    }
+                }
+                return;
+            }
+
+            // Five lane arrays in one buffer, the workspace's in a plan
+            double* y = block_scratch(workspace, block, 5 * lanes, local);
+            double* grid_max = y + lanes;
+            double* bridge_max = grid_max + lanes;
+            double* w = bridge_max + lanes;
+            double* log_u = w + lanes;
+            std::fill(y, w, y_start);
+
+            for (size_t step = 0; step < num_steps; ++step) {
+                fill_normals(rng, normal_method, w, drawn);
+                if (antithetic) {
+                    for (size_t j = 0; j < drawn; ++j) {
+                        w[drawn + j] = -w[j];
+                    }
+                }
+
+                if (sample_bridge) {
+                    for (size_t j = 0; j < lanes; ++j) {
+                        log_u[j] = std::log(1.0 - uniform(rng));
+                    }
+                    for (size_t j = 0; j < lanes; ++j) {
+                        double y0 = y[j];
+                        double y1 = y0 + drift + diffusion * w[j];
+                        double dy = y1 - y0;
+                        double peak = 0.5 * (y0 + y1 + std::sqrt(dy * dy - two_variance * log_u[j]));
+                        bridge_max[j] = std::max(bridge_max[j], peak);
+                        grid_max[j] = std::max(grid_max[j], y1);
+                        y[j] = y1;
+                    }
+                } else {
+                    for (size_t j = 0; j < lanes; ++j) {
+                        double y1 = y[j] + drift + diffusion * w[j];
+                        grid_max[j] = std::max(grid_max[j], y1);
+                        y[j] = y1;
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < lanes; ++j) {
+                double grid_extreme = std::exp(sign * grid_max[j]);
+                record(acc, std::exp(sign * y[j]), grid_extreme,
+                       sample_bridge ? std::exp(sign * bridge_max[j]) : grid_extreme);
+            }
+        });
+}
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_EXTREMUM_KERNEL_HPP
@@ -0,0 +1,65 @@
+#ifndef MCOPTIONS_LIKELIHOOD_RATIO_HPP
+#define MCOPTIONS_LIKELIHOOD_RATIO_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Likelihood-ratio reweighting of cached GBM paths
+ *
+ * A path simulated on the grid t_0 < ... < t_n = T under rate r and
+ * volatility sigma has log increments X_k ~ N(m dt_k, sigma^2 dt_k) with
+ * m = r - sigma^2 / 2. Its log density depends on the path only through
+ *
+ *   S = sum X_k           (the total log return)
+ *   Q = sum X_k^2 / dt_k
+ *
+ * as  -(Q - 2 m S + m^2 T) / (2 sigma^2) - n log(sigma) + const.
+ *
+ * Keeping S, Q and the undiscounted payoff of every path is therefore
+ * enough to price the same payoffs under a nearby (r', sigma') with the
+ * same spot: weight each path by the ratio of its new to its old density
+ * and take the self-normalised weighted mean, discounted at r'. This is
+ * exact in expectation only for payoffs that are functions of the simulated
+ * path alone (see PathState::pathwise in path_kernel.hpp).
+ *
+ * The weights degenerate as the parameters move away, faster for volatility
+ * than for rate and faster on finer grids. The effective sample size
+ *
+ *   ESS = (sum w)^2 / sum w^2
+ *
+ * measures how many equally weighted paths the weighted set is worth;
+ * callers resimulate once it drops below a fraction of the path count.
+ */
+
+// Undiscounted payoff and density statistics of one path
+struct CachedPath {
+    double payoff;
+    double log_return;      // S
+    double scaled_square;   // Q
+};
+
+// Paths of one simulation, filled by price_streaming when a context carries it
+struct PathCache {
+    std::vector<CachedPath> paths;
+    double rate = 0.0;
+    double volatility = 0.0;
+    double maturity = 0.0;
+    size_t num_steps = 0;
+    bool filled = false;
+};
+
+struct ReweightedPrice {
+    double price;
+    double error_estimate;          // Standard error of the weighted mean
+    double effective_sample_size;
+};
+
+// Prices the cached payoffs under (rate, volatility); one pass over the cache
+ReweightedPrice reweight_paths(const PathCache& cache, double rate, double volatility);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_LIKELIHOOD_RATIO_HPP
@@ -0,0 +1,130 @@
+#ifndef MCOPTIONS_METHOD_SELECTOR_HPP
+#define MCOPTIONS_METHOD_SELECTOR_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument.hpp"
+#include <cstddef>
+
+namespace mcoptions {
+
+/**
+ * Automatic pricing method selection
+ *
+ * Given an instrument, the active model and an accuracy tolerance, pick the
+ * cheapest method that is expected to meet the tolerance, together with its
+ * discretisation parameters (tree depth, number of paths).
+ *
+ * Methods are considered in order of preference:
+ *   analytic > binomial tree > Monte Carlo / LSM
+ *
+ * A closed form is exact and is taken whenever it applies. Otherwise each
+ * candidate gets a predicted error and a predicted cost from a simple
+ * cost/accuracy model whose constants were measured with
+ * tests/benchmark_methods.cpp. The winner is the cheapest candidate whose
+ * predicted error is within tolerance; if none qualifies, the most accurate
+ * candidate (at its parameter caps) is used instead.
+ */
+
+enum class PricingMethod {
+    Auto = 0,
+    Analytic = 1,
+    BinomialTree = 2,
+    MonteCarlo = 3,
+    LeastSquaresMC = 4
+};
+
+enum class ExerciseStyle {
+    European,
+    American
+};
+
+/**
+ * Per-unit costs and error coefficients used to rank methods
+ */
+struct CostModel {
+    double analytic_ns;          // One Black-Scholes evaluation
+    double tree_node_ns;         // One node visit during backward induction
+    double tree_error_coeff;     // |error| ~ coeff * S * sigma * sqrt(T) / N
+    double mc_step_ns;           // One path step (RNG + GBM update)
+    double lsm_step_ns;          // One path step including regression share
+    double lsm_bias;             // Relative bias of LSM (exercise grid + basis)
+
+    size_t max_tree_steps;
+    size_t min_paths;
+    size_t max_paths;
+    size_t lsm_exercise_dates;
+};
+
+/**
+ * Calibrated defaults (see tests/benchmark_methods.cpp)
+ */
+const CostModel& default_cost_model();
+
+struct MethodChoice {
+    PricingMethod method;
+    size_t num_paths;            // 0 for deterministic methods
+    size_t num_steps;            // Tree depth, time steps or exercise dates
+    double predicted_error;      // Absolute price error (1 std error for MC)
+    double predicted_cost_ns;
+};
+
+struct PricingResult {
+    double price;
+    double error_estimate;
+    PricingMethod method;
+    size_t num_paths;
+    size_t num_steps;
+};
+
+/**
+ * Standard deviation of the discounted vanilla payoff under GBM
+ *
+ * Closed form via the second moment E[(S_T - K)+^2], used to size the
+ * number of Monte Carlo paths for a target standard error.
+ */
+double vanilla_payoff_stddev(const OptionData& option);
+
+/**
+ * Rank all capable methods and return the chosen one
+ *
+ * @param ctx Context (model and variance reduction settings)
+ * @param option Vanilla option data
+ * @param style European or American exercise
+ * @param tolerance Target absolute price error (must be positive)
+ * @param model Cost/accuracy model to use
+ * @return Chosen method and parameters
+ */
+MethodChoice select_method(
+    const Context& ctx,
+    const OptionData& option,
+    ExerciseStyle style,
+    double tolerance,
+    const CostModel& model = default_cost_model()
+);
+
+/**
+ * Price with an explicit choice (as produced by select_method)
+ *
+ * Temporarily overrides the context's path/step settings and restores them
+ * afterwards, so the caller's configuration is left unchanged.
+ */
+PricingResult price_with_method(
+    Context& ctx,
+    const OptionData& option,
+    ExerciseStyle style,
+    const MethodChoice& choice
+);
+
+/**
+ * Select the cheapest method meeting the tolerance and price with it
+ */
+PricingResult price_auto(
+    Context& ctx,
+    const OptionData& option,
+    ExerciseStyle style,
+    double tolerance
+);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_METHOD_SELECTOR_HPP
@@ -17,6 +17,16 @@ std::vector<double> simulate_gbm_path(
     const std::vector<double>& random_normals
 );
 
+// Same on an arbitrary grid starting at 0 (one normal per step)
+std::vector<double> simulate_gbm_path(
+    const Context& ctx,
+    double spot,
+    double rate,
+    double volatility,
+    const std::vector<double>& times,
+    const std::vector<double>& random_normals
+);
+
 double discount_factor(double rate, double time);
 
 }
@@ -0,0 +1,269 @@
+#ifndef MCOPTIONS_PATH_KERNEL_HPP
+#define MCOPTIONS_PATH_KERNEL_HPP
+
+#include "internal/context.hpp"
+#include "internal/engine/parallel.hpp"
+#include "internal/random.hpp"
+#include "internal/methods/likelihood_ratio.hpp"
+#include "internal/methods/monte_carlo.hpp"
+#include "internal/methods/simulation_workspace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Streaming GBM path kernel
+ *
+ * Simulates log-price paths step by step on an arbitrary time grid without
+ * materialising them. Path-dependent state (barrier survival, excursion
+ * counters, running extrema, ...) lives in a small per-path object that is
+ * fed every step, so memory use does not grow with the number of steps.
+ *
+ * A PathState must provide:
+ *
+ *   void begin(double x0);                     // start of a path, x = log(S)
+ *   void step(double t0, double t1,            // one step of the grid
+ *             double x0, double x1,
+ *             double variance);                // sigma^2 * (t1 - t0)
+ *   double payoff(double spot) const;          // undiscounted, at maturity
+ *
+ * and may declare `static constexpr bool pathwise = true` when the payoff is
+ * a function of the simulated grid values alone (it ignores `variance` and
+ * nothing in it was derived from the volatility). Only such states record
+ * into a context's path cache for likelihood-ratio reweighting.
+ *
+ * The prototype passed in is copied for every path. A path's normals are
+ * drawn in one batch (Context::get_normal_method) into a buffer reused
+ * across the block, and antithetic pairs are simulated side by side from
+ * it. Paths are run in blocks on the parallel engine (see
+ * engine/parallel.hpp). With a workspace on the context the step tables and
+ * block buffers are the workspace's (see simulation_workspace.hpp).
+ */
+
+/**
+ * Uniform time grid 0 = t_0 < ... < t_n = T
+ */
+inline std::vector<double> uniform_time_grid(double time_to_maturity, size_t num_steps) {
+    std::vector<double> times(num_steps + 1);
+    for (size_t i = 0; i <= num_steps; ++i) {
+        times[i] = time_to_maturity * static_cast<double>(i) / static_cast<double>(num_steps);
+    }
+    times[num_steps] = time_to_maturity;
+    return times;
+}
+
+template <typename PathState, typename = void>
+struct is_pathwise : std::false_type {};
+
+template <typename PathState>
+struct is_pathwise<PathState, std::void_t<decltype(PathState::pathwise)>>
+    : std::bool_constant<PathState::pathwise> {};
+
+namespace detail {
+
+// Core loop: simulates every path, block by block on the engine, and reports
+// each finished state (and its terminal spot) with record(sink, state, spot, path),
+// which calls sink.add(y) or sink.add(y, x). `path` numbers the paths from 0,
+// antithetic partners next to each other.
+template <typename PathState, typename Record>
+SampleMoments run_streaming(
+    Context& ctx,
+    double spot,
+    double rate,
+    double volatility,
+    const std::vector<double>& times,
+    const PathState& prototype,
+    Record&& record
+) {
+    size_t num_steps = times.size() - 1;
+    SimulationWorkspace* workspace = ctx.get_workspace().get();
+    StepTables local_tables;
+    if (!workspace) compute_step_tables(times, rate, volatility, local_tables);
+    const StepTables& tables = workspace ? workspace->step_tables(times, rate, volatility)
+                                         : local_tables;
+    const double* drift = tables.drift.data();
+    const double* diffusion = tables.diffusion.data();
+    const double* variance = tables.variance.data();
+
+    bool antithetic = ctx.get_antithetic();
+    size_t effective_paths = antithetic ? ctx.get_num_simulations() / 2 : ctx.get_num_simulations();
+    double x_start = std::log(spot);
+    NormalMethod normal_method = ctx.get_normal_method();
+    // Two uniforms per Box-Muller normal; the ziggurat's count varies
+    uint64_t draws_per_block =
+        normal_method == NormalMethod::BoxMuller ? kPathsPerBlock * 2 * num_steps : 0;
+
+    size_t num_blocks = count_blocks(effective_paths, kPathsPerBlock);
+    if (workspace) workspace->reserve_blocks(num_blocks);
+
+    return simulate_blocks(ctx, num_blocks, draws_per_block,
+        [&](size_t block, auto& rng, auto& acc) {
+            size_t first = block * kPathsPerBlock;
+            size_t last = std::min(first + kPathsPerBlock, effective_paths);
+            std::vector<double> local_normals;
+            double* normals = block_scratch(workspace, block, num_steps, local_normals);
+
+            for (size_t p = first; p < last; ++p) {
+                fill_normals(rng, normal_method, normals, num_steps);
+                PathState state = prototype;
+                PathState anti_state = prototype;
+                state.begin(x_start);
+                if (antithetic) anti_state.begin(x_start);
+
+                double x = x_start;
+                double anti_x = x_start;
+                for (size_t i = 0; i < num_steps; ++i) {
+                    double z = normals[i];
+                    double x_next = x + drift[i] + diffusion[i] * z;
+                    state.step(times[i], times[i + 1], x, x_next, variance[i]);
+                    x = x_next;
+
+                    if (antithetic) {
+                        double anti_next = anti_x + drift[i] - diffusion[i] * z;
+                        anti_state.step(times[i], times[i + 1], anti_x, anti_next, variance[i]);
+                        anti_x = anti_next;
+                    }
+                }
+
+                record(acc, state, std::exp(x), antithetic ? 2 * p : p);
+                if (antithetic) {
+                    record(acc, anti_state, std::exp(anti_x), 2 * p + 1);
+                }
+            }
+        });
+}
+
+// Adds what the likelihood ratio needs to a path-wise state
+template <typename PathState>
+struct RecordingState : PathState {
+    double x_start;
+    double x_end;
+    double scaled_square;   // sum of dx^2 / dt over the steps
+
+    void begin(double x0) {
+        PathState::begin(x0);
+        x_start = x0;
+        x_end = x0;
+        scaled_square = 0.0;
+    }
+
+    void step(double t0, double t1, double x0, double x1, double variance) {
+        PathState::step(t0, t1, x0, x1, variance);
+        double dx = x1 - x0;
+        scaled_square += dx * dx / (t1 - t0);
+        x_end = x1;
+    }
+};
+
+// price_streaming that also fills `cache`; the samples, and so the price,
+// are the same as without it
+template <typename PathState>
+double price_streaming_recorded(
+    Context& ctx,
+    double spot,
+    double rate,
+    double volatility,
+    const std::vector<double>& times,
+    const PathState& prototype,
+    PathCache& cache
+) {
+    size_t pairs = ctx.get_antithetic() ? ctx.get_num_simulations() / 2 : ctx.get_num_simulations();
+    cache.paths.assign(ctx.get_antithetic() ? 2 * pairs : pairs, CachedPath{});
+    cache.filled = false;
+
+    RecordingState<PathState> recording{prototype, 0.0, 0.0, 0.0};
+    SampleMoments moments = run_streaming(
+        ctx, spot, rate, volatility, times, recording,
+        [&cache](auto& acc, const RecordingState<PathState>& state, double spot_t, size_t path) {
+            double y = state.payoff(spot_t);
+            cache.paths[path] = CachedPath{y, state.x_end - state.x_start, state.scaled_square};
+            acc.add(y);
+        });
+
+    cache.rate = rate;
+    cache.volatility = volatility;
+    cache.maturity = times.back();
+    cache.num_steps = times.size() - 1;
+    cache.filled = true;
+    return discount_factor(rate, times.back()) * moments.sum_y / static_cast<double>(moments.count);
+}
+
+} // namespace detail
+
+/**
+ * Run the kernel and return the discounted mean payoff
+ *
+ * With a path cache on the context and a path-wise state, the paths are
+ * recorded as well.
+ *
+ * @param ctx Context (RNG, number of paths, antithetic flag)
+ * @param times Increasing time grid starting at 0; the last point is maturity
+ * @param prototype Initial per-path state
+ */
+template <typename PathState>
+double price_streaming(
+    Context& ctx,
+    double spot,
+    double rate,
+    double volatility,
+    const std::vector<double>& times,
+    const PathState& prototype
+) {
+    if constexpr (is_pathwise<PathState>::value) {
+        if (ctx.get_path_cache()) {
+            return detail::price_streaming_recorded(ctx, spot, rate, volatility, times, prototype,
+                                                    *ctx.get_path_cache());
+        }
+    }
+
+    SampleMoments moments = detail::run_streaming(
+        ctx, spot, rate, volatility, times, prototype,
+        [](auto& acc, const PathState& state, double spot_t, size_t) {
+            acc.add(state.payoff(spot_t));
+        });
+
+    return discount_factor(rate, times.back()) * moments.sum_y / static_cast<double>(moments.count);
+}
+
+/**
+ * Run the kernel with a control variate
+ *
+ * The PathState additionally provides `double control(double spot) const`,
+ * an undiscounted per-path quantity whose discounted expectation
+ * `control_mean` is known in closed form. The regression coefficient is
+ * estimated from the same paths:
+ *
+ *   price = mean(Y) - beta * (mean(X) - control_mean),  beta = cov(Y, X) / var(X)
+ */
+template <typename PathState>
+double price_streaming_with_control(
+    Context& ctx,
+    double spot,
+    double rate,
+    double volatility,
+    const std::vector<double>& times,
+    const PathState& prototype,
+    double control_mean
+) {
+    double df = discount_factor(rate, times.back());
+    SampleMoments moments = detail::run_streaming(
+        ctx, spot, rate, volatility, times, prototype,
+        [df](auto& acc, const PathState& state, double spot_t, size_t) {
+            acc.add(df * state.payoff(spot_t), df * state.control(spot_t));
+        });
+
+    double n = static_cast<double>(moments.count);
+    double mean_y = moments.sum_y / n;
+    double mean_x = moments.sum_x / n;
+    double var_x = moments.sum_xx / n - mean_x * mean_x;
+    double cov_xy = moments.sum_xy / n - mean_x * mean_y;
+    double beta = var_x > 0.0 ? cov_xy / var_x : 0.0;
+    return mean_y - beta * (mean_x - control_mean);
+}
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_PATH_KERNEL_HPP
@@ -0,0 +1,126 @@
+#ifndef MCOPTIONS_PRICING_PLAN_HPP
+#define MCOPTIONS_PRICING_PLAN_HPP
+
+#include "internal/context.hpp"
+#include "internal/instruments/instrument_descriptor.hpp"
+#include "internal/methods/likelihood_ratio.hpp"
+#include "internal/methods/method_selector.hpp"
+#include <cstdint>
+#include <memory>
+
+namespace mcoptions {
+
+/**
+ * Prepared pricing plan: one contract, priced repeatedly under new market data
+ *
+ * Preparing does everything that does not depend on the market once:
+ * - The instrument is validated and copied, exercise dates included.
+ * - The context settings are snapshotted.
+ * - Automatic method selection for vanilla options runs, sized for the
+ *   market in the prepared instrument.
+ * - The worker pool for the plan's thread settings is pinned.
+ * - A random stream is fixed.
+ * - A workspace goes on the private context (simulation_workspace.hpp): the
+ *   first execution builds the kernel's time grid and sizes its block
+ *   buffers, later ones reuse them and recompute the step tables only when
+ *   the rate or volatility moves.
+ *
+ * Each execution patches spot, rate and volatility into the copy, checks
+ * only those, reseeds the private context to the fixed stream and prices.
+ * Executions with the same market therefore repeat exactly, and differences
+ * between executions come from the market alone (common random numbers).
+ * Plans pinning different thread settings do not rebuild the shared pool
+ * between their executions.
+ *
+ * With reweighting on, a full Monte Carlo simulation of a path-wise product
+ * (Asian, forward start, cliquet without control variate, Parisian) keeps
+ * its paths. Later executions at the same spot reprice them by likelihood
+ * ratio under the new rate and volatility (see likelihood_ratio.hpp), one
+ * pass over the cache, and simulate afresh only when the spot moves or the
+ * effective sample size falls below the given fraction of the paths. Other
+ * products and methods always simulate.
+ *
+ * A plan executes one call at a time; separate plans are independent.
+ */
+
+struct MarketInputs {
+    double spot;
+    double rate;
+    double volatility;
+};
+
+struct PlanStats {
+    bool reweighted;                // The last execution reused cached paths
+    double effective_sample_size;   // Of the last execution; 0 when nothing is cached
+    uint64_t simulations;           // Executions that priced from scratch
+};
+
+class PricingPlan {
+public:
+    // Throws std::invalid_argument for a malformed instrument
+    PricingPlan(Context& ctx, const InstrumentDescriptor& instrument);
+
+    // The private context and its workspace belong to one plan
+    PricingPlan(const PricingPlan&) = delete;
+    PricingPlan& operator=(const PricingPlan&) = delete;
+
+    // Throws as price_instrument() does
+    PricingResult execute(const MarketInputs& market);
+
+    // 0 turns reweighting off (the default); throws std::invalid_argument
+    // outside [0, 1]
+    void set_reweighting(double min_effective_fraction);
+    const PlanStats& stats() const { return stats_; }
+
+    // The reweighting cache, so that scenario executions can put it back
+    struct CacheState {
+        std::shared_ptr<PathCache> cache;
+        double spot;
+        PricingResult result;
+    };
+    CacheState save_cache() const { return CacheState{cache_, cached_spot_, cached_result_}; }
+    void restore_cache(CacheState state);
+
+private:
+    PricingResult simulate();
+
+
+    Context context_;
+    InstrumentDescriptor instrument_;
+    uint64_t seed_;
+    bool selected_;              // Vanilla with Auto: choice_ is fixed
+    ExerciseStyle style_;
+    MethodChoice choice_;
+
+    double min_effective_fraction_;
+    std::shared_ptr<PathCache> cache_;  // Null unless the last simulation was recorded
+    double cached_spot_;
+    PricingResult cached_result_;
+    PlanStats stats_;
+};
+
+/**
+ * Bump-and-reprice sensitivities by central differences on a plan
+ *
+ * Every scenario executes the plan, so it runs the base's method on the
+ * base's random stream, and Monte Carlo Greeks difference correlated prices:
+ * - delta, gamma: spot +/- 1%
+ * - vega: volatility +/- 0.01, at most half the volatility; below a
+ *   volatility of 2e-4 a one-sided +0.01 bump instead
+ * - rho: rate +/- 1bp
+ *
+ * The plan's reweighting cache is the same afterwards as before.
+ */
+struct Greeks {
+    double delta;
+    double gamma;
+    double vega;
+    double rho;
+};
+
+// `price` is the plan's price at `market`; throws as execute() does
+Greeks plan_greeks(PricingPlan& plan, const MarketInputs& market, double price);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_PRICING_PLAN_HPP
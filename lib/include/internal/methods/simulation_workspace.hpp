@@ -0,0 +1,121 @@
+#ifndef MCOPTIONS_SIMULATION_WORKSPACE_HPP
+#define MCOPTIONS_SIMULATION_WORKSPACE_HPP
+
+#include "internal/context.hpp"
+#include "internal/methods/time_grid.hpp"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Set-up a prepared plan keeps across executions of its Monte Carlo kernel
+ *
+ * A plan's contract and settings are fixed, so most of what a kernel builds
+ * before simulating comes out the same on every call. With a workspace on
+ * the context (Context::set_workspace) the kernels keep it here instead:
+ * - the time grid of the contract, with a per-point event mask;
+ * - the per-step drift, diffusion and variance of the GBM, recomputed in
+ *   place when the rate or volatility moves;
+ * - one scratch buffer per block of paths, reused by the block of the same
+ *   index in the next job.
+ *
+ * Once the first execution has sized everything, a kernel allocates nothing
+ * of its own. A workspace serves one job at a time, like its plan; the
+ * blocks of a job use distinct buffers and may run concurrently.
+ */
+
+struct GridKey {
+    const char* kernel;        // Name of the kernel that built the grid
+    double maturity;
+    size_t size;               // Steps or dates the grid was built from
+
+    bool operator==(const GridKey& other) const {
+        return std::strcmp(kernel, other.kernel) == 0 && maturity == other.maturity &&
+               size == other.size;
+    }
+};
+
+struct KernelGrid {
+    TimeGrid grid;
+    std::vector<char> marks;   // Per grid point, for kernels that flag event steps
+};
+
+struct StepTables {
+    std::vector<double> drift;        // (r - sigma^2 / 2) dt
+    std::vector<double> diffusion;    // sigma sqrt(dt)
+    std::vector<double> variance;     // sigma^2 dt
+};
+
+// Fills `tables` for the steps of `times`, reusing its storage
+void compute_step_tables(const std::vector<double>& times, double rate, double volatility,
+                         StepTables& tables);
+
+class SimulationWorkspace {
+public:
+    /**
+     * The grid build(KernelGrid&) fills in for `key`, built again only when
+     * the key changes. The key does not cover the contract's own dates: a
+     * workspace belongs to one contract.
+     */
+    template <typename Build>
+    const KernelGrid& grid(const GridKey& key, Build&& build) {
+        if (!has_grid_ || !(key == grid_key_)) {
+            grid_.grid.times.clear();
+            grid_.grid.event_steps.clear();
+            grid_.marks.clear();
+            build(grid_);
+            grid_key_ = key;
+            has_grid_ = true;
+        }
+        return grid_;
+    }
+
+    // Tables for `times` under (rate, volatility), kept until either changes
+    const StepTables& step_tables(const std::vector<double>& times, double rate, double volatility);
+
+    // Makes room for the buffers of `num_blocks` blocks; call before the job runs
+    void reserve_blocks(size_t num_blocks);
+
+    // At least `size` doubles for `block`, left as the last job wrote them
+    double* block_buffer(size_t block, size_t size);
+
+private:
+    bool has_grid_ = false;
+    GridKey grid_key_ = {"", 0.0, 0};
+    KernelGrid grid_;
+
+    std::vector<double> table_times_;
+    double table_rate_ = 0.0;
+    double table_volatility_ = 0.0;
+    StepTables tables_;
+
+    std::vector<std::vector<double>> blocks_;
+};
+
+/**
+ * Helpers for kernels that run with or without a workspace
+ */
+
+// The workspace's grid for `key`, or `local` filled by build()
+template <typename Build>
+const KernelGrid& kernel_grid(const Context& ctx, const GridKey& key, KernelGrid& local, Build&& build) {
+    if (SimulationWorkspace* workspace = ctx.get_workspace().get()) {
+        return workspace->grid(key, build);
+    }
+    build(local);
+    return local;
+}
+
+// `size` doubles of block scratch: the workspace's buffer for `block`, or `local`
+inline double* block_scratch(SimulationWorkspace* workspace, size_t block, size_t size,
+                             std::vector<double>& local) {
+    if (workspace) return workspace->block_buffer(block, size);
+    local.resize(size);
+    return local.data();
+}
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_SIMULATION_WORKSPACE_HPP
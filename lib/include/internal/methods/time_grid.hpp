@@ -0,0 +1,41 @@
+#ifndef MCOPTIONS_TIME_GRID_HPP
+#define MCOPTIONS_TIME_GRID_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace mcoptions {
+
+/**
+ * Simulation time grid built from an instrument's own dates
+ *
+ * Under GBM the transition between any two dates is exact, so a path only
+ * has to be simulated at the dates the payoff looks at (observations,
+ * exercise dates, window edges) and at maturity. The builder merges those
+ * dates into the smallest grid containing them, instead of snapping them onto
+ * a fixed uniform grid.
+ *
+ * Optional refinement splits every interval longer than `max_step` into
+ * equal sub-steps, for payoffs that also depend on the path between dates
+ * (e.g. Parisian excursion clocks).
+ */
+struct TimeGrid {
+    std::vector<double> times;        // 0 = t_0 < ... < t_n = maturity
+    std::vector<size_t> event_steps;  // Grid index of each event date, in input order
+};
+
+/**
+ * @param maturity Last grid point, must be positive
+ * @param event_dates Dates in [0, maturity] in any order; duplicates and dates
+ *                    closer than 1e-12 * maturity share a grid point
+ * @param max_step Maximum step length after refinement; 0 = no refinement
+ */
+TimeGrid build_time_grid(
+    double maturity,
+    const std::vector<double>& event_dates,
+    double max_step = 0.0
+);
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_TIME_GRID_HPP
@@ -0,0 +1,31 @@
+#ifndef MCOPTIONS_CORRELATED_GBM_HPP
+#define MCOPTIONS_CORRELATED_GBM_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace mcoptions {
+
+// Multi-asset GBM helpers: correlated normals via the Cholesky factor of the
+// correlation matrix
+
+// Lower-triangular Cholesky factor of a row-major n x n correlation matrix.
+// An empty matrix means independent assets (identity factor).
+// Throws std::invalid_argument if the matrix is not a valid correlation matrix.
+std::vector<double> cholesky_factor(const std::vector<double>& correlation, size_t n);
+
+// out = L * z for one draw of n independent normals
+inline void correlate_normals(const std::vector<double>& factor, size_t n,
+                              const double* z, double* out) {
+    for (size_t i = 0; i < n; ++i) {
+        double sum = 0.0;
+        for (size_t k = 0; k <= i; ++k) {
+            sum += factor[i * n + k] * z[k];
+        }
+        out[i] = sum;
+    }
+}
+
+}
+
+#endif
@@ -1,24 +1,227 @@
 #ifndef MCOPTIONS_RANDOM_HPP
 #define MCOPTIONS_RANDOM_HPP
 
+#include "internal/ziggurat.hpp"
 #include <random>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace mcoptions {
 
-inline double box_muller(std::mt19937_64& rng) {
+/**
+ * Philox4x32-10 counter-based generator (Salmon et al., SC'11)
+ *
+ * Output block i of stream s is a keyed bijection of the counter (i, s), so
+ * a stream is fully described by three integers: setting one up is a few
+ * stores with no state warm-up, and any position is reachable in O(1) via
+ * discard(). Distinct (key, stream) pairs give independent sequences; the
+ * generator passes TestU01 BigCrush.
+ *
+ * Satisfies UniformRandomBitGenerator with 64-bit outputs (two per block).
+ */
+class Philox4x32 {
+public:
+    using result_type = uint64_t;
+
+    explicit Philox4x32(uint64_t key = 0, uint64_t stream = 0)
+        : key_(key), stream_(stream), block_(0), index_(2) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    result_type operator()() {
+        if (index_ == 2) refill();
+        return output_[index_++];
+    }
+
+    // Skip n outputs
+    void discard(uint64_t n) {
+        uint64_t buffered = 2 - index_;
+        if (n < buffered) {
+            index_ += static_cast<unsigned>(n);
+            return;
+        }
+        n -= buffered;
+        block_ += n / 2;
+        index_ = 2;
+        if (n % 2) {
+            refill();
+            index_ = 1;
+        }
+    }
+
+    /**
+     * The raw bijection: four 32-bit words for counter (c0, c1, c2, c3)
+     */
+    static void block(const uint32_t counter[4], uint64_t key, uint32_t out[4]) {
+        const uint32_t kMul0 = 0xD2511F53u, kMul1 = 0xCD9E8D57u;
+        const uint32_t kWeyl0 = 0x9E3779B9u, kWeyl1 = 0xBB67AE85u;
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+        for (int round = 0; round < 10; ++round) {
+            uint64_t p0 = static_cast<uint64_t>(kMul0) * c0;
+            uint64_t p1 = static_cast<uint64_t>(kMul1) * c2;
+            uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c0 = n0;
+            c1 = static_cast<uint32_t>(p1);
+            c2 = n2;
+            c3 = static_cast<uint32_t>(p0);
+            k0 += kWeyl0;
+            k1 += kWeyl1;
+        }
+        out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+    }
+
+private:
+    void refill() {
+        uint32_t counter[4] = {
+            static_cast<uint32_t>(block_), static_cast<uint32_t>(block_ >> 32),
+            static_cast<uint32_t>(stream_), static_cast<uint32_t>(stream_ >> 32)
+        };
+        uint32_t words[4];
+        block(counter, key_, words);
+        output_[0] = (static_cast<uint64_t>(words[1]) << 32) | words[0];
+        output_[1] = (static_cast<uint64_t>(words[3]) << 32) | words[2];
+        ++block_;
+        index_ = 0;
+    }
+
+    uint64_t key_;
+    uint64_t stream_;
+    uint64_t block_;         // Next counter value
+    uint64_t output_[2];
+    unsigned index_;         // Next unused output; 2 = buffer empty
+};
+
+/**
+ * 64-bit Mersenne Twister (Matsumoto-Nishimura), bit-identical to std::mt19937_64
+ *
+ * The sequential generator of the legacy kernels. Unlike the standard one
+ * its state is open, so engine/mt_jump.hpp can move it ahead by any number of
+ * outputs without generating them.
+ *
+ * The state is the window of the last 312 generated words plus the number of
+ * them already returned: output k of the window is word k, tempered.
+ */
+class Mt19937_64 {
+public:
+    using result_type = uint64_t;
+    static constexpr size_t kStateWords = 312;
+
+    explicit Mt19937_64(uint64_t value = 5489u) { seed(value); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    void seed(uint64_t value) {
+        state_[0] = value;
+        for (size_t i = 1; i < kStateWords; ++i) {
+            uint64_t prev = state_[i - 1];
+            state_[i] = 6364136223846793005ULL * (prev ^ (prev >> 62)) + i;
+        }
+        index_ = kStateWords;
+    }
+
+    result_type operator()() {
+        if (index_ == kStateWords) generate();
+        uint64_t x = state_[index_++];
+        x ^= (x >> 29) & 0x5555555555555555ULL;
+        x ^= (x << 17) & 0x71D67FFFEDA60000ULL;
+        x ^= (x << 37) & 0xFFF7EEE000000000ULL;
+        x ^= x >> 43;
+        return x;
+    }
+
+    // Skip n outputs by generating them (see jump_ahead for large n)
+    void discard(uint64_t n) {
+        while (n > 0) {
+            if (index_ == kStateWords) generate();
+            uint64_t take = std::min<uint64_t>(n, kStateWords - index_);
+            index_ += static_cast<size_t>(take);
+            n -= take;
+        }
+    }
+
+    // Raw state, for jump-ahead and checkpoints
+    uint64_t* state() { return state_; }
+    const uint64_t* state() const { return state_; }
+    size_t position() const { return index_; }
+    void set_position(size_t index) { index_ = std::min(index, kStateWords); }
+
+    /**
+     * One step of the raw recurrence on a circular window of 312 words
+     *
+     * `start` is the oldest word; it is replaced by the next one and the
+     * window start moves on by one.
+     */
+    static void step(uint64_t* window, size_t& start) {
+        const size_t n = kStateWords;
+        size_t next = start + 1 == n ? 0 : start + 1;
+        size_t middle = start + 156 < n ? start + 156 : start + 156 - n;
+        window[start] = twist(window[start], window[next], window[middle]);
+        start = next;
+    }
+
+private:
+    static uint64_t twist(uint64_t oldest, uint64_t next, uint64_t middle) {
+        const uint64_t kUpper = 0xFFFFFFFF80000000ULL;
+        const uint64_t kLower = 0x7FFFFFFFULL;
+        uint64_t x = (oldest & kUpper) | (next & kLower);
+        return middle ^ (x >> 1) ^ ((x & 1) ? 0xB5026F5AA96619E9ULL : 0);
+    }
+
+    void generate() {
+        const size_t n = kStateWords, m = 156;
+        for (size_t i = 0; i < n - m; ++i) {
+            state_[i] = twist(state_[i], state_[i + 1], state_[i + m]);
+        }
+        for (size_t i = n - m; i < n - 1; ++i) {
+            state_[i] = twist(state_[i], state_[i + 1], state_[i + m - n]);
+        }
+        state_[n - 1] = twist(state_[n - 1], state_[0], state_[m - 1]);
+        index_ = 0;
+    }
+
+    uint64_t state_[kStateWords];
+    size_t index_;           // Next unused word; 312 = window used up
+};
+
+template <typename Rng>
+inline double box_muller(Rng& rng) {
     std::uniform_real_distribution<double> uniform(0.0, 1.0);
     double u1 = uniform(rng);
     double u2 = uniform(rng);
     return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * M_PI * u2);
 }
 
-inline std::vector<double> generate_normal_samples(std::mt19937_64& rng, size_t n) {
-    std::vector<double> samples(n);
+/**
+ * Source of standard normals for the simulation kernels
+ */
+enum class NormalMethod {
+    BoxMuller,  // Two uniforms per normal; the historical sequence
+    Ziggurat    // Table lookup, mostly one multiply and compare (ziggurat.hpp)
+};
+
+template <typename Rng>
+inline void fill_normals(Rng& rng, NormalMethod method, double* out, size_t n) {
+    if (method == NormalMethod::Ziggurat) {
+        ziggurat_normals(rng, out, n);
+        return;
+    }
     for (size_t i = 0; i < n; ++i) {
-        samples[i] = box_muller(rng);
+        out[i] = box_muller(rng);
     }
+}
+
+template <typename Rng>
+inline std::vector<double> generate_normal_samples(Rng& rng, size_t n,
+                                                   NormalMethod method = NormalMethod::BoxMuller) {
+    std::vector<double> samples(n);
+    fill_normals(rng, method, samples.data(), n);
     return samples;
 }
 
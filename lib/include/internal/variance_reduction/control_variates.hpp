@@ -43,6 +43,16 @@ inline double price(double spot, double strike, double rate, double volatility,
         : put_price(spot, strike, rate, volatility, time);
 }
 
+// Forward-start option: strike fixed at start_time as strike_ratio * S(start_time).
+// Without dividends the value at start_time is S(start_time) * BS(1, strike_ratio)
+// over the remaining life, and E[exp(-r t) S(t)] = spot.
+inline double forward_start_price(double spot, double strike_ratio, double rate,
+                                  double volatility, double start_time,
+                                  double time_to_maturity, OptionType type) {
+    return spot * price(1.0, strike_ratio, rate, volatility,
+                        time_to_maturity - start_time, type);
+}
+
 } // namespace black_scholes
 
 // Apply control variate correction to Monte Carlo estimate
@@ -0,0 +1,150 @@
+#ifndef MCOPTIONS_ZIGGURAT_HPP
+#define MCOPTIONS_ZIGGURAT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace mcoptions {
+
+/**
+ * Ziggurat sampler for the standard normal (Marsaglia-Tsang 2000, 256 strips)
+ *
+ * The half density is covered by 256 strips of equal area: 255 rectangles
+ * stacked on a base strip that also holds the tail beyond r. One 64-bit draw
+ * gives a strip (8 bits), a sign (1 bit) and a 52-bit abscissa u; x = u * w[i]
+ * is accepted if it lies under the next strip up, u < k[i]. That test, one
+ * multiply and one compare, passes for about 99.3% of draws. The rest fall in
+ * a wedge (accepted against the density), in the tail (Marsaglia's
+ * exponential method) or are redrawn.
+ *
+ * ziggurat_normals() works in batches: a loop over the lanes does the table
+ * lookups and the fast test without branches, the rejected lanes are compacted
+ * into a short index list and only those take the scalar slow path. Which
+ * draws become which output depends only on the generator, so seeded runs
+ * repeat exactly; the number of draws per normal, however, varies.
+ */
+
+struct ZigguratTables {
+    static constexpr double kTail = 3.6541528853610088;   // r: start of the tail
+    static constexpr double kArea = 4.92867323399e-3;     // Area of each strip
+    static constexpr uint64_t kMantissa = (uint64_t(1) << 52) - 1;
+
+    uint64_t k[256];   // Fast acceptance bound on u per strip
+    double w[256];     // u -> x scale per strip
+    double f[256];     // exp(-x^2 / 2) at the strip edges
+
+    ZigguratTables() {
+        const double m = 4503599627370496.0;   // 2^52
+        double x = kTail;
+        double previous = x;
+        double q = kArea / std::exp(-0.5 * x * x);
+        k[0] = static_cast<uint64_t>(x / q * m);
+        k[1] = 0;
+        w[0] = q / m;
+        w[255] = x / m;
+        f[0] = 1.0;
+        f[255] = std::exp(-0.5 * x * x);
+        for (int i = 254; i >= 1; --i) {
+            x = std::sqrt(-2.0 * std::log(kArea / x + std::exp(-0.5 * x * x)));
+            k[i + 1] = static_cast<uint64_t>(x / previous * m);
+            previous = x;
+            f[i] = std::exp(-0.5 * x * x);
+            w[i] = x / m;
+        }
+    }
+};
+
+inline const ZigguratTables& ziggurat_tables() {
+    static const ZigguratTables tables;
+    return tables;
+}
+
+namespace detail {
+
+template <typename Rng>
+inline double open_uniform(Rng& rng) {
+    return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+} // namespace detail
+
+/**
+ * Finish one draw (the raw 64 bits) that may fail the fast test
+ */
+template <typename Rng>
+double ziggurat_resolve(Rng& rng, const ZigguratTables& t, uint64_t bits) {
+    for (;;) {
+        size_t strip = bits & 0xFF;
+        bool negative = (bits >> 8) & 1;
+        uint64_t u = (bits >> 9) & ZigguratTables::kMantissa;
+        double x = static_cast<double>(u) * t.w[strip];
+        if (u < t.k[strip]) {
+            return negative ? -x : x;
+        }
+        if (strip == 0) {
+            // Tail: r + E / r with E exponential, accepted with probability exp(-x^2/2) / exp(-r x)
+            for (;;) {
+                double xx = -std::log1p(-detail::open_uniform(rng)) / ZigguratTables::kTail;
+                double yy = -std::log1p(-detail::open_uniform(rng));
+                if (yy + yy > xx * xx) {
+                    x = ZigguratTables::kTail + xx;
+                    return negative ? -x : x;
+                }
+            }
+        }
+        double y = (t.f[strip - 1] - t.f[strip]) * detail::open_uniform(rng) + t.f[strip];
+        if (y < std::exp(-0.5 * x * x)) {
+            return negative ? -x : x;
+        }
+        bits = rng();
+    }
+}
+
+template <typename Rng>
+inline double ziggurat_normal(Rng& rng) {
+    return ziggurat_resolve(rng, ziggurat_tables(), rng());
+}
+
+/**
+ * Fill out[0..n) with standard normals
+ */
+template <typename Rng>
+void ziggurat_normals(Rng& rng, double* out, size_t n) {
+    const size_t kBatch = 256;
+    const ZigguratTables& t = ziggurat_tables();
+    uint64_t bits[kBatch];
+    uint8_t reject[kBatch];
+    uint16_t rejected[kBatch];
+
+    for (size_t first = 0; first < n; first += kBatch) {
+        size_t lanes = std::min(kBatch, n - first);
+        double* x = out + first;
+        for (size_t j = 0; j < lanes; ++j) bits[j] = rng();
+
+        // Fast path for every lane: gather, multiply, compare, no branches
+        for (size_t j = 0; j < lanes; ++j) {
+            uint64_t strip = bits[j] & 0xFF;
+            uint64_t u = (bits[j] >> 9) & ZigguratTables::kMantissa;
+            double sign = 1.0 - 2.0 * static_cast<double>((bits[j] >> 8) & 1);
+            x[j] = sign * static_cast<double>(u) * t.w[strip];
+            reject[j] = u >= t.k[strip];
+        }
+
+        // Compact the rejected lanes and finish them in order
+        size_t count = 0;
+        for (size_t j = 0; j < lanes; ++j) {
+            rejected[count] = static_cast<uint16_t>(j);
+            count += reject[j];
+        }
+        for (size_t i = 0; i < count; ++i) {
+            size_t j = rejected[i];
+            x[j] = ziggurat_resolve(rng, t, bits[j]);
+        }
+    }
+}
+
+} // namespace mcoptions
+
+#endif // MCOPTIONS_ZIGGURAT_HPP
@@ -22,7 +22,8 @@ typedef struct mco_context mco_context_t;
 
 MCO_API mco_context_t* mco_context_new(void);
 MCO_API void mco_context_free(mco_context_t* ctx);
-MCO_API void mco_context_set_seed(mco_context_t* ctx, uint64_t seed);
+MCO_API void mco_context_set_seed(mco_context_t* ctx, uint64_t seed);   // All 64 bits are used
+MCO_API uint64_t mco_context_get_seed(mco_context_t* ctx);
 MCO_API void mco_context_set_num_simulations(mco_context_t* ctx, uint64_t n);
 MCO_API void mco_context_set_num_steps(mco_context_t* ctx, uint64_t n);
 MCO_API void mco_context_set_antithetic(mco_context_t* ctx, int enabled);
@@ -33,6 +34,11 @@ MCO_API double mco_european_call(mco_context_t* ctx, double spot, double strike,
 MCO_API double mco_european_put(mco_context_t* ctx, double spot, double strike,
                                  double rate, double volatility, double time_to_maturity);
 
+/*
+ * Asian options average num_observations equally spaced fixings ending at
+ * maturity; paths are simulated on exactly those dates. Bermudan options are
+ * simulated on their exercise dates. Both return -1.0 on invalid input.
+ */
 MCO_API double mco_asian_arithmetic_call(mco_context_t* ctx, double spot, double strike,
                                           double rate, double volatility, double time_to_maturity,
                                           size_t num_observations);
@@ -74,6 +80,53 @@ MCO_API double mco_lookback_put(mco_context_t* ctx, double spot, double strike,
                                 double rate, double volatility, double time_to_maturity,
                                 int fixed_strike);
 
+/*
+ * Double, window and Parisian barriers (return -1.0 on invalid input)
+ *
+ * Double and window barriers are continuously monitored via a
+ * Brownian-bridge correction, so they are only simulated at the window edges
+ * and maturity, whatever the context's step count. Parisian options
+ * are knocked once the spot stays beyond the barrier for `window` years in a
+ * row; barrier_type uses the same codes as mco_barrier_call.
+ */
+MCO_API double mco_double_barrier_call(mco_context_t* ctx, double spot, double strike,
+                                       double rate, double volatility, double time_to_maturity,
+                                       double lower_barrier, double upper_barrier,
+                                       int knock_in, double rebate);
+MCO_API double mco_double_barrier_put(mco_context_t* ctx, double spot, double strike,
+                                      double rate, double volatility, double time_to_maturity,
+                                      double lower_barrier, double upper_barrier,
+                                      int knock_in, double rebate);
+
+MCO_API double mco_window_barrier_call(mco_context_t* ctx, double spot, double strike,
+                                       double rate, double volatility, double time_to_maturity,
+                                       double barrier_level, int barrier_type,
+                                       double window_start, double window_end, double rebate);
+MCO_API double mco_window_barrier_put(mco_context_t* ctx, double spot, double strike,
+                                      double rate, double volatility, double time_to_maturity,
+                                      double barrier_level, int barrier_type,
+                                      double window_start, double window_end, double rebate);
+
+MCO_API double mco_parisian_call(mco_context_t* ctx, double spot, double strike,
+                                 double rate, double volatility, double time_to_maturity,
+                                 double barrier_level, int barrier_type,
+                                 double window, double rebate);
+MCO_API double mco_parisian_put(mco_context_t* ctx, double spot, double strike,
+                                double rate, double volatility, double time_to_maturity,
+                                double barrier_level, int barrier_type,
+                                double window, double rebate);
+
+/*
+ * Forward-start options: strike set at start_time to strike_ratio * S(start_time).
+ * Closed form under Black-Scholes. Returns -1.0 on invalid input.
+ */
+MCO_API double mco_forward_start_call(mco_context_t* ctx, double spot, double strike_ratio,
+                                      double rate, double volatility,
+                                      double start_time, double time_to_maturity);
+MCO_API double mco_forward_start_put(mco_context_t* ctx, double spot, double strike_ratio,
+                                     double rate, double volatility,
+                                     double start_time, double time_to_maturity);
+
 // Model selection
 MCO_API void mco_context_set_model(mco_context_t* ctx, int model);  // 0=GBM, 1=SABR
 MCO_API void mco_context_set_sabr_params(mco_context_t* ctx, 
@@ -84,6 +137,29 @@ MCO_API void mco_context_set_sabr_params(mco_context_t* ctx,
 MCO_API void mco_context_set_control_variates(mco_context_t* ctx, int enabled);
 MCO_API void mco_context_set_stratified_sampling(mco_context_t* ctx, int enabled);
 
+// Normal sampling
+//
+// BOX_MULLER (default) gives the historical sequences. ZIGGURAT looks normals
+// up in a 256-strip table: about 99% cost one multiply and compare, the rest
+// take a short rejection step, so the uniforms used per normal vary (and a
+// sequential stream then runs in order, see mco_context_set_stream_mode).
+typedef enum {
+    MCO_NORMAL_BOX_MULLER = 0,
+    MCO_NORMAL_ZIGGURAT = 1
+} mco_normal_method_t;
+
+/* Returns MCO_ERROR_INVALID_ARGUMENT for an unknown method */
+MCO_API int mco_context_set_normal_method(mco_context_t* ctx, int method);
+
+/*
+ * Inverse normal CDF (Wichura's AS241) over `count` probabilities; normals
+ * may alias probabilities. refine != 0 adds one Halley step. 0 and 1 map to
+ * -inf and +inf, values outside [0, 1] to NaN. Stratified sampling maps its
+ * uniforms through the same function.
+ */
+MCO_API int mco_inverse_normal_cdf(const double* probabilities, size_t count,
+                                   int refine, double* normals);
+
 // Future methods (placeholders - return -1.0 for "not implemented")
 MCO_API double mco_european_call_fdm(mco_context_t* ctx, double spot, double strike,
                                      double rate, double volatility, double time_to_maturity);
@@ -217,6 +293,607 @@ MCO_API double mco_lsm_american_put_default(
     double time_to_maturity
 );
 
+// ============================================================================
+// Automatic Method Selection
+// ============================================================================
+
+typedef enum {
+    MCO_OK = 0,
+    MCO_ERROR_INVALID_ARGUMENT = -1,
+    MCO_ERROR_UNSUPPORTED = -2,
+    MCO_ERROR_INTERNAL = -3
+} mco_status_t;
+
+typedef enum {
+    MCO_METHOD_AUTO = 0,
+    MCO_METHOD_ANALYTIC = 1,
+    MCO_METHOD_BINOMIAL_TREE = 2,
+    MCO_METHOD_MONTE_CARLO = 3,
+    MCO_METHOD_LSM = 4
+} mco_method_t;
+
+typedef enum {
+    MCO_EXERCISE_EUROPEAN = 0,
+    MCO_EXERCISE_AMERICAN = 1
+} mco_exercise_style_t;
+
+typedef enum {
+    MCO_CALL = 0,
+    MCO_PUT = 1
+} mco_option_type_t;
+
+typedef struct {
+    double price;
+    double error_estimate;   /* Predicted absolute error (1 std error for MC) */
+    int method;              /* mco_method_t actually used */
+    uint64_t num_paths;      /* 0 for deterministic methods */
+    uint64_t num_steps;      /* Tree depth, time steps or exercise dates */
+    int status;              /* mco_status_t of this result */
+} mco_price_result_t;
+
+/*
+ * Price with the cheapest method expected to meet `tolerance` (absolute price
+ * error). Preference order: analytic > binomial tree > Monte Carlo / LSM.
+ * The context's own path/step settings are left unchanged.
+ * Returns MCO_OK or a negative mco_status_t.
+ */
+MCO_API int mco_price(
+    mco_context_t* ctx,
+    int exercise_style,
+    int option_type,
+    double spot,
+    double strike,
+    double rate,
+    double volatility,
+    double time_to_maturity,
+    double tolerance,
+    mco_price_result_t* result
+);
+
+// ============================================================================
+// Autocallable Notes
+// ============================================================================
+
+/*
+ * Autocallable / phoenix terms. Barriers and put strike are fractions of the
+ * initial fixing and apply to the worst-performing underlying.
+ */
+typedef struct {
+    double notional;
+    double autocall_barrier;       /* Early redemption if worst >= this */
+    double coupon_barrier;         /* Coupon paid if worst >= this */
+    double coupon_rate;            /* Per observation, fraction of notional */
+    int memory;                    /* 1 = missed coupons are paid later */
+    double knock_in_barrier;       /* Observed at maturity; 0 = none */
+    double put_strike;             /* Knocked-in redemption = worst / put_strike */
+    const double* observation_dates;  /* Increasing, last = maturity */
+    size_t num_observations;
+} mco_autocallable_terms_t;
+
+/*
+ * Price an autocallable on one or more correlated GBM underlyings.
+ * Paths that autocall stop being simulated. error_estimate is the Monte
+ * Carlo standard error; num_steps is the number of observation dates.
+ *
+ * initial_fixings: NULL = today's spots
+ * correlation:     row-major num_assets x num_assets, NULL = independent
+ */
+MCO_API int mco_price_autocallable(
+    mco_context_t* ctx,
+    size_t num_assets,
+    const double* spots,
+    const double* initial_fixings,
+    const double* volatilities,
+    const double* correlation,
+    double rate,
+    const mco_autocallable_terms_t* terms,
+    mco_price_result_t* result
+);
+
+// ============================================================================
+// Cliquets
+// ============================================================================
+
+/*
+ * notional * clamp(sum_i clamp(S(t_i)/S(t_{i-1}) - 1, local_floor, local_cap),
+ *                  global_floor, global_cap), paid at the last reset date.
+ * Caps may be INFINITY and floors -INFINITY.
+ */
+typedef struct {
+    const double* reset_dates;     /* Increasing, last = maturity; t_0 = 0 */
+    size_t num_resets;
+    double local_floor;
+    double local_cap;
+    double global_floor;
+    double global_cap;
+    double notional;
+} mco_cliquet_params_t;
+
+/*
+ * Monte Carlo over the reset dates. With control variates enabled on the
+ * context, the locally clamped sum (a strip of forward-start call spreads,
+ * known in closed form) is used as control.
+ */
+MCO_API int mco_price_cliquet(
+    mco_context_t* ctx,
+    double rate,
+    double volatility,
+    const mco_cliquet_params_t* params,
+    mco_price_result_t* result
+);
+
+// ============================================================================
+// Closed-Form Barriers and Lookbacks
+// ============================================================================
+
+/*
+ * Black-Scholes closed forms: Reiner-Rubinstein single barriers and
+ * Goldman-Sosin-Gatto (floating strike) / Conze-Viswanathan (fixed strike)
+ * lookbacks on contracts starting today. Rebates are paid at maturity, as in
+ * the Monte Carlo pricers.
+ *
+ * monitoring_steps = 0 prices continuous monitoring. m > 0 prices monitoring
+ * at m equally spaced dates (the Monte Carlo convention with m time steps)
+ * through the Broadie-Glasserman-Kou shift of the barrier / extremum.
+ *
+ * Scalar versions return -1.0 on invalid input.
+ */
+MCO_API double mco_barrier_call_analytic(mco_context_t* ctx, double spot, double strike,
+                                         double rate, double volatility, double time_to_maturity,
+                                         double barrier_level, int barrier_type, double rebate,
+                                         size_t monitoring_steps);
+MCO_API double mco_barrier_put_analytic(mco_context_t* ctx, double spot, double strike,
+                                        double rate, double volatility, double time_to_maturity,
+                                        double barrier_level, int barrier_type, double rebate,
+                                        size_t monitoring_steps);
+
+MCO_API double mco_lookback_call_analytic(mco_context_t* ctx, double spot, double strike,
+                                          double rate, double volatility, double time_to_maturity,
+                                          int fixed_strike, size_t monitoring_steps);
+MCO_API double mco_lookback_put_analytic(mco_context_t* ctx, double spot, double strike,
+                                         double rate, double volatility, double time_to_maturity,
+                                         int fixed_strike, size_t monitoring_steps);
+
+/*
+ * Batch versions over parallel arrays of length `count`; option_types hold
+ * mco_option_type_t codes. Returns MCO_OK or MCO_ERROR_INVALID_ARGUMENT, in
+ * which case `prices` is left partially filled.
+ */
+MCO_API int mco_barrier_analytic_batch(
+    mco_context_t* ctx,
+    size_t count,
+    const int* option_types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times_to_maturity,
+    const double* barrier_levels,
+    const int* barrier_types,
+    const double* rebates,
+    size_t monitoring_steps,
+    double* prices
+);
+
+MCO_API int mco_lookback_analytic_batch(
+    mco_context_t* ctx,
+    size_t count,
+    const int* option_types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times_to_maturity,
+    const int* fixed_strikes,
+    size_t monitoring_steps,
+    double* prices
+);
+
+// ============================================================================
+// Generic Instrument Descriptor
+// ============================================================================
+
+typedef enum {
+    MCO_INSTRUMENT_EUROPEAN = 0,
+    MCO_INSTRUMENT_AMERICAN = 1,
+    MCO_INSTRUMENT_ASIAN = 2,
+    MCO_INSTRUMENT_BARRIER = 3,
+    MCO_INSTRUMENT_LOOKBACK = 4,
+    MCO_INSTRUMENT_BERMUDAN = 5,
+    MCO_INSTRUMENT_DOUBLE_BARRIER = 6,
+    MCO_INSTRUMENT_WINDOW_BARRIER = 7,
+    MCO_INSTRUMENT_PARISIAN = 8,
+    MCO_INSTRUMENT_AUTOCALLABLE = 9,    /* Single asset; strike = initial fixing */
+    MCO_INSTRUMENT_FORWARD_START = 10,  /* strike = strike ratio */
+    MCO_INSTRUMENT_CLIQUET = 11         /* spot and strike unused */
+} mco_instrument_kind_t;
+
+typedef struct {
+    uint64_t num_exercise_points;  /* 0 = library default (MC / LSM only) */
+} mco_american_params_t;
+
+typedef struct {
+    uint64_t num_observations;
+} mco_asian_params_t;
+
+typedef struct {
+    double barrier_level;
+    int barrier_type;              /* 0=up-out, 1=up-in, 2=down-out, 3=down-in */
+    double rebate;
+    int continuous;                /* 1 = continuous monitoring, 0 = on the context's steps */
+} mco_barrier_params_t;
+
+typedef struct {
+    int fixed_strike;              /* 1 = fixed strike, 0 = floating strike */
+    int continuous;                /* 1 = continuous monitoring, 0 = on the context's steps */
+} mco_lookback_params_t;
+
+typedef struct {
+    const double* exercise_dates;  /* Borrowed; only read during the call */
+    size_t num_dates;
+} mco_bermudan_params_t;
+
+typedef struct {
+    double lower_barrier;
+    double upper_barrier;
+    int knock_in;                  /* 0 = double knock-out, 1 = double knock-in */
+    double rebate;
+} mco_double_barrier_params_t;
+
+typedef struct {
+    double barrier_level;
+    int barrier_type;              /* Same codes as mco_barrier_params_t */
+    double window_start;
+    double window_end;
+    double rebate;
+} mco_window_barrier_params_t;
+
+typedef struct {
+    double barrier_level;
+    int barrier_type;              /* Same codes as mco_barrier_params_t */
+    double window;                 /* Required excursion length in years */
+    double rebate;
+} mco_parisian_params_t;
+
+typedef struct {
+    double start_time;             /* Strike-setting date */
+} mco_forward_start_params_t;
+
+/*
+ * Plain-data description of any supported instrument. `kind` selects which
+ * member of `params` is read. `method` is an mco_method_t; with
+ * MCO_METHOD_AUTO vanilla instruments go through the selector of mco_price
+ * using `tolerance`, continuously monitored barriers and lookbacks use their
+ * closed forms under GBM, other path-dependent ones use Monte Carlo with the
+ * context's settings. MCO_METHOD_ANALYTIC on a discretely monitored barrier
+ * or lookback gives the BGK-corrected closed form (error_estimate NaN).
+ */
+typedef struct {
+    int kind;                      /* mco_instrument_kind_t */
+    int option_type;               /* mco_option_type_t */
+    int method;                    /* mco_method_t */
+    double spot;
+    double strike;
+    double rate;
+    double volatility;
+    double time_to_maturity;
+    double tolerance;              /* Only used with MCO_METHOD_AUTO */
+    union {
+        mco_american_params_t american;
+        mco_asian_params_t asian;
+        mco_barrier_params_t barrier;
+        mco_lookback_params_t lookback;
+        mco_bermudan_params_t bermudan;
+        mco_double_barrier_params_t double_barrier;
+        mco_window_barrier_params_t window_barrier;
+        mco_parisian_params_t parisian;
+        mco_autocallable_terms_t autocallable;
+        mco_forward_start_params_t forward_start;
+        mco_cliquet_params_t cliquet;
+    } params;
+} mco_instrument_t;
+
+/*
+ * Price one instrument. error_estimate is NaN when the method has no error
+ * estimate. Returns MCO_OK or a negative mco_status_t (MCO_ERROR_UNSUPPORTED
+ * when the requested method cannot price the instrument).
+ */
+MCO_API int mco_price_instrument(
+    mco_context_t* ctx,
+    const mco_instrument_t* instrument,
+    mco_price_result_t* result
+);
+
+/*
+ * Price `count` instruments into `results` (same length). Every instrument is
+ * attempted; results[i].status holds its individual status. Returns MCO_OK if
+ * all succeeded, otherwise the status of the first failure.
+ *
+ * With more than one thread the instruments are priced concurrently on the
+ * engine and each one may split its own paths further (see Parallel Engine).
+ * Instrument i draws from its own stream derived from the context RNG and i,
+ * so results do not depend on the thread count or on the other instruments.
+ */
+MCO_API int mco_price_instruments(
+    mco_context_t* ctx,
+    const mco_instrument_t* instruments,
+    size_t count,
+    mco_price_result_t* results
+);
+
+/*
+ * As mco_price_instruments for a slice of a larger batch whose first element
+ * sits at position first_index: instrument i draws the stream of position
+ * first_index + i, so pricing a batch slice by slice with the same seed gives
+ * the prices of one mco_price_instruments call over the whole batch. The
+ * sequential stream cannot skip ahead to a slice; there first_index must be
+ * 0, otherwise every results[i].status and the return are
+ * MCO_ERROR_UNSUPPORTED.
+ */
+MCO_API int mco_price_instruments_from(
+    mco_context_t* ctx,
+    const mco_instrument_t* instruments,
+    size_t count,
+    size_t first_index,
+    mco_price_result_t* results
+);
+
+// ============================================================================
+// Prepared Pricing Plans
+// ============================================================================
+
+/*
+ * A plan is a prepared statement for pricing: one instrument compiled
+ * against a snapshot of the context, then executed with new market data.
+ *
+ * mco_plan_prepare() validates and copies the instrument, copies the context
+ * settings (later changes to ctx do not affect the plan), runs automatic
+ * method selection once for vanilla instruments (sized for the market in the
+ * instrument), pins the worker pool and fixes a random stream.
+ * mco_plan_execute() prices under the given market on that stream: the same
+ * market gives the same price, and price changes reflect the market alone.
+ * A plan runs one execution at a time; separate plans may run concurrently.
+ */
+typedef struct mco_plan mco_plan_t;
+
+typedef struct {
+    double spot;
+    double rate;
+    double volatility;
+} mco_market_t;
+
+/* Returns MCO_OK with *plan set (free with mco_plan_free), or MCO_ERROR_INVALID_ARGUMENT */
+MCO_API int mco_plan_prepare(mco_context_t* ctx, const mco_instrument_t* instrument,
+                             mco_plan_t** plan);
+
+/* Same statuses as mco_price_instrument */
+MCO_API int mco_plan_execute(mco_plan_t* plan, const mco_market_t* market,
+                             mco_price_result_t* result);
+MCO_API void mco_plan_free(mco_plan_t* plan);
+
+/*
+ * Incremental repricing by likelihood-ratio reweighting. With a minimum
+ * effective sample fraction in (0, 1], a Monte Carlo execution of a
+ * path-wise product (Asian, forward start, Parisian, cliquet without
+ * control variates) keeps its paths, and later executions at the same spot
+ * reweight them to the new rate and volatility instead of simulating: one
+ * pass over the cached payoffs. The plan simulates afresh when the spot
+ * moves or the effective sample size of the weights drops below the
+ * fraction times the number of paths. 0 turns reweighting off (default).
+ * Returns MCO_OK or MCO_ERROR_INVALID_ARGUMENT.
+ */
+MCO_API int mco_plan_set_reweighting(mco_plan_t* plan, double min_effective_fraction);
+
+typedef struct {
+    int reweighted;                 /* 1 if the last execution reused cached paths */
+    double effective_sample_size;   /* Of the last execution, 0 if nothing was cached */
+    uint64_t simulations;           /* Executions that priced from scratch */
+} mco_plan_stats_t;
+
+MCO_API int mco_plan_get_stats(const mco_plan_t* plan, mco_plan_stats_t* stats);
+
+typedef struct {
+    double delta;
+    double gamma;
+    double vega;                   /* Per unit of volatility */
+    double rho;                    /* Per unit of rate */
+} mco_greeks_t;
+
+/*
+ * Prices `count` instruments with bump-and-reprice Greeks. Each instrument
+ * is prepared as a plan and executed at its own market and at six bumped
+ * ones (spot +/- 1%, volatility +/- 0.01, rate +/- 1bp), so every scenario
+ * uses the same method and random numbers and Monte Carlo Greeks are free
+ * of independent simulation noise. Near zero volatility vega bumps up only.
+ * Seven pricings per instrument; the instruments run concurrently as in
+ * mco_price_instruments. Greeks are NaN where results[i].status is not
+ * MCO_OK. Returns as mco_price_instruments.
+ */
+MCO_API int mco_price_instruments_greeks(
+    mco_context_t* ctx,
+    const mco_instrument_t* instruments,
+    size_t count,
+    mco_price_result_t* results,
+    mco_greeks_t* greeks
+);
+
+// ============================================================================
+// Chebyshev Proxies
+// ============================================================================
+
+/*
+ * Interpolated price surface of one instrument for fast intraday repricing
+ *
+ * mco_proxy_build() prices the instrument (as mco_price_instrument would) on
+ * a tensor grid of Chebyshev-Lobatto nodes over spot, volatility and time to
+ * maturity, with the nodes running in parallel on the engine and sharing one
+ * seed. Afterwards mco_proxy_evaluate() returns the price and Greeks at any
+ * point of the domain without further pricing. The error falls geometrically
+ * with the node count for prices that are smooth in the domain, so place
+ * barriers and strikes away from the domain of a short-dated proxy.
+ *
+ * Only spot, volatility and time to maturity of the instrument move; other
+ * dates in its parameters stay as given, so a time axis is rejected for
+ * Bermudan, autocallable, cliquet and window barrier instruments.
+ */
+typedef struct mco_proxy mco_proxy_t;
+
+typedef struct {
+    double lower;
+    double upper;
+    size_t nodes;                  /* 2..64, or 0 to keep the instrument's own value */
+} mco_proxy_axis_t;
+
+typedef struct {
+    mco_proxy_axis_t spot;
+    mco_proxy_axis_t volatility;
+    mco_proxy_axis_t time_to_maturity;
+} mco_proxy_domain_t;
+
+typedef struct {
+    double price;
+    double delta;                  /* NaN for an axis without nodes */
+    double gamma;
+    double vega;                   /* Per unit of volatility */
+    double theta;                  /* -dPrice / dTime to maturity */
+    double error_estimate;         /* Truncation estimate + largest node error; NaN if a node has none */
+} mco_proxy_value_t;
+
+/*
+ * Returns MCO_OK with *proxy set (free with mco_proxy_free), or the status of
+ * the first node that failed to price.
+ */
+MCO_API int mco_proxy_build(mco_context_t* ctx, const mco_instrument_t* instrument,
+                            const mco_proxy_domain_t* domain, mco_proxy_t** proxy);
+MCO_API void mco_proxy_free(mco_proxy_t* proxy);
+
+/* Arguments on axes without nodes are ignored; MCO_ERROR_INVALID_ARGUMENT outside the domain */
+MCO_API int mco_proxy_evaluate(const mco_proxy_t* proxy, double spot, double volatility,
+                               double time_to_maturity, mco_proxy_value_t* value);
+
+/*
+ * Binary image of a proxy, e.g. to keep it across restarts. *size receives
+ * the image size; with buffer NULL only the size is reported. A buffer
+ * smaller than *size gives MCO_ERROR_INVALID_ARGUMENT. Images are in native
+ * byte order; mco_proxy_deserialize() rejects truncated or foreign ones.
+ */
+MCO_API int mco_proxy_serialize(const mco_proxy_t* proxy, void* buffer, size_t capacity,
+                                size_t* size);
+MCO_API int mco_proxy_deserialize(const void* buffer, size_t size, mco_proxy_t** proxy);
+
+// ============================================================================
+// Parallel Engine
+// ============================================================================
+
+/*
+ * Monte Carlo kernels simulate their paths in blocks on a process-wide
+ * worker pool. num_threads = 1 (the default) runs everything on the calling
+ * thread; 0 uses one worker per CPU available to the process. Each block has
+ * its own generator derived from the context seed, so seeded results do not
+ * depend on the thread count (up to the order of floating-point sums).
+ *
+ * With an affinity other than NONE workers are pinned to CPUs and allocate
+ * their path blocks themselves, so the memory sits on their own NUMA node;
+ * partial sums are reduced per node before they are combined.
+ */
+typedef enum {
+    MCO_AFFINITY_NONE = 0,         /* Threads float */
+    MCO_AFFINITY_COMPACT = 1,      /* Fill one NUMA node before the next */
+    MCO_AFFINITY_SPREAD = 2        /* Round-robin across NUMA nodes */
+} mco_thread_affinity_t;
+
+typedef struct {
+    size_t num_cpus;               /* CPUs this process may run on */
+    size_t num_nodes;              /* NUMA nodes holding at least one of them */
+} mco_topology_t;
+
+MCO_API void mco_context_set_num_threads(mco_context_t* ctx, size_t num_threads);
+MCO_API size_t mco_context_get_num_threads(mco_context_t* ctx);
+
+/* Returns MCO_ERROR_INVALID_ARGUMENT for an unknown mode */
+MCO_API int mco_context_set_thread_affinity(mco_context_t* ctx, int affinity);
+
+/*
+ * Reproducible mode: every block of paths accumulates into its own partial
+ * sum and the partials are combined in a fixed pairwise tree, so a seed gives
+ * bit-identical prices on any number of threads. The default fast mode sums
+ * per worker, whose grouping depends on scheduling (differences of a few ulps).
+ */
+MCO_API void mco_context_set_reproducible(mco_context_t* ctx, int enabled);
+
+/*
+ * Where simulations draw their random numbers
+ *
+ * BLOCKS (default): every block of paths has its own counter-based stream.
+ * SEQUENTIAL: the context's single Mersenne Twister sequence, consumed in
+ * exactly the order of the serial library, so a seed reproduces historical
+ * prices bit for bit on any number of threads. Workers jump ahead to their
+ * share of the sequence; kernels whose draw count per path varies
+ * (stratified sampling, Longstaff-Schwartz) and batches of instruments then
+ * run in order. Sample sums are kept in path order, which costs 16 bytes
+ * per path while a job is split.
+ */
+typedef enum {
+    MCO_STREAM_BLOCKS = 0,
+    MCO_STREAM_SEQUENTIAL = 1
+} mco_stream_mode_t;
+
+/* Returns MCO_ERROR_INVALID_ARGUMENT for an unknown mode */
+MCO_API int mco_context_set_stream_mode(mco_context_t* ctx, int mode);
+
+/*
+ * One block of the Philox4x32-10 bijection behind BLOCKS streams: four
+ * 32-bit output words for a four-word counter under a 64-bit key. Exposed
+ * so the generator can be checked against the Random123 known answers.
+ */
+MCO_API int mco_philox4x32(const uint32_t counter[4], uint64_t key, uint32_t out[4]);
+
+/*
+ * Checkpoints for long simulations
+ *
+ * With a checkpoint file, every Monte Carlo job run with the context (and
+ * with batches priced through it) saves its progress to `path` at most
+ * every `interval_seconds` (0 = after every chunk of 64 blocks per worker):
+ * the partial sums, the blocks done and the position of the sequential
+ * stream. After a crash, repeat the same calls on a context with the same
+ * seed and settings and resume = 1: the finished blocks of interrupted jobs
+ * are skipped and the prices are bit-identical to an uninterrupted run.
+ * Finished jobs leave only their counts in the file and are priced again.
+ * A job is recognised by its stream, a fingerprint of the contract's
+ * parameters and its first block, so records of other jobs in the file are
+ * simply not used. resume = 0 drops what the file holds; a
+ * missing file is an empty checkpoint. A NULL path turns checkpointing off.
+ *
+ * Jobs on block streams then sum per block in the fixed order of
+ * reproducible mode. Jobs that record paths for reweighting do not
+ * checkpoint. A checkpoint that cannot be written does not fail the
+ * pricing: the write is retried at the next interval, and
+ * mco_context_flush_checkpoint returns MCO_ERROR_INTERNAL while it fails.
+ *
+ * Returns MCO_ERROR_INVALID_ARGUMENT for a negative interval or, when
+ * resuming, a file that is not a checkpoint.
+ */
+typedef struct {
+    uint64_t jobs;                 /* Jobs in progress or finished */
+    uint64_t jobs_done;            /* ... of which finished */
+    uint64_t blocks_done;          /* Blocks of paths finished, over all jobs */
+    uint64_t blocks_total;
+} mco_checkpoint_info_t;
+
+MCO_API int mco_context_set_checkpoint(mco_context_t* ctx, const char* path,
+                                       double interval_seconds, int resume);
+
+/* Writes progress not yet in the file, e.g. before the process stops */
+MCO_API int mco_context_flush_checkpoint(mco_context_t* ctx);
+
+/* Reads a checkpoint file, e.g. to report the progress of a running job */
+MCO_API int mco_checkpoint_info(const char* path, mco_checkpoint_info_t* info);
+
+MCO_API int mco_get_topology(mco_topology_t* topology);
+
+/* Usable CPUs on NUMA node `node` (0 past the last node) */
+MCO_API size_t mco_topology_node_cpus(size_t node);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,10 @@ project "mcoptions"
         "src/methods/**.cpp",
         "include/internal/methods/**.hpp",
         
+        -- Parallel engine
+        "src/engine/**.cpp",
+        "include/internal/engine/**.hpp",
+        
         -- Variance Reduction (when we add them)
         "src/variance_reduction/**.cpp",
         "include/internal/variance_reduction/**.hpp",
@@ -53,7 +57,7 @@ project "mcoptions"
     defines { "MCOPTIONS_EXPORTS" }
     
     filter "system:linux"
-        links { "m" }
+        links { "m", "pthread" }
         buildoptions { "-fPIC" }
     
     filter "system:windows"
@@ -0,0 +1,468 @@
+/*
+ * Native Python bindings: batch pricing over columns of numbers.
+ *
+ * price() takes one keyword per instrument field. Each is either a scalar,
+ * used for every row, or a one-dimensional buffer such as a NumPy array or a
+ * pandas column's values. Buffers are read in place through the buffer
+ * protocol, strided or not, and in any common numeric type. The whole batch
+ * goes to mco_price_instruments (or mco_price_instruments_greeks) in one
+ * call with the GIL released, so other Python threads keep running.
+ *
+ * Results come back as a dict of memoryviews over freshly allocated memory;
+ * numpy.asarray() wraps them without copying.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "mcoptions.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ========================================================================== */
+/* Columns                                                                    */
+/* ========================================================================== */
+
+typedef enum {
+    FIELD_KIND,
+    FIELD_OPTION_TYPE,
+    FIELD_METHOD,
+    FIELD_SPOT,
+    FIELD_STRIKE,
+    FIELD_RATE,
+    FIELD_VOLATILITY,
+    FIELD_TIME_TO_MATURITY,
+    FIELD_TOLERANCE,
+    FIELD_NUM_EXERCISE_POINTS,  /* American */
+    FIELD_NUM_OBSERVATIONS,     /* Asian */
+    FIELD_BARRIER_LEVEL,        /* Barrier, window barrier, Parisian */
+    FIELD_BARRIER_TYPE,
+    FIELD_REBATE,               /* All barrier kinds */
+    FIELD_CONTINUOUS,           /* Barrier, lookback */
+    FIELD_FIXED_STRIKE,         /* Lookback */
+    FIELD_LOWER_BARRIER,        /* Double barrier */
+    FIELD_UPPER_BARRIER,
+    FIELD_KNOCK_IN,
+    FIELD_WINDOW_START,         /* Window barrier */
+    FIELD_WINDOW_END,
+    FIELD_EXCURSION_WINDOW,     /* Parisian */
+    FIELD_START_TIME,           /* Forward start */
+    NUM_FIELDS
+} field_t;
+
+static const char* const field_names[NUM_FIELDS] = {
+    "kind", "option_type", "method", "spot", "strike", "rate", "volatility",
+    "time_to_maturity", "tolerance", "num_exercise_points", "num_observations",
+    "barrier_level", "barrier_type", "rebate", "continuous", "fixed_strike",
+    "lower_barrier", "upper_barrier", "knock_in", "window_start", "window_end",
+    "excursion_window", "start_time"
+};
+
+/* A buffer of `length` values, or a scalar when has_view is 0 */
+typedef struct {
+    Py_buffer view;
+    int has_view;
+    char format;
+    double scalar;
+} column_t;
+
+static int supported_format(char format) {
+    return strchr("dfbBhHiIlLqQ?", format) != NULL;
+}
+
+static double column_value(const column_t* column, Py_ssize_t row) {
+    if (!column->has_view) return column->scalar;
+    const char* p = (const char*)column->view.buf;
+    if (column->view.ndim > 0) p += row * column->view.strides[0];
+    switch (column->format) {
+        case 'd': return *(const double*)p;
+        case 'f': return *(const float*)p;
+        case 'b': return *(const signed char*)p;
+        case 'B': return *(const unsigned char*)p;
+        case 'h': return *(const short*)p;
+        case 'H': return *(const unsigned short*)p;
+        case 'i': return *(const int*)p;
+        case 'I': return *(const unsigned int*)p;
+        case 'l': return (double)*(const long*)p;
+        case 'L': return (double)*(const unsigned long*)p;
+        case 'q': return (double)*(const long long*)p;
+        case 'Q': return (double)*(const unsigned long long*)p;
+        case '?': return *(const _Bool*)p ? 1.0 : 0.0;
+        default: return NAN;
+    }
+}
+
+/* Fills `column` from a scalar or a 1-D buffer; returns -1 with an exception set */
+static int column_from_object(column_t* column, const char* name, PyObject* value) {
+    if (PyObject_CheckBuffer(value)) {
+        if (PyObject_GetBuffer(value, &column->view, PyBUF_STRIDES | PyBUF_FORMAT) < 0) return -1;
+        column->has_view = 1;
+        const char* format = column->view.format ? column->view.format : "B";
+        /* Native byte order and alignment only: '@' or '=' prefixes are fine */
+        if (*format == '@' || *format == '=') format++;
+        if (column->view.ndim > 1 || strlen(format) != 1 || !supported_format(*format)) {
+            PyErr_Format(PyExc_TypeError,
+                         "%s: expected a scalar or a 1-D numeric buffer", name);
+            return -1;
+        }
+        column->format = *format;
+        if (column->view.ndim == 0) {
+            /* NumPy scalars export zero-dimensional buffers */
+            column->scalar = column_value(column, 0);
+            PyBuffer_Release(&column->view);
+            column->has_view = 0;
+        }
+        return 0;
+    }
+    column->scalar = PyFloat_AsDouble(value);
+    if (column->scalar == -1.0 && PyErr_Occurred()) {
+        PyErr_Format(PyExc_TypeError, "%s: expected a number or a 1-D numeric buffer", name);
+        return -1;
+    }
+    return 0;
+}
+
+static void release_columns(column_t* columns) {
+    for (int f = 0; f < NUM_FIELDS; ++f) {
+        if (columns[f].has_view) PyBuffer_Release(&columns[f].view);
+    }
+}
+
+/* ========================================================================== */
+/* Instruments                                                                */
+/* ========================================================================== */
+
+static void fill_instrument(const column_t* columns, Py_ssize_t row, mco_instrument_t* out) {
+#define VALUE(field) column_value(&columns[field], row)
+    memset(out, 0, sizeof(*out));
+    out->kind = (int)VALUE(FIELD_KIND);
+    out->option_type = (int)VALUE(FIELD_OPTION_TYPE);
+    out->method = (int)VALUE(FIELD_METHOD);
+    out->spot = VALUE(FIELD_SPOT);
+    out->strike = VALUE(FIELD_STRIKE);
+    out->rate = VALUE(FIELD_RATE);
+    out->volatility = VALUE(FIELD_VOLATILITY);
+    out->time_to_maturity = VALUE(FIELD_TIME_TO_MATURITY);
+    out->tolerance = VALUE(FIELD_TOLERANCE);
+
+    switch (out->kind) {
+        case MCO_INSTRUMENT_AMERICAN:
+            out->params.american.num_exercise_points = (uint64_t)VALUE(FIELD_NUM_EXERCISE_POINTS);
+            break;
+        case MCO_INSTRUMENT_ASIAN:
+            out->params.asian.num_observations = (uint64_t)VALUE(FIELD_NUM_OBSERVATIONS);
+            break;
+        case MCO_INSTRUMENT_BARRIER:
+            out->params.barrier.barrier_level = VALUE(FIELD_BARRIER_LEVEL);
+            out->params.barrier.barrier_type = (int)VALUE(FIELD_BARRIER_TYPE);
+            out->params.barrier.rebate = VALUE(FIELD_REBATE);
+            out->params.barrier.continuous = VALUE(FIELD_CONTINUOUS) != 0.0;
+            break;
+        case MCO_INSTRUMENT_LOOKBACK:
+            out->params.lookback.fixed_strike = VALUE(FIELD_FIXED_STRIKE) != 0.0;
+            out->params.lookback.continuous = VALUE(FIELD_CONTINUOUS) != 0.0;
+            break;
+        case MCO_INSTRUMENT_DOUBLE_BARRIER:
+            out->params.double_barrier.lower_barrier = VALUE(FIELD_LOWER_BARRIER);
+            out->params.double_barrier.upper_barrier = VALUE(FIELD_UPPER_BARRIER);
+            out->params.double_barrier.knock_in = VALUE(FIELD_KNOCK_IN) != 0.0;
+            out->params.double_barrier.rebate = VALUE(FIELD_REBATE);
+            break;
+        case MCO_INSTRUMENT_WINDOW_BARRIER:
+            out->params.window_barrier.barrier_level = VALUE(FIELD_BARRIER_LEVEL);
+            out->params.window_barrier.barrier_type = (int)VALUE(FIELD_BARRIER_TYPE);
+            out->params.window_barrier.window_start = VALUE(FIELD_WINDOW_START);
+            out->params.window_barrier.window_end = VALUE(FIELD_WINDOW_END);
+            out->params.window_barrier.rebate = VALUE(FIELD_REBATE);
+            break;
+        case MCO_INSTRUMENT_PARISIAN:
+            out->params.parisian.barrier_level = VALUE(FIELD_BARRIER_LEVEL);
+            out->params.parisian.barrier_type = (int)VALUE(FIELD_BARRIER_TYPE);
+            out->params.parisian.window = VALUE(FIELD_EXCURSION_WINDOW);
+            out->params.parisian.rebate = VALUE(FIELD_REBATE);
+            break;
+        case MCO_INSTRUMENT_FORWARD_START:
+            out->params.forward_start.start_time = VALUE(FIELD_START_TIME);
+            break;
+        default:
+            /* Bermudan, autocallable and cliquet need date schedules: the
+               library rejects them with MCO_ERROR_INVALID_ARGUMENT */
+            break;
+    }
+#undef VALUE
+}
+
+/* ========================================================================== */
+/* Settings                                                                   */
+/* ========================================================================== */
+
+typedef struct {
+    unsigned long long num_simulations;  /* 0 = library default */
+    unsigned long long num_steps;
+    unsigned long long num_threads;      /* 0 = every CPU */
+    unsigned long long seed;
+    int has_seed;
+    int antithetic;
+    int control_variates;
+    int stratified_sampling;
+    int reproducible;
+    int greeks;
+} settings_t;
+
+/* Returns 1 if `name` is a setting (parsed into `settings`), 0 if not, -1 on error */
+static int parse_setting(settings_t* settings, const char* name, PyObject* value) {
+    unsigned long long* count = NULL;
+    int* flag = NULL;
+    if (strcmp(name, "num_simulations") == 0) count = &settings->num_simulations;
+    else if (strcmp(name, "num_steps") == 0) count = &settings->num_steps;
+    else if (strcmp(name, "num_threads") == 0) count = &settings->num_threads;
+    else if (strcmp(name, "seed") == 0) count = &settings->seed;
+    else if (strcmp(name, "antithetic") == 0) flag = &settings->antithetic;
+    else if (strcmp(name, "control_variates") == 0) flag = &settings->control_variates;
+    else if (strcmp(name, "stratified_sampling") == 0) flag = &settings->stratified_sampling;
+    else if (strcmp(name, "reproducible") == 0) flag = &settings->reproducible;
+    else if (strcmp(name, "greeks") == 0) flag = &settings->greeks;
+    else return 0;
+
+    if (flag) {
+        int truth = PyObject_IsTrue(value);
+        if (truth < 0) return -1;
+        *flag = truth;
+        return 1;
+    }
+    if (count == &settings->seed && value == Py_None) return 1;
+    *count = PyLong_AsUnsignedLongLong(value);
+    if (PyErr_Occurred()) return -1;
+    if (count == &settings->seed) settings->has_seed = 1;
+    return 1;
+}
+
+static mco_context_t* make_context(const settings_t* settings) {
+    mco_context_t* ctx = mco_context_new();
+    if (settings->num_simulations > 0) mco_context_set_num_simulations(ctx, settings->num_simulations);
+    if (settings->num_steps > 0) mco_context_set_num_steps(ctx, settings->num_steps);
+    if (settings->has_seed) mco_context_set_seed(ctx, settings->seed);
+    mco_context_set_num_threads(ctx, (size_t)settings->num_threads);
+    mco_context_set_antithetic(ctx, settings->antithetic);
+    mco_context_set_control_variates(ctx, settings->control_variates);
+    mco_context_set_stratified_sampling(ctx, settings->stratified_sampling);
+    mco_context_set_reproducible(ctx, settings->reproducible);
+    return ctx;
+}
+
+/* ========================================================================== */
+/* Results                                                                    */
+/* ========================================================================== */
+
+/* Adds a writable memoryview of `count` items of `format` to `dict` and
+   returns its memory, or NULL with an exception set */
+static void* add_result_column(PyObject* dict, const char* name, const char* format,
+                               size_t item_size, Py_ssize_t count) {
+    PyObject* bytes = PyByteArray_FromStringAndSize(NULL, count * (Py_ssize_t)item_size);
+    if (!bytes) return NULL;
+    PyObject* raw = PyMemoryView_FromObject(bytes);
+    void* data = PyByteArray_AS_STRING(bytes);
+    Py_DECREF(bytes);  /* The memoryview keeps the bytearray alive */
+    if (!raw) return NULL;
+    PyObject* typed = PyObject_CallMethod(raw, "cast", "s", format);
+    Py_DECREF(raw);
+    if (!typed) return NULL;
+    int failed = PyDict_SetItemString(dict, name, typed);
+    Py_DECREF(typed);
+    return failed ? NULL : data;
+}
+
+/* ========================================================================== */
+/* price()                                                                    */
+/* ========================================================================== */
+
+PyDoc_STRVAR(price_doc,
+"price(**fields_and_settings) -> dict\n"
+"\n"
+"Price a batch of instruments in one library call, without the GIL.\n"
+"\n"
+"Instrument fields (scalar or 1-D buffer, one row per instrument):\n"
+"  kind, option_type, method, spot, strike, rate, volatility,\n"
+"  time_to_maturity, tolerance, num_exercise_points, num_observations,\n"
+"  barrier_level, barrier_type, rebate, continuous, fixed_strike,\n"
+"  lower_barrier, upper_barrier, knock_in, window_start, window_end,\n"
+"  excursion_window, start_time\n"
+"Unset fields are 0, except tolerance which is 0.01. Kinds needing date\n"
+"schedules (Bermudan, autocallable, cliquet) are not supported and report\n"
+"MCO_ERROR_INVALID_ARGUMENT.\n"
+"\n"
+"Settings: num_simulations, num_steps, seed, num_threads (default 1, 0 = all\n"
+"CPUs), antithetic, control_variates, stratified_sampling, reproducible,\n"
+"greeks (bump-and-reprice delta, gamma, vega, rho on common random numbers).\n"
+"\n"
+"Returns memoryviews keyed price, error_estimate, method, num_paths, status\n"
+"and, with greeks=True, delta, gamma, vega, rho.");
+
+static PyObject* mco_py_price(PyObject* self, PyObject* args, PyObject* kwargs) {
+    (void)self;
+    if (PyTuple_GET_SIZE(args) != 0) {
+        PyErr_SetString(PyExc_TypeError, "price() takes keyword arguments only");
+        return NULL;
+    }
+
+    column_t columns[NUM_FIELDS];
+    memset(columns, 0, sizeof(columns));
+    columns[FIELD_TOLERANCE].scalar = 0.01;
+    settings_t settings;
+    memset(&settings, 0, sizeof(settings));
+    settings.num_threads = 1;
+    PyObject* out = NULL;
+    mco_instrument_t* instruments = NULL;
+    mco_price_result_t* results = NULL;
+    mco_greeks_t* greeks = NULL;
+
+    /* Rows: the common length of the buffer columns, 1 if all are scalars */
+    Py_ssize_t rows = -1;
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos = 0;
+    while (kwargs && PyDict_Next(kwargs, &pos, &key, &value)) {
+        const char* name = PyUnicode_AsUTF8(key);
+        if (!name) goto done;
+        int setting = parse_setting(&settings, name, value);
+        if (setting < 0) goto done;
+        if (setting) continue;
+
+        int field = 0;
+        while (field < NUM_FIELDS && strcmp(field_names[field], name) != 0) field++;
+        if (field == NUM_FIELDS) {
+            PyErr_Format(PyExc_TypeError, "price() got an unexpected keyword argument '%s'", name);
+            goto done;
+        }
+        if (column_from_object(&columns[field], name, value) < 0) goto done;
+        if (columns[field].has_view) {
+            Py_ssize_t length = columns[field].view.shape[0];
+            if (rows >= 0 && length != rows) {
+                PyErr_Format(PyExc_ValueError, "%s has %zd rows, expected %zd", name, length, rows);
+                goto done;
+            }
+            rows = length;
+        }
+    }
+    if (rows < 0) rows = 1;
+
+    out = PyDict_New();
+    if (!out) goto done;
+    double* prices = add_result_column(out, "price", "d", sizeof(double), rows);
+    double* errors = prices ? add_result_column(out, "error_estimate", "d", sizeof(double), rows) : NULL;
+    int* methods = errors ? add_result_column(out, "method", "i", sizeof(int), rows) : NULL;
+    unsigned long long* paths =
+        methods ? add_result_column(out, "num_paths", "Q", sizeof(unsigned long long), rows) : NULL;
+    int* statuses = paths ? add_result_column(out, "status", "i", sizeof(int), rows) : NULL;
+    if (!statuses) goto fail;
+
+    double* greek_columns[4] = {NULL, NULL, NULL, NULL};
+    if (settings.greeks) {
+        static const char* const greek_names[4] = {"delta", "gamma", "vega", "rho"};
+        for (int g = 0; g < 4; ++g) {
+            greek_columns[g] = add_result_column(out, greek_names[g], "d", sizeof(double), rows);
+            if (!greek_columns[g]) goto fail;
+        }
+    }
+
+    size_t count = (size_t)rows;
+    instruments = malloc((count ? count : 1) * sizeof(mco_instrument_t));
+    results = malloc((count ? count : 1) * sizeof(mco_price_result_t));
+    greeks = settings.greeks ? malloc((count ? count : 1) * sizeof(mco_greeks_t)) : NULL;
+    if (!instruments || !results || (settings.greeks && !greeks)) {
+        PyErr_NoMemory();
+        goto fail;
+    }
+
+    /* Buffers stay exported, and the result memory is not shared yet, so
+       everything below runs without the GIL */
+    Py_BEGIN_ALLOW_THREADS
+    for (size_t i = 0; i < count; ++i) fill_instrument(columns, (Py_ssize_t)i, &instruments[i]);
+
+    mco_context_t* ctx = make_context(&settings);
+    if (settings.greeks) {
+        mco_price_instruments_greeks(ctx, instruments, count, results, greeks);
+    } else {
+        mco_price_instruments(ctx, instruments, count, results);
+    }
+    mco_context_free(ctx);
+
+    for (size_t i = 0; i < count; ++i) {
+        int ok = results[i].status == MCO_OK;
+        prices[i] = ok ? results[i].price : NAN;
+        errors[i] = ok ? results[i].error_estimate : NAN;
+        methods[i] = ok ? results[i].method : -1;
+        paths[i] = ok ? results[i].num_paths : 0;
+        statuses[i] = results[i].status;
+        if (settings.greeks) {
+            greek_columns[0][i] = greeks[i].delta;
+            greek_columns[1][i] = greeks[i].gamma;
+            greek_columns[2][i] = greeks[i].vega;
+            greek_columns[3][i] = greeks[i].rho;
+        }
+    }
+    Py_END_ALLOW_THREADS
+    goto done;
+
+fail:
+    Py_CLEAR(out);
+done:
+    free(instruments);
+    free(results);
+    free(greeks);
+    release_columns(columns);
+    return out;
+}
+
+/* ========================================================================== */
+/* Module                                                                     */
+/* ========================================================================== */
+
+static PyMethodDef mco_py_methods[] = {
+    {"price", (PyCFunction)(void (*)(void))mco_py_price, METH_VARARGS | METH_KEYWORDS, price_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef mco_py_module = {
+    PyModuleDef_HEAD_INIT,
+    "mcoptions",
+    "Batch option pricing over NumPy arrays and other buffers",
+    -1,
+    mco_py_methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_mcoptions(void) {
+    PyObject* module = PyModule_Create(&mco_py_module);
+    if (!module) return NULL;
+
+    static const struct { const char* name; int value; } constants[] = {
+        {"EUROPEAN", MCO_INSTRUMENT_EUROPEAN},
+        {"AMERICAN", MCO_INSTRUMENT_AMERICAN},
+        {"ASIAN", MCO_INSTRUMENT_ASIAN},
+        {"BARRIER", MCO_INSTRUMENT_BARRIER},
+        {"LOOKBACK", MCO_INSTRUMENT_LOOKBACK},
+        {"DOUBLE_BARRIER", MCO_INSTRUMENT_DOUBLE_BARRIER},
+        {"WINDOW_BARRIER", MCO_INSTRUMENT_WINDOW_BARRIER},
+        {"PARISIAN", MCO_INSTRUMENT_PARISIAN},
+        {"FORWARD_START", MCO_INSTRUMENT_FORWARD_START},
+        {"CALL", MCO_CALL},
+        {"PUT", MCO_PUT},
+        {"AUTO", MCO_METHOD_AUTO},
+        {"ANALYTIC", MCO_METHOD_ANALYTIC},
+        {"BINOMIAL_TREE", MCO_METHOD_BINOMIAL_TREE},
+        {"MONTE_CARLO", MCO_METHOD_MONTE_CARLO},
+        {"LSM", MCO_METHOD_LSM},
+        {"OK", MCO_OK},
+        {"ERROR_INVALID_ARGUMENT", MCO_ERROR_INVALID_ARGUMENT},
+        {"ERROR_UNSUPPORTED", MCO_ERROR_UNSUPPORTED},
+        {"ERROR_INTERNAL", MCO_ERROR_INTERNAL},
+    };
+    for (size_t i = 0; i < sizeof(constants) / sizeof(constants[0]); ++i) {
+        if (PyModule_AddIntConstant(module, constants[i].name, constants[i].value) < 0) {
+            Py_DECREF(module);
+            return NULL;
+        }
+    }
+    return module;
+}
@@ -0,0 +1,28 @@
+"""Builds the mcoptions extension against lib/build/libmcoptions.so.
+
+    python3 setup.py build_ext --inplace
+
+The module finds the library through its run path, so lib/build must hold
+libmcoptions.so when it is imported.
+"""
+import os
+from setuptools import Extension, setup
+
+here = os.path.dirname(os.path.abspath(__file__))
+lib = os.path.dirname(here)
+
+setup(
+    name="mcoptions",
+    version="1.0",
+    ext_modules=[
+        Extension(
+            "mcoptions",
+            sources=[os.path.join(here, "mcoptions_module.c")],
+            include_dirs=[os.path.join(lib, "include")],
+            library_dirs=[os.path.join(lib, "build")],
+            libraries=["mcoptions"],
+            runtime_library_dirs=["$ORIGIN/../build"],
+            extra_compile_args=["-std=c11", "-Wall", "-Wextra"],
+        )
+    ],
+)
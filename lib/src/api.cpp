@@ -1,5 +1,8 @@
 #include "mcoptions.h"
 #include "internal/context.hpp"
+#include "internal/engine/parallel.hpp"
+#include "internal/engine/topology.hpp"
+#include "internal/inverse_normal.hpp"
 #include "internal/methods/least_squares_monte_carlo.hpp"
 #include "internal/instruments/european_option.hpp"
 #include "internal/instruments/asian_option.hpp"
@@ -7,8 +10,24 @@
 #include "internal/instruments/bermudan_option.hpp"
 #include "internal/instruments/barrier_option.hpp"
 #include "internal/instruments/lookback_option.hpp"
+#include "internal/instruments/double_barrier_option.hpp"
+#include "internal/instruments/window_barrier_option.hpp"
+#include "internal/instruments/parisian_option.hpp"
+#include "internal/instruments/autocallable_note.hpp"
+#include "internal/instruments/forward_start_option.hpp"
+#include "internal/instruments/cliquet_option.hpp"
 #include "internal/instruments/instrument.hpp"
+#include "internal/instruments/instrument_descriptor.hpp"
+#include "internal/methods/analytic_exotics.hpp"
 #include "internal/methods/binomial_tree.hpp"
+#include "internal/methods/chebyshev_proxy.hpp"
+#include "internal/methods/method_selector.hpp"
+#include "internal/methods/pricing_plan.hpp"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 using namespace mcoptions;
 
@@ -26,6 +45,11 @@ void mco_context_set_seed(mco_context_t* ctx, uint64_t seed) {
     context->set_seed(seed);
 }
 
+uint64_t mco_context_get_seed(mco_context_t* ctx) {
+    Context* context = reinterpret_cast<Context*>(ctx);
+    return context->get_seed();
+}
+
 void mco_context_set_num_simulations(mco_context_t* ctx, uint64_t n) {
     Context* context = reinterpret_cast<Context*>(ctx);
     context->set_num_simulations(n);
@@ -57,6 +81,31 @@ void mco_context_set_stratified_sampling(mco_context_t* ctx, int enabled) {
     context->set_stratified_sampling(enabled != 0);
 }
 
+// Normal Sampling
+int mco_context_set_normal_method(mco_context_t* ctx, int method) {
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    switch (method) {
+        case MCO_NORMAL_BOX_MULLER:
+            context->set_normal_method(NormalMethod::BoxMuller);
+            break;
+        case MCO_NORMAL_ZIGGURAT:
+            context->set_normal_method(NormalMethod::Ziggurat);
+            break;
+        default:
+            return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    return MCO_OK;
+}
+
+int mco_inverse_normal_cdf(const double* probabilities, size_t count,
+                           int refine, double* normals) {
+    if (count == 0) return MCO_OK;
+    if (!probabilities || !normals) return MCO_ERROR_INVALID_ARGUMENT;
+    inverse_normal_cdfs(probabilities, normals, count, refine != 0);
+    return MCO_OK;
+}
+
 // Model Selection
 void mco_context_set_model(mco_context_t* ctx, int model) {
     Context* context = reinterpret_cast<Context*>(ctx);
@@ -92,7 +141,11 @@ double mco_asian_arithmetic_call(mco_context_t* ctx, double spot, double strike,
     Context* context = reinterpret_cast<Context*>(ctx);
     AsianOptionData option{spot, strike, rate, volatility, time_to_maturity, 
                           OptionType::Call, num_observations};
-    return price_asian_option(*context, option);
+    try {
+        return price_asian_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
 }
 
 double mco_asian_arithmetic_put(mco_context_t* ctx, double spot, double strike,
@@ -101,7 +154,11 @@ double mco_asian_arithmetic_put(mco_context_t* ctx, double spot, double strike,
     Context* context = reinterpret_cast<Context*>(ctx);
     AsianOptionData option{spot, strike, rate, volatility, time_to_maturity,
                           OptionType::Put, num_observations};
-    return price_asian_option(*context, option);
+    try {
+        return price_asian_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
 }
 
 // American Options
@@ -127,11 +184,16 @@ double mco_american_put(mco_context_t* ctx, double spot, double strike,
 double mco_bermudan_call(mco_context_t* ctx, double spot, double strike, 
                          double rate, double volatility, 
                          const double* exercise_dates, size_t num_dates) {
+    if (!exercise_dates || num_dates == 0) return -1.0;
     Context* context = reinterpret_cast<Context*>(ctx);
     std::vector<double> ex_dates(exercise_dates, exercise_dates + num_dates);
     BermudanOptionData option{spot, strike, rate, volatility, ex_dates.back(),
                              OptionType::Call, ex_dates};
-    return price_bermudan_option(*context, option);
+    try {
+        return price_bermudan_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
 }
 
 // Barrier Options
@@ -159,11 +221,16 @@ double mco_lookback_call(mco_context_t* ctx, double spot, double strike,
 double mco_bermudan_put(mco_context_t* ctx, double spot, double strike, 
                         double rate, double volatility, 
                         const double* exercise_dates, size_t num_dates) {
+    if (!exercise_dates || num_dates == 0) return -1.0;
     Context* context = reinterpret_cast<Context*>(ctx);
     std::vector<double> ex_dates(exercise_dates, exercise_dates + num_dates);
     BermudanOptionData option{spot, strike, rate, volatility, ex_dates.back(),
                              OptionType::Put, ex_dates};
-    return price_bermudan_option(*context, option);
+    try {
+        return price_bermudan_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
 }
 
 // Barrier Put
@@ -187,6 +254,134 @@ double mco_lookback_put(mco_context_t* ctx, double spot, double strike,
     return price_lookback_option(*context, option);
 }
 
+// Double, Window and Parisian Barriers
+double mco_double_barrier_call(mco_context_t* ctx, double spot, double strike,
+                               double rate, double volatility, double time_to_maturity,
+                               double lower_barrier, double upper_barrier,
+                               int knock_in, double rebate) {
+    if (!ctx) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    DoubleBarrierOptionData option{spot, strike, rate, volatility, time_to_maturity,
+                                   OptionType::Call, lower_barrier, upper_barrier, knock_in != 0, rebate};
+    try {
+        return price_double_barrier_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_double_barrier_put(mco_context_t* ctx, double spot, double strike,
+                              double rate, double volatility, double time_to_maturity,
+                              double lower_barrier, double upper_barrier,
+                              int knock_in, double rebate) {
+    if (!ctx) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    DoubleBarrierOptionData option{spot, strike, rate, volatility, time_to_maturity,
+                                   OptionType::Put, lower_barrier, upper_barrier, knock_in != 0, rebate};
+    try {
+        return price_double_barrier_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_window_barrier_call(mco_context_t* ctx, double spot, double strike,
+                               double rate, double volatility, double time_to_maturity,
+                               double barrier_level, int barrier_type,
+                               double window_start, double window_end, double rebate) {
+    if (!ctx) return -1.0;
+    if (barrier_type < 0 || barrier_type > 3) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    WindowBarrierOptionData option{spot, strike, rate, volatility, time_to_maturity,
+                                   OptionType::Call, barrier_level, static_cast<BarrierType>(barrier_type),
+                                   window_start, window_end, rebate};
+    try {
+        return price_window_barrier_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_window_barrier_put(mco_context_t* ctx, double spot, double strike,
+                              double rate, double volatility, double time_to_maturity,
+                              double barrier_level, int barrier_type,
+                              double window_start, double window_end, double rebate) {
+    if (!ctx) return -1.0;
+    if (barrier_type < 0 || barrier_type > 3) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    WindowBarrierOptionData option{spot, strike, rate, volatility, time_to_maturity,
+                                   OptionType::Put, barrier_level, static_cast<BarrierType>(barrier_type),
+                                   window_start, window_end, rebate};
+    try {
+        return price_window_barrier_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_parisian_call(mco_context_t* ctx, double spot, double strike,
+                         double rate, double volatility, double time_to_maturity,
+                         double barrier_level, int barrier_type,
+                         double window, double rebate) {
+    if (!ctx) return -1.0;
+    if (barrier_type < 0 || barrier_type > 3) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    ParisianOptionData option{spot, strike, rate, volatility, time_to_maturity,
+                              OptionType::Call, barrier_level, static_cast<BarrierType>(barrier_type),
+                              window, rebate};
+    try {
+        return price_parisian_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_parisian_put(mco_context_t* ctx, double spot, double strike,
+                        double rate, double volatility, double time_to_maturity,
+                        double barrier_level, int barrier_type,
+                        double window, double rebate) {
+    if (!ctx) return -1.0;
+    if (barrier_type < 0 || barrier_type > 3) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    ParisianOptionData option{spot, strike, rate, volatility, time_to_maturity,
+                              OptionType::Put, barrier_level, static_cast<BarrierType>(barrier_type),
+                              window, rebate};
+    try {
+        return price_parisian_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+// Forward-Start Options
+double mco_forward_start_call(mco_context_t* ctx, double spot, double strike_ratio,
+                              double rate, double volatility,
+                              double start_time, double time_to_maturity) {
+    if (!ctx) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    ForwardStartOptionData option{spot, strike_ratio, rate, volatility,
+                                  start_time, time_to_maturity, OptionType::Call};
+    try {
+        return price_forward_start_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_forward_start_put(mco_context_t* ctx, double spot, double strike_ratio,
+                             double rate, double volatility,
+                             double start_time, double time_to_maturity) {
+    if (!ctx) return -1.0;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    ForwardStartOptionData option{spot, strike_ratio, rate, volatility,
+                                  start_time, time_to_maturity, OptionType::Put};
+    try {
+        return price_forward_start_option(*context, option);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
 // Finite Difference Method (STUB)
 double mco_european_call_fdm(mco_context_t* ctx, double spot, double strike,
                              double rate, double volatility, double time_to_maturity) {
@@ -398,3 +593,788 @@ double mco_lsm_american_put_default(
 ) {
     return mco_lsm_american_put(ctx, spot, strike, rate, volatility, time_to_maturity, 50);
 }
+
+// ============================================================================
+// Automatic Method Selection
+// ============================================================================
+
+namespace {
+
+void fill_price_result(const PricingResult& in, mco_price_result_t* out) {
+    out->price = in.price;
+    out->error_estimate = in.error_estimate;
+    out->method = static_cast<int>(in.method);
+    out->num_paths = in.num_paths;
+    out->num_steps = in.num_steps;
+    out->status = MCO_OK;
+}
+
+AutocallableTerms to_autocallable_terms(const mco_autocallable_terms_t& in) {
+    if (!in.observation_dates && in.num_observations > 0) {
+        throw std::invalid_argument("Missing observation dates");
+    }
+    AutocallableTerms out;
+    out.notional = in.notional;
+    out.autocall_barrier = in.autocall_barrier;
+    out.coupon_barrier = in.coupon_barrier;
+    out.coupon_rate = in.coupon_rate;
+    out.memory = in.memory != 0;
+    out.knock_in_barrier = in.knock_in_barrier;
+    out.put_strike = in.put_strike;
+    out.observation_dates.assign(in.observation_dates, in.observation_dates + in.num_observations);
+    return out;
+}
+
+CliquetOptionData to_cliquet_data(const mco_cliquet_params_t& in, double rate, double volatility) {
+    if (!in.reset_dates && in.num_resets > 0) {
+        throw std::invalid_argument("Missing reset dates");
+    }
+    CliquetOptionData out;
+    out.rate = rate;
+    out.volatility = volatility;
+    out.reset_dates.assign(in.reset_dates, in.reset_dates + in.num_resets);
+    out.local_floor = in.local_floor;
+    out.local_cap = in.local_cap;
+    out.global_floor = in.global_floor;
+    out.global_cap = in.global_cap;
+    out.notional = in.notional;
+    return out;
+}
+
+InstrumentDescriptor to_descriptor(const mco_instrument_t& in) {
+    if (in.kind < MCO_INSTRUMENT_EUROPEAN || in.kind > MCO_INSTRUMENT_CLIQUET) {
+        throw std::invalid_argument("Unknown instrument kind");
+    }
+    if (in.option_type != MCO_CALL && in.option_type != MCO_PUT) {
+        throw std::invalid_argument("Unknown option type");
+    }
+    if (in.method < MCO_METHOD_AUTO || in.method > MCO_METHOD_LSM) {
+        throw std::invalid_argument("Unknown pricing method");
+    }
+
+    InstrumentDescriptor out{};
+    out.kind = static_cast<InstrumentKind>(in.kind);
+    out.option = OptionData{in.spot, in.strike, in.rate, in.volatility, in.time_to_maturity,
+                            in.option_type == MCO_CALL ? OptionType::Call : OptionType::Put};
+    out.method = static_cast<PricingMethod>(in.method);
+    out.tolerance = in.tolerance;
+
+    switch (in.kind) {
+        case MCO_INSTRUMENT_AMERICAN:
+            out.num_exercise_points = in.params.american.num_exercise_points;
+            break;
+        case MCO_INSTRUMENT_ASIAN:
+            out.num_observations = in.params.asian.num_observations;
+            break;
+        case MCO_INSTRUMENT_BARRIER:
+            if (in.params.barrier.barrier_type < 0 || in.params.barrier.barrier_type > 3) {
+                throw std::invalid_argument("Unknown barrier type");
+            }
+            out.barrier_level = in.params.barrier.barrier_level;
+            out.barrier_type = static_cast<BarrierType>(in.params.barrier.barrier_type);
+            out.rebate = in.params.barrier.rebate;
+            out.continuous_monitoring = in.params.barrier.continuous != 0;
+            break;
+        case MCO_INSTRUMENT_LOOKBACK:
+            out.fixed_strike = in.params.lookback.fixed_strike != 0;
+            out.continuous_monitoring = in.params.lookback.continuous != 0;
+            break;
+        case MCO_INSTRUMENT_BERMUDAN:
+            if (!in.params.bermudan.exercise_dates && in.params.bermudan.num_dates > 0) {
+                throw std::invalid_argument("Missing exercise dates");
+            }
+            out.exercise_dates.assign(in.params.bermudan.exercise_dates,
+                                      in.params.bermudan.exercise_dates + in.params.bermudan.num_dates);
+            break;
+        case MCO_INSTRUMENT_DOUBLE_BARRIER:
+            out.lower_barrier = in.params.double_barrier.lower_barrier;
+            out.upper_barrier = in.params.double_barrier.upper_barrier;
+            out.knock_in = in.params.double_barrier.knock_in != 0;
+            out.rebate = in.params.double_barrier.rebate;
+            break;
+        case MCO_INSTRUMENT_WINDOW_BARRIER:
+            if (in.params.window_barrier.barrier_type < 0 || in.params.window_barrier.barrier_type > 3) {
+                throw std::invalid_argument("Unknown barrier type");
+            }
+            out.barrier_level = in.params.window_barrier.barrier_level;
+            out.barrier_type = static_cast<BarrierType>(in.params.window_barrier.barrier_type);
+            out.window_start = in.params.window_barrier.window_start;
+            out.window_end = in.params.window_barrier.window_end;
+            out.rebate = in.params.window_barrier.rebate;
+            break;
+        case MCO_INSTRUMENT_PARISIAN:
+            if (in.params.parisian.barrier_type < 0 || in.params.parisian.barrier_type > 3) {
+                throw std::invalid_argument("Unknown barrier type");
+            }
+            out.barrier_level = in.params.parisian.barrier_level;
+            out.barrier_type = static_cast<BarrierType>(in.params.parisian.barrier_type);
+            out.excursion_window = in.params.parisian.window;
+            out.rebate = in.params.parisian.rebate;
+            break;
+        case MCO_INSTRUMENT_AUTOCALLABLE:
+            out.autocallable = to_autocallable_terms(in.params.autocallable);
+            break;
+        case MCO_INSTRUMENT_FORWARD_START:
+            out.start_time = in.params.forward_start.start_time;
+            break;
+        case MCO_INSTRUMENT_CLIQUET:
+            out.cliquet = to_cliquet_data(in.params.cliquet, in.rate, in.volatility);
+            break;
+        default:
+            break;
+    }
+    return out;
+}
+
+int price_instrument_checked(Context& ctx, const mco_instrument_t& instrument,
+                             mco_price_result_t* result) {
+    int status = MCO_OK;
+    try {
+        fill_price_result(price_instrument(ctx, to_descriptor(instrument)), result);
+    } catch (const std::invalid_argument&) {
+        status = MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::domain_error&) {
+        status = MCO_ERROR_UNSUPPORTED;
+    } catch (const std::exception&) {
+        status = MCO_ERROR_INTERNAL;
+    }
+    result->status = status;
+    return status;
+}
+
+} // anonymous namespace
+
+int mco_price(
+    mco_context_t* ctx,
+    int exercise_style,
+    int option_type,
+    double spot,
+    double strike,
+    double rate,
+    double volatility,
+    double time_to_maturity,
+    double tolerance,
+    mco_price_result_t* result
+) {
+    if (!result) return MCO_ERROR_INVALID_ARGUMENT;
+    result->status = MCO_ERROR_INVALID_ARGUMENT;
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    if (exercise_style != MCO_EXERCISE_EUROPEAN && exercise_style != MCO_EXERCISE_AMERICAN) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    if (option_type != MCO_CALL && option_type != MCO_PUT) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    
+    Context* context = reinterpret_cast<Context*>(ctx);
+    
+    OptionData option{spot, strike, rate, volatility, time_to_maturity,
+                      option_type == MCO_CALL ? OptionType::Call : OptionType::Put};
+    ExerciseStyle style = exercise_style == MCO_EXERCISE_EUROPEAN
+        ? ExerciseStyle::European : ExerciseStyle::American;
+    
+    try {
+        fill_price_result(price_auto(*context, option, style, tolerance), result);
+    } catch (const std::invalid_argument&) {
+        result->status = MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        result->status = MCO_ERROR_INTERNAL;
+    }
+    
+    return result->status;
+}
+
+int mco_price_instrument(
+    mco_context_t* ctx,
+    const mco_instrument_t* instrument,
+    mco_price_result_t* result
+) {
+    if (!result) return MCO_ERROR_INVALID_ARGUMENT;
+    result->status = MCO_ERROR_INVALID_ARGUMENT;
+    if (!ctx || !instrument) return MCO_ERROR_INVALID_ARGUMENT;
+    
+    Context* context = reinterpret_cast<Context*>(ctx);
+    return price_instrument_checked(*context, *instrument, result);
+}
+
+int mco_price_instruments(
+    mco_context_t* ctx,
+    const mco_instrument_t* instruments,
+    size_t count,
+    mco_price_result_t* results
+) {
+    return mco_price_instruments_from(ctx, instruments, count, 0, results);
+}
+
+int mco_price_instruments_from(
+    mco_context_t* ctx,
+    const mco_instrument_t* instruments,
+    size_t count,
+    size_t first_index,
+    mco_price_result_t* results
+) {
+    if (!ctx || (count > 0 && (!instruments || !results))) return MCO_ERROR_INVALID_ARGUMENT;
+    
+    Context* context = reinterpret_cast<Context*>(ctx);
+    
+    std::vector<int> statuses(count);
+    if (context->get_stream_mode() == Context::StreamMode::Sequential) {
+        if (first_index > 0) {
+            for (size_t i = 0; i < count; ++i) results[i].status = MCO_ERROR_UNSUPPORTED;
+            return MCO_ERROR_UNSUPPORTED;
+        }
+        // One after the other on the context's sequence, as the serial library
+        // did; each instrument still splits its own paths
+        for (size_t i = 0; i < count; ++i) {
+            statuses[i] = price_instrument_checked(*context, instruments[i], &results[i]);
+        }
+    } else {
+        // Instruments are tasks of the engine and may fork their own path blocks;
+        // each one draws from its own stream so the batch does not share an RNG
+        uint64_t batch_key = context->next_stream_key();
+        parallel_for(*context, count, [&](size_t i) {
+            Context local = *context;
+            local.set_seed(block_rng(batch_key, first_index + i)());
+            statuses[i] = price_instrument_checked(local, instruments[i], &results[i]);
+        });
+    }
+    
+    for (int status : statuses) {
+        if (status != MCO_OK) return status;
+    }
+    return MCO_OK;
+}
+
+// ============================================================================
+// Prepared Pricing Plans
+// ============================================================================
+
+int mco_plan_prepare(mco_context_t* ctx, const mco_instrument_t* instrument, mco_plan_t** plan) {
+    if (!plan) return MCO_ERROR_INVALID_ARGUMENT;
+    *plan = nullptr;
+    if (!ctx || !instrument) return MCO_ERROR_INVALID_ARGUMENT;
+
+    Context* context = reinterpret_cast<Context*>(ctx);
+    try {
+        *plan = reinterpret_cast<mco_plan_t*>(new PricingPlan(*context, to_descriptor(*instrument)));
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+int mco_plan_execute(mco_plan_t* plan, const mco_market_t* market, mco_price_result_t* result) {
+    if (!result) return MCO_ERROR_INVALID_ARGUMENT;
+    result->status = MCO_ERROR_INVALID_ARGUMENT;
+    if (!plan || !market) return MCO_ERROR_INVALID_ARGUMENT;
+
+    int status = MCO_OK;
+    try {
+        fill_price_result(reinterpret_cast<PricingPlan*>(plan)->execute(
+            MarketInputs{market->spot, market->rate, market->volatility}), result);
+    } catch (const std::invalid_argument&) {
+        status = MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::domain_error&) {
+        status = MCO_ERROR_UNSUPPORTED;
+    } catch (const std::exception&) {
+        status = MCO_ERROR_INTERNAL;
+    }
+    result->status = status;
+    return status;
+}
+
+void mco_plan_free(mco_plan_t* plan) {
+    delete reinterpret_cast<PricingPlan*>(plan);
+}
+
+int mco_plan_set_reweighting(mco_plan_t* plan, double min_effective_fraction) {
+    if (!plan) return MCO_ERROR_INVALID_ARGUMENT;
+    try {
+        reinterpret_cast<PricingPlan*>(plan)->set_reweighting(min_effective_fraction);
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    return MCO_OK;
+}
+
+int mco_plan_get_stats(const mco_plan_t* plan, mco_plan_stats_t* stats) {
+    if (!plan || !stats) return MCO_ERROR_INVALID_ARGUMENT;
+    const PlanStats& plan_stats = reinterpret_cast<const PricingPlan*>(plan)->stats();
+    stats->reweighted = plan_stats.reweighted ? 1 : 0;
+    stats->effective_sample_size = plan_stats.effective_sample_size;
+    stats->simulations = plan_stats.simulations;
+    return MCO_OK;
+}
+
+int mco_price_instruments_greeks(
+    mco_context_t* ctx,
+    const mco_instrument_t* instruments,
+    size_t count,
+    mco_price_result_t* results,
+    mco_greeks_t* greeks
+) {
+    if (!ctx || (count > 0 && (!instruments || !results || !greeks))) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+
+    Context* context = reinterpret_cast<Context*>(ctx);
+    std::vector<int> statuses(count);
+    uint64_t batch_key = context->next_stream_key();
+    parallel_for(*context, count, [&](size_t i) {
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        greeks[i] = mco_greeks_t{nan, nan, nan, nan};
+        int status = MCO_OK;
+        try {
+            Context local = *context;
+            local.set_seed(block_rng(batch_key, i)());
+            PricingPlan plan(local, to_descriptor(instruments[i]));
+            MarketInputs market{instruments[i].spot, instruments[i].rate, instruments[i].volatility};
+            PricingResult base = plan.execute(market);
+            Greeks g = plan_greeks(plan, market, base.price);
+            fill_price_result(base, &results[i]);
+            greeks[i] = mco_greeks_t{g.delta, g.gamma, g.vega, g.rho};
+        } catch (const std::invalid_argument&) {
+            status = MCO_ERROR_INVALID_ARGUMENT;
+        } catch (const std::domain_error&) {
+            status = MCO_ERROR_UNSUPPORTED;
+        } catch (const std::exception&) {
+            status = MCO_ERROR_INTERNAL;
+        }
+        results[i].status = status;
+        statuses[i] = status;
+    });
+
+    for (int status : statuses) {
+        if (status != MCO_OK) return status;
+    }
+    return MCO_OK;
+}
+
+// ============================================================================
+// Chebyshev Proxies
+// ============================================================================
+
+int mco_proxy_build(mco_context_t* ctx, const mco_instrument_t* instrument,
+                    const mco_proxy_domain_t* domain, mco_proxy_t** proxy) {
+    if (!proxy) return MCO_ERROR_INVALID_ARGUMENT;
+    *proxy = nullptr;
+    if (!ctx || !instrument || !domain) return MCO_ERROR_INVALID_ARGUMENT;
+
+    Context* context = reinterpret_cast<Context*>(ctx);
+    const mco_proxy_axis_t* in[kProxyAxes] = {&domain->spot, &domain->volatility,
+                                              &domain->time_to_maturity};
+    ProxyAxis axes[kProxyAxes];
+    for (size_t a = 0; a < kProxyAxes; ++a) {
+        axes[a] = ProxyAxis{in[a]->lower, in[a]->upper, in[a]->nodes};
+    }
+
+    try {
+        ChebyshevProxy built = ChebyshevProxy::build(*context, to_descriptor(*instrument), axes);
+        *proxy = reinterpret_cast<mco_proxy_t*>(new ChebyshevProxy(std::move(built)));
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::domain_error&) {
+        return MCO_ERROR_UNSUPPORTED;
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+void mco_proxy_free(mco_proxy_t* proxy) {
+    delete reinterpret_cast<ChebyshevProxy*>(proxy);
+}
+
+int mco_proxy_evaluate(const mco_proxy_t* proxy, double spot, double volatility,
+                       double time_to_maturity, mco_proxy_value_t* value) {
+    if (!proxy || !value) return MCO_ERROR_INVALID_ARGUMENT;
+    try {
+        ProxyValue v = reinterpret_cast<const ChebyshevProxy*>(proxy)->evaluate(
+            spot, volatility, time_to_maturity);
+        *value = mco_proxy_value_t{v.price, v.delta, v.gamma, v.vega, v.theta, v.error_estimate};
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    return MCO_OK;
+}
+
+int mco_proxy_serialize(const mco_proxy_t* proxy, void* buffer, size_t capacity, size_t* size) {
+    if (!proxy || !size) return MCO_ERROR_INVALID_ARGUMENT;
+    try {
+        std::vector<unsigned char> image = reinterpret_cast<const ChebyshevProxy*>(proxy)->serialize();
+        *size = image.size();
+        if (!buffer) return MCO_OK;
+        if (capacity < image.size()) return MCO_ERROR_INVALID_ARGUMENT;
+        std::copy(image.begin(), image.end(), static_cast<unsigned char*>(buffer));
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+int mco_proxy_deserialize(const void* buffer, size_t size, mco_proxy_t** proxy) {
+    if (!proxy) return MCO_ERROR_INVALID_ARGUMENT;
+    *proxy = nullptr;
+    if (!buffer) return MCO_ERROR_INVALID_ARGUMENT;
+    try {
+        ChebyshevProxy loaded = ChebyshevProxy::deserialize(
+            static_cast<const unsigned char*>(buffer), size);
+        *proxy = reinterpret_cast<mco_proxy_t*>(new ChebyshevProxy(std::move(loaded)));
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+// ============================================================================
+// Autocallable Notes
+// ============================================================================
+
+int mco_price_autocallable(
+    mco_context_t* ctx,
+    size_t num_assets,
+    const double* spots,
+    const double* initial_fixings,
+    const double* volatilities,
+    const double* correlation,
+    double rate,
+    const mco_autocallable_terms_t* terms,
+    mco_price_result_t* result
+) {
+    if (!result) return MCO_ERROR_INVALID_ARGUMENT;
+    result->status = MCO_ERROR_INVALID_ARGUMENT;
+    if (!ctx || !terms || num_assets == 0 || !spots || !volatilities) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    
+    Context* context = reinterpret_cast<Context*>(ctx);
+    
+    try {
+        AutocallableNoteData note;
+        note.spots.assign(spots, spots + num_assets);
+        if (initial_fixings) {
+            note.initial_fixings.assign(initial_fixings, initial_fixings + num_assets);
+        }
+        note.volatilities.assign(volatilities, volatilities + num_assets);
+        if (correlation) {
+            note.correlation.assign(correlation, correlation + num_assets * num_assets);
+        }
+        note.rate = rate;
+        note.terms = to_autocallable_terms(*terms);
+        
+        AutocallableResult price = price_autocallable_note(*context, note);
+        fill_price_result(PricingResult{price.price, price.std_error, PricingMethod::MonteCarlo,
+                                        context->get_num_simulations(),
+                                        note.terms.observation_dates.size()},
+                          result);
+    } catch (const std::invalid_argument&) {
+        result->status = MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        result->status = MCO_ERROR_INTERNAL;
+    }
+    
+    return result->status;
+}
+
+// ============================================================================
+// Cliquets
+// ============================================================================
+
+int mco_price_cliquet(
+    mco_context_t* ctx,
+    double rate,
+    double volatility,
+    const mco_cliquet_params_t* params,
+    mco_price_result_t* result
+) {
+    if (!result) return MCO_ERROR_INVALID_ARGUMENT;
+    result->status = MCO_ERROR_INVALID_ARGUMENT;
+    if (!ctx || !params) return MCO_ERROR_INVALID_ARGUMENT;
+    
+    Context* context = reinterpret_cast<Context*>(ctx);
+    
+    try {
+        CliquetOptionData option = to_cliquet_data(*params, rate, volatility);
+        double price = price_cliquet_option(*context, option);
+        fill_price_result(PricingResult{price, std::numeric_limits<double>::quiet_NaN(),
+                                        PricingMethod::MonteCarlo,
+                                        context->get_num_simulations(),
+                                        option.reset_dates.size()},
+                          result);
+    } catch (const std::invalid_argument&) {
+        result->status = MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        result->status = MCO_ERROR_INTERNAL;
+    }
+    
+    return result->status;
+}
+
+// ============================================================================
+// Closed-Form Barriers and Lookbacks
+// ============================================================================
+
+double mco_barrier_call_analytic(mco_context_t* ctx, double spot, double strike,
+                                 double rate, double volatility, double time_to_maturity,
+                                 double barrier_level, int barrier_type, double rebate,
+                                 size_t monitoring_steps) {
+    if (!ctx) return -1.0;
+    if (barrier_type < 0 || barrier_type > 3) return -1.0;
+    try {
+        return analytic::barrier_price(spot, strike, rate, volatility, time_to_maturity,
+                                       barrier_level, static_cast<BarrierType>(barrier_type),
+                                       rebate, OptionType::Call, monitoring_steps);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_barrier_put_analytic(mco_context_t* ctx, double spot, double strike,
+                                double rate, double volatility, double time_to_maturity,
+                                double barrier_level, int barrier_type, double rebate,
+                                size_t monitoring_steps) {
+    if (!ctx) return -1.0;
+    if (barrier_type < 0 || barrier_type > 3) return -1.0;
+    try {
+        return analytic::barrier_price(spot, strike, rate, volatility, time_to_maturity,
+                                       barrier_level, static_cast<BarrierType>(barrier_type),
+                                       rebate, OptionType::Put, monitoring_steps);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_lookback_call_analytic(mco_context_t* ctx, double spot, double strike,
+                                  double rate, double volatility, double time_to_maturity,
+                                  int fixed_strike, size_t monitoring_steps) {
+    if (!ctx) return -1.0;
+    try {
+        return analytic::lookback_price(spot, strike, rate, volatility, time_to_maturity,
+                                        fixed_strike != 0, OptionType::Call, monitoring_steps);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+double mco_lookback_put_analytic(mco_context_t* ctx, double spot, double strike,
+                                 double rate, double volatility, double time_to_maturity,
+                                 int fixed_strike, size_t monitoring_steps) {
+    if (!ctx) return -1.0;
+    try {
+        return analytic::lookback_price(spot, strike, rate, volatility, time_to_maturity,
+                                        fixed_strike != 0, OptionType::Put, monitoring_steps);
+    } catch (const std::exception&) {
+        return -1.0;
+    }
+}
+
+int mco_barrier_analytic_batch(
+    mco_context_t* ctx,
+    size_t count,
+    const int* option_types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times_to_maturity,
+    const double* barrier_levels,
+    const int* barrier_types,
+    const double* rebates,
+    size_t monitoring_steps,
+    double* prices
+) {
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    if (count == 0) return MCO_OK;
+    if (!option_types || !spots || !strikes || !rates || !volatilities || !times_to_maturity ||
+        !barrier_levels || !barrier_types || !rebates || !prices) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+
+    try {
+        std::vector<OptionType> types(count);
+        std::vector<BarrierType> kinds(count);
+        for (size_t i = 0; i < count; ++i) {
+            if ((option_types[i] != MCO_CALL && option_types[i] != MCO_PUT) ||
+                barrier_types[i] < 0 || barrier_types[i] > 3) {
+                return MCO_ERROR_INVALID_ARGUMENT;
+            }
+            types[i] = option_types[i] == MCO_CALL ? OptionType::Call : OptionType::Put;
+            kinds[i] = static_cast<BarrierType>(barrier_types[i]);
+        }
+        analytic::barrier_price_batch(count, types.data(), spots, strikes, rates, volatilities,
+                                      times_to_maturity, barrier_levels, kinds.data(), rebates,
+                                      monitoring_steps, prices);
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+int mco_lookback_analytic_batch(
+    mco_context_t* ctx,
+    size_t count,
+    const int* option_types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times_to_maturity,
+    const int* fixed_strikes,
+    size_t monitoring_steps,
+    double* prices
+) {
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    if (count == 0) return MCO_OK;
+    if (!option_types || !spots || !strikes || !rates || !volatilities || !times_to_maturity ||
+        !fixed_strikes || !prices) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    }
+
+    try {
+        std::vector<OptionType> types(count);
+        std::unique_ptr<bool[]> fixed(new bool[count]);
+        for (size_t i = 0; i < count; ++i) {
+            if (option_types[i] != MCO_CALL && option_types[i] != MCO_PUT) {
+                return MCO_ERROR_INVALID_ARGUMENT;
+            }
+            types[i] = option_types[i] == MCO_CALL ? OptionType::Call : OptionType::Put;
+            fixed[i] = fixed_strikes[i] != 0;
+        }
+        analytic::lookback_price_batch(count, types.data(), spots, strikes, rates, volatilities,
+                                       times_to_maturity, fixed.get(), monitoring_steps, prices);
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+// ============================================================================
+// Parallel Engine
+// ============================================================================
+
+void mco_context_set_num_threads(mco_context_t* ctx, size_t num_threads) {
+    Context* context = reinterpret_cast<Context*>(ctx);
+    context->set_num_threads(num_threads);
+}
+
+size_t mco_context_get_num_threads(mco_context_t* ctx) {
+    Context* context = reinterpret_cast<Context*>(ctx);
+    return context->get_num_threads();
+}
+
+void mco_context_set_reproducible(mco_context_t* ctx, int enabled) {
+    Context* context = reinterpret_cast<Context*>(ctx);
+    context->set_reproducible(enabled != 0);
+}
+
+int mco_context_set_stream_mode(mco_context_t* ctx, int mode) {
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    switch (mode) {
+        case MCO_STREAM_BLOCKS:
+            context->set_stream_mode(Context::StreamMode::Blocks);
+            break;
+        case MCO_STREAM_SEQUENTIAL:
+            context->set_stream_mode(Context::StreamMode::Sequential);
+            break;
+        default:
+            return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    return MCO_OK;
+}
+
+int mco_philox4x32(const uint32_t counter[4], uint64_t key, uint32_t out[4]) {
+    if (!counter || !out) return MCO_ERROR_INVALID_ARGUMENT;
+    Philox4x32::block(counter, key, out);
+    return MCO_OK;
+}
+
+int mco_context_set_thread_affinity(mco_context_t* ctx, int affinity) {
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    switch (affinity) {
+        case MCO_AFFINITY_NONE:
+            context->set_thread_affinity(Context::ThreadAffinity::None);
+            break;
+        case MCO_AFFINITY_COMPACT:
+            context->set_thread_affinity(Context::ThreadAffinity::Compact);
+            break;
+        case MCO_AFFINITY_SPREAD:
+            context->set_thread_affinity(Context::ThreadAffinity::Spread);
+            break;
+        default:
+            return MCO_ERROR_INVALID_ARGUMENT;
+    }
+    return MCO_OK;
+}
+
+int mco_context_set_checkpoint(mco_context_t* ctx, const char* path,
+                               double interval_seconds, int resume) {
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    if (!path) {
+        context->set_checkpoint(nullptr);
+        return MCO_OK;
+    }
+    try {
+        context->set_checkpoint(std::make_shared<Checkpoint>(path, interval_seconds, resume != 0));
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+int mco_context_flush_checkpoint(mco_context_t* ctx) {
+    if (!ctx) return MCO_ERROR_INVALID_ARGUMENT;
+    Context* context = reinterpret_cast<Context*>(ctx);
+    if (!context->get_checkpoint()) return MCO_OK;
+    try {
+        context->get_checkpoint()->flush();
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+int mco_checkpoint_info(const char* path, mco_checkpoint_info_t* info) {
+    if (!path || !info) return MCO_ERROR_INVALID_ARGUMENT;
+    try {
+        Checkpoint checkpoint(path, 0.0, true);
+        *info = mco_checkpoint_info_t{};
+        info->jobs = info->jobs_done = checkpoint.finished_jobs();
+        info->blocks_done = info->blocks_total = checkpoint.finished_blocks();
+        for (const CheckpointRecord& record : checkpoint.records()) {
+            ++info->jobs;
+            info->blocks_done += record.blocks_done;
+            info->blocks_total += record.num_blocks;
+        }
+    } catch (const std::invalid_argument&) {
+        return MCO_ERROR_INVALID_ARGUMENT;
+    } catch (const std::exception&) {
+        return MCO_ERROR_INTERNAL;
+    }
+    return MCO_OK;
+}
+
+int mco_get_topology(mco_topology_t* topology) {
+    if (!topology) return MCO_ERROR_INVALID_ARGUMENT;
+    const CpuTopology& detected = system_topology();
+    topology->num_cpus = detected.num_cpus();
+    topology->num_nodes = detected.num_nodes();
+    return MCO_OK;
+}
+
+size_t mco_topology_node_cpus(size_t node) {
+    const CpuTopology& detected = system_topology();
+    return node < detected.num_nodes() ? detected.node_cpus[node].size() : 0;
+}
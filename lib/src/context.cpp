@@ -1,5 +1,6 @@
 #include "internal/context.hpp"
 #include <random>
+#include <utility>
 
 namespace mcoptions {
 
@@ -11,14 +12,23 @@ Context::Context()
       stratified_sampling_enabled_(false),
       importance_sampling_enabled_(false),
       drift_shift_(0.0),
+      normal_method_(NormalMethod::BoxMuller),
       model_(Model::BlackScholes),
       sabr_alpha_(0.0),
       sabr_beta_(1.0),
       sabr_rho_(0.0),
       sabr_nu_(0.0),
       binomial_steps_(100),
-      rng_(std::random_device{}())
-{}
+      num_threads_(1),
+      thread_affinity_(ThreadAffinity::None),
+      job_fingerprint_(0),
+      reproducible_(false),
+      stream_mode_(StreamMode::Blocks),
+      rng_stale_(true)
+{
+    std::random_device device;
+    set_seed((static_cast<uint64_t>(device()) << 32) ^ device());
+}
 
 void Context::set_num_simulations(size_t n) {
     num_simulations_ = n;
@@ -73,6 +83,14 @@ double Context::get_drift_shift() const {
     return drift_shift_;
 }
 
+void Context::set_normal_method(NormalMethod method) {
+    normal_method_ = method;
+}
+
+NormalMethod Context::get_normal_method() const {
+    return normal_method_;
+}
+
 void Context::set_model(Model model) {
     model_ = model;
 }
@@ -112,12 +130,101 @@ size_t Context::get_binomial_steps() const {
     return binomial_steps_;
 }
 
-std::mt19937_64& Context::get_rng() {
+void Context::set_num_threads(size_t n) {
+    num_threads_ = n;
+    worker_pool_.reset();
+}
+
+size_t Context::get_num_threads() const {
+    return num_threads_;
+}
+
+void Context::set_thread_affinity(ThreadAffinity affinity) {
+    thread_affinity_ = affinity;
+    worker_pool_.reset();
+}
+
+Context::ThreadAffinity Context::get_thread_affinity() const {
+    return thread_affinity_;
+}
+
+void Context::set_worker_pool(std::shared_ptr<WorkerPool> pool) {
+    worker_pool_ = std::move(pool);
+}
+
+const std::shared_ptr<WorkerPool>& Context::get_worker_pool() const {
+    return worker_pool_;
+}
+
+void Context::set_path_cache(std::shared_ptr<PathCache> cache) {
+    path_cache_ = std::move(cache);
+}
+
+const std::shared_ptr<PathCache>& Context::get_path_cache() const {
+    return path_cache_;
+}
+
+void Context::set_workspace(std::shared_ptr<SimulationWorkspace> workspace) {
+    workspace_ = std::move(workspace);
+}
+
+const std::shared_ptr<SimulationWorkspace>& Context::get_workspace() const {
+    return workspace_;
+}
+
+void Context::set_checkpoint(std::shared_ptr<Checkpoint> checkpoint) {
+    checkpoint_ = std::move(checkpoint);
+}
+
+const std::shared_ptr<Checkpoint>& Context::get_checkpoint() const {
+    return checkpoint_;
+}
+
+void Context::set_job_fingerprint(uint64_t fingerprint) {
+    job_fingerprint_ = fingerprint;
+}
+
+uint64_t Context::get_job_fingerprint() const {
+    return job_fingerprint_;
+}
+
+void Context::set_reproducible(bool enabled) {
+    reproducible_ = enabled;
+}
+
+bool Context::get_reproducible() const {
+    return reproducible_;
+}
+
+void Context::set_stream_mode(StreamMode mode) {
+    stream_mode_ = mode;
+}
+
+Context::StreamMode Context::get_stream_mode() const {
+    return stream_mode_;
+}
+
+Mt19937_64& Context::get_rng() {
+    if (rng_stale_) {
+        rng_.seed(seed_);
+        rng_stale_ = false;
+    }
     return rng_;
 }
 
-void Context::set_seed(unsigned int seed) {
-    rng_.seed(seed);
+void Context::set_seed(uint64_t seed) {
+    seed_ = seed;
+    rng_stale_ = true;
+    // Job keys come from stream 0 under the seed
+    stream_keys_ = Philox4x32(seed, 0);
+}
+
+uint64_t Context::get_seed() const {
+    return seed_;
+}
+
+uint64_t Context::next_stream_key() {
+    return stream_keys_();
 }
 
 }
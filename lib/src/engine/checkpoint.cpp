@@ -0,0 +1,273 @@
+#include "internal/engine/checkpoint.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace mcoptions {
+
+namespace {
+
+const char kMagic[8] = {'M', 'C', 'O', 'C', 'K', 'P', 'T', '1'};
+const uint32_t kFormatVersion = 3;
+const uint32_t kByteOrderTag = 0x01020304;
+
+template <typename T>
+void put(std::vector<unsigned char>& out, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void put_moments(std::vector<unsigned char>& out, const SampleMoments& m) {
+    put(out, static_cast<uint64_t>(m.count));
+    put(out, m.sum_y);
+    put(out, m.sum_yy);
+    put(out, m.sum_x);
+    put(out, m.sum_xx);
+    put(out, m.sum_xy);
+}
+
+class Reader {
+public:
+    Reader(const unsigned char* data, size_t size) : data_(data), size_(size), offset_(0) {}
+
+    template <typename T>
+    T get() {
+        if (size_ - offset_ < sizeof(T)) {
+            throw std::invalid_argument("Checkpoint file is truncated");
+        }
+        T value;
+        std::memcpy(&value, data_ + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    SampleMoments get_moments() {
+        SampleMoments m;
+        m.count = static_cast<size_t>(get<uint64_t>());
+        m.sum_y = get<double>();
+        m.sum_yy = get<double>();
+        m.sum_x = get<double>();
+        m.sum_xx = get<double>();
+        m.sum_xy = get<double>();
+        return m;
+    }
+
+    // Element count that the rest of the file can actually hold
+    uint64_t get_count(size_t element_size) {
+        uint64_t count = get<uint64_t>();
+        if (count > (size_ - offset_) / element_size) {
+            throw std::invalid_argument("Checkpoint file is truncated");
+        }
+        return count;
+    }
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+    size_t offset_;
+};
+
+const size_t kMomentsBytes = sizeof(uint64_t) + 5 * sizeof(double);
+
+bool same_moments(const SampleMoments& a, const SampleMoments& b) {
+    // Bitwise, so that NaN sums still identify a job
+    return a.count == b.count &&
+           std::memcmp(&a.sum_y, &b.sum_y, sizeof(double)) == 0 &&
+           std::memcmp(&a.sum_yy, &b.sum_yy, sizeof(double)) == 0 &&
+           std::memcmp(&a.sum_x, &b.sum_x, sizeof(double)) == 0 &&
+           std::memcmp(&a.sum_xx, &b.sum_xx, sizeof(double)) == 0 &&
+           std::memcmp(&a.sum_xy, &b.sum_xy, sizeof(double)) == 0;
+}
+
+struct CheckpointFile {
+    uint64_t finished_jobs = 0;
+    uint64_t finished_blocks = 0;
+    std::vector<CheckpointRecord> records;
+};
+
+CheckpointFile read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return {};
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(kMagic) || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw std::invalid_argument("Not a checkpoint file: " + path);
+    }
+    Reader reader(data.data() + sizeof(kMagic), data.size() - sizeof(kMagic));
+    if (reader.get<uint32_t>() != kFormatVersion) {
+        throw std::invalid_argument("Unsupported checkpoint version: " + path);
+    }
+    if (reader.get<uint32_t>() != kByteOrderTag) {
+        throw std::invalid_argument("Checkpoint was written with another byte order: " + path);
+    }
+
+    CheckpointFile contents;
+    contents.finished_jobs = reader.get<uint64_t>();
+    contents.finished_blocks = reader.get<uint64_t>();
+    contents.records.resize(reader.get_count(kMomentsBytes));
+    for (CheckpointRecord& record : contents.records) {
+        record.stream_mode = reader.get<uint32_t>();
+        record.key = reader.get<uint64_t>();
+        record.num_blocks = reader.get<uint64_t>();
+        record.draws_per_block = reader.get<uint64_t>();
+        record.fingerprint = reader.get<uint64_t>();
+        record.first_block = reader.get_moments();
+        record.blocks_done = reader.get<uint64_t>();
+        if (record.blocks_done > record.num_blocks) {
+            throw std::invalid_argument("Checkpoint file is corrupt: " + path);
+        }
+        record.partials.resize(reader.get_count(kMomentsBytes));
+        for (SampleMoments& partial : record.partials) partial = reader.get_moments();
+        record.rng_state.resize(reader.get_count(sizeof(uint64_t)));
+        for (uint64_t& word : record.rng_state) word = reader.get<uint64_t>();
+        record.loaded = true;
+    }
+    return contents;
+}
+
+} // namespace
+
+bool CheckpointRecord::same_job(const CheckpointRecord& other) const {
+    return stream_mode == other.stream_mode && key == other.key &&
+           num_blocks == other.num_blocks && draws_per_block == other.draws_per_block &&
+           fingerprint == other.fingerprint && same_moments(first_block, other.first_block);
+}
+
+Checkpoint::Checkpoint(std::string path, double interval_seconds, bool resume)
+    : path_(std::move(path)),
+      interval_(interval_seconds),
+      last_write_(std::chrono::steady_clock::now())
+{
+    if (path_.empty()) throw std::invalid_argument("Checkpoint path must not be empty");
+    if (!(interval_seconds >= 0.0)) throw std::invalid_argument("Checkpoint interval must be >= 0");
+    if (resume) {
+        CheckpointFile contents = read_file(path_);
+        finished_jobs_ = contents.finished_jobs;
+        finished_blocks_ = contents.finished_blocks;
+        records_ = std::move(contents.records);
+    }
+}
+
+bool Checkpoint::has_saved_jobs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const CheckpointRecord& saved : records_) {
+        if (saved.loaded) return true;
+    }
+    return false;
+}
+
+bool Checkpoint::find(CheckpointRecord& record) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const CheckpointRecord& saved : records_) {
+        if (saved.same_job(record)) {
+            record.blocks_done = saved.blocks_done;
+            record.partials = saved.partials;
+            record.rng_state = saved.rng_state;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Checkpoint::update(const CheckpointRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool finished = record.blocks_done == record.num_blocks;
+    bool found = false;
+    for (size_t i = 0; i < records_.size(); ++i) {
+        if (records_[i].same_job(record)) {
+            if (finished) {
+                records_.erase(records_.begin() + i);
+            } else {
+                records_[i] = record;
+                records_[i].loaded = false;
+            }
+            found = true;
+            break;
+        }
+    }
+    if (!found && !finished) {
+        records_.push_back(record);
+        records_.back().loaded = false;
+    }
+    if (finished) {
+        ++finished_jobs_;
+        finished_blocks_ += record.num_blocks;
+    }
+    dirty_ = true;
+
+    std::chrono::duration<double> since = std::chrono::steady_clock::now() - last_write_;
+    if (since.count() < interval_) return;
+    try {
+        write_locked();
+    } catch (const std::exception&) {
+        // Still dirty: flush() reports the failure, the next interval retries
+        last_write_ = std::chrono::steady_clock::now();
+    }
+}
+
+void Checkpoint::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dirty_) write_locked();
+}
+
+std::vector<CheckpointRecord> Checkpoint::records() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+}
+
+uint64_t Checkpoint::finished_jobs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finished_jobs_;
+}
+
+uint64_t Checkpoint::finished_blocks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return finished_blocks_;
+}
+
+void Checkpoint::write_locked() {
+    std::vector<unsigned char> out(kMagic, kMagic + sizeof(kMagic));
+    put(out, kFormatVersion);
+    put(out, kByteOrderTag);
+    put(out, finished_jobs_);
+    put(out, finished_blocks_);
+    put(out, static_cast<uint64_t>(records_.size()));
+    for (const CheckpointRecord& record : records_) {
+        put(out, record.stream_mode);
+        put(out, record.key);
+        put(out, record.num_blocks);
+        put(out, record.draws_per_block);
+        put(out, record.fingerprint);
+        put_moments(out, record.first_block);
+        put(out, record.blocks_done);
+        put(out, static_cast<uint64_t>(record.partials.size()));
+        for (const SampleMoments& partial : record.partials) put_moments(out, partial);
+        put(out, static_cast<uint64_t>(record.rng_state.size()));
+        for (uint64_t word : record.rng_state) put(out, word);
+    }
+
+    // Replace the old file only once the new one is complete on disk
+    std::string temporary = path_ + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) throw std::runtime_error("Could not open checkpoint file " + temporary);
+    bool ok = std::fwrite(out.data(), 1, out.size(), file) == out.size() && std::fflush(file) == 0;
+#ifdef __linux__
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(temporary.c_str(), path_.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Could not write checkpoint file " + path_);
+    }
+    last_write_ = std::chrono::steady_clock::now();
+    dirty_ = false;
+}
+
+} // namespace mcoptions
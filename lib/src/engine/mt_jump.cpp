@@ -0,0 +1,277 @@
+#include "internal/engine/mt_jump.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mcoptions {
+
+namespace {
+
+using Poly = std::vector<uint64_t>;   // Bit i = coefficient of x^i
+
+const size_t kDegree = 19937;                         // Dimension of the state
+const size_t kWords = Mt19937_64::kStateWords;        // Words of a reduced polynomial
+const uint64_t kGenerateBelow = uint64_t(1) << 20;    // Cheaper to generate than to jump
+const size_t kMaxCached = 256;
+
+bool bit(const Poly& p, size_t i) {
+    return (p[i >> 6] >> (i & 63)) & 1;
+}
+
+void flip(Poly& p, size_t i) {
+    p[i >> 6] ^= uint64_t(1) << (i & 63);
+}
+
+bool parity(uint64_t x) {
+    x ^= x >> 32;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return x & 1;
+}
+
+// 64 bits of p starting at bit `first` (zero past the end)
+uint64_t bits_at(const Poly& p, size_t first) {
+    size_t word = first >> 6;
+    unsigned shift = first & 63;
+    uint64_t low = word < p.size() ? p[word] >> shift : 0;
+    uint64_t high = shift && word + 1 < p.size() ? p[word + 1] << (64 - shift) : 0;
+    return low | high;
+}
+
+// p ^= q * x^shift, truncated to the length of p
+void add_shifted(Poly& p, const Poly& q, size_t shift) {
+    size_t words = shift >> 6;
+    unsigned bits = shift & 63;
+    for (size_t i = 0; i + words < p.size() && i < q.size(); ++i) {
+        p[i + words] ^= q[i] << bits;
+        if (bits && i + words + 1 < p.size()) p[i + words + 1] ^= q[i] >> (64 - bits);
+    }
+}
+
+/**
+ * Characteristic polynomial phi of the generator
+ *
+ * Bit 0 of the raw words is a linear recurring sequence; phi is irreducible,
+ * so its minimal polynomial, which Berlekamp-Massey finds from 2 * 19937
+ * terms, is phi itself.
+ */
+Poly characteristic_polynomial() {
+    const size_t n = 2 * kDegree;
+    const size_t words = n / 64 + 2;
+
+    // Sequence stored reversed, so the terms s[k - i] for i = 0..L are contiguous
+    Poly reversed(words, 0);
+    Mt19937_64 rng;
+    uint64_t window[kWords];
+    std::copy(rng.state(), rng.state() + kWords, window);
+    size_t start = 0;
+    for (size_t k = 0; k < n; ++k) {
+        size_t newest = start;
+        Mt19937_64::step(window, start);
+        if (window[newest] & 1) flip(reversed, n - 1 - k);
+    }
+
+    // Connection polynomial C(x) = 1 + c_1 x + ... + c_L x^L
+    Poly c(words, 0), b(words, 0), t;
+    c[0] = b[0] = 1;
+    size_t length = 0;
+    size_t gap = 1;
+    for (size_t k = 0; k < n; ++k) {
+        size_t offset = n - 1 - k;
+        uint64_t sum = 0;
+        for (size_t w = 0; w <= length / 64; ++w) {
+            sum ^= c[w] & bits_at(reversed, offset + 64 * w);
+        }
+        if (!parity(sum)) {
+            ++gap;
+        } else if (2 * length <= k) {
+            t = c;
+            add_shifted(c, b, gap);
+            length = k + 1 - length;
+            b.swap(t);
+            gap = 1;
+        } else {
+            add_shifted(c, b, gap);
+            ++gap;
+        }
+    }
+    if (length != kDegree) {
+        throw std::runtime_error("Mersenne Twister characteristic polynomial has the wrong degree");
+    }
+
+    // phi is the reciprocal of C
+    Poly phi(kWords + 1, 0);
+    for (size_t i = 0; i <= length; ++i) {
+        if (bit(c, i)) flip(phi, length - i);
+    }
+    return phi;
+}
+
+/**
+ * Arithmetic modulo phi
+ *
+ * Reduction clears the top bits one at a time with a copy of phi shifted to
+ * the right bit offset; the 64 offsets are prepared once.
+ */
+class Modulus {
+public:
+    Modulus() : phi_(characteristic_polynomial()), shifted_(64) {
+        for (unsigned s = 0; s < 64; ++s) {
+            shifted_[s].assign(kWords + 1, 0);
+            add_shifted(shifted_[s], phi_, s);
+        }
+    }
+
+    static const Modulus& instance() {
+        static const Modulus modulus;
+        return modulus;
+    }
+
+    Poly square(const Poly& p) const {
+        // Squaring is linear over GF(2): spread the bits apart
+        Poly wide(2 * kWords, 0);
+        for (size_t i = 0; i < kWords; ++i) {
+            wide[2 * i] = spread(static_cast<uint32_t>(p[i]));
+            wide[2 * i + 1] = spread(static_cast<uint32_t>(p[i] >> 32));
+        }
+        reduce(wide, 2 * kDegree - 2);
+        wide.resize(kWords);
+        return wide;
+    }
+
+    Poly times_x(const Poly& p) const {
+        Poly result(kWords + 1, 0);
+        add_shifted(result, p, 1);
+        reduce(result, kDegree);
+        result.resize(kWords);
+        return result;
+    }
+
+    // p / x; phi has a constant term, so x is invertible
+    Poly over_x(const Poly& p) const {
+        Poly result(p);
+        result.resize(kWords + 1, 0);
+        if (result[0] & 1) {
+            for (size_t i = 0; i <= kWords; ++i) result[i] ^= phi_[i];
+        }
+        for (size_t i = 0; i < kWords; ++i) {
+            result[i] = (result[i] >> 1) | (result[i + 1] << 63);
+        }
+        result.resize(kWords);
+        return result;
+    }
+
+private:
+    static uint64_t spread(uint32_t half) {
+        uint64_t x = half;
+        x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+        x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+        x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        x = (x | (x << 2)) & 0x3333333333333333ULL;
+        x = (x | (x << 1)) & 0x5555555555555555ULL;
+        return x;
+    }
+
+    // Reduce p (degree <= top) to degree < 19937
+    void reduce(Poly& p, size_t top) const {
+        for (size_t i = top; i >= kDegree; --i) {
+            if (!bit(p, i)) continue;
+            size_t shift = i - kDegree;
+            const Poly& q = shifted_[shift & 63];
+            size_t base = shift >> 6;
+            for (size_t w = 0; w < q.size() && base + w < p.size(); ++w) p[base + w] ^= q[w];
+        }
+    }
+
+    Poly phi_;
+    std::vector<Poly> shifted_;
+};
+
+/**
+ * q(x) = x^(n * 2^squarings - 1) mod phi
+ *
+ * The state T^N s is then q(T) T s: the first step is taken explicitly
+ * because T also drops the 31 unused low bits of the oldest word, which
+ * phi does not account for.
+ */
+Poly jump_polynomial(uint64_t n, unsigned squarings) {
+    const Modulus& modulus = Modulus::instance();
+    Poly p(kWords, 0);
+    p[0] = 1;
+    for (int b = 63; b >= 0; --b) {
+        p = modulus.square(p);
+        if ((n >> b) & 1) p = modulus.times_x(p);
+    }
+    for (unsigned i = 0; i < squarings; ++i) {
+        p = modulus.square(p);
+    }
+    return modulus.over_x(p);
+}
+
+std::shared_ptr<const Poly> cached_polynomial(uint64_t n, unsigned squarings) {
+    static std::mutex mutex;
+    static std::map<std::pair<uint64_t, unsigned>, std::shared_ptr<const Poly>> cache;
+
+    auto key = std::make_pair(n, squarings);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = cache.find(key);
+        if (found != cache.end()) return found->second;
+    }
+    auto poly = std::make_shared<const Poly>(jump_polynomial(n, squarings));
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cache.size() >= kMaxCached) cache.clear();
+    cache.emplace(key, poly);
+    return poly;
+}
+
+// Replace the window by q(T) T window; the read position is unchanged
+void apply(Mt19937_64& rng, const Poly& q) {
+    uint64_t window[kWords];
+    uint64_t sum[kWords] = {};
+    std::copy(rng.state(), rng.state() + kWords, window);
+    size_t start = 0;
+    Mt19937_64::step(window, start);
+
+    size_t top = kDegree;
+    while (top > 0 && !bit(q, top - 1)) --top;
+    for (size_t i = 0; i < top; ++i) {
+        if (bit(q, i)) {
+            // The window in order is window[start..] followed by window[..start)
+            size_t head = kWords - start;
+            for (size_t w = 0; w < head; ++w) sum[w] ^= window[start + w];
+            for (size_t w = 0; w < start; ++w) sum[head + w] ^= window[w];
+        }
+        Mt19937_64::step(window, start);
+    }
+    std::copy(sum, sum + kWords, rng.state());
+}
+
+} // anonymous namespace
+
+void jump_ahead(Mt19937_64& rng, uint64_t steps) {
+    if (steps < kGenerateBelow) {
+        rng.discard(steps);
+        return;
+    }
+    apply(rng, *cached_polynomial(steps, 0));
+}
+
+void jump_ahead_pow2(Mt19937_64& rng, unsigned exponent) {
+    if (exponent > 1024) {
+        throw std::invalid_argument("Jump exponent must be at most 1024");
+    }
+    if (exponent < 64 && (uint64_t(1) << exponent) < kGenerateBelow) {
+        rng.discard(uint64_t(1) << exponent);
+        return;
+    }
+    apply(rng, *cached_polynomial(1, exponent));
+}
+
+} // namespace mcoptions
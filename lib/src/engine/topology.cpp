@@ -0,0 +1,90 @@
+#include "internal/engine/topology.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace mcoptions {
+
+namespace {
+
+// Parses sysfs cpu lists such as "0-3,8-11"
+std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+CpuTopology detect_topology() {
+    CpuTopology topology;
+
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    auto usable = [&](int cpu) {
+        return cpu >= 0 && cpu < CPU_SETSIZE && (!have_mask || CPU_ISSET(cpu, &allowed));
+    };
+
+    // Node ids can have gaps (offline or memory-only nodes), so probe a generous range
+    for (int node = 0; node < 1024; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) continue;
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(line)) {
+            if (usable(cpu)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) topology.node_cpus.push_back(std::move(cpus));
+    }
+
+    if (topology.node_cpus.empty() && have_mask) {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) topology.node_cpus.push_back(std::move(cpus));
+    }
+#endif
+
+    if (topology.node_cpus.empty()) {
+        unsigned count = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> cpus(count);
+        for (unsigned cpu = 0; cpu < count; ++cpu) cpus[cpu] = static_cast<int>(cpu);
+        topology.node_cpus.push_back(std::move(cpus));
+    }
+    return topology;
+}
+
+} // anonymous namespace
+
+size_t CpuTopology::num_cpus() const {
+    size_t count = 0;
+    for (const auto& cpus : node_cpus) count += cpus.size();
+    return count;
+}
+
+const CpuTopology& system_topology() {
+    static const CpuTopology topology = detect_topology();
+    return topology;
+}
+
+} // namespace mcoptions
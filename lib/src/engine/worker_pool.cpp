@@ -0,0 +1,280 @@
+#include "internal/engine/worker_pool.hpp"
+#include "internal/engine/topology.hpp"
+#include <exception>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace mcoptions {
+
+namespace {
+
+thread_local WorkerPool* tls_pool = nullptr;
+thread_local size_t tls_worker = 0;
+
+// Configurations whose pools shared_worker_pool keeps alive
+const size_t kMaxSharedPools = 4;
+
+void pin_current_thread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    // Best effort: a refused pin leaves the thread floating
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+} // anonymous namespace
+
+// One run() call; tasks keep it alive until the last block has finished
+struct WorkerPool::Job {
+    const std::function<void(size_t, size_t)>* task;
+    size_t grain;
+    std::atomic<size_t> pending;
+    std::atomic<bool> failed{false};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done = false;
+    std::exception_ptr error;
+};
+
+WorkerPool::WorkerPool(size_t num_workers, Context::ThreadAffinity affinity)
+    : affinity_(affinity), num_nodes_(1), queued_(0), sleepers_(0), stopping_(false),
+      deque_tasks_(0), helpers_(0) {
+    const CpuTopology& topology = system_topology();
+    if (num_workers == 0) num_workers = topology.num_cpus();
+
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
+    // CPU and reduction group of every worker
+    if (affinity != Context::ThreadAffinity::None) {
+        size_t nodes = topology.num_nodes();
+        std::vector<std::pair<size_t, int>> order;   // (node, cpu)
+        if (affinity == Context::ThreadAffinity::Compact) {
+            for (size_t node = 0; node < nodes; ++node) {
+                for (int cpu : topology.node_cpus[node]) order.emplace_back(node, cpu);
+            }
+        } else {
+            for (size_t slot = 0; order.size() < topology.num_cpus(); ++slot) {
+                for (size_t node = 0; node < nodes; ++node) {
+                    if (slot < topology.node_cpus[node].size()) {
+                        order.emplace_back(node, topology.node_cpus[node][slot]);
+                    }
+                }
+            }
+        }
+
+        // Renumber the nodes actually used so groups are dense
+        std::vector<size_t> group(nodes, nodes);
+        num_nodes_ = 0;
+        for (size_t i = 0; i < num_workers; ++i) {
+            const auto& place = order[i % order.size()];
+            if (group[place.first] == nodes) group[place.first] = num_nodes_++;
+            workers_[i]->node = group[place.first];
+            workers_[i]->cpu = place.second;
+        }
+    }
+
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_[i]->thread = std::thread(&WorkerPool::worker_loop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker->thread.join();
+}
+
+WorkerPool* WorkerPool::current() {
+    return tls_pool;
+}
+
+void WorkerPool::run(size_t num_blocks, const std::function<void(size_t, size_t)>& task, size_t grain) {
+    if (num_blocks == 0) return;
+
+    auto job = std::make_shared<Job>();
+    job->task = &task;
+    job->grain = grain > 0 ? grain : 1;
+    job->pending = num_blocks;
+
+    if (tls_pool == this) {
+        // Fork-join from inside a task: work on our own range and keep
+        // running or stealing tasks until every block of the job is done.
+        // With nothing to take, the rest is running elsewhere: sleep
+        size_t self = tls_worker;
+        execute(Task{job, 0, num_blocks}, self);
+        while (job->pending.load() > 0) {
+            Task other;
+            if (pop_local(self, other) || steal(self, other)) {
+                execute(std::move(other), self);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            ++helpers_;
+            help_.wait(lock, [&] { return job->pending.load() == 0 || deque_tasks_.load() > 0; });
+            --helpers_;
+        }
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            ++queued_;
+            injected_.push_back(Task{job, 0, num_blocks});
+        }
+        notify_work();
+
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->finished.wait(lock, [&] { return job->done; });
+    }
+
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+void WorkerPool::execute(Task task, size_t worker) {
+    Job& job = *task.job;
+    while (task.end - task.begin > job.grain) {
+        size_t mid = task.begin + (task.end - task.begin) / 2;
+        push_local(worker, Task{task.job, mid, task.end});
+        task.end = mid;
+    }
+
+    for (size_t block = task.begin; block < task.end; ++block) {
+        if (job.failed.load(std::memory_order_relaxed)) break;
+        try {
+            (*job.task)(block, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            if (!job.error) job.error = std::current_exception();
+            job.failed = true;
+        }
+    }
+
+    size_t count = task.end - task.begin;
+    if (job.pending.fetch_sub(count) == count) {
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.done = true;
+            job.finished.notify_all();
+        }
+        notify_helpers();
+    }
+}
+
+void WorkerPool::push_local(size_t worker, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(workers_[worker]->mutex);
+        ++queued_;
+        ++deque_tasks_;
+        workers_[worker]->tasks.push_back(std::move(task));
+    }
+    notify_work();
+    notify_helpers();
+}
+
+bool WorkerPool::pop_local(size_t worker, Task& task) {
+    std::lock_guard<std::mutex> lock(workers_[worker]->mutex);
+    auto& tasks = workers_[worker]->tasks;
+    if (tasks.empty()) return false;
+    task = std::move(tasks.back());
+    tasks.pop_back();
+    --queued_;
+    --deque_tasks_;
+    return true;
+}
+
+bool WorkerPool::steal(size_t thief, Task& task) {
+    size_t n = workers_.size();
+    for (size_t offset = 1; offset < n; ++offset) {
+        Worker& victim = *workers_[(thief + offset) % n];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) continue;
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        --queued_;
+        --deque_tasks_;
+        return true;
+    }
+    return false;
+}
+
+bool WorkerPool::pop_injected(Task& task) {
+    std::lock_guard<std::mutex> lock(inject_mutex_);
+    if (injected_.empty()) return false;
+    task = std::move(injected_.front());
+    injected_.pop_front();
+    --queued_;
+    return true;
+}
+
+void WorkerPool::notify_work() {
+    // A sleeper registers before re-checking queued_, so either it sees the
+    // new task or we see it; taking the lock orders us after its check
+    if (sleepers_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        wake_.notify_one();
+    }
+}
+
+void WorkerPool::notify_helpers() {
+    // As notify_work: a helper counts itself before checking its condition
+    if (helpers_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        help_.notify_all();
+    }
+}
+
+void WorkerPool::worker_loop(size_t index) {
+    pin_current_thread(workers_[index]->cpu);
+    tls_pool = this;
+    tls_worker = index;
+
+    for (;;) {
+        Task task;
+        if (pop_local(index, task) || steal(index, task) || pop_injected(task)) {
+            execute(std::move(task), index);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        if (stopping_) return;
+        ++sleepers_;
+        wake_.wait(lock, [&] { return stopping_ || queued_.load() > 0; });
+        --sleepers_;
+        if (stopping_ && queued_.load() == 0) return;
+    }
+}
+
+std::shared_ptr<WorkerPool> shared_worker_pool(size_t num_workers, Context::ThreadAffinity affinity) {
+    static std::mutex mutex;
+    static std::vector<std::shared_ptr<WorkerPool>> pools;   // Most recently used first
+
+    if (num_workers == 0) num_workers = system_topology().num_cpus();
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<WorkerPool> pool;
+    for (auto it = pools.begin(); it != pools.end(); ++it) {
+        if ((*it)->num_workers() == num_workers && (*it)->affinity() == affinity) {
+            pool = *it;
+            pools.erase(it);
+            break;
+        }
+    }
+    if (!pool) pool = std::make_shared<WorkerPool>(num_workers, affinity);
+    pools.insert(pools.begin(), pool);
+    if (pools.size() > kMaxSharedPools) pools.pop_back();
+    return pool;
+}
+
+} // namespace mcoptions
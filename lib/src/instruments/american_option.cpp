@@ -15,7 +15,7 @@ double price_american_option(Context& ctx, const AmericanOptionData& option) {
     std::vector<std::vector<double>> all_paths(num_paths);
     
     for (size_t i = 0; i < num_paths; ++i) {
-        auto normals = generate_normal_samples(ctx.get_rng(), num_steps);
+        auto normals = generate_normal_samples(ctx.get_rng(), num_steps, ctx.get_normal_method());
         all_paths[i] = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
                                           option.time_to_maturity, num_steps, normals);
     }
@@ -1,49 +1,67 @@
 #include "internal/instruments/asian_option.hpp"
-#include "internal/methods/monte_carlo.hpp"
-#include "internal/random.hpp"
+#include "internal/methods/path_kernel.hpp"
+#include "internal/methods/simulation_workspace.hpp"
+#include "internal/methods/time_grid.hpp"
 #include <cmath>
-#include <numeric>
+#include <stdexcept>
 
 namespace mcoptions {
 
+namespace {
+
+// Running sum of the spot on observation dates
+struct AsianState {
+    static constexpr bool pathwise = true;
+
+    const std::vector<char>* observed;  // Per grid point
+    double strike;
+    OptionType type;
+    size_t num_observations;
+    size_t index;
+    double sum;
+
+    void begin(double) {
+        index = 0;
+        sum = 0.0;
+    }
+
+    void step(double, double, double, double x1, double) {
+        if ((*observed)[++index]) sum += std::exp(x1);
+    }
+
+    double payoff(double) const {
+        return mcoptions::payoff(sum / static_cast<double>(num_observations), strike, type);
+    }
+};
+
+} // anonymous namespace
+
 double price_asian_option(Context& ctx, const AsianOptionData& option) {
-    double sum_payoff = 0.0;
-    
-    size_t effective_paths = ctx.get_antithetic() ? ctx.get_num_simulations() / 2 : ctx.get_num_simulations();
-    
-    for (size_t i = 0; i < effective_paths; ++i) {
-        auto normals = generate_normal_samples(ctx.get_rng(), ctx.get_num_steps());
-        auto path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                       option.time_to_maturity, ctx.get_num_steps(), normals);
-        
-        size_t obs_step = ctx.get_num_steps() / option.num_observations;
-        double sum_spots = 0.0;
-        for (int j = 0; j < option.num_observations; ++j) {
-            size_t idx = std::min((j + 1) * obs_step, ctx.get_num_steps());
-            sum_spots += path[idx];
-        }
-        double avg_spot = sum_spots / option.num_observations;
-        double poff = payoff(avg_spot, option.strike, option.type);
-        sum_payoff += poff;
-        
-        if (ctx.get_antithetic()) {
-            for (auto& z : normals) z = -z;
-            auto anti_path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                                option.time_to_maturity, ctx.get_num_steps(), normals);
-            double anti_sum_spots = 0.0;
-            for (int j = 0; j < option.num_observations; ++j) {
-                size_t idx = std::min((j + 1) * obs_step, ctx.get_num_steps());
-                anti_sum_spots += anti_path[idx];
-            }
-            double anti_avg_spot = anti_sum_spots / option.num_observations;
-            double anti_poff = payoff(anti_avg_spot, option.strike, option.type);
-            sum_payoff += anti_poff;
-        }
+    if (option.num_observations == 0) {
+        throw std::invalid_argument("Asian option needs at least one observation");
     }
-    
-    size_t total_paths = ctx.get_antithetic() ? ctx.get_num_simulations() : effective_paths;
-    double avg_payoff = sum_payoff / total_paths;
-    return discount_factor(option.rate, option.time_to_maturity) * avg_payoff;
+
+    // Equally spaced observations ending at maturity; the grid steps only over them
+    KernelGrid local;
+    const KernelGrid& grid = kernel_grid(
+        ctx, GridKey{"asian", option.time_to_maturity, option.num_observations}, local,
+        [&](KernelGrid& out) {
+            std::vector<double> dates(option.num_observations);
+            for (size_t j = 0; j < option.num_observations; ++j) {
+                dates[j] = option.time_to_maturity * static_cast<double>(j + 1) /
+                           static_cast<double>(option.num_observations);
+            }
+            out.grid = build_time_grid(option.time_to_maturity, dates);
+            out.marks.assign(out.grid.times.size(), 0);
+            for (size_t step : out.grid.event_steps) out.marks[step] = 1;
+        });
+
+    AsianState prototype{&grid.marks, option.strike, option.type, option.num_observations, 0, 0.0};
+    ctx.set_job_fingerprint(job_fingerprint("asian", {
+        option.spot, option.strike, option.rate, option.volatility, option.time_to_maturity,
+        static_cast<double>(option.type), static_cast<double>(option.num_observations)}));
+    return price_streaming(ctx, option.spot, option.rate, option.volatility, grid.grid.times,
+                           prototype);
 }
 
 }
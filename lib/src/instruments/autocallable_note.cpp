@@ -0,0 +1,196 @@
+#include "internal/instruments/autocallable_note.hpp"
+#include "internal/models/correlated_gbm.hpp"
+#include "internal/random.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mcoptions {
+
+namespace {
+
+const size_t kBlockSize = 256;
+
+void validate(const AutocallableNoteData& note) {
+    size_t n = note.spots.size();
+    if (n == 0) {
+        throw std::invalid_argument("Autocallable needs at least one underlying");
+    }
+    if (note.volatilities.size() != n ||
+        (!note.initial_fixings.empty() && note.initial_fixings.size() != n)) {
+        throw std::invalid_argument("Spots, fixings and volatilities must have the same length");
+    }
+    for (size_t a = 0; a < n; ++a) {
+        if (note.spots[a] <= 0.0 || note.volatilities[a] < 0.0) {
+            throw std::invalid_argument("Spots must be positive and volatilities non-negative");
+        }
+        if (!note.initial_fixings.empty() && note.initial_fixings[a] <= 0.0) {
+            throw std::invalid_argument("Initial fixings must be positive");
+        }
+    }
+
+    const AutocallableTerms& t = note.terms;
+    if (t.observation_dates.empty()) {
+        throw std::invalid_argument("Autocallable needs at least one observation date");
+    }
+    double prev = 0.0;
+    for (double d : t.observation_dates) {
+        if (d <= prev) {
+            throw std::invalid_argument("Observation dates must be positive and increasing");
+        }
+        prev = d;
+    }
+    if (t.autocall_barrier <= 0.0 || t.coupon_barrier <= 0.0 ||
+        t.knock_in_barrier < 0.0 || t.put_strike <= 0.0) {
+        throw std::invalid_argument("Barriers and put strike must be positive");
+    }
+}
+
+} // anonymous namespace
+
+AutocallableResult price_autocallable_note(Context& ctx, const AutocallableNoteData& note) {
+    validate(note);
+
+    const AutocallableTerms& terms = note.terms;
+    const size_t num_assets = note.spots.size();
+    const size_t num_dates = terms.observation_dates.size();
+    const size_t num_paths = ctx.get_num_simulations();
+    Mt19937_64& rng = ctx.get_rng();
+    NormalMethod normal_method = ctx.get_normal_method();
+
+    std::vector<double> factor = cholesky_factor(note.correlation, num_assets);
+
+    // Per-interval drift/diffusion per asset and discount factors per date
+    std::vector<double> drift(num_assets * num_dates);
+    std::vector<double> diffusion(num_assets * num_dates);
+    std::vector<double> discount(num_dates);
+    for (size_t i = 0; i < num_dates; ++i) {
+        double t0 = i == 0 ? 0.0 : terms.observation_dates[i - 1];
+        double dt = terms.observation_dates[i] - t0;
+        for (size_t a = 0; a < num_assets; ++a) {
+            double vol = note.volatilities[a];
+            drift[a * num_dates + i] = (note.rate - 0.5 * vol * vol) * dt;
+            diffusion[a * num_dates + i] = vol * std::sqrt(dt);
+        }
+        discount[i] = std::exp(-note.rate * terms.observation_dates[i]);
+    }
+
+    // Barriers in log-performance space
+    const double log_autocall = std::log(terms.autocall_barrier);
+    const double log_coupon = std::log(terms.coupon_barrier);
+    const double log_knock_in = terms.knock_in_barrier > 0.0
+        ? std::log(terms.knock_in_barrier) : -HUGE_VAL;
+    const double coupon = terms.coupon_rate * terms.notional;
+
+    std::vector<double> x_start(num_assets);
+    for (size_t a = 0; a < num_assets; ++a) {
+        double fixing = note.initial_fixings.empty() ? note.spots[a] : note.initial_fixings[a];
+        x_start[a] = std::log(note.spots[a] / fixing);
+    }
+
+    // Structure-of-arrays lane state: x[a * kBlockSize + j] is the
+    // log-performance of asset a on lane j
+    std::vector<double> x(num_assets * kBlockSize);
+    std::vector<double> w(num_assets * kBlockSize);
+    std::vector<double> worst(kBlockSize);
+    std::vector<double> pv(kBlockSize);
+    std::vector<int> missed(kBlockSize);
+    std::vector<double> z(num_assets);
+    std::vector<double> zc(num_assets);
+
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    size_t lane_steps = 0;
+
+    auto retire = [&](size_t j, size_t& active) {
+        sum += pv[j];
+        sum_sq += pv[j] * pv[j];
+        size_t last = --active;
+        if (j != last) {
+            for (size_t a = 0; a < num_assets; ++a) {
+                x[a * kBlockSize + j] = x[a * kBlockSize + last];
+            }
+            pv[j] = pv[last];
+            missed[j] = missed[last];
+        }
+    };
+
+    for (size_t block_start = 0; block_start < num_paths; block_start += kBlockSize) {
+        size_t active = std::min(kBlockSize, num_paths - block_start);
+        for (size_t a = 0; a < num_assets; ++a) {
+            std::fill(x.begin() + a * kBlockSize, x.begin() + a * kBlockSize + active, x_start[a]);
+        }
+        std::fill(pv.begin(), pv.begin() + active, 0.0);
+        std::fill(missed.begin(), missed.begin() + active, 0);
+
+        for (size_t i = 0; i < num_dates && active > 0; ++i) {
+            lane_steps += active;
+
+            // Normals only for lanes still alive
+            if (num_assets == 1) {
+                fill_normals(rng, normal_method, w.data(), active);
+            } else {
+                for (size_t j = 0; j < active; ++j) {
+                    fill_normals(rng, normal_method, z.data(), num_assets);
+                    correlate_normals(factor, num_assets, z.data(), zc.data());
+                    for (size_t a = 0; a < num_assets; ++a) w[a * kBlockSize + j] = zc[a];
+                }
+            }
+
+            // Dense per-asset updates over the active prefix
+            for (size_t a = 0; a < num_assets; ++a) {
+                double mu = drift[a * num_dates + i];
+                double sd = diffusion[a * num_dates + i];
+                double* xa = &x[a * kBlockSize];
+                const double* wa = &w[a * kBlockSize];
+                for (size_t j = 0; j < active; ++j) {
+                    xa[j] += mu + sd * wa[j];
+                }
+            }
+
+            std::copy(x.begin(), x.begin() + active, worst.begin());
+            for (size_t a = 1; a < num_assets; ++a) {
+                const double* xa = &x[a * kBlockSize];
+                for (size_t j = 0; j < active; ++j) {
+                    worst[j] = std::min(worst[j], xa[j]);
+                }
+            }
+
+            bool final_date = i + 1 == num_dates;
+            double df = discount[i];
+
+            // Walk backwards so retiring a lane only moves already-visited lanes
+            for (size_t j = active; j-- > 0;) {
+                double perf = worst[j];
+
+                if (perf >= log_coupon) {
+                    int periods = terms.memory ? missed[j] + 1 : 1;
+                    pv[j] += df * coupon * periods;
+                    missed[j] = 0;
+                } else {
+                    ++missed[j];
+                }
+
+                if (final_date) {
+                    double redemption = terms.notional;
+                    if (perf < log_knock_in) {
+                        redemption *= std::min(1.0, std::exp(perf) / terms.put_strike);
+                    }
+                    pv[j] += df * redemption;
+                    retire(j, active);
+                } else if (perf >= log_autocall) {
+                    pv[j] += df * terms.notional;
+                    retire(j, active);
+                }
+            }
+        }
+    }
+
+    double n = static_cast<double>(num_paths);
+    double mean = sum / n;
+    double variance = num_paths > 1 ? std::max(0.0, (sum_sq - n * mean * mean) / (n - 1.0)) : 0.0;
+
+    return AutocallableResult{mean, std::sqrt(variance / n), static_cast<double>(lane_steps) / n};
+}
+
+}
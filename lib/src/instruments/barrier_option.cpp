@@ -1,18 +1,123 @@
 #include "internal/instruments/barrier_option.hpp"
+#include "internal/instruments/window_barrier_option.hpp"
+#include "internal/methods/analytic_exotics.hpp"
+#include "internal/methods/brownian_bridge.hpp"
 #include "internal/methods/monte_carlo.hpp"
+#include "internal/methods/path_kernel.hpp"
+#include "internal/methods/simulation_workspace.hpp"
 #include "internal/random.hpp"
 #include <cmath>
 #include <algorithm>
 
 namespace mcoptions {
 
+namespace {
+
+// Discretely monitored barrier, paired with the Brownian-bridge estimate of
+// the continuously monitored contract at the BGK-shifted barrier. The latter
+// has the shifted Reiner-Rubinstein price as its exact expectation and tracks
+// the discrete payoff closely, which makes it a strong control variate.
+struct BarrierControlState {
+    double log_barrier;
+    double log_shifted;
+    bool upper;
+    bool knock_in;
+    double strike;
+    OptionType type;
+    double rebate;
+    bool hit;
+    double survival;
+
+    bool beyond(double x, double level) const {
+        return upper ? x >= level : x <= level;
+    }
+
+    void begin(double x0) {
+        hit = beyond(x0, log_barrier);
+        survival = beyond(x0, log_shifted) ? 0.0 : 1.0;
+    }
+
+    void step(double, double, double x0, double x1, double variance) {
+        if (!hit) hit = beyond(x1, log_barrier);
+        if (survival > 0.0) {
+            survival *= 1.0 - barrier_crossing_probability(x0, x1, log_shifted, upper, variance);
+        }
+    }
+
+    double payoff(double spot) const {
+        double vanilla = mcoptions::payoff(spot, strike, type);
+        return hit == knock_in ? vanilla : rebate;
+    }
+
+    double control(double spot) const {
+        double vanilla = mcoptions::payoff(spot, strike, type);
+        return knock_in
+            ? (1.0 - survival) * vanilla + survival * rebate
+            : survival * vanilla + (1.0 - survival) * rebate;
+    }
+};
+
+double price_barrier_option_with_control(Context& ctx, const BarrierOptionData& option) {
+    size_t num_steps = ctx.get_num_steps();
+    bool upper = option.barrier_type == BarrierType::UpAndOut ||
+                 option.barrier_type == BarrierType::UpAndIn;
+    bool knock_in = option.barrier_type == BarrierType::UpAndIn ||
+                    option.barrier_type == BarrierType::DownAndIn;
+
+    double shift = analytic::bgk_shift(option.volatility, option.time_to_maturity, num_steps);
+    double log_barrier = std::log(option.barrier_level);
+    double log_shifted = upper ? log_barrier + shift : log_barrier - shift;
+
+    double control_mean = analytic::barrier_price(
+        option.spot, option.strike, option.rate, option.volatility, option.time_to_maturity,
+        std::exp(log_shifted), option.barrier_type, option.rebate, option.type);
+
+    KernelGrid local;
+    const KernelGrid& grid = kernel_grid(
+        ctx, GridKey{"barrier", option.time_to_maturity, num_steps}, local, [&](KernelGrid& out) {
+            out.grid.times = uniform_time_grid(option.time_to_maturity, num_steps);
+        });
+
+    BarrierControlState prototype{log_barrier, log_shifted, upper, knock_in,
+                                  option.strike, option.type, option.rebate, false, 1.0};
+    ctx.set_job_fingerprint(job_fingerprint("barrier", {
+        option.spot, option.strike, option.rate, option.volatility, option.time_to_maturity,
+        static_cast<double>(option.type), option.barrier_level,
+        static_cast<double>(option.barrier_type), option.rebate}));
+    return price_streaming_with_control(ctx, option.spot, option.rate, option.volatility,
+                                        grid.grid.times, prototype, control_mean);
+}
+
+} // anonymous namespace
+
 double price_barrier_option(Context& ctx, const BarrierOptionData& option) {
+    if (option.continuous_monitoring && ctx.get_model() == Context::Model::BlackScholes) {
+        return analytic::barrier_price(option.spot, option.strike, option.rate, option.volatility,
+                                       option.time_to_maturity, option.barrier_level,
+                                       option.barrier_type, option.rebate, option.type);
+    }
+    return price_barrier_option_mc(ctx, option);
+}
+
+double price_barrier_option_mc(Context& ctx, const BarrierOptionData& option) {
+    if (option.continuous_monitoring) {
+        // A window covering the whole life is a continuously monitored barrier
+        WindowBarrierOptionData window{option.spot, option.strike, option.rate, option.volatility,
+                                       option.time_to_maturity, option.type, option.barrier_level,
+                                       option.barrier_type, 0.0, option.time_to_maturity,
+                                       option.rebate};
+        return price_window_barrier_option(ctx, window);
+    }
+    if (ctx.get_control_variates() && option.volatility > 0.0 && option.barrier_level > 0.0) {
+        return price_barrier_option_with_control(ctx, option);
+    }
+
     double sum_payoff = 0.0;
     
     size_t effective_paths = ctx.get_antithetic() ? ctx.get_num_simulations() / 2 : ctx.get_num_simulations();
     
     for (size_t i = 0; i < effective_paths; ++i) {
-        auto normals = generate_normal_samples(ctx.get_rng(), ctx.get_num_steps());
+        auto normals = generate_normal_samples(ctx.get_rng(), ctx.get_num_steps(), ctx.get_normal_method());
         auto path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
                                        option.time_to_maturity, ctx.get_num_steps(), normals);
         
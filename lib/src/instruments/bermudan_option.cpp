@@ -1,5 +1,6 @@
 #include "internal/instruments/bermudan_option.hpp"
 #include "internal/methods/monte_carlo.hpp"
+#include "internal/methods/time_grid.hpp"
 #include "internal/random.hpp"
 #include <cmath>
 #include <vector>
@@ -18,27 +19,25 @@ double price_bermudan_option(Context& ctx, const BermudanOptionData& option) {
                            option.volatility, option.time_to_maturity, option.type};
         double final_payoff = 0.0;
         for (size_t i = 0; i < num_paths; ++i) {
-            auto normals = generate_normal_samples(ctx.get_rng(), ctx.get_num_steps());
+            auto normals = generate_normal_samples(ctx.get_rng(), 1, ctx.get_normal_method());
             auto path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                           option.time_to_maturity, ctx.get_num_steps(), normals);
+                                           option.time_to_maturity, 1, normals);
             final_payoff += payoff(path.back(), option.strike, option.type);
         }
         return discount_factor(option.rate, option.time_to_maturity) * (final_payoff / num_paths);
     }
     
+    // Simulate only at the exercise dates and maturity
+    TimeGrid grid = build_time_grid(option.time_to_maturity, option.exercise_dates);
+    const std::vector<size_t>& exercise_steps = grid.event_steps;
+    size_t num_grid_steps = grid.times.size() - 1;
+    
     // Generate all paths
     std::vector<std::vector<double>> all_paths(num_paths);
     for (size_t i = 0; i < num_paths; ++i) {
-        auto normals = generate_normal_samples(ctx.get_rng(), ctx.get_num_steps());
+        auto normals = generate_normal_samples(ctx.get_rng(), num_grid_steps, ctx.get_normal_method());
         all_paths[i] = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                          option.time_to_maturity, ctx.get_num_steps(), normals);
-    }
-    
-    // Map exercise dates to step indices
-    std::vector<size_t> exercise_steps;
-    for (double ex_date : option.exercise_dates) {
-        size_t step = static_cast<size_t>((ex_date / option.time_to_maturity) * ctx.get_num_steps());
-        exercise_steps.push_back(step);
+                                          grid.times, normals);
     }
     
     // Initialize cashflows at maturity
@@ -1,54 +1,74 @@
 #include "internal/instruments/european_option.hpp"
+#include "internal/engine/parallel.hpp"
 #include "internal/methods/monte_carlo.hpp"
+#include "internal/methods/simulation_workspace.hpp"
 #include "internal/random.hpp"
 #include "internal/variance_reduction/control_variates.hpp"
 #include "internal/variance_reduction/stratified_sampling.hpp"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace mcoptions {
 
 double price_european_option(Context& ctx, const OptionData& option) {
-    double sum_payoff = 0.0;
-    double sum_control = 0.0;  // For control variates
-    
     size_t effective_paths = ctx.get_antithetic() ? ctx.get_num_simulations() / 2 : ctx.get_num_simulations();
+    NormalMethod normal_method = ctx.get_normal_method();
+    // Two uniforms per Box-Muller normal; the stratified shuffle and the
+    // ziggurat draw a variable number
+    bool fixed_draws = !ctx.get_stratified_sampling() && normal_method == NormalMethod::BoxMuller;
+    uint64_t draws_per_block = fixed_draws ? kPathsPerBlock * 2 * ctx.get_num_steps() : 0;
     
-    for (size_t i = 0; i < effective_paths; ++i) {
-        // Generate random samples (stratified if enabled)
-        std::vector<double> normals;
-        if (ctx.get_stratified_sampling()) {
-            normals = generate_stratified_normals(ctx.get_rng(), ctx.get_num_steps());
-        } else {
-            normals = generate_normal_samples(ctx.get_rng(), ctx.get_num_steps());
-        }
-        
-        // Simulate path
-        auto path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                       option.time_to_maturity, ctx.get_num_steps(), normals);
-        
-        double final_spot = path.back();
-        double poff = payoff(final_spot, option.strike, option.type);
-        sum_payoff += poff;
-        
-        // For control variates: accumulate payoff
-        if (ctx.get_control_variates()) {
-            sum_control += poff;
-        }
-        
-        // Antithetic variates
-        if (ctx.get_antithetic()) {
-            for (auto& z : normals) z = -z;
-            auto anti_path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                                option.time_to_maturity, ctx.get_num_steps(), normals);
-            double anti_final_spot = anti_path.back();
-            double anti_poff = payoff(anti_final_spot, option.strike, option.type);
-            sum_payoff += anti_poff;
+    size_t num_steps = ctx.get_num_steps();
+    double dt = option.time_to_maturity / num_steps;
+    double drift = (option.rate - 0.5 * option.volatility * option.volatility) * dt;
+    double diffusion = option.volatility * std::sqrt(dt);
+    
+    size_t num_blocks = count_blocks(effective_paths, kPathsPerBlock);
+    SimulationWorkspace* workspace = ctx.get_workspace().get();
+    if (workspace) workspace->reserve_blocks(num_blocks);
+    
+    ctx.set_job_fingerprint(job_fingerprint("european", {
+        option.spot, option.strike, option.rate, option.volatility, option.time_to_maturity,
+        static_cast<double>(option.type)}));
+    SampleMoments moments = simulate_blocks(
+        ctx, num_blocks, draws_per_block,
+        [&](size_t block, auto& rng, auto& acc) {
+            size_t first = block * kPathsPerBlock;
+            size_t last = std::min(first + kPathsPerBlock, effective_paths);
+            // One buffer per block (the workspace's in a plan); only the terminal spot is kept
+            std::vector<double> local_normals;
+            double* normals = block_scratch(workspace, block, num_steps, local_normals);
             
-            if (ctx.get_control_variates()) {
-                sum_control += anti_poff;
+            for (size_t i = first; i < last; ++i) {
+                // Generate random samples (stratified if enabled)
+                if (ctx.get_stratified_sampling()) {
+                    std::vector<double> stratified = generate_stratified_normals(rng, num_steps);
+                    std::copy(stratified.begin(), stratified.end(), normals);
+                } else {
+                    fill_normals(rng, normal_method, normals, num_steps);
+                }
+                
+                // Simulate path (the same updates as simulate_gbm_path)
+                double spot = option.spot;
+                for (size_t k = 0; k < num_steps; ++k) {
+                    spot = spot * std::exp(drift + diffusion * normals[k]);
+                }
+                acc.add(payoff(spot, option.strike, option.type));
+                
+                // Antithetic variates
+                if (ctx.get_antithetic()) {
+                    double anti_spot = option.spot;
+                    for (size_t k = 0; k < num_steps; ++k) {
+                        anti_spot = anti_spot * std::exp(drift + diffusion * -normals[k]);
+                    }
+                    acc.add(payoff(anti_spot, option.strike, option.type));
+                }
             }
-        }
-    }
+        });
+    double sum_payoff = moments.sum_y;
+    // The control is the payoff itself, priced in closed form below
+    double sum_control = moments.sum_y;
     
     size_t total_paths = ctx.get_antithetic() ? ctx.get_num_simulations() : effective_paths;
     double avg_payoff = sum_payoff / total_paths;
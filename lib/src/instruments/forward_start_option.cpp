@@ -0,0 +1,78 @@
+#include "internal/instruments/forward_start_option.hpp"
+#include "internal/methods/path_kernel.hpp"
+#include "internal/methods/simulation_workspace.hpp"
+#include "internal/variance_reduction/control_variates.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace mcoptions {
+
+namespace {
+
+// Remembers the log-spot at the strike-setting date
+struct ForwardStartState {
+    static constexpr bool pathwise = true;
+
+    double start_time;
+    double strike_ratio;
+    OptionType type;
+    double log_fixing;
+
+    void begin(double x0) {
+        log_fixing = x0;
+    }
+
+    void step(double, double t1, double, double x1, double) {
+        if (t1 == start_time) log_fixing = x1;
+    }
+
+    double payoff(double spot) const {
+        return mcoptions::payoff(spot, strike_ratio * std::exp(log_fixing), type);
+    }
+};
+
+void validate(const ForwardStartOptionData& option) {
+    if (option.spot <= 0.0 || option.strike_ratio <= 0.0) {
+        throw std::invalid_argument("Spot and strike ratio must be positive");
+    }
+    if (option.volatility < 0.0) {
+        throw std::invalid_argument("Volatility cannot be negative");
+    }
+    if (option.start_time < 0.0 || option.time_to_maturity <= option.start_time) {
+        throw std::invalid_argument("Need 0 <= start time < maturity");
+    }
+}
+
+} // anonymous namespace
+
+double price_forward_start_option(Context& ctx, const ForwardStartOptionData& option) {
+    validate(option);
+    if (ctx.get_model() == Context::Model::BlackScholes) {
+        return black_scholes::forward_start_price(option.spot, option.strike_ratio, option.rate,
+                                                  option.volatility, option.start_time,
+                                                  option.time_to_maturity, option.type);
+    }
+    return price_forward_start_option_mc(ctx, option);
+}
+
+double price_forward_start_option_mc(Context& ctx, const ForwardStartOptionData& option) {
+    validate(option);
+
+    size_t dates = option.start_time > 0.0 ? 1 : 0;
+    KernelGrid local;
+    const KernelGrid& grid = kernel_grid(
+        ctx, GridKey{"forward_start", option.time_to_maturity, dates}, local, [&](KernelGrid& out) {
+            out.grid.times.push_back(0.0);
+            if (option.start_time > 0.0) out.grid.times.push_back(option.start_time);
+            out.grid.times.push_back(option.time_to_maturity);
+        });
+
+    ForwardStartState prototype{option.start_time, option.strike_ratio, option.type, 0.0};
+    ctx.set_job_fingerprint(job_fingerprint("forward_start", {
+        option.spot, option.strike_ratio, option.rate, option.volatility, option.start_time,
+        option.time_to_maturity, static_cast<double>(option.type)}));
+    return price_streaming(ctx, option.spot, option.rate, option.volatility, grid.grid.times,
+                           prototype);
+}
+
+}
@@ -0,0 +1,305 @@
+#include "internal/instruments/instrument_descriptor.hpp"
+#include "internal/instruments/european_option.hpp"
+#include "internal/instruments/american_option.hpp"
+#include "internal/instruments/asian_option.hpp"
+#include "internal/instruments/lookback_option.hpp"
+#include "internal/instruments/bermudan_option.hpp"
+#include "internal/instruments/double_barrier_option.hpp"
+#include "internal/instruments/window_barrier_option.hpp"
+#include "internal/instruments/parisian_option.hpp"
+#include "internal/instruments/forward_start_option.hpp"
+#include "internal/methods/analytic_exotics.hpp"
+#include "internal/methods/binomial_tree.hpp"
+#include "internal/methods/least_squares_monte_carlo.hpp"
+#include "internal/methods/time_grid.hpp"
+#include "internal/variance_reduction/control_variates.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace mcoptions {
+
+namespace {
+
+const double kNoErrorEstimate = std::numeric_limits<double>::quiet_NaN();
+
+PricingResult mc_result(const Context& ctx, double price) {
+    return PricingResult{price, kNoErrorEstimate, PricingMethod::MonteCarlo,
+                         ctx.get_num_simulations(), ctx.get_num_steps()};
+}
+
+PricingResult price_vanilla(Context& ctx, const InstrumentDescriptor& inst, ExerciseStyle style) {
+    const OptionData& o = inst.option;
+    const CostModel& model = default_cost_model();
+    double scale = o.spot * o.volatility * std::sqrt(o.time_to_maturity);
+
+    switch (inst.method) {
+        case PricingMethod::Auto:
+            return price_auto(ctx, o, style, inst.tolerance);
+
+        case PricingMethod::Analytic:
+            if (style == ExerciseStyle::American && o.type == OptionType::Put) {
+                throw std::domain_error("No closed form for American puts");
+            }
+            return PricingResult{
+                black_scholes::price(o.spot, o.strike, o.rate, o.volatility,
+                                     o.time_to_maturity, o.type),
+                0.0, PricingMethod::Analytic, 0, 0};
+
+        case PricingMethod::BinomialTree: {
+            size_t steps = ctx.get_binomial_steps();
+            double price = style == ExerciseStyle::European
+                ? price_european_option_binomial(ctx, o, steps)
+                : price_american_option_binomial(ctx, o, steps);
+            return PricingResult{price, model.tree_error_coeff * scale / static_cast<double>(steps),
+                                 PricingMethod::BinomialTree, 0, steps};
+        }
+
+        case PricingMethod::MonteCarlo: {
+            if (style == ExerciseStyle::European) {
+                PricingResult result = mc_result(ctx, price_european_option(ctx, o));
+                result.error_estimate = vanilla_payoff_stddev(o) /
+                    std::sqrt(static_cast<double>(ctx.get_num_simulations()));
+                return result;
+            }
+            AmericanOptionData data;
+            static_cast<OptionData&>(data) = o;
+            data.num_exercise_points = inst.num_exercise_points > 0
+                ? inst.num_exercise_points : model.lsm_exercise_dates;
+            PricingResult result = mc_result(ctx, price_american_option(ctx, data));
+            result.num_steps = data.num_exercise_points;
+            return result;
+        }
+
+        case PricingMethod::LeastSquaresMC: {
+            if (style == ExerciseStyle::European) {
+                throw std::domain_error("LSM only applies to early exercise");
+            }
+            size_t dates = inst.num_exercise_points > 0
+                ? inst.num_exercise_points : model.lsm_exercise_dates;
+            return PricingResult{price_american_option_lsm(ctx, o, dates), kNoErrorEstimate,
+                                 PricingMethod::LeastSquaresMC, ctx.get_num_simulations(), dates};
+        }
+    }
+
+    throw std::invalid_argument("Unknown pricing method");
+}
+
+// Path-dependent products only have Monte Carlo pricers for now, which is
+// also what Auto resolves to
+void require_monte_carlo(const InstrumentDescriptor& inst) {
+    if (inst.method != PricingMethod::Auto && inst.method != PricingMethod::MonteCarlo) {
+        throw std::domain_error("Only Monte Carlo is available for this instrument");
+    }
+}
+
+// Barriers and lookbacks: the closed form is exact for continuous monitoring
+// and BGK-adjusted for discrete monitoring. Auto only takes it when exact.
+bool use_closed_form(const Context& ctx, const InstrumentDescriptor& inst) {
+    switch (inst.method) {
+        case PricingMethod::Analytic:
+            if (inst.option.volatility <= 0.0) {
+                throw std::domain_error("Closed forms need a positive volatility");
+            }
+            return true;
+        case PricingMethod::Auto:
+            return inst.continuous_monitoring && inst.option.volatility > 0.0 &&
+                   ctx.get_model() == Context::Model::BlackScholes;
+        case PricingMethod::MonteCarlo:
+            return false;
+        default:
+            throw std::domain_error("Only closed form or Monte Carlo is available for this instrument");
+    }
+}
+
+size_t monitoring_steps(const Context& ctx, const InstrumentDescriptor& inst) {
+    return inst.continuous_monitoring ? 0 : ctx.get_num_steps();
+}
+
+PricingResult closed_form_result(const Context& ctx, const InstrumentDescriptor& inst, double price) {
+    // The BGK correction has no usable error bound
+    double error = inst.continuous_monitoring ? 0.0 : kNoErrorEstimate;
+    return PricingResult{price, error, PricingMethod::Analytic, 0, monitoring_steps(ctx, inst)};
+}
+
+} // anonymous namespace
+
+void validate_market_inputs(const InstrumentDescriptor& inst) {
+    const OptionData& o = inst.option;
+    if (inst.kind != InstrumentKind::Cliquet && o.spot <= 0.0) {
+        throw std::invalid_argument("Spot must be positive and strike non-negative");
+    }
+    if (o.volatility < 0.0) {
+        throw std::invalid_argument("Volatility cannot be negative");
+    }
+}
+
+void validate_instrument(const InstrumentDescriptor& inst) {
+    const OptionData& o = inst.option;
+    if (inst.kind != InstrumentKind::Cliquet &&
+        (o.strike < 0.0 || (inst.kind == InstrumentKind::Autocallable && o.strike <= 0.0))) {
+        throw std::invalid_argument("Spot must be positive and strike non-negative");
+    }
+    validate_market_inputs(inst);
+    if (inst.kind != InstrumentKind::Cliquet && o.time_to_maturity <= 0.0) {
+        throw std::invalid_argument("Time to maturity must be positive");
+    }
+
+    switch (inst.kind) {
+        case InstrumentKind::Asian:
+            if (inst.num_observations == 0) {
+                throw std::invalid_argument("Asian option needs at least one observation");
+            }
+            break;
+        case InstrumentKind::Barrier:
+            if (inst.barrier_level <= 0.0) {
+                throw std::invalid_argument("Barrier level must be positive");
+            }
+            break;
+        case InstrumentKind::Bermudan:
+            if (inst.exercise_dates.empty()) {
+                throw std::invalid_argument("Bermudan option needs at least one exercise date");
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+PricingResult price_instrument(Context& ctx, const InstrumentDescriptor& inst) {
+    validate_instrument(inst);
+    return price_validated_instrument(ctx, inst);
+}
+
+PricingResult price_validated_instrument(Context& ctx, const InstrumentDescriptor& inst) {
+    const OptionData& o = inst.option;
+
+    switch (inst.kind) {
+        case InstrumentKind::European:
+            return price_vanilla(ctx, inst, ExerciseStyle::European);
+
+        case InstrumentKind::American:
+            return price_vanilla(ctx, inst, ExerciseStyle::American);
+
+        case InstrumentKind::Asian: {
+            require_monte_carlo(inst);
+            AsianOptionData data;
+            static_cast<OptionData&>(data) = o;
+            data.num_observations = inst.num_observations;
+            PricingResult result = mc_result(ctx, price_asian_option(ctx, data));
+            result.num_steps = inst.num_observations;
+            return result;
+        }
+
+        case InstrumentKind::Barrier: {
+            BarrierOptionData data{o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                                   o.type, inst.barrier_level, inst.barrier_type, inst.rebate,
+                                   inst.continuous_monitoring};
+            if (use_closed_form(ctx, inst)) {
+                return closed_form_result(ctx, inst, analytic::barrier_price(
+                    o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                    inst.barrier_level, inst.barrier_type, inst.rebate, o.type,
+                    monitoring_steps(ctx, inst)));
+            }
+            return mc_result(ctx, price_barrier_option_mc(ctx, data));
+        }
+
+        case InstrumentKind::Lookback: {
+            LookbackOptionData data{o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                                    o.type, inst.fixed_strike, inst.continuous_monitoring};
+            if (use_closed_form(ctx, inst)) {
+                return closed_form_result(ctx, inst, analytic::lookback_price(
+                    o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                    inst.fixed_strike, o.type, monitoring_steps(ctx, inst)));
+            }
+            return mc_result(ctx, price_lookback_option_mc(ctx, data));
+        }
+
+        case InstrumentKind::Bermudan: {
+            require_monte_carlo(inst);
+            BermudanOptionData data{o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                                    o.type, inst.exercise_dates};
+            PricingResult result = mc_result(ctx, price_bermudan_option(ctx, data));
+            result.num_steps = inst.exercise_dates.size();
+            return result;
+        }
+
+        case InstrumentKind::DoubleBarrier: {
+            require_monte_carlo(inst);
+            DoubleBarrierOptionData data{o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                                         o.type, inst.lower_barrier, inst.upper_barrier,
+                                         inst.knock_in, inst.rebate};
+            PricingResult result = mc_result(ctx, price_double_barrier_option(ctx, data));
+            result.num_steps = 1;
+            return result;
+        }
+
+        case InstrumentKind::WindowBarrier: {
+            require_monte_carlo(inst);
+            WindowBarrierOptionData data{o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                                         o.type, inst.barrier_level, inst.barrier_type,
+                                         inst.window_start, inst.window_end, inst.rebate};
+            PricingResult result = mc_result(ctx, price_window_barrier_option(ctx, data));
+            result.num_steps = build_time_grid(o.time_to_maturity,
+                                               {inst.window_start, inst.window_end}).times.size() - 1;
+            return result;
+        }
+
+        case InstrumentKind::Parisian: {
+            require_monte_carlo(inst);
+            ParisianOptionData data{o.spot, o.strike, o.rate, o.volatility, o.time_to_maturity,
+                                    o.type, inst.barrier_level, inst.barrier_type,
+                                    inst.excursion_window, inst.rebate};
+            return mc_result(ctx, price_parisian_option(ctx, data));
+        }
+
+        case InstrumentKind::Autocallable: {
+            require_monte_carlo(inst);
+            AutocallableNoteData data{{o.spot}, {o.strike}, {o.volatility}, {}, o.rate,
+                                      inst.autocallable};
+            AutocallableResult note = price_autocallable_note(ctx, data);
+            return PricingResult{note.price, note.std_error, PricingMethod::MonteCarlo,
+                                 ctx.get_num_simulations(),
+                                 inst.autocallable.observation_dates.size()};
+        }
+
+        case InstrumentKind::ForwardStart: {
+            ForwardStartOptionData data{o.spot, o.strike, o.rate, o.volatility,
+                                        inst.start_time, o.time_to_maturity, o.type};
+            switch (inst.method) {
+                case PricingMethod::Analytic:
+                    return PricingResult{black_scholes::forward_start_price(
+                                             o.spot, o.strike, o.rate, o.volatility,
+                                             inst.start_time, o.time_to_maturity, o.type),
+                                         0.0, PricingMethod::Analytic, 0, 0};
+                case PricingMethod::Auto:
+                    if (ctx.get_model() == Context::Model::BlackScholes) {
+                        return PricingResult{price_forward_start_option(ctx, data), 0.0,
+                                             PricingMethod::Analytic, 0, 0};
+                    }
+                    [[fallthrough]];
+                case PricingMethod::MonteCarlo: {
+                    PricingResult result = mc_result(ctx, price_forward_start_option_mc(ctx, data));
+                    result.num_steps = inst.start_time > 0.0 ? 2 : 1;
+                    return result;
+                }
+                default:
+                    throw std::domain_error("Forward starts are priced in closed form or by Monte Carlo");
+            }
+        }
+
+        case InstrumentKind::Cliquet: {
+            require_monte_carlo(inst);
+            CliquetOptionData data = inst.cliquet;
+            data.rate = o.rate;
+            data.volatility = o.volatility;
+            PricingResult result = mc_result(ctx, price_cliquet_option(ctx, data));
+            result.num_steps = data.reset_dates.size();
+            return result;
+        }
+    }
+
+    throw std::invalid_argument("Unknown instrument kind");
+}
+
+} // namespace mcoptions
@@ -1,83 +1,91 @@
 #include "internal/instruments/lookback_option.hpp"
+#include "internal/methods/analytic_exotics.hpp"
+#include "internal/methods/extremum_kernel.hpp"
 #include "internal/methods/monte_carlo.hpp"
-#include "internal/random.hpp"
 #include <cmath>
 #include <algorithm>
 
 namespace mcoptions {
 
+namespace {
+
+double lookback_payoff(double extremum, double spot, double strike, bool fixed_strike,
+                       OptionType type) {
+    if (fixed_strike) {
+        return type == OptionType::Call
+            ? std::max(0.0, extremum - strike)
+            : std::max(0.0, strike - extremum);
+    }
+    return type == OptionType::Call ? spot - extremum : extremum - spot;
+}
+
+} // anonymous namespace
+
 double price_lookback_option(Context& ctx, const LookbackOptionData& option) {
-    double sum_payoff = 0.0;
-    
-    size_t effective_paths = ctx.get_antithetic() ? ctx.get_num_simulations() / 2 : ctx.get_num_simulations();
-    
-    for (size_t i = 0; i < effective_paths; ++i) {
-        auto normals = generate_normal_samples(ctx.get_rng(), ctx.get_num_steps());
-        auto path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                       option.time_to_maturity, ctx.get_num_steps(), normals);
-        
-        // Find max and min along path
-        double max_spot = *std::max_element(path.begin(), path.end());
-        double min_spot = *std::min_element(path.begin(), path.end());
-        double final_spot = path.back();
-        
-        double poff = 0.0;
-        
-        if (option.fixed_strike) {
-            // Fixed strike lookback
-            if (option.type == OptionType::Call) {
-                // Payoff = max(S_max - K, 0)
-                poff = std::max(0.0, max_spot - option.strike);
-            } else {
-                // Payoff = max(K - S_min, 0)
-                poff = std::max(0.0, option.strike - min_spot);
-            }
-        } else {
-            // Floating strike lookback
-            if (option.type == OptionType::Call) {
-                // Payoff = S_T - S_min (always positive)
-                poff = final_spot - min_spot;
-            } else {
-                // Payoff = S_max - S_T (always positive)
-                poff = max_spot - final_spot;
-            }
-        }
-        
-        sum_payoff += poff;
-        
-        // Antithetic variates
-        if (ctx.get_antithetic()) {
-            for (auto& z : normals) z = -z;
-            auto anti_path = simulate_gbm_path(ctx, option.spot, option.rate, option.volatility,
-                                                option.time_to_maturity, ctx.get_num_steps(), normals);
-            
-            double anti_max_spot = *std::max_element(anti_path.begin(), anti_path.end());
-            double anti_min_spot = *std::min_element(anti_path.begin(), anti_path.end());
-            double anti_final_spot = anti_path.back();
-            
-            double anti_poff = 0.0;
-            
-            if (option.fixed_strike) {
-                if (option.type == OptionType::Call) {
-                    anti_poff = std::max(0.0, anti_max_spot - option.strike);
-                } else {
-                    anti_poff = std::max(0.0, option.strike - anti_min_spot);
-                }
-            } else {
-                if (option.type == OptionType::Call) {
-                    anti_poff = anti_final_spot - anti_min_spot;
-                } else {
-                    anti_poff = anti_max_spot - anti_final_spot;
-                }
+    if (option.continuous_monitoring && ctx.get_model() == Context::Model::BlackScholes) {
+        return analytic::lookback_price(option.spot, option.strike, option.rate,
+                                        option.volatility, option.time_to_maturity,
+                                        option.fixed_strike, option.type);
+    }
+    return price_lookback_option_mc(ctx, option);
+}
+
+double price_lookback_option_mc(Context& ctx, const LookbackOptionData& option) {
+    size_t num_steps = ctx.get_num_steps();
+    bool control = ctx.get_control_variates() && option.volatility > 0.0 &&
+                   !option.continuous_monitoring;
+    bool sample_bridge = option.continuous_monitoring || control;
+
+    // Each payoff only needs one extremum
+    bool track_max = option.fixed_strike == (option.type == OptionType::Call);
+
+    // Control: payoff on the bridge extremum moved by the BGK factor, whose
+    // expectation is exactly the BGK-adjusted closed form
+    double shift = analytic::bgk_shift(option.volatility, option.time_to_maturity, num_steps);
+    double bgk_factor = std::exp(track_max ? -shift : shift);
+
+    ctx.set_job_fingerprint(job_fingerprint("lookback", {
+        option.spot, option.strike, option.rate, option.volatility, option.time_to_maturity,
+        static_cast<double>(option.type), static_cast<double>(option.fixed_strike),
+        static_cast<double>(option.continuous_monitoring)}));
+
+    // Payoffs are summed undiscounted, as the serial loop did
+    SampleMoments moments = run_extremum_kernel(
+        ctx, option.spot, option.rate, option.volatility,
+        option.time_to_maturity, num_steps, track_max, sample_bridge,
+        [&](auto& acc, double terminal, double grid_extreme, double bridge_extreme) {
+            double extreme = option.continuous_monitoring ? bridge_extreme : grid_extreme;
+            double y = lookback_payoff(extreme, terminal, option.strike,
+                                       option.fixed_strike, option.type);
+            if (!control) {
+                acc.add(y);
+                return;
             }
-            
-            sum_payoff += anti_poff;
-        }
+            double x = lookback_payoff(bgk_factor * bridge_extreme, terminal,
+                                       option.strike, option.fixed_strike, option.type);
+            acc.add(y, x);
+        });
+
+    // The serial loop divided an antithetic sum by the requested path count;
+    // the sequential stream keeps that to reproduce its prices
+    double n = static_cast<double>(moments.count);
+    if (ctx.get_stream_mode() == Context::StreamMode::Sequential && ctx.get_antithetic()) {
+        n = static_cast<double>(ctx.get_num_simulations());
     }
-    
-    size_t total_paths = ctx.get_antithetic() ? ctx.get_num_simulations() : effective_paths;
-    double avg_payoff = sum_payoff / total_paths;
-    return discount_factor(option.rate, option.time_to_maturity) * avg_payoff;
+    double df = discount_factor(option.rate, option.time_to_maturity);
+    double mean_y = df * (moments.sum_y / n);
+    if (!control) {
+        return mean_y;
+    }
+
+    double control_mean = analytic::lookback_price(
+        option.spot, option.strike, option.rate, option.volatility,
+        option.time_to_maturity, option.fixed_strike, option.type, num_steps);
+    double mean_x = moments.sum_x / n;
+    double var_x = moments.sum_xx / n - mean_x * mean_x;
+    double cov_xy = moments.sum_xy / n - mean_x * (moments.sum_y / n);
+    double beta = var_x > 0.0 ? cov_xy / var_x : 0.0;
+    return mean_y - beta * (df * mean_x - control_mean);
 }
 
 }
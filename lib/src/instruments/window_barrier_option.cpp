@@ -0,0 +1,84 @@
+#include "internal/instruments/window_barrier_option.hpp"
+#include "internal/methods/brownian_bridge.hpp"
+#include "internal/methods/path_kernel.hpp"
+#include "internal/methods/simulation_workspace.hpp"
+#include "internal/methods/time_grid.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace mcoptions {
+
+namespace {
+
+// Survival probability of a single barrier that only counts on steps
+// inside the monitoring window. Window edges are grid points, so a step is
+// either fully inside or fully outside.
+struct WindowBarrierState {
+    double log_barrier;
+    bool upper;
+    bool knock_in;
+    double window_start;
+    double window_end;
+    double strike;
+    OptionType type;
+    double rebate;
+    double survival;
+
+    void begin(double) {
+        survival = 1.0;
+    }
+
+    void step(double t0, double t1, double x0, double x1, double variance) {
+        if (survival == 0.0) return;
+        double mid = 0.5 * (t0 + t1);
+        if (mid < window_start || mid > window_end) return;
+        survival *= 1.0 - barrier_crossing_probability(x0, x1, log_barrier, upper, variance);
+    }
+
+    double payoff(double spot) const {
+        double vanilla = mcoptions::payoff(spot, strike, type);
+        return knock_in
+            ? (1.0 - survival) * vanilla + survival * rebate
+            : survival * vanilla + (1.0 - survival) * rebate;
+    }
+};
+
+} // anonymous namespace
+
+double price_window_barrier_option(Context& ctx, const WindowBarrierOptionData& option) {
+    if (option.barrier_level <= 0.0) {
+        throw std::invalid_argument("Barrier level must be positive");
+    }
+    if (option.window_start < 0.0 || option.window_end <= option.window_start ||
+        option.window_end > option.time_to_maturity) {
+        throw std::invalid_argument("Window must satisfy 0 <= start < end <= maturity");
+    }
+
+    // The bridge survival is exact over any step, so the window edges are
+    // the only dates the grid needs
+    KernelGrid local;
+    const KernelGrid& grid = kernel_grid(
+        ctx, GridKey{"window_barrier", option.time_to_maturity, 2}, local, [&](KernelGrid& out) {
+            out.grid = build_time_grid(option.time_to_maturity,
+                                       {option.window_start, option.window_end});
+        });
+
+    bool upper = option.barrier_type == BarrierType::UpAndOut ||
+                 option.barrier_type == BarrierType::UpAndIn;
+    bool knock_in = option.barrier_type == BarrierType::UpAndIn ||
+                    option.barrier_type == BarrierType::DownAndIn;
+
+    WindowBarrierState prototype{std::log(option.barrier_level), upper, knock_in,
+                                 option.window_start, option.window_end,
+                                 option.strike, option.type, option.rebate, 1.0};
+    ctx.set_job_fingerprint(job_fingerprint("window_barrier", {
+        option.spot, option.strike, option.rate, option.volatility, option.time_to_maturity,
+        static_cast<double>(option.type), option.barrier_level,
+        static_cast<double>(option.barrier_type), option.window_start, option.window_end,
+        option.rebate}));
+
+    return price_streaming(ctx, option.spot, option.rate, option.volatility, grid.grid.times,
+                           prototype);
+}
+
+}
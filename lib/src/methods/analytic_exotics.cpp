@@ -0,0 +1,256 @@
+#include "internal/methods/analytic_exotics.hpp"
+#include "internal/variance_reduction/control_variates.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mcoptions {
+namespace analytic {
+
+namespace {
+
+using black_scholes::normal_cdf;
+
+// The lookback formulas divide by the drift; r = 0 is their removable singularity
+const double kMinDrift = 1e-7;
+
+void validate(double spot, double strike, double volatility, double time_to_maturity) {
+    if (spot <= 0.0 || strike < 0.0) {
+        throw std::invalid_argument("Spot must be positive and strike non-negative");
+    }
+    if (volatility <= 0.0 || time_to_maturity <= 0.0) {
+        throw std::invalid_argument("Volatility and time to maturity must be positive");
+    }
+}
+
+bool is_up(BarrierType barrier_type) {
+    return barrier_type == BarrierType::UpAndOut || barrier_type == BarrierType::UpAndIn;
+}
+
+bool is_in(BarrierType barrier_type) {
+    return barrier_type == BarrierType::UpAndIn || barrier_type == BarrierType::DownAndIn;
+}
+
+// Continuously monitored barrier (Reiner-Rubinstein, rebate paid at maturity)
+double continuous_barrier(double S, double K, double r, double sigma, double T,
+                          double H, BarrierType barrier_type, double rebate, OptionType type) {
+    bool up = is_up(barrier_type);
+    bool in = is_in(barrier_type);
+    double df = std::exp(-r * T);
+
+    if (up ? S >= H : S <= H) {
+        return in ? black_scholes::price(S, K, r, sigma, T, type) : rebate * df;
+    }
+
+    double phi = type == OptionType::Call ? 1.0 : -1.0;
+    double eta = up ? -1.0 : 1.0;
+    double sig_t = sigma * std::sqrt(T);
+    double mu = (r - 0.5 * sigma * sigma) / (sigma * sigma);
+    double hs = H / S;
+    double hs_2mu = std::pow(hs, 2.0 * mu);
+    double hs_2mu2 = hs_2mu * hs * hs;
+    double shift = (1.0 + mu) * sig_t;
+
+    double x1 = std::log(S / K) / sig_t + shift;
+    double x2 = std::log(S / H) / sig_t + shift;
+    double y1 = std::log(H * H / (S * K)) / sig_t + shift;
+    double y2 = std::log(H / S) / sig_t + shift;
+
+    double A = phi * S * normal_cdf(phi * x1) - phi * K * df * normal_cdf(phi * (x1 - sig_t));
+    double B = phi * S * normal_cdf(phi * x2) - phi * K * df * normal_cdf(phi * (x2 - sig_t));
+    double C = phi * S * hs_2mu2 * normal_cdf(eta * y1)
+             - phi * K * df * hs_2mu * normal_cdf(eta * (y1 - sig_t));
+    double D = phi * S * hs_2mu2 * normal_cdf(eta * y2)
+             - phi * K * df * hs_2mu * normal_cdf(eta * (y2 - sig_t));
+
+    // Risk-neutral probability of never touching the barrier
+    double survival = normal_cdf(eta * (x2 - sig_t)) - hs_2mu * normal_cdf(eta * (y2 - sig_t));
+
+    double knock_in;
+    bool strike_above = K > H;
+    if (type == OptionType::Call) {
+        if (up) knock_in = strike_above ? A : B - C + D;
+        else    knock_in = strike_above ? C : A - B + D;
+    } else {
+        if (up) knock_in = strike_above ? A - B + D : C;
+        else    knock_in = strike_above ? B - C + D : A;
+    }
+
+    // A is the vanilla, so in-out parity gives the knock-out
+    if (in) {
+        return knock_in + rebate * df * survival;
+    }
+    return A - knock_in + rebate * df * (1.0 - survival);
+}
+
+// Continuously monitored lookbacks on a contract starting today
+double floating_call(double S, double r, double sigma, double T) {
+    double b = std::abs(r) < kMinDrift ? kMinDrift : r;
+    double sig_t = sigma * std::sqrt(T);
+    double a1 = (b + 0.5 * sigma * sigma) * T / sig_t;
+    double a2 = a1 - sig_t;
+    double df = std::exp(-r * T);
+    return S * normal_cdf(a1) - S * df * normal_cdf(a2)
+         + S * df * sigma * sigma / (2.0 * b)
+           * (normal_cdf(-a1 + 2.0 * b * T / sig_t) - std::exp(b * T) * normal_cdf(-a1));
+}
+
+double floating_put(double S, double r, double sigma, double T) {
+    double b = std::abs(r) < kMinDrift ? kMinDrift : r;
+    double sig_t = sigma * std::sqrt(T);
+    double b1 = (b + 0.5 * sigma * sigma) * T / sig_t;
+    double b2 = b1 - sig_t;
+    double df = std::exp(-r * T);
+    return S * df * normal_cdf(-b2) - S * normal_cdf(-b1)
+         + S * df * sigma * sigma / (2.0 * b)
+           * (-normal_cdf(b1 - 2.0 * b * T / sig_t) + std::exp(b * T) * normal_cdf(b1));
+}
+
+double fixed_call(double S, double K, double r, double sigma, double T) {
+    double b = std::abs(r) < kMinDrift ? kMinDrift : r;
+    double sig_t = sigma * std::sqrt(T);
+    double df = std::exp(-r * T);
+    double level = std::max(K, S);   // Running maximum is the spot today
+    double d1 = (std::log(S / level) + (b + 0.5 * sigma * sigma) * T) / sig_t;
+    double d2 = d1 - sig_t;
+    double value = S * normal_cdf(d1) - level * df * normal_cdf(d2)
+                 + S * df * sigma * sigma / (2.0 * b)
+                   * (-std::pow(S / level, -2.0 * b / (sigma * sigma))
+                        * normal_cdf(d1 - 2.0 * b * T / sig_t)
+                      + std::exp(b * T) * normal_cdf(d1));
+    return value + df * (level - K);
+}
+
+double fixed_put(double S, double K, double r, double sigma, double T) {
+    double b = std::abs(r) < kMinDrift ? kMinDrift : r;
+    double sig_t = sigma * std::sqrt(T);
+    double df = std::exp(-r * T);
+    double level = std::min(K, S);   // Running minimum is the spot today
+    double d1 = (std::log(S / level) + (b + 0.5 * sigma * sigma) * T) / sig_t;
+    double d2 = d1 - sig_t;
+    double value = level * df * normal_cdf(-d2) - S * normal_cdf(-d1)
+                 + S * df * sigma * sigma / (2.0 * b)
+                   * (std::pow(S / level, -2.0 * b / (sigma * sigma))
+                        * normal_cdf(-d1 + 2.0 * b * T / sig_t)
+                      - std::exp(b * T) * normal_cdf(-d1));
+    return value + df * (K - level);
+}
+
+} // anonymous namespace
+
+double bgk_shift(double volatility, double time_to_maturity, size_t monitoring_steps) {
+    if (monitoring_steps == 0) return 0.0;
+    return kBgkBeta * volatility
+         * std::sqrt(time_to_maturity / static_cast<double>(monitoring_steps));
+}
+
+double barrier_price(
+    double spot,
+    double strike,
+    double rate,
+    double volatility,
+    double time_to_maturity,
+    double barrier_level,
+    BarrierType barrier_type,
+    double rebate,
+    OptionType type,
+    size_t monitoring_steps
+) {
+    validate(spot, strike, volatility, time_to_maturity);
+    if (barrier_level <= 0.0) {
+        throw std::invalid_argument("Barrier level must be positive");
+    }
+
+    // The first monitoring date is today, so a breached spot knocks regardless of the shift
+    bool up = is_up(barrier_type);
+    if (up ? spot >= barrier_level : spot <= barrier_level) {
+        return is_in(barrier_type)
+            ? black_scholes::price(spot, strike, rate, volatility, time_to_maturity, type)
+            : rebate * std::exp(-rate * time_to_maturity);
+    }
+
+    // Discrete monitoring misses crossings between dates: move the barrier away
+    double shift = bgk_shift(volatility, time_to_maturity, monitoring_steps);
+    double level = barrier_level * std::exp(up ? shift : -shift);
+    return continuous_barrier(spot, strike, rate, volatility, time_to_maturity,
+                              level, barrier_type, rebate, type);
+}
+
+double lookback_price(
+    double spot,
+    double strike,
+    double rate,
+    double volatility,
+    double time_to_maturity,
+    bool fixed_strike,
+    OptionType type,
+    size_t monitoring_steps
+) {
+    validate(spot, strike, volatility, time_to_maturity);
+
+    // Discrete maxima sit about exp(-shift) below the continuous one (minima above)
+    double shift = bgk_shift(volatility, time_to_maturity, monitoring_steps);
+    double down = std::exp(-shift);
+    double up = std::exp(shift);
+    double S = spot;
+    double r = rate;
+    double T = time_to_maturity;
+
+    if (fixed_strike) {
+        if (type == OptionType::Call) {
+            // E[(M e^-a - K)+] = e^-a E[(M - K e^a)+]
+            return down * fixed_call(S, strike * up, r, volatility, T);
+        }
+        return up * fixed_put(S, strike * down, r, volatility, T);
+    }
+
+    // The discounted terminal spot is worth S
+    if (type == OptionType::Call) {
+        // S_T - m e^a
+        return S - up * (S - floating_call(S, r, volatility, T));
+    }
+    // M e^-a - S_T
+    return down * (floating_put(S, r, volatility, T) + S) - S;
+}
+
+void barrier_price_batch(
+    size_t n,
+    const OptionType* types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times,
+    const double* barrier_levels,
+    const BarrierType* barrier_types,
+    const double* rebates,
+    size_t monitoring_steps,
+    double* prices
+) {
+    for (size_t i = 0; i < n; ++i) {
+        prices[i] = barrier_price(spots[i], strikes[i], rates[i], volatilities[i], times[i],
+                                  barrier_levels[i], barrier_types[i], rebates[i], types[i],
+                                  monitoring_steps);
+    }
+}
+
+void lookback_price_batch(
+    size_t n,
+    const OptionType* types,
+    const double* spots,
+    const double* strikes,
+    const double* rates,
+    const double* volatilities,
+    const double* times,
+    const bool* fixed_strikes,
+    size_t monitoring_steps,
+    double* prices
+) {
+    for (size_t i = 0; i < n; ++i) {
+        prices[i] = lookback_price(spots[i], strikes[i], rates[i], volatilities[i], times[i],
+                                   fixed_strikes[i], types[i], monitoring_steps);
+    }
+}
+
+} // namespace analytic
+} // namespace mcoptions
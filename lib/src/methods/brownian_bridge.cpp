@@ -0,0 +1,62 @@
+#include "internal/methods/brownian_bridge.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace mcoptions {
+
+double barrier_crossing_probability(
+    double x0,
+    double x1,
+    double barrier,
+    bool upper,
+    double variance
+) {
+    double d0 = upper ? barrier - x0 : x0 - barrier;
+    double d1 = upper ? barrier - x1 : x1 - barrier;
+    if (d0 <= 0.0 || d1 <= 0.0) {
+        return 1.0;
+    }
+    if (variance <= 0.0) {
+        return 0.0;
+    }
+    return std::exp(-2.0 * d0 * d1 / variance);
+}
+
+double double_barrier_survival_probability(
+    double x0,
+    double x1,
+    double lower,
+    double upper,
+    double variance,
+    size_t max_terms
+) {
+    if (x0 <= lower || x0 >= upper || x1 <= lower || x1 >= upper) {
+        return 0.0;
+    }
+    if (variance <= 0.0) {
+        return 1.0;
+    }
+
+    const double eps = 1e-14;
+    double w = upper - lower;
+    double a = x0 - lower;
+    double b = x1 - lower;
+    double c = 2.0 / variance;
+
+    // k = 0: reflection in the lower barrier only
+    double sum = 1.0 - std::exp(-c * a * b);
+
+    for (size_t n = 1; n <= max_terms; ++n) {
+        double kw = static_cast<double>(n) * w;
+        double pos = std::exp(-c * kw * (kw + b - a)) - std::exp(-c * (a + kw) * (b + kw));
+        double neg = std::exp(-c * kw * (kw - b + a)) - std::exp(-c * (a - kw) * (b - kw));
+        sum += pos + neg;
+        if (std::abs(pos) < eps && std::abs(neg) < eps) {
+            break;
+        }
+    }
+
+    return std::min(1.0, std::max(0.0, sum));
+}
+
+} // namespace mcoptions
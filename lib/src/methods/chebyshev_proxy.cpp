@@ -0,0 +1,338 @@
+#include "internal/methods/chebyshev_proxy.hpp"
+#include "internal/engine/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace mcoptions {
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const char kMagic[8] = {'M', 'C', 'O', 'P', 'R', 'O', 'X', 'Y'};
+const uint32_t kFormatVersion = 1;
+const uint32_t kByteOrderTag = 0x01020304;
+
+// Node j of n (n >= 2) on the axis; node 0 is the upper end
+double node_coordinate(const ProxyAxis& axis, size_t j) {
+    double x = std::cos(kPi * static_cast<double>(j) / static_cast<double>(axis.nodes - 1));
+    return 0.5 * (axis.upper + axis.lower) + 0.5 * (axis.upper - axis.lower) * x;
+}
+
+/**
+ * Values at the Lobatto nodes -> Chebyshev coefficients along one axis
+ *
+ * c_k = 2/(n-1) sum_j'' f_j cos(pi j k / (n-1)), halved for k = 0 and n-1
+ * (the double prime halves the end terms of the sum).
+ */
+void transform_axis(std::vector<double>& data, const size_t (&extents)[kProxyAxes], size_t axis) {
+    size_t n = extents[axis];
+    if (n < 2) return;
+    size_t outer = 1, inner = 1;
+    for (size_t a = 0; a < axis; ++a) outer *= extents[a];
+    for (size_t a = axis + 1; a < kProxyAxes; ++a) inner *= extents[a];
+
+    std::vector<double> cosines(n * n);
+    for (size_t k = 0; k < n; ++k) {
+        for (size_t j = 0; j < n; ++j) {
+            cosines[k * n + j] = std::cos(kPi * static_cast<double>((j * k) % (2 * (n - 1))) /
+                                          static_cast<double>(n - 1));
+        }
+    }
+
+    std::vector<double> line(n);
+    for (size_t o = 0; o < outer; ++o) {
+        for (size_t i = 0; i < inner; ++i) {
+            double* base = data.data() + o * n * inner + i;
+            for (size_t j = 0; j < n; ++j) line[j] = base[j * inner];
+            for (size_t k = 0; k < n; ++k) {
+                double sum = 0.5 * (line[0] * cosines[k * n] + line[n - 1] * cosines[k * n + n - 1]);
+                for (size_t j = 1; j + 1 < n; ++j) sum += line[j] * cosines[k * n + j];
+                double c = 2.0 * sum / static_cast<double>(n - 1);
+                base[k * inner] = (k == 0 || k == n - 1) ? 0.5 * c : c;
+            }
+        }
+    }
+}
+
+// Largest coefficient among the two highest orders along `axis`
+double tail_coefficient(const std::vector<double>& coefficients,
+                        const size_t (&extents)[kProxyAxes], size_t axis) {
+    size_t n = extents[axis];
+    if (n < 2) return 0.0;
+    size_t inner = 1;
+    for (size_t a = axis + 1; a < kProxyAxes; ++a) inner *= extents[a];
+    double largest = 0.0;
+    for (size_t index = 0; index < coefficients.size(); ++index) {
+        size_t k = (index / inner) % n;
+        if (k + 2 >= n) largest = std::max(largest, std::fabs(coefficients[index]));
+    }
+    return largest;
+}
+
+// T_k and its first two derivatives in the axis coordinate
+struct Basis {
+    double t[ChebyshevProxy::kMaxNodes];
+    double d1[ChebyshevProxy::kMaxNodes];
+    double d2[ChebyshevProxy::kMaxNodes];
+};
+
+void evaluate_basis(const ProxyAxis& axis, double value, Basis& b) {
+    b.t[0] = 1.0;
+    b.d1[0] = 0.0;
+    b.d2[0] = 0.0;
+    if (axis.nodes < 2) return;
+
+    double width = axis.upper - axis.lower;
+    double x = std::max(-1.0, std::min(1.0, (2.0 * value - axis.upper - axis.lower) / width));
+    double scale = 2.0 / width;
+    b.t[1] = x;
+    b.d1[1] = 1.0;
+    b.d2[1] = 0.0;
+    for (size_t k = 2; k < axis.nodes; ++k) {
+        b.t[k] = 2.0 * x * b.t[k - 1] - b.t[k - 2];
+        b.d1[k] = 2.0 * b.t[k - 1] + 2.0 * x * b.d1[k - 1] - b.d1[k - 2];
+        b.d2[k] = 4.0 * b.d1[k - 1] + 2.0 * x * b.d2[k - 1] - b.d2[k - 2];
+    }
+    for (size_t k = 1; k < axis.nodes; ++k) {
+        b.d1[k] *= scale;
+        b.d2[k] *= scale * scale;
+    }
+}
+
+// Dates inside the contract do not move with the time to maturity
+bool has_date_schedule(InstrumentKind kind) {
+    switch (kind) {
+        case InstrumentKind::Bermudan:
+        case InstrumentKind::Autocallable:
+        case InstrumentKind::Cliquet:
+        case InstrumentKind::WindowBarrier:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool in_domain(const ProxyAxis& axis, double value) {
+    if (axis.nodes == 0) return true;
+    double slack = 1e-12 * (axis.upper - axis.lower);
+    return value >= axis.lower - slack && value <= axis.upper + slack;
+}
+
+template <typename T>
+void put(std::vector<unsigned char>& out, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+class Reader {
+public:
+    Reader(const unsigned char* data, size_t size) : data_(data), size_(size), offset_(0) {}
+
+    template <typename T>
+    T get() {
+        if (size_ - offset_ < sizeof(T)) {
+            throw std::invalid_argument("Proxy image is truncated");
+        }
+        T value;
+        std::memcpy(&value, data_ + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return value;
+    }
+
+    size_t remaining() const { return size_ - offset_; }
+
+private:
+    const unsigned char* data_;
+    size_t size_;
+    size_t offset_;
+};
+
+} // anonymous namespace
+
+void ChebyshevProxy::validate(const ProxyAxis& axis, size_t index) {
+    if (axis.nodes == 0) return;
+    if (axis.nodes < 2 || axis.nodes > kMaxNodes) {
+        throw std::invalid_argument("Proxy axes need between 2 and 64 nodes");
+    }
+    if (!std::isfinite(axis.lower) || !std::isfinite(axis.upper) || !(axis.lower < axis.upper)) {
+        throw std::invalid_argument("Proxy axis bounds must be finite with lower < upper");
+    }
+    if (!(axis.lower > 0.0)) {
+        throw std::invalid_argument(index == kProxyTime ? "Proxy time to maturity must be positive"
+                                                        : "Proxy spot and volatility must be positive");
+    }
+}
+
+ChebyshevProxy ChebyshevProxy::build(Context& ctx, const InstrumentDescriptor& instrument,
+                                     const ProxyAxis (&axes)[kProxyAxes]) {
+    ChebyshevProxy proxy;
+    bool interpolated = false;
+    for (size_t a = 0; a < kProxyAxes; ++a) {
+        validate(axes[a], a);
+        proxy.axes_[a] = axes[a];
+        interpolated = interpolated || axes[a].nodes > 0;
+    }
+    if (!interpolated) {
+        throw std::invalid_argument("Proxy needs at least one interpolated axis");
+    }
+    if (axes[kProxyTime].nodes > 0 && has_date_schedule(instrument.kind)) {
+        throw std::invalid_argument("Proxy time axis needs an instrument without a date schedule");
+    }
+    proxy.fixed_[kProxySpot] = instrument.option.spot;
+    proxy.fixed_[kProxyVolatility] = instrument.option.volatility;
+    proxy.fixed_[kProxyTime] = instrument.option.time_to_maturity;
+
+    size_t extents[kProxyAxes];
+    size_t count = 1;
+    for (size_t a = 0; a < kProxyAxes; ++a) {
+        extents[a] = proxy.extent(a);
+        count *= extents[a];
+    }
+
+    // Common random numbers: every node starts from the same seed
+    uint64_t seed = block_rng(ctx.next_stream_key(), 0)();
+    std::vector<double> values(count);
+    std::vector<double> node_errors(count);
+    parallel_for(ctx, count, [&](size_t index) {
+        size_t position[kProxyAxes];
+        size_t rest = index;
+        for (size_t a = kProxyAxes; a-- > 0;) {
+            position[a] = rest % extents[a];
+            rest /= extents[a];
+        }
+        double coordinate[kProxyAxes];
+        for (size_t a = 0; a < kProxyAxes; ++a) {
+            coordinate[a] = proxy.axes_[a].nodes ? node_coordinate(proxy.axes_[a], position[a])
+                                                 : proxy.fixed_[a];
+        }
+
+        InstrumentDescriptor node = instrument;
+        node.option.spot = coordinate[kProxySpot];
+        node.option.volatility = coordinate[kProxyVolatility];
+        node.option.time_to_maturity = coordinate[kProxyTime];
+        Context local = ctx;
+        local.set_seed(seed);
+        PricingResult result = price_instrument(local, node);
+        values[index] = result.price;
+        node_errors[index] = result.error_estimate;
+    });
+
+    for (size_t a = 0; a < kProxyAxes; ++a) transform_axis(values, extents, a);
+
+    double truncation = 0.0;
+    for (size_t a = 0; a < kProxyAxes; ++a) truncation += tail_coefficient(values, extents, a);
+    // A node without an error estimate (most Monte Carlo kinds) leaves the
+    // noise unknown, and so the proxy's error
+    double noise = 0.0;
+    for (double error : node_errors) {
+        if (!std::isfinite(error)) {
+            noise = std::numeric_limits<double>::quiet_NaN();
+            break;
+        }
+        noise = std::max(noise, error);
+    }
+    proxy.error_estimate_ = truncation + noise;
+    proxy.coefficients_ = std::move(values);
+    return proxy;
+}
+
+ProxyValue ChebyshevProxy::evaluate(double spot, double volatility, double time_to_maturity) const {
+    const double point[kProxyAxes] = {spot, volatility, time_to_maturity};
+    Basis basis[kProxyAxes];
+    for (size_t a = 0; a < kProxyAxes; ++a) {
+        if (!in_domain(axes_[a], point[a])) {
+            throw std::invalid_argument("Point is outside the proxy domain");
+        }
+        evaluate_basis(axes_[a], point[a], basis[a]);
+    }
+
+    // Contract the innermost (time) axis first, then volatility, then spot
+    size_t n_spot = extent(kProxySpot), n_vol = extent(kProxyVolatility), n_time = extent(kProxyTime);
+    const Basis& bs = basis[kProxySpot];
+    const Basis& bv = basis[kProxyVolatility];
+    const Basis& bt = basis[kProxyTime];
+    double price = 0.0, delta = 0.0, gamma = 0.0, vega = 0.0, time_slope = 0.0;
+    const double* c = coefficients_.data();
+    for (size_t i = 0; i < n_spot; ++i) {
+        double p = 0.0, v = 0.0, t = 0.0;
+        for (size_t j = 0; j < n_vol; ++j) {
+            double sum = 0.0, slope = 0.0;
+            for (size_t k = 0; k < n_time; ++k, ++c) {
+                sum += *c * bt.t[k];
+                slope += *c * bt.d1[k];
+            }
+            p += sum * bv.t[j];
+            v += sum * bv.d1[j];
+            t += slope * bv.t[j];
+        }
+        price += p * bs.t[i];
+        delta += p * bs.d1[i];
+        gamma += p * bs.d2[i];
+        vega += v * bs.t[i];
+        time_slope += t * bs.t[i];
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ProxyValue value;
+    value.price = price;
+    value.delta = axes_[kProxySpot].nodes ? delta : nan;
+    value.gamma = axes_[kProxySpot].nodes ? gamma : nan;
+    value.vega = axes_[kProxyVolatility].nodes ? vega : nan;
+    value.theta = axes_[kProxyTime].nodes ? -time_slope : nan;
+    value.error_estimate = error_estimate_;
+    return value;
+}
+
+std::vector<unsigned char> ChebyshevProxy::serialize() const {
+    std::vector<unsigned char> out(kMagic, kMagic + sizeof(kMagic));
+    put(out, kFormatVersion);
+    put(out, kByteOrderTag);
+    for (size_t a = 0; a < kProxyAxes; ++a) {
+        put(out, axes_[a].lower);
+        put(out, axes_[a].upper);
+        put(out, static_cast<uint64_t>(axes_[a].nodes));
+        put(out, fixed_[a]);
+    }
+    put(out, error_estimate_);
+    put(out, static_cast<uint64_t>(coefficients_.size()));
+    for (double c : coefficients_) put(out, c);
+    return out;
+}
+
+ChebyshevProxy ChebyshevProxy::deserialize(const unsigned char* data, size_t size) {
+    if (!data || size < sizeof(kMagic) || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        throw std::invalid_argument("Not a proxy image");
+    }
+    Reader reader(data + sizeof(kMagic), size - sizeof(kMagic));
+    if (reader.get<uint32_t>() != kFormatVersion) {
+        throw std::invalid_argument("Unsupported proxy image version");
+    }
+    if (reader.get<uint32_t>() != kByteOrderTag) {
+        throw std::invalid_argument("Proxy image was written with another byte order");
+    }
+
+    ChebyshevProxy proxy;
+    size_t count = 1;
+    for (size_t a = 0; a < kProxyAxes; ++a) {
+        proxy.axes_[a].lower = reader.get<double>();
+        proxy.axes_[a].upper = reader.get<double>();
+        uint64_t nodes = reader.get<uint64_t>();
+        if (nodes > kMaxNodes) throw std::invalid_argument("Proxy axes need between 2 and 64 nodes");
+        proxy.axes_[a].nodes = static_cast<size_t>(nodes);
+        proxy.fixed_[a] = reader.get<double>();
+        validate(proxy.axes_[a], a);
+        count *= proxy.extent(a);
+    }
+    proxy.error_estimate_ = reader.get<double>();
+    if (reader.get<uint64_t>() != count || reader.remaining() != count * sizeof(double)) {
+        throw std::invalid_argument("Proxy image has the wrong number of coefficients");
+    }
+    proxy.coefficients_.resize(count);
+    for (double& c : proxy.coefficients_) c = reader.get<double>();
+    return proxy;
+}
+
+} // namespace mcoptions
@@ -1,4 +1,5 @@
 #include "internal/methods/least_squares_monte_carlo.hpp"
+#include "internal/engine/parallel.hpp"
 #include "internal/models/gbm.hpp"
 #include "internal/random.hpp"
 #include <cmath>
@@ -52,11 +53,8 @@ LeastSquaresMonteCarlo::LeastSquaresMonteCarlo(
     total_steps_ = num_exercise_dates_ + 1;  // +1 for maturity
     dt_ = time_to_maturity_ / static_cast<double>(total_steps_);
     
-    // Allocate memory
+    // Rows are allocated by the workers that fill them (see generate_price_paths)
     price_paths_.resize(num_paths_);
-    for (auto& path : price_paths_) {
-        path.resize(total_steps_ + 1);  // +1 for initial spot
-    }
     
     cash_flows_.resize(num_paths_, 0.0);
     exercise_times_.resize(num_paths_, total_steps_);  // Default: exercise at maturity
@@ -75,45 +73,55 @@ double LeastSquaresMonteCarlo::calculate_intrinsic_value(double stock_price) con
 }
 
 void LeastSquaresMonteCarlo::generate_price_paths() {
-    auto& rng = ctx_.get_rng();
-    std::normal_distribution<double> normal(0.0, 1.0);
+    // Polar normals come in pairs and the distribution keeps the spare one;
+    // the sequential stream runs its blocks in order and shares one across them
+    // (the draw count varies, so that stream is not split)
+    std::normal_distribution<double> serial_normal(0.0, 1.0);
+    bool sequential = ctx_.get_stream_mode() == Context::StreamMode::Sequential;
+    NormalMethod normal_method = ctx_.get_normal_method();
     
-    // Generate paths
-    for (size_t path = 0; path < num_paths_; ++path) {
-        price_paths_[path][0] = spot_;
-        
-        // Generate random normals for this path
+    // Generate paths in blocks; each row is first written by the worker that
+    // simulates it, so the matrix is spread over the nodes of the pool
+    parallel_for_streams(ctx_, count_blocks(num_paths_, kPathsPerBlock), 0, [&](size_t block, auto& rng) {
+        std::normal_distribution<double> block_normal(0.0, 1.0);
+        std::normal_distribution<double>& normal = sequential ? serial_normal : block_normal;
+        size_t first = block * kPathsPerBlock;
+        size_t last = std::min(first + kPathsPerBlock, num_paths_);
         std::vector<double> random_normals(total_steps_);
-        for (size_t step = 0; step < total_steps_; ++step) {
-            random_normals[step] = normal(rng);
-        }
         
-        // Apply antithetic variates if enabled
-        if (ctx_.get_antithetic() && path < num_paths_ / 2) {
-            // Store for antithetic pair
-            for (size_t step = 0; step < total_steps_; ++step) {
-                // Will be negated for antithetic path
-            }
-        } else if (ctx_.get_antithetic() && path >= num_paths_ / 2) {
-            // Use negated normals from paired path
-            size_t paired_path = path - num_paths_ / 2;
-            for (size_t step = 0; step < total_steps_; ++step) {
-                random_normals[step] = -random_normals[step];
+        for (size_t path = first; path < last; ++path) {
+            price_paths_[path].assign(total_steps_ + 1, 0.0);  // +1 for initial spot
+            price_paths_[path][0] = spot_;
+            
+            // Generate random normals for this path
+            if (normal_method == NormalMethod::Ziggurat) {
+                fill_normals(rng, normal_method, random_normals.data(), total_steps_);
+            } else {
+                for (size_t step = 0; step < total_steps_; ++step) {
+                    random_normals[step] = normal(rng);
+                }
             }
-        }
-        
-        // Simulate GBM path step by step
-        for (size_t step = 0; step < total_steps_; ++step) {
-            double S = price_paths_[path][step];
-            double Z = random_normals[step];
             
-            // GBM: S(t+dt) = S(t) * exp((r - 0.5*σ²)*dt + σ*√dt*Z)
-            double drift = (rate_ - 0.5 * volatility_ * volatility_) * dt_;
-            double diffusion = volatility_ * std::sqrt(dt_) * Z;
+            // Antithetic variates: second half of the paths uses negated normals
+            if (ctx_.get_antithetic() && path >= num_paths_ / 2) {
+                for (size_t step = 0; step < total_steps_; ++step) {
+                    random_normals[step] = -random_normals[step];
+                }
+            }
             
-            price_paths_[path][step + 1] = S * std::exp(drift + diffusion);
+            // Simulate GBM path step by step
+            for (size_t step = 0; step < total_steps_; ++step) {
+                double S = price_paths_[path][step];
+                double Z = random_normals[step];
+                
+                // GBM: S(t+dt) = S(t) * exp((r - 0.5*σ²)*dt + σ*√dt*Z)
+                double drift = (rate_ - 0.5 * volatility_ * volatility_) * dt_;
+                double diffusion = volatility_ * std::sqrt(dt_) * Z;
+                
+                price_paths_[path][step + 1] = S * std::exp(drift + diffusion);
+            }
         }
-    }
+    });
 }
 
 void LeastSquaresMonteCarlo::least_squares_regression(
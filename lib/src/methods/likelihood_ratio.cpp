@@ -0,0 +1,54 @@
+#include "internal/methods/likelihood_ratio.hpp"
+#include "internal/methods/monte_carlo.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace mcoptions {
+
+ReweightedPrice reweight_paths(const PathCache& cache, double rate, double volatility) {
+    size_t n = cache.paths.size();
+    double old_variance = cache.volatility * cache.volatility;
+    double new_variance = volatility * volatility;
+    double old_drift = cache.rate - 0.5 * old_variance;
+    double new_drift = rate - 0.5 * new_variance;
+
+    // The log ratio of the densities is linear in Q and S; its constant part
+    // cancels in the self-normalised mean
+    double q_coefficient = 0.5 / old_variance - 0.5 / new_variance;
+    double s_coefficient = new_drift / new_variance - old_drift / old_variance;
+
+    // Log weights first, then shift by the largest so exp() cannot overflow
+    std::vector<double> weights(n);
+    double largest = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; ++i) {
+        weights[i] = q_coefficient * cache.paths[i].scaled_square +
+                     s_coefficient * cache.paths[i].log_return;
+        largest = std::max(largest, weights[i]);
+    }
+
+    double sum_w = 0.0;
+    double sum_ww = 0.0;
+    double sum_wy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double w = std::exp(weights[i] - largest);
+        weights[i] = w;
+        sum_w += w;
+        sum_ww += w * w;
+        sum_wy += w * cache.paths[i].payoff;
+    }
+    double mean = sum_wy / sum_w;
+
+    // Delta-method variance of the self-normalised mean
+    double spread = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = weights[i] * (cache.paths[i].payoff - mean);
+        spread += d * d;
+    }
+
+    double df = discount_factor(rate, cache.maturity);
+    return ReweightedPrice{df * mean, df * std::sqrt(spread) / sum_w, sum_w * sum_w / sum_ww};
+}
+
+} // namespace mcoptions
@@ -0,0 +1,264 @@
+#include "internal/methods/method_selector.hpp"
+#include "internal/methods/binomial_tree.hpp"
+#include "internal/methods/least_squares_monte_carlo.hpp"
+#include "internal/instruments/european_option.hpp"
+#include "internal/variance_reduction/control_variates.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace mcoptions {
+
+namespace {
+
+// Restores the caller's simulation settings when a method overrides them
+class SimulationSettingsGuard {
+public:
+    explicit SimulationSettingsGuard(Context& ctx)
+        : ctx_(ctx),
+          num_simulations_(ctx.get_num_simulations()),
+          num_steps_(ctx.get_num_steps()) {}
+
+    ~SimulationSettingsGuard() {
+        ctx_.set_num_simulations(num_simulations_);
+        ctx_.set_num_steps(num_steps_);
+    }
+
+private:
+    Context& ctx_;
+    size_t num_simulations_;
+    size_t num_steps_;
+};
+
+size_t clamp_count(double value, size_t lo, size_t hi) {
+    if (!(value < static_cast<double>(hi))) return hi;
+    size_t n = static_cast<size_t>(std::ceil(value));
+    return std::max(lo, std::min(hi, n));
+}
+
+MethodChoice analytic_candidate(const CostModel& model) {
+    return MethodChoice{PricingMethod::Analytic, 0, 0, 0.0, model.analytic_ns};
+}
+
+MethodChoice tree_candidate(const OptionData& option, double tolerance, const CostModel& model) {
+    double scale = option.spot * option.volatility * std::sqrt(option.time_to_maturity);
+    size_t steps = clamp_count(model.tree_error_coeff * scale / tolerance, 1, model.max_tree_steps);
+    double n = static_cast<double>(steps);
+    return MethodChoice{
+        PricingMethod::BinomialTree,
+        0,
+        steps,
+        model.tree_error_coeff * scale / n,
+        model.tree_node_ns * 0.5 * (n + 1.0) * (n + 2.0)
+    };
+}
+
+MethodChoice mc_candidate(const OptionData& option, double tolerance, const CostModel& model) {
+    double sd = vanilla_payoff_stddev(option);
+    size_t paths = clamp_count((sd / tolerance) * (sd / tolerance), model.min_paths, model.max_paths);
+    // GBM transitions are exact, so a terminal payoff needs a single step
+    size_t steps = 1;
+    return MethodChoice{
+        PricingMethod::MonteCarlo,
+        paths,
+        steps,
+        sd / std::sqrt(static_cast<double>(paths)),
+        model.mc_step_ns * static_cast<double>(paths * steps)
+    };
+}
+
+MethodChoice lsm_candidate(const OptionData& option, double tolerance, const CostModel& model) {
+    double sd = vanilla_payoff_stddev(option);
+    double bias = model.lsm_bias * black_scholes::price(option.spot, option.strike, option.rate,
+                                                        option.volatility, option.time_to_maturity,
+                                                        option.type);
+    double budget = tolerance - bias;
+    double target = budget > 0.0 ? budget : tolerance;
+    size_t paths = clamp_count((sd / target) * (sd / target), model.min_paths, model.max_paths);
+    size_t steps = model.lsm_exercise_dates;
+    return MethodChoice{
+        PricingMethod::LeastSquaresMC,
+        paths,
+        steps,
+        sd / std::sqrt(static_cast<double>(paths)) + bias,
+        model.lsm_step_ns * static_cast<double>(paths * (steps + 1))
+    };
+}
+
+} // anonymous namespace
+
+const CostModel& default_cost_model() {
+    // Measured with tests/benchmark_methods.cpp (gcc -O2, single thread),
+    // rounded up so predictions stay conservative
+    static const CostModel model{
+        /* analytic_ns        */ 750.0,
+        /* tree_node_ns       */ 50.0,
+        /* tree_error_coeff   */ 0.11,
+        /* mc_step_ns         */ 95.0,
+        /* lsm_step_ns        */ 135.0,
+        /* lsm_bias           */ 0.0035,
+        /* max_tree_steps     */ 20000,
+        /* min_paths          */ 1000,
+        /* max_paths          */ 50000000,
+        /* lsm_exercise_dates */ 50
+    };
+    return model;
+}
+
+double vanilla_payoff_stddev(const OptionData& option) {
+    double S = option.spot;
+    double K = option.strike;
+    double r = option.rate;
+    double sigma = option.volatility;
+    double T = option.time_to_maturity;
+
+    if (T <= 0.0 || sigma <= 0.0) {
+        return 0.0;
+    }
+
+    double sqrt_t = std::sqrt(T);
+    double d1 = black_scholes::d1(S, K, r, sigma, T);
+    double d2 = d1 - sigma * sqrt_t;
+    double growth = std::exp(r * T);
+    double growth2 = std::exp((2.0 * r + sigma * sigma) * T);
+
+    // Undiscounted first and second moments of the payoff
+    double first, second;
+    if (option.type == OptionType::Call) {
+        first = S * growth * black_scholes::normal_cdf(d1) - K * black_scholes::normal_cdf(d2);
+        second = S * S * growth2 * black_scholes::normal_cdf(d1 + sigma * sqrt_t)
+               - 2.0 * K * S * growth * black_scholes::normal_cdf(d1)
+               + K * K * black_scholes::normal_cdf(d2);
+    } else {
+        first = K * black_scholes::normal_cdf(-d2) - S * growth * black_scholes::normal_cdf(-d1);
+        second = K * K * black_scholes::normal_cdf(-d2)
+               - 2.0 * K * S * growth * black_scholes::normal_cdf(-d1)
+               + S * S * growth2 * black_scholes::normal_cdf(-d1 - sigma * sqrt_t);
+    }
+
+    double variance = std::max(0.0, second - first * first);
+    return std::exp(-r * T) * std::sqrt(variance);
+}
+
+MethodChoice select_method(
+    const Context& ctx,
+    const OptionData& option,
+    ExerciseStyle style,
+    double tolerance,
+    const CostModel& model
+) {
+    if (!(tolerance > 0.0)) {
+        throw std::invalid_argument("Tolerance must be positive");
+    }
+    if (option.spot <= 0.0 || option.strike <= 0.0) {
+        throw std::invalid_argument("Spot and strike must be positive");
+    }
+    if (option.volatility < 0.0) {
+        throw std::invalid_argument("Volatility cannot be negative");
+    }
+    if (option.time_to_maturity <= 0.0) {
+        throw std::invalid_argument("Time to maturity must be positive");
+    }
+
+    // Closed forms and the CRR tree assume flat Black-Scholes dynamics
+    bool gbm = ctx.get_model() == Context::Model::BlackScholes;
+
+    // Without dividends an American call is never exercised early
+    bool analytic_capable = gbm && (style == ExerciseStyle::European ||
+                                    option.type == OptionType::Call);
+
+    // A closed form is exact, so it is preferred outright whenever it applies
+    if (analytic_capable) {
+        return analytic_candidate(model);
+    }
+
+    std::vector<MethodChoice> candidates;
+    if (gbm) {
+        candidates.push_back(tree_candidate(option, tolerance, model));
+    }
+    if (style == ExerciseStyle::European) {
+        candidates.push_back(mc_candidate(option, tolerance, model));
+    } else {
+        candidates.push_back(lsm_candidate(option, tolerance, model));
+    }
+
+    const MethodChoice* best = nullptr;
+    for (const auto& c : candidates) {
+        if (c.predicted_error > tolerance) continue;
+        if (!best || c.predicted_cost_ns < best->predicted_cost_ns) {
+            best = &c;
+        }
+    }
+
+    if (!best) {
+        // Nothing meets the tolerance within its caps: take the most accurate
+        best = &candidates.front();
+        for (const auto& c : candidates) {
+            if (c.predicted_error < best->predicted_error) {
+                best = &c;
+            }
+        }
+    }
+
+    return *best;
+}
+
+PricingResult price_with_method(
+    Context& ctx,
+    const OptionData& option,
+    ExerciseStyle style,
+    const MethodChoice& choice
+) {
+    PricingResult result{0.0, choice.predicted_error, choice.method,
+                         choice.num_paths, choice.num_steps};
+
+    switch (choice.method) {
+        case PricingMethod::Analytic:
+            result.price = black_scholes::price(option.spot, option.strike, option.rate,
+                                                option.volatility, option.time_to_maturity,
+                                                option.type);
+            break;
+
+        case PricingMethod::BinomialTree:
+            result.price = style == ExerciseStyle::European
+                ? price_european_option_binomial(ctx, option, choice.num_steps)
+                : price_american_option_binomial(ctx, option, choice.num_steps);
+            break;
+
+        case PricingMethod::MonteCarlo: {
+            if (style != ExerciseStyle::European) {
+                throw std::invalid_argument("Plain Monte Carlo cannot price early exercise");
+            }
+            SimulationSettingsGuard guard(ctx);
+            ctx.set_num_simulations(choice.num_paths);
+            ctx.set_num_steps(choice.num_steps);
+            result.price = price_european_option(ctx, option);
+            break;
+        }
+
+        case PricingMethod::LeastSquaresMC: {
+            SimulationSettingsGuard guard(ctx);
+            ctx.set_num_simulations(choice.num_paths);
+            result.price = price_american_option_lsm(ctx, option, choice.num_steps);
+            break;
+        }
+
+        default:
+            throw std::invalid_argument("Unknown pricing method");
+    }
+
+    return result;
+}
+
+PricingResult price_auto(
+    Context& ctx,
+    const OptionData& option,
+    ExerciseStyle style,
+    double tolerance
+) {
+    MethodChoice choice = select_method(ctx, option, style, tolerance);
+    return price_with_method(ctx, option, style, choice);
+}
+
+} // namespace mcoptions
@@ -28,6 +28,27 @@ std::vector<double> simulate_gbm_path(
     return path;
 }
 
+std::vector<double> simulate_gbm_path(
+    const Context&,
+    double spot,
+    double rate,
+    double volatility,
+    const std::vector<double>& times,
+    const std::vector<double>& random_normals
+) {
+    std::vector<double> path(times.size());
+    path[0] = spot;
+    
+    for (size_t i = 0; i + 1 < times.size(); ++i) {
+        double dt = times[i + 1] - times[i];
+        double drift = (rate - 0.5 * volatility * volatility) * dt;
+        double diffusion = volatility * std::sqrt(dt);
+        path[i + 1] = path[i] * std::exp(drift + diffusion * random_normals[i]);
+    }
+    
+    return path;
+}
+
 double discount_factor(double rate, double time) {
     return std::exp(-rate * time);
 }
@@ -0,0 +1,157 @@
+#include "internal/methods/pricing_plan.hpp"
+#include "internal/engine/parallel.hpp"
+#include "internal/engine/worker_pool.hpp"
+#include "internal/methods/simulation_workspace.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace mcoptions {
+
+PricingPlan::PricingPlan(Context& ctx, const InstrumentDescriptor& instrument)
+    : context_(ctx),
+      instrument_(instrument),
+      seed_(block_rng(ctx.next_stream_key(), 0)()),
+      selected_(false),
+      style_(ExerciseStyle::European),
+      choice_(),
+      min_effective_fraction_(0.0),
+      cached_spot_(0.0),
+      cached_result_(),
+      stats_{false, 0.0, 0} {
+    validate_instrument(instrument_);
+
+    bool vanilla = instrument_.kind == InstrumentKind::European ||
+                   instrument_.kind == InstrumentKind::American;
+    if (vanilla && instrument_.method == PricingMethod::Auto) {
+        style_ = instrument_.kind == InstrumentKind::European ? ExerciseStyle::European
+                                                              : ExerciseStyle::American;
+        choice_ = select_method(context_, instrument_.option, style_, instrument_.tolerance);
+        selected_ = true;
+    }
+
+    if (context_.get_num_threads() != 1) {
+        context_.set_worker_pool(shared_worker_pool(context_.get_num_threads(),
+                                                    context_.get_thread_affinity()));
+    }
+    context_.set_workspace(std::make_shared<SimulationWorkspace>());
+}
+
+PricingResult PricingPlan::execute(const MarketInputs& market) {
+    instrument_.option.spot = market.spot;
+    instrument_.option.rate = market.rate;
+    instrument_.option.volatility = market.volatility;
+    // The contract terms were checked when the plan was prepared
+    validate_market_inputs(instrument_);
+    stats_.reweighted = false;
+    stats_.effective_sample_size = 0.0;
+
+    if (min_effective_fraction_ == 0.0) return simulate();
+
+    if (cache_ && market.spot == cached_spot_) {
+        if (market.rate == cache_->rate && market.volatility == cache_->volatility) {
+            stats_.reweighted = true;
+            stats_.effective_sample_size = static_cast<double>(cache_->paths.size());
+            return cached_result_;
+        }
+        ReweightedPrice reweighted = reweight_paths(*cache_, market.rate, market.volatility);
+        if (reweighted.effective_sample_size >=
+            min_effective_fraction_ * static_cast<double>(cache_->paths.size())) {
+            PricingResult result = cached_result_;
+            result.price = reweighted.price;
+            result.error_estimate = reweighted.error_estimate;
+            stats_.reweighted = true;
+            stats_.effective_sample_size = reweighted.effective_sample_size;
+            return result;
+        }
+    }
+
+    // Record the paths if the product's kernel can; others leave the cache empty
+    auto cache = std::make_shared<PathCache>();
+    context_.set_path_cache(cache);
+    cache_.reset();
+    PricingResult result;
+    try {
+        result = simulate();
+    } catch (...) {
+        context_.set_path_cache(nullptr);
+        throw;
+    }
+    context_.set_path_cache(nullptr);
+
+    if (cache->filled) {
+        cache_ = std::move(cache);
+        cached_spot_ = market.spot;
+        cached_result_ = result;
+        stats_.effective_sample_size = static_cast<double>(cache_->paths.size());
+    }
+    return result;
+}
+
+void PricingPlan::set_reweighting(double min_effective_fraction) {
+    if (!(min_effective_fraction >= 0.0 && min_effective_fraction <= 1.0)) {
+        throw std::invalid_argument("Minimum effective sample fraction must be in [0, 1]");
+    }
+    min_effective_fraction_ = min_effective_fraction;
+    cache_.reset();
+}
+
+void PricingPlan::restore_cache(CacheState state) {
+    cache_ = std::move(state.cache);
+    cached_spot_ = state.spot;
+    cached_result_ = state.result;
+}
+
+PricingResult PricingPlan::simulate() {
+    ++stats_.simulations;
+    context_.set_seed(seed_);
+
+    if (!selected_) return price_validated_instrument(context_, instrument_);
+    return price_with_method(context_, instrument_.option, style_, choice_);
+}
+
+namespace {
+
+const double kVolBump = 0.01;
+// Smallest central volatility bump; below it vega is one-sided
+const double kMinCentralVolBump = 1e-4;
+
+} // anonymous namespace
+
+Greeks plan_greeks(PricingPlan& plan, const MarketInputs& market, double price) {
+    // Bumped spots resimulate and replace the cache the base execution left
+    PricingPlan::CacheState saved = plan.save_cache();
+    auto bumped = [&](double spot, double rate, double volatility) {
+        return plan.execute(MarketInputs{spot, rate, volatility}).price;
+    };
+
+    Greeks greeks;
+    try {
+        double ds = 0.01 * market.spot;
+        double up = bumped(market.spot + ds, market.rate, market.volatility);
+        double down = bumped(market.spot - ds, market.rate, market.volatility);
+        greeks.delta = (up - down) / (2.0 * ds);
+        greeks.gamma = (up - 2.0 * price + down) / (ds * ds);
+
+        double dv = std::min(kVolBump, 0.5 * market.volatility);
+        if (dv >= kMinCentralVolBump) {
+            double vol_up = bumped(market.spot, market.rate, market.volatility + dv);
+            double vol_down = bumped(market.spot, market.rate, market.volatility - dv);
+            greeks.vega = (vol_up - vol_down) / (2.0 * dv);
+        } else {
+            double vol_up = bumped(market.spot, market.rate, market.volatility + kVolBump);
+            greeks.vega = (vol_up - price) / kVolBump;
+        }
+
+        double dr = 1e-4;
+        double rate_up = bumped(market.spot, market.rate + dr, market.volatility);
+        double rate_down = bumped(market.spot, market.rate - dr, market.volatility);
+        greeks.rho = (rate_up - rate_down) / (2.0 * dr);
+    } catch (...) {
+        plan.restore_cache(std::move(saved));
+        throw;
+    }
+    plan.restore_cache(std::move(saved));
+    return greeks;
+}
+
+} // namespace mcoptions
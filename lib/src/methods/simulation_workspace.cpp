@@ -0,0 +1,44 @@
+#include "internal/methods/simulation_workspace.hpp"
+#include <cmath>
+
+namespace mcoptions {
+
+void compute_step_tables(const std::vector<double>& times, double rate, double volatility,
+                         StepTables& tables) {
+    size_t num_steps = times.size() - 1;
+    tables.drift.resize(num_steps);
+    tables.diffusion.resize(num_steps);
+    tables.variance.resize(num_steps);
+    for (size_t i = 0; i < num_steps; ++i) {
+        double dt = times[i + 1] - times[i];
+        tables.drift[i] = (rate - 0.5 * volatility * volatility) * dt;
+        tables.variance[i] = volatility * volatility * dt;
+        tables.diffusion[i] = std::sqrt(tables.variance[i]);
+    }
+}
+
+const StepTables& SimulationWorkspace::step_tables(const std::vector<double>& times, double rate,
+                                                   double volatility) {
+    if (times == table_times_ && rate == table_rate_ && volatility == table_volatility_ &&
+        !times.empty()) {
+        return tables_;
+    }
+
+    compute_step_tables(times, rate, volatility, tables_);
+    table_times_ = times;
+    table_rate_ = rate;
+    table_volatility_ = volatility;
+    return tables_;
+}
+
+void SimulationWorkspace::reserve_blocks(size_t num_blocks) {
+    if (blocks_.size() < num_blocks) blocks_.resize(num_blocks);
+}
+
+double* SimulationWorkspace::block_buffer(size_t block, size_t size) {
+    std::vector<double>& buffer = blocks_[block];
+    if (buffer.size() < size) buffer.resize(size);
+    return buffer.data();
+}
+
+} // namespace mcoptions
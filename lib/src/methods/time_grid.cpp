@@ -0,0 +1,55 @@
+#include "internal/methods/time_grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mcoptions {
+
+TimeGrid build_time_grid(double maturity, const std::vector<double>& event_dates, double max_step) {
+    if (!(maturity > 0.0)) {
+        throw std::invalid_argument("Maturity must be positive");
+    }
+    if (max_step < 0.0) {
+        throw std::invalid_argument("Maximum step cannot be negative");
+    }
+    for (double t : event_dates) {
+        if (!(t >= 0.0 && t <= maturity)) {
+            throw std::invalid_argument("Event dates must lie between today and maturity");
+        }
+    }
+
+    // Merge the dates with both ends
+    std::vector<double> dates(event_dates);
+    dates.push_back(0.0);
+    dates.push_back(maturity);
+    std::sort(dates.begin(), dates.end());
+    double min_gap = 1e-12 * maturity;
+    dates.erase(std::unique(dates.begin(), dates.end(),
+                            [min_gap](double a, double b) { return b - a < min_gap; }),
+                dates.end());
+    dates.back() = maturity;
+
+    TimeGrid grid;
+    grid.times.reserve(dates.size());
+    grid.times.push_back(0.0);
+    for (size_t i = 1; i < dates.size(); ++i) {
+        double t0 = dates[i - 1];
+        double dt = dates[i] - t0;
+        size_t parts = max_step > 0.0 ? static_cast<size_t>(std::ceil(dt / max_step - 1e-9)) : 1;
+        parts = std::max<size_t>(parts, 1);
+        for (size_t k = 1; k < parts; ++k) {
+            grid.times.push_back(t0 + dt * static_cast<double>(k) / static_cast<double>(parts));
+        }
+        grid.times.push_back(dates[i]);
+    }
+
+    // Each event maps to the nearest grid point (its own, up to the merge tolerance)
+    grid.event_steps.reserve(event_dates.size());
+    for (double t : event_dates) {
+        auto it = std::lower_bound(grid.times.begin(), grid.times.end(), t - min_gap);
+        grid.event_steps.push_back(static_cast<size_t>(it - grid.times.begin()));
+    }
+    return grid;
+}
+
+} // namespace mcoptions
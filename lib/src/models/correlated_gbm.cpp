@@ -0,0 +1,48 @@
+#include "internal/models/correlated_gbm.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace mcoptions {
+
+std::vector<double> cholesky_factor(const std::vector<double>& correlation, size_t n) {
+    std::vector<double> factor(n * n, 0.0);
+
+    if (correlation.empty()) {
+        for (size_t i = 0; i < n; ++i) factor[i * n + i] = 1.0;
+        return factor;
+    }
+    if (correlation.size() != n * n) {
+        throw std::invalid_argument("Correlation matrix must be n x n");
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        if (std::abs(correlation[i * n + i] - 1.0) > 1e-12) {
+            throw std::invalid_argument("Correlation matrix must have a unit diagonal");
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (std::abs(correlation[i * n + j] - correlation[j * n + i]) > 1e-12) {
+                throw std::invalid_argument("Correlation matrix must be symmetric");
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            double sum = correlation[i * n + j];
+            for (size_t k = 0; k < j; ++k) {
+                sum -= factor[i * n + k] * factor[j * n + k];
+            }
+            if (i == j) {
+                if (sum <= 0.0) {
+                    throw std::invalid_argument("Correlation matrix is not positive definite");
+                }
+                factor[i * n + i] = std::sqrt(sum);
+            } else {
+                factor[i * n + j] = sum / factor[j * n + j];
+            }
+        }
+    }
+    return factor;
+}
+
+}
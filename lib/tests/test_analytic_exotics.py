@@ -0,0 +1,200 @@
+import pytest
+import math
+import statistics
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+BARRIER, LOOKBACK = 3, 4
+AUTO, ANALYTIC, MC = 0, 1, 3
+CALL, PUT = 0, 1
+UP_AND_OUT, UP_AND_IN, DOWN_AND_OUT, DOWN_AND_IN = 0, 1, 2, 3
+
+
+def normal_cdf(x):
+    return 0.5 * (1.0 + math.erf(x / math.sqrt(2.0)))
+
+
+def black_scholes(S, K, r, sigma, T, option_type):
+    d1 = (math.log(S / K) + (r + 0.5 * sigma ** 2) * T) / (sigma * math.sqrt(T))
+    d2 = d1 - sigma * math.sqrt(T)
+    if option_type == CALL:
+        return S * normal_cdf(d1) - K * math.exp(-r * T) * normal_cdf(d2)
+    return K * math.exp(-r * T) * normal_cdf(-d2) - S * normal_cdf(-d1)
+
+
+def barrier_instrument(ffi, option_type, barrier_type, level, continuous, method=AUTO):
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = BARRIER
+    inst.option_type = option_type
+    inst.method = method
+    inst.spot = 100.0
+    inst.strike = 100.0
+    inst.rate = 0.05
+    inst.volatility = 0.25
+    inst.time_to_maturity = 1.0
+    inst.params.barrier.barrier_level = level
+    inst.params.barrier.barrier_type = barrier_type
+    inst.params.barrier.continuous = continuous
+    return inst
+
+
+def test_in_out_parity(ctx):
+    """Knock-in plus knock-out is the vanilla for every barrier and strike"""
+    ffi, mco, context = ctx
+    for option_type, price in ((CALL, mco.mco_barrier_call_analytic),
+                               (PUT, mco.mco_barrier_put_analytic)):
+        for strike in (80.0, 100.0, 130.0):
+            vanilla = black_scholes(100.0, strike, 0.05, 0.25, 1.0, option_type)
+            for out_type, in_type, level in ((UP_AND_OUT, UP_AND_IN, 120.0),
+                                             (DOWN_AND_OUT, DOWN_AND_IN, 85.0)):
+                for steps in (0, 50):
+                    knock_out = price(context, 100.0, strike, 0.05, 0.25, 1.0,
+                                      level, out_type, 0.0, steps)
+                    knock_in = price(context, 100.0, strike, 0.05, 0.25, 1.0,
+                                     level, in_type, 0.0, steps)
+                    assert knock_out >= 0.0 and knock_in >= 0.0
+                    assert abs(knock_out + knock_in - vanilla) < 1e-10
+
+
+def test_continuous_barrier_matches_bridge_simulation(ctx):
+    """Auto takes the closed form; forcing Monte Carlo uses the bridge and agrees"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 100000)
+    mco.mco_context_set_num_steps(context, 20)
+    result = ffi.new("mco_price_result_t*")
+
+    inst = barrier_instrument(ffi, CALL, UP_AND_OUT, 130.0, continuous=1)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    assert result.method == ANALYTIC
+    assert result.error_estimate == 0.0
+    analytic = result.price
+
+    inst.method = MC
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    assert result.method == MC
+    assert abs(result.price - analytic) / analytic < 0.03
+
+
+def test_bgk_matches_discrete_monitoring(ctx):
+    """The shifted closed form tracks the discretely monitored simulation"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 100000)
+    mco.mco_context_set_num_steps(context, 50)
+
+    mc = mco.mco_barrier_call(context, 100.0, 100.0, 0.05, 0.25, 1.0, 85.0, DOWN_AND_IN, 2.0)
+    bgk = mco.mco_barrier_call_analytic(context, 100.0, 100.0, 0.05, 0.25, 1.0,
+                                        85.0, DOWN_AND_IN, 2.0, 50)
+    continuous = mco.mco_barrier_call_analytic(context, 100.0, 100.0, 0.05, 0.25, 1.0,
+                                               85.0, DOWN_AND_IN, 2.0, 0)
+
+    assert abs(bgk - mc) < abs(continuous - mc)
+    assert abs(bgk - mc) / mc < 0.03
+
+
+def test_lookback_closed_forms(ctx):
+    """Continuous lookbacks match the bridge-sampled simulation; discrete ones are cheaper"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 100000)
+    mco.mco_context_set_num_steps(context, 20)
+    result = ffi.new("mco_price_result_t*")
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = LOOKBACK
+    inst.spot = 100.0
+    inst.rate = 0.05
+    inst.volatility = 0.25
+    inst.time_to_maturity = 1.0
+    inst.params.lookback.continuous = 1
+
+    for option_type in (CALL, PUT):
+        for fixed, strike in ((1, 90.0), (1, 110.0), (0, 0.0)):
+            inst.option_type = option_type
+            inst.strike = strike
+            inst.params.lookback.fixed_strike = fixed
+
+            inst.method = AUTO
+            assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+            assert result.method == ANALYTIC
+            analytic = result.price
+
+            inst.method = MC
+            assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+            assert abs(result.price - analytic) / analytic < 0.03
+
+            price = mco.mco_lookback_call_analytic if option_type == CALL \
+                else mco.mco_lookback_put_analytic
+            assert price(context, 100.0, strike, 0.05, 0.25, 1.0, fixed, 0) == analytic
+            assert price(context, 100.0, strike, 0.05, 0.25, 1.0, fixed, 12) < analytic
+
+
+def test_control_variates_reduce_variance(ctx):
+    """The BGK-shifted continuous contract cuts the spread of discrete estimates"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 4000)
+    mco.mco_context_set_num_steps(context, 25)
+
+    def estimates(price, control):
+        mco.mco_context_set_control_variates(context, control)
+        values = []
+        for seed in range(20):
+            mco.mco_context_set_seed(context, seed)
+            values.append(price())
+        return values
+
+    barrier = lambda: mco.mco_barrier_put(context, 100.0, 100.0, 0.05, 0.25, 1.0,
+                                          85.0, DOWN_AND_OUT, 0.0)
+    lookback = lambda: mco.mco_lookback_call(context, 100.0, 100.0, 0.05, 0.25, 1.0, 1)
+
+    for price in (barrier, lookback):
+        plain = estimates(price, 0)
+        controlled = estimates(price, 1)
+        assert abs(statistics.mean(plain) - statistics.mean(controlled)) < \
+            3.0 * statistics.stdev(plain) / math.sqrt(len(plain))
+        assert statistics.stdev(controlled) < 0.5 * statistics.stdev(plain)
+
+
+def test_batch_matches_scalar(ctx):
+    """Batch entry points price each element like the scalar ones"""
+    ffi, mco, context = ctx
+    n = 6
+    types = [CALL, PUT, CALL, PUT, CALL, PUT]
+    strikes = [90.0, 95.0, 100.0, 105.0, 110.0, 115.0]
+    barrier_types = [UP_AND_OUT, UP_AND_IN, DOWN_AND_OUT, DOWN_AND_IN, UP_AND_OUT, DOWN_AND_IN]
+    levels = [125.0, 125.0, 80.0, 80.0, 140.0, 90.0]
+    fixed = [1, 1, 0, 0, 1, 0]
+    c = lambda kind, values: ffi.new(kind + "[]", values)
+    prices = ffi.new("double[]", n)
+
+    status = mco.mco_barrier_analytic_batch(
+        context, n, c("int", types), c("double", [100.0] * n), c("double", strikes),
+        c("double", [0.05] * n), c("double", [0.25] * n), c("double", [1.0] * n),
+        c("double", levels), c("int", barrier_types), c("double", [1.0] * n), 50, prices)
+    assert status == MCO_OK
+    for i in range(n):
+        price = mco.mco_barrier_call_analytic if types[i] == CALL else mco.mco_barrier_put_analytic
+        assert prices[i] == price(context, 100.0, strikes[i], 0.05, 0.25, 1.0,
+                                  levels[i], barrier_types[i], 1.0, 50)
+
+    status = mco.mco_lookback_analytic_batch(
+        context, n, c("int", types), c("double", [100.0] * n), c("double", strikes),
+        c("double", [0.05] * n), c("double", [0.25] * n), c("double", [1.0] * n),
+        c("int", fixed), 0, prices)
+    assert status == MCO_OK
+    for i in range(n):
+        price = mco.mco_lookback_call_analytic if types[i] == CALL else mco.mco_lookback_put_analytic
+        assert prices[i] == price(context, 100.0, strikes[i], 0.05, 0.25, 1.0, fixed[i], 0)
+
+
+def test_invalid_inputs_rejected(ctx):
+    """Unknown barrier types and non-positive volatility are errors"""
+    ffi, mco, context = ctx
+    assert mco.mco_barrier_call_analytic(context, 100.0, 100.0, 0.05, 0.25, 1.0,
+                                         120.0, 7, 0.0, 0) == -1.0
+    assert mco.mco_lookback_put_analytic(context, 100.0, 100.0, 0.05, 0.0, 1.0, 1, 0) == -1.0
+
+    prices = ffi.new("double[]", 1)
+    one = lambda kind, value: ffi.new(kind + "[]", [value])
+    status = mco.mco_barrier_analytic_batch(
+        context, 1, one("int", CALL), one("double", 100.0), one("double", 100.0),
+        one("double", 0.05), one("double", 0.25), one("double", 1.0),
+        one("double", -5.0), one("int", UP_AND_OUT), one("double", 0.0), 0, prices)
+    assert status == MCO_ERROR_INVALID_ARGUMENT
@@ -30,3 +30,31 @@ def test_asian_more_observations_less_variance(ctx):
     
     # More observations = more averaging = lower variance = cheaper
     assert asian_weekly <= asian_monthly
+
+def test_asian_grid_follows_observation_dates(ctx):
+    """Paths step over the fixings only, so the context's step count is irrelevant"""
+    ffi, mco, context = ctx
+    
+    prices = []
+    for steps in (1, 252, 1000):
+        mco.mco_context_set_num_steps(context, steps)
+        mco.mco_context_set_seed(context, 7)
+        prices.append(mco.mco_asian_arithmetic_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 12))
+    assert prices[0] == prices[1] == prices[2]
+    
+    # Fixings no longer have to divide the step count
+    mco.mco_context_set_num_steps(context, 10)
+    daily = mco.mco_asian_arithmetic_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 250)
+    assert abs(daily - prices[0]) < 1.0
+    
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = 2  # Asian
+    inst.spot = 100.0
+    inst.strike = 100.0
+    inst.rate = 0.05
+    inst.volatility = 0.2
+    inst.time_to_maturity = 1.0
+    inst.params.asian.num_observations = 12
+    result = ffi.new("mco_price_result_t*")
+    assert mco.mco_price_instrument(context, inst, result) == 0
+    assert result.num_steps == 12
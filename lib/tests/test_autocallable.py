@@ -0,0 +1,125 @@
+import pytest
+import math
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+MC = 3
+
+DATES = [0.25, 0.5, 0.75, 1.0]
+
+
+def normal_cdf(x):
+    return 0.5 * (1.0 + math.erf(x / math.sqrt(2.0)))
+
+
+def black_scholes_put(S, K, r, sigma, T):
+    d1 = (math.log(S / K) + (r + 0.5 * sigma ** 2) * T) / (sigma * math.sqrt(T))
+    d2 = d1 - sigma * math.sqrt(T)
+    return K * math.exp(-r * T) * normal_cdf(-d2) - S * normal_cdf(-d1)
+
+
+def make_terms(ffi, dates=DATES, autocall=1.0, coupon_barrier=0.7, coupon=0.02,
+               memory=1, knock_in=0.6, put_strike=1.0):
+    obs = ffi.new("double[]", dates)
+    terms = ffi.new("mco_autocallable_terms_t*")
+    terms.notional = 100.0
+    terms.autocall_barrier = autocall
+    terms.coupon_barrier = coupon_barrier
+    terms.coupon_rate = coupon
+    terms.memory = memory
+    terms.knock_in_barrier = knock_in
+    terms.put_strike = put_strike
+    terms.observation_dates = obs
+    terms.num_observations = len(dates)
+    return terms, obs
+
+
+def price(ffi, mco, context, terms, spots=(100.0,), vols=(0.2,), corr=None, rate=0.05):
+    n = len(spots)
+    result = ffi.new("mco_price_result_t*")
+    c_spots = ffi.new("double[]", list(spots))
+    c_vols = ffi.new("double[]", list(vols))
+    c_corr = ffi.new("double[]", corr) if corr else ffi.NULL
+    status = mco.mco_price_autocallable(context, n, c_spots, ffi.NULL, c_vols, c_corr,
+                                        rate, terms, result)
+    return status, result
+
+
+def test_never_called_is_a_zero_coupon_bond(ctx):
+    """Unreachable barriers and no knock-in leave a discounted notional"""
+    ffi, mco, context = ctx
+    terms, obs = make_terms(ffi, autocall=1e9, coupon_barrier=1e9, knock_in=0.0)
+
+    status, result = price(ffi, mco, context, terms)
+
+    assert status == MCO_OK
+    assert abs(result.price - 100.0 * math.exp(-0.05)) < 1e-10
+    assert result.error_estimate < 1e-10
+
+
+def test_knock_in_put_at_maturity(ctx):
+    """With only the knock-in active the note is a bond minus a put"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 200000)
+    terms, obs = make_terms(ffi, autocall=1e9, coupon_barrier=1e9, knock_in=1.0)
+
+    status, result = price(ffi, mco, context, terms)
+
+    expected = 100.0 * math.exp(-0.05) - black_scholes_put(100.0, 100.0, 0.05, 0.2, 1.0)
+    assert status == MCO_OK
+    assert abs(result.price - expected) < 4.0 * result.error_estimate
+
+
+def test_certain_autocall_redeems_on_first_date(ctx):
+    """A zero autocall barrier redeems every path on the first observation"""
+    ffi, mco, context = ctx
+    terms, obs = make_terms(ffi, autocall=1e-9, coupon_barrier=1e-9, coupon=0.02)
+
+    status, result = price(ffi, mco, context, terms)
+
+    assert status == MCO_OK
+    assert result.method == MC
+    assert result.num_steps == len(DATES)
+    assert abs(result.price - 102.0 * math.exp(-0.05 * 0.25)) < 1e-10
+
+
+def test_memory_coupons_add_value(ctx):
+    """Catching up missed coupons can only increase the price on the same paths"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+
+    terms, obs = make_terms(ffi, memory=1)
+    mco.mco_context_set_seed(context, 1)
+    _, with_memory = price(ffi, mco, context, terms)
+
+    terms, obs = make_terms(ffi, memory=0)
+    mco.mco_context_set_seed(context, 1)
+    _, without_memory = price(ffi, mco, context, terms)
+
+    assert with_memory.price > without_memory.price
+
+
+def test_worst_of_is_cheaper(ctx):
+    """Adding a second, imperfectly correlated underlying makes the note riskier"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 50000)
+    terms, obs = make_terms(ffi)
+
+    _, single = price(ffi, mco, context, terms)
+    status, basket = price(ffi, mco, context, terms, spots=(100.0, 50.0), vols=(0.2, 0.25),
+                           corr=[1.0, 0.5, 0.5, 1.0])
+
+    assert status == MCO_OK
+    assert basket.price < single.price - 3.0 * single.error_estimate
+
+
+def test_invalid_correlation_rejected(ctx):
+    """Correlation matrices must be symmetric positive definite"""
+    ffi, mco, context = ctx
+    terms, obs = make_terms(ffi)
+
+    status, result = price(ffi, mco, context, terms, spots=(100.0, 100.0), vols=(0.2, 0.2),
+                           corr=[1.0, 1.5, 1.5, 1.0])
+
+    assert status == MCO_ERROR_INVALID_ARGUMENT
+    assert result.status == MCO_ERROR_INVALID_ARGUMENT
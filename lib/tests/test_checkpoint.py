@@ -0,0 +1,192 @@
+"""
+Tests for checkpointing and resuming long simulations
+"""
+
+import os
+import signal
+import time
+
+import pytest
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+MCO_ERROR_INTERNAL = -3
+STREAM_BLOCKS = 0
+STREAM_SEQUENTIAL = 1
+
+ASIAN = (100.0, 100.0, 0.05, 0.2, 1.0, 20)
+
+
+def new_context(mco, stream_mode, num_simulations=400000, num_steps=20):
+    context = mco.mco_context_new()
+    mco.mco_context_set_seed(context, 7)
+    mco.mco_context_set_num_simulations(context, num_simulations)
+    mco.mco_context_set_num_steps(context, num_steps)
+    mco.mco_context_set_stream_mode(context, stream_mode)
+    return context
+
+
+def info(ffi, mco, path):
+    result = ffi.new("mco_checkpoint_info_t*")
+    assert mco.mco_checkpoint_info(path.encode(), result) == MCO_OK
+    return result
+
+
+def kill_after_first_checkpoint(ffi, mco, path, stream_mode, option=ASIAN):
+    """Forks a run that checkpoints to `path` and kills it once it has saved some progress"""
+    pid = os.fork()
+    if pid == 0:
+        try:
+            context = new_context(mco, stream_mode)
+            mco.mco_context_set_checkpoint(context, path.encode(), 0.0, 0)
+            mco.mco_asian_arithmetic_call(context, *option)
+        finally:
+            os._exit(0)
+
+    deadline = time.time() + 60
+    try:
+        while time.time() < deadline:
+            if os.path.exists(path) and info(ffi, mco, path).blocks_done > 0:
+                break
+            time.sleep(0.001)
+    finally:
+        os.kill(pid, signal.SIGKILL)
+        os.waitpid(pid, 0)
+
+
+@pytest.mark.parametrize("stream_mode", [STREAM_BLOCKS, STREAM_SEQUENTIAL])
+def test_resumed_run_equals_uninterrupted_run(lib, tmp_path, stream_mode):
+    ffi, mco = lib
+    path = str(tmp_path / "asian.ckpt")
+    kill_after_first_checkpoint(ffi, mco, path, stream_mode)
+
+    saved = info(ffi, mco, path)
+    assert saved.jobs == 1 and saved.jobs_done == 0
+    assert 0 < saved.blocks_done < saved.blocks_total
+
+    context = new_context(mco, stream_mode)
+    assert mco.mco_context_set_checkpoint(context, path.encode(), 0.0, 1) == MCO_OK
+    resumed = mco.mco_asian_arithmetic_call(context, *ASIAN)
+    mco.mco_context_free(context)
+
+    # Block streams checkpoint with the fixed-order reduction
+    context = new_context(mco, stream_mode)
+    mco.mco_context_set_reproducible(context, 1)
+    uninterrupted = mco.mco_asian_arithmetic_call(context, *ASIAN)
+    mco.mco_context_free(context)
+
+    assert resumed == uninterrupted
+    finished = info(ffi, mco, path)
+    assert finished.jobs_done == 1 and finished.blocks_done == finished.blocks_total
+
+
+@pytest.mark.parametrize("threads", [1, 3])
+def test_checkpointed_run_independent_of_threads(lib, tmp_path, threads):
+    ffi, mco = lib
+    prices = []
+    for stream_mode in (STREAM_BLOCKS, STREAM_SEQUENTIAL):
+        context = new_context(mco, stream_mode, num_simulations=200000, num_steps=10)
+        mco.mco_context_set_num_threads(context, threads)
+        path = str(tmp_path / f"run{stream_mode}.ckpt")
+        assert mco.mco_context_set_checkpoint(context, path.encode(), 0.0, 0) == MCO_OK
+        checkpointed = mco.mco_asian_arithmetic_call(context, *ASIAN[:5], 10)
+        mco.mco_context_free(context)
+
+        context = new_context(mco, stream_mode, num_simulations=200000, num_steps=10)
+        mco.mco_context_set_reproducible(context, 1)
+        plain = mco.mco_asian_arithmetic_call(context, *ASIAN[:5], 10)
+        mco.mco_context_free(context)
+        assert checkpointed == plain
+        prices.append(checkpointed)
+    assert prices[0] != prices[1]
+
+
+def test_other_jobs_in_the_file_are_not_used(lib, tmp_path):
+    ffi, mco = lib
+    path = str(tmp_path / "book.ckpt")
+    context = new_context(mco, STREAM_BLOCKS, num_simulations=50000)
+    assert mco.mco_context_set_checkpoint(context, path.encode(), 3600.0, 0) == MCO_OK
+    mco.mco_asian_arithmetic_call(context, *ASIAN)
+    # Within the interval nothing is written until a flush
+    assert not os.path.exists(path)
+    assert mco.mco_context_flush_checkpoint(context) == MCO_OK
+    mco.mco_context_free(context)
+    assert info(ffi, mco, path).jobs_done == 1
+
+    # Same seed and stream key, different strike: a new job
+    context = new_context(mco, STREAM_BLOCKS, num_simulations=50000)
+    assert mco.mco_context_set_checkpoint(context, path.encode(), 0.0, 1) == MCO_OK
+    resumed = mco.mco_asian_arithmetic_put(context, *ASIAN)
+    mco.mco_context_free(context)
+
+    context = new_context(mco, STREAM_BLOCKS, num_simulations=50000)
+    mco.mco_context_set_reproducible(context, 1)
+    fresh = mco.mco_asian_arithmetic_put(context, *ASIAN)
+    mco.mco_context_free(context)
+
+    assert resumed == fresh
+    assert info(ffi, mco, path).jobs == 2
+
+
+@pytest.mark.parametrize("stream_mode", [STREAM_BLOCKS, STREAM_SEQUENTIAL])
+def test_contracts_with_equal_first_blocks_are_different_jobs(lib, tmp_path, stream_mode):
+    """Deep out of the money, both pay nothing on block 0; the other's record is not resumed"""
+    ffi, mco = lib
+    path = str(tmp_path / "otm.ckpt")
+    kill_after_first_checkpoint(ffi, mco, path, stream_mode, (100.0, 400.0) + ASIAN[2:])
+    assert info(ffi, mco, path).jobs == 1
+
+    context = new_context(mco, stream_mode)
+    assert mco.mco_context_set_checkpoint(context, path.encode(), 0.0, 1) == MCO_OK
+    assert mco.mco_asian_arithmetic_call(context, 100.0, 500.0, *ASIAN[2:]) == 0.0
+    mco.mco_context_free(context)
+
+    # The killed job is still in progress next to the finished one
+    saved = info(ffi, mco, path)
+    assert saved.jobs == 2 and saved.jobs_done == 1
+    assert saved.blocks_done < saved.blocks_total
+
+
+def test_finished_jobs_leave_only_counts(lib, tmp_path):
+    ffi, mco = lib
+    path = str(tmp_path / "batch.ckpt")
+    context = new_context(mco, STREAM_SEQUENTIAL, num_simulations=50000)
+    assert mco.mco_context_set_checkpoint(context, path.encode(), 0.0, 0) == MCO_OK
+    mco.mco_asian_arithmetic_call(context, *ASIAN)
+    size = os.path.getsize(path)
+    for _ in range(3):
+        mco.mco_asian_arithmetic_put(context, *ASIAN)
+    mco.mco_context_free(context)
+
+    assert os.path.getsize(path) == size
+    saved = info(ffi, mco, path)
+    assert saved.jobs == saved.jobs_done == 4
+    assert saved.blocks_done == saved.blocks_total > 0
+
+
+def test_unwritable_checkpoint_does_not_fail_pricing(lib, tmp_path):
+    ffi, mco = lib
+    path = str(tmp_path / "missing" / "run.ckpt")
+    context = new_context(mco, STREAM_BLOCKS, num_simulations=50000)
+    assert mco.mco_context_set_checkpoint(context, path.encode(), 0.0, 0) == MCO_OK
+    checkpointed = mco.mco_asian_arithmetic_call(context, *ASIAN)
+    assert mco.mco_context_flush_checkpoint(context) == MCO_ERROR_INTERNAL
+    mco.mco_context_free(context)
+
+    context = new_context(mco, STREAM_BLOCKS, num_simulations=50000)
+    mco.mco_context_set_reproducible(context, 1)
+    plain = mco.mco_asian_arithmetic_call(context, *ASIAN)
+    mco.mco_context_free(context)
+    assert checkpointed == plain
+
+
+def test_checkpoint_errors(ctx, tmp_path):
+    ffi, mco, context = ctx
+    bogus = tmp_path / "bogus.ckpt"
+    bogus.write_bytes(b"not a checkpoint")
+    assert mco.mco_context_set_checkpoint(context, str(bogus).encode(), 0.0, 1) == MCO_ERROR_INVALID_ARGUMENT
+    # Not resuming ignores the old contents
+    assert mco.mco_context_set_checkpoint(context, str(bogus).encode(), 0.0, 0) == MCO_OK
+    assert mco.mco_context_set_checkpoint(context, b"x.ckpt", -1.0, 0) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_context_set_checkpoint(context, ffi.NULL, 0.0, 0) == MCO_OK
+    assert mco.mco_checkpoint_info(str(bogus).encode(), ffi.new("mco_checkpoint_info_t*")) == MCO_ERROR_INVALID_ARGUMENT
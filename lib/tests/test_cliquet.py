@@ -0,0 +1,136 @@
+import pytest
+import math
+import statistics
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+FORWARD_START, CLIQUET = 10, 11
+ANALYTIC, MC = 1, 3
+CALL, PUT = 0, 1
+
+MONTHLY = [i / 12.0 for i in range(1, 13)]
+
+
+def normal_cdf(x):
+    return 0.5 * (1.0 + math.erf(x / math.sqrt(2.0)))
+
+
+def black_scholes_call(S, K, r, sigma, T):
+    d1 = (math.log(S / K) + (r + 0.5 * sigma ** 2) * T) / (sigma * math.sqrt(T))
+    d2 = d1 - sigma * math.sqrt(T)
+    return S * normal_cdf(d1) - K * math.exp(-r * T) * normal_cdf(d2)
+
+
+def make_cliquet(ffi, dates=MONTHLY, local_floor=-0.02, local_cap=0.02,
+                 global_floor=0.0, global_cap=0.10):
+    c_dates = ffi.new("double[]", dates)
+    params = ffi.new("mco_cliquet_params_t*")
+    params.reset_dates = c_dates
+    params.num_resets = len(dates)
+    params.local_floor = local_floor
+    params.local_cap = local_cap
+    params.global_floor = global_floor
+    params.global_cap = global_cap
+    params.notional = 100.0
+    return params, c_dates
+
+
+def test_forward_start_closed_form(ctx):
+    """Forward-start call is spot times an ATM-forward unit call over the remaining life"""
+    ffi, mco, context = ctx
+
+    price = mco.mco_forward_start_call(context, 100.0, 1.0, 0.05, 0.2, 0.5, 1.5)
+
+    assert abs(price - 100.0 * black_scholes_call(1.0, 1.0, 0.05, 0.2, 1.0)) < 1e-10
+
+
+def test_forward_start_simulation_matches_closed_form(ctx):
+    """Forcing Monte Carlo through the descriptor agrees with the closed form"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 200000)
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = FORWARD_START
+    inst.option_type = PUT
+    inst.spot = 100.0
+    inst.strike = 0.9
+    inst.rate = 0.05
+    inst.volatility = 0.2
+    inst.time_to_maturity = 1.0
+    inst.params.forward_start.start_time = 0.25
+    result = ffi.new("mco_price_result_t*")
+
+    inst.method = ANALYTIC
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    analytic = result.price
+
+    inst.method = MC
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    assert result.method == MC
+    assert abs(result.price - analytic) / analytic < 0.03
+
+
+def test_uncapped_cliquet_equals_closed_form(ctx):
+    """Without global cap/floor the control variate is exact"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 2000)
+    mco.mco_context_set_control_variates(context, 1)
+    params, dates = make_cliquet(ffi, global_floor=-math.inf, global_cap=math.inf)
+    result = ffi.new("mco_price_result_t*")
+
+    # Each period: floor + unit call at 1+floor - unit call at 1+cap, grown to the reset date
+    dt = 1.0 / 12.0
+    growth = math.exp(0.05 * dt)
+    period = (-0.02 + growth * black_scholes_call(1.0, 0.98, 0.05, 0.2, dt)
+              - growth * black_scholes_call(1.0, 1.02, 0.05, 0.2, dt))
+    expected = math.exp(-0.05) * 100.0 * 12 * period
+
+    assert mco.mco_price_cliquet(context, 0.05, 0.2, params, result) == MCO_OK
+    assert abs(result.price - expected) < 1e-9
+
+
+def test_control_variate_reduces_cliquet_variance(ctx):
+    """The forward-start strip control cuts the spread of repeated estimates"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 5000)
+    params, dates = make_cliquet(ffi)
+    result = ffi.new("mco_price_result_t*")
+
+    def estimates(control):
+        mco.mco_context_set_control_variates(context, control)
+        values = []
+        for seed in range(20):
+            mco.mco_context_set_seed(context, seed)
+            assert mco.mco_price_cliquet(context, 0.05, 0.2, params, result) == MCO_OK
+            values.append(result.price)
+        return values
+
+    plain = estimates(0)
+    controlled = estimates(1)
+
+    assert abs(statistics.mean(plain) - statistics.mean(controlled)) < 0.1
+    assert statistics.stdev(controlled) < 0.6 * statistics.stdev(plain)
+
+
+def test_cliquet_bounded_by_global_terms(ctx):
+    """Price lies between the discounted global floor and cap"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 5000)
+    params, dates = make_cliquet(ffi, global_floor=0.01, global_cap=0.08)
+    result = ffi.new("mco_price_result_t*")
+
+    assert mco.mco_price_cliquet(context, 0.05, 0.2, params, result) == MCO_OK
+    df = math.exp(-0.05)
+    assert 100.0 * 0.01 * df <= result.price <= 100.0 * 0.08 * df
+
+
+def test_invalid_cliquet_rejected(ctx):
+    """Inverted caps and unordered dates are rejected"""
+    ffi, mco, context = ctx
+    result = ffi.new("mco_price_result_t*")
+
+    params, dates = make_cliquet(ffi, local_floor=0.05, local_cap=0.01)
+    assert mco.mco_price_cliquet(context, 0.05, 0.2, params, result) == MCO_ERROR_INVALID_ARGUMENT
+
+    params, dates = make_cliquet(ffi, dates=[0.5, 0.25])
+    assert mco.mco_price_cliquet(context, 0.05, 0.2, params, result) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_forward_start_call(context, 100.0, 1.0, 0.05, 0.2, 1.0, 0.5) == -1.0
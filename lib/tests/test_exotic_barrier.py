@@ -0,0 +1,123 @@
+import pytest
+import math
+
+DOWN_AND_OUT, DOWN_AND_IN = 2, 3
+
+
+def normal_cdf(x):
+    return 0.5 * (1.0 + math.erf(x / math.sqrt(2.0)))
+
+
+def black_scholes_call(S, K, r, sigma, T):
+    d1 = (math.log(S / K) + (r + 0.5 * sigma ** 2) * T) / (sigma * math.sqrt(T))
+    d2 = d1 - sigma * math.sqrt(T)
+    return S * normal_cdf(d1) - K * math.exp(-r * T) * normal_cdf(d2)
+
+
+def down_and_out_call(S, K, r, sigma, T, H):
+    """Continuously monitored down-and-out call, H <= K (Merton / Reiner-Rubinstein)"""
+    lam = (r + 0.5 * sigma ** 2) / sigma ** 2
+    y = math.log(H * H / (S * K)) / (sigma * math.sqrt(T)) + lam * sigma * math.sqrt(T)
+    down_in = (S * (H / S) ** (2 * lam) * normal_cdf(y)
+               - K * math.exp(-r * T) * (H / S) ** (2 * lam - 2) * normal_cdf(y - sigma * math.sqrt(T)))
+    return black_scholes_call(S, K, r, sigma, T) - down_in
+
+
+def test_bridge_gives_continuous_monitoring_on_one_step(ctx):
+    """A window covering the whole life is a continuous barrier, even with a single step"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 100000)
+    mco.mco_context_set_num_steps(context, 1)
+
+    price = mco.mco_window_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0,
+                                        90.0, DOWN_AND_OUT, 0.0, 1.0, 0.0)
+    expected = down_and_out_call(100.0, 100.0, 0.05, 0.2, 1.0, 90.0)
+
+    assert abs(price - expected) / expected < 0.02
+
+
+def test_double_knock_out_independent_of_steps(ctx):
+    """With the bridge survival probability the step count only affects noise"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 100000)
+
+    mco.mco_context_set_num_steps(context, 1)
+    coarse = mco.mco_double_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 80.0, 130.0, 0, 0.0)
+    mco.mco_context_set_num_steps(context, 50)
+    fine = mco.mco_double_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 80.0, 130.0, 0, 0.0)
+
+    assert coarse > 0.0
+    assert abs(coarse - fine) / fine < 0.03
+
+
+def test_double_knock_in_out_parity(ctx):
+    """Knock-in + knock-out on the same paths is the vanilla option"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 100000)
+    mco.mco_context_set_num_steps(context, 10)
+
+    mco.mco_context_set_seed(context, 11)
+    knock_out = mco.mco_double_barrier_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 80.0, 130.0, 0, 0.0)
+    mco.mco_context_set_seed(context, 11)
+    knock_in = mco.mco_double_barrier_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 80.0, 130.0, 1, 0.0)
+
+    call = black_scholes_call(100.0, 100.0, 0.05, 0.2, 1.0)
+    vanilla_put = call - 100.0 + 100.0 * math.exp(-0.05)
+    assert abs((knock_out + knock_in) - vanilla_put) / vanilla_put < 0.02
+
+
+def test_shorter_window_is_worth_more(ctx):
+    """A knock-out monitored over part of the life is worth more than one monitored throughout"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 50000)
+    mco.mco_context_set_num_steps(context, 4)
+
+    full = mco.mco_window_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0,
+                                       90.0, DOWN_AND_OUT, 0.0, 1.0, 0.0)
+    partial = mco.mco_window_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0,
+                                          90.0, DOWN_AND_OUT, 0.25, 0.75, 0.0)
+    vanilla = black_scholes_call(100.0, 100.0, 0.05, 0.2, 1.0)
+
+    assert full < partial < vanilla
+
+
+def test_parisian_window_monotonic(ctx):
+    """Longer required excursions knock out fewer paths"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_num_steps(context, 252)
+
+    prices = []
+    for window in [0.0, 0.02, 0.1]:
+        mco.mco_context_set_seed(context, 5)
+        prices.append(mco.mco_parisian_call(context, 100.0, 100.0, 0.05, 0.2, 1.0,
+                                            90.0, DOWN_AND_OUT, window, 0.0))
+
+    vanilla = black_scholes_call(100.0, 100.0, 0.05, 0.2, 1.0)
+    assert prices[0] < prices[1] < prices[2] < vanilla * 1.02
+
+
+def test_parisian_in_out_parity(ctx):
+    """Parisian knock-in + knock-out on the same paths is the vanilla option"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_num_steps(context, 100)
+
+    mco.mco_context_set_seed(context, 3)
+    out = mco.mco_parisian_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 90.0, DOWN_AND_OUT, 0.05, 0.0)
+    mco.mco_context_set_seed(context, 3)
+    knock_in = mco.mco_parisian_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 90.0, DOWN_AND_IN, 0.05, 0.0)
+
+    vanilla = black_scholes_call(100.0, 100.0, 0.05, 0.2, 1.0)
+    assert abs((out + knock_in) - vanilla) / vanilla < 0.05
+
+
+def test_invalid_barriers_rejected(ctx):
+    """Malformed corridors and windows return -1"""
+    ffi, mco, context = ctx
+
+    assert mco.mco_double_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 130.0, 80.0, 0, 0.0) == -1.0
+    assert mco.mco_window_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0,
+                                       90.0, DOWN_AND_OUT, 0.8, 0.2, 0.0) == -1.0
+    assert mco.mco_parisian_call(context, 100.0, 100.0, 0.05, 0.2, 1.0,
+                                 90.0, 7, 0.1, 0.0) == -1.0
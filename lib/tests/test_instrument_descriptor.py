@@ -0,0 +1,170 @@
+import pytest
+import math
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+MCO_ERROR_UNSUPPORTED = -2
+
+EUROPEAN, AMERICAN, ASIAN, BARRIER, LOOKBACK, BERMUDAN = range(6)
+DOUBLE_BARRIER, WINDOW_BARRIER, PARISIAN, AUTOCALLABLE = range(6, 10)
+CALL, PUT = 0, 1
+AUTO, ANALYTIC, TREE, MC, LSM = range(5)
+
+
+def make_instrument(ffi, kind, option_type=CALL, method=AUTO, tolerance=0.01):
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = kind
+    inst.option_type = option_type
+    inst.method = method
+    inst.spot = 100.0
+    inst.strike = 100.0
+    inst.rate = 0.05
+    inst.volatility = 0.2
+    inst.time_to_maturity = 1.0
+    inst.tolerance = tolerance
+    return inst
+
+
+def test_descriptor_matches_dedicated_entry_points(ctx):
+    """Same seed, same settings: the generic path must reproduce the legacy calls"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_num_steps(context, 50)
+    result = ffi.new("mco_price_result_t*")
+
+    inst = make_instrument(ffi, ASIAN)
+    inst.params.asian.num_observations = 10
+    mco.mco_context_set_seed(context, 7)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    mco.mco_context_set_seed(context, 7)
+    expected = mco.mco_asian_arithmetic_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 10)
+    assert result.price == expected
+    assert result.method == MC
+    assert result.num_paths == 20000
+
+    inst = make_instrument(ffi, BARRIER, PUT)
+    inst.params.barrier.barrier_level = 80.0
+    inst.params.barrier.barrier_type = 3
+    inst.params.barrier.rebate = 0.0
+    mco.mco_context_set_seed(context, 7)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    mco.mco_context_set_seed(context, 7)
+    expected = mco.mco_barrier_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 80.0, 3, 0.0)
+    assert result.price == expected
+
+
+def test_bermudan_dates_are_borrowed(ctx):
+    """Exercise dates are read through the pointer during the call only"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 10000)
+    dates = ffi.new("double[]", [0.25, 0.5, 0.75, 1.0])
+    inst = make_instrument(ffi, BERMUDAN, PUT)
+    inst.params.bermudan.exercise_dates = dates
+    inst.params.bermudan.num_dates = 4
+    result = ffi.new("mco_price_result_t*")
+
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    assert result.num_steps == 4
+    assert 5.0 < result.price < 8.0
+
+
+def test_auto_vanilla_uses_selector(ctx):
+    """AUTO on vanilla instruments behaves exactly like mco_price"""
+    ffi, mco, context = ctx
+    result = ffi.new("mco_price_result_t*")
+    reference = ffi.new("mco_price_result_t*")
+
+    inst = make_instrument(ffi, AMERICAN, PUT, AUTO, 0.01)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    mco.mco_price(context, 1, PUT, 100.0, 100.0, 0.05, 0.2, 1.0, 0.01, reference)
+    assert result.method == reference.method == TREE
+    assert result.price == reference.price
+
+
+def test_unsupported_method_is_reported(ctx):
+    """A method that cannot price the product is rejected, not approximated"""
+    ffi, mco, context = ctx
+    result = ffi.new("mco_price_result_t*")
+
+    inst = make_instrument(ffi, AMERICAN, PUT, ANALYTIC)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_ERROR_UNSUPPORTED
+    assert result.status == MCO_ERROR_UNSUPPORTED
+
+    inst = make_instrument(ffi, LOOKBACK, CALL, TREE)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_ERROR_UNSUPPORTED
+
+
+def test_batch_reports_per_instrument_status(ctx):
+    """One bad entry does not stop the rest of the batch"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 5000)
+    instruments = ffi.new("mco_instrument_t[3]")
+    results = ffi.new("mco_price_result_t[3]")
+
+    for i, kind in enumerate([EUROPEAN, ASIAN, LOOKBACK]):
+        src = make_instrument(ffi, kind)
+        instruments[i] = src[0]
+    instruments[1].params.asian.num_observations = 0  # invalid
+    instruments[2].params.lookback.fixed_strike = 1
+
+    status = mco.mco_price_instruments(context, instruments, 3, results)
+
+    assert status == MCO_ERROR_INVALID_ARGUMENT
+    assert results[0].status == MCO_OK
+    assert results[0].method == ANALYTIC
+    assert results[0].error_estimate == 0.0
+    assert results[1].status == MCO_ERROR_INVALID_ARGUMENT
+    assert results[2].status == MCO_OK
+    assert results[2].price > 0.0
+    assert math.isnan(results[2].error_estimate)
+
+
+def test_descriptor_double_barrier(ctx):
+    """Newer products are reachable through the same descriptor"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 10000)
+    mco.mco_context_set_num_steps(context, 5)
+    result = ffi.new("mco_price_result_t*")
+
+    inst = make_instrument(ffi, DOUBLE_BARRIER)
+    inst.params.double_barrier.lower_barrier = 80.0
+    inst.params.double_barrier.upper_barrier = 130.0
+    inst.params.double_barrier.knock_in = 0
+    mco.mco_context_set_seed(context, 9)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    mco.mco_context_set_seed(context, 9)
+    expected = mco.mco_double_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 80.0, 130.0, 0, 0.0)
+    assert result.price == expected
+
+
+def test_descriptor_autocallable(ctx):
+    """Single-asset autocallables use strike as the initial fixing"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 10000)
+    dates = ffi.new("double[]", [0.5, 1.0])
+    result = ffi.new("mco_price_result_t*")
+    reference = ffi.new("mco_price_result_t*")
+
+    inst = make_instrument(ffi, AUTOCALLABLE)
+    inst.strike = 110.0
+    terms = inst.params.autocallable
+    terms.notional = 100.0
+    terms.autocall_barrier = 1.0
+    terms.coupon_barrier = 0.8
+    terms.coupon_rate = 0.03
+    terms.memory = 1
+    terms.knock_in_barrier = 0.7
+    terms.put_strike = 1.0
+    terms.observation_dates = dates
+    terms.num_observations = 2
+
+    mco.mco_context_set_seed(context, 4)
+    assert mco.mco_price_instrument(context, inst, result) == MCO_OK
+    mco.mco_context_set_seed(context, 4)
+    spot = ffi.new("double[]", [100.0])
+    fixing = ffi.new("double[]", [110.0])
+    vol = ffi.new("double[]", [0.2])
+    mco.mco_price_autocallable(context, 1, spot, fixing, vol, ffi.NULL, 0.05,
+                               ffi.addressof(inst.params, "autocallable"), reference)
+    assert result.price == reference.price
+    assert result.error_estimate == reference.error_estimate
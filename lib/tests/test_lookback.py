@@ -105,3 +105,56 @@ def test_lookback_floating_strike_put(ctx):
     
     assert price > 0
     assert price > 5.0
+
+def test_lookback_bridge_extremum_on_coarse_grid(ctx):
+    """Sampling the bridge maximum gives continuous monitoring with only four steps"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 100000)
+    mco.mco_context_set_num_steps(context, 4)
+    result = ffi.new("mco_price_result_t*")
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = 4  # Lookback
+    inst.method = 3  # Monte Carlo
+    inst.spot = 100.0
+    inst.strike = 100.0
+    inst.rate = 0.05
+    inst.volatility = 0.2
+    inst.time_to_maturity = 1.0
+    inst.params.lookback.fixed_strike = 1
+    inst.params.lookback.continuous = 1
+
+    assert mco.mco_price_instrument(context, inst, result) == 0
+    continuous = mco.mco_lookback_call_analytic(context, 100.0, 100.0, 0.05, 0.2, 1.0, 1, 0)
+    grid_only = mco.mco_lookback_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 1)
+
+    assert abs(result.price - continuous) / continuous < 0.02
+    assert grid_only < 0.9 * continuous
+
+# Seed 42, 3001 paths of 50 steps, as priced by the serial loop before the
+# parallel engine: (call, fixed_strike, antithetic) -> price
+SERIAL_PRICES = {
+    (1, 1, 0): 17.853508409864887,
+    (1, 1, 1): 17.533598701171663,
+    (1, 0, 0): 16.414195368620078,
+    (1, 0, 1): 16.02734550898763,
+    (0, 1, 0): 10.894078903975387,
+    (0, 1, 1): 11.133601723424796,
+    (0, 0, 0): 12.333391945220184,
+    (0, 0, 1): 12.63985491560885,
+}
+
+@pytest.mark.parametrize("key", sorted(SERIAL_PRICES))
+@pytest.mark.parametrize("threads", [1, 3])
+def test_lookback_sequential_stream_reproduces_serial_prices(ctx, key, threads):
+    """The sequential stream draws path by path, so seeded prices are the historical ones"""
+    ffi, mco, context = ctx
+    call, fixed_strike, antithetic = key
+    mco.mco_context_set_seed(context, 42)
+    mco.mco_context_set_num_simulations(context, 3001)
+    mco.mco_context_set_num_steps(context, 50)
+    mco.mco_context_set_antithetic(context, antithetic)
+    mco.mco_context_set_stream_mode(context, 1)  # MCO_STREAM_SEQUENTIAL
+    mco.mco_context_set_num_threads(context, threads)
+    price = (mco.mco_lookback_call if call else mco.mco_lookback_put)(
+        context, 100.0, 100.0, 0.05, 0.2, 1.0, fixed_strike)
+    assert price == SERIAL_PRICES[key]
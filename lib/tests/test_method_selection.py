@@ -0,0 +1,90 @@
+import pytest
+import math
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+
+EUROPEAN, AMERICAN = 0, 1
+CALL, PUT = 0, 1
+
+ANALYTIC, TREE, MC, LSM = 1, 2, 3, 4
+
+
+def normal_cdf(x):
+    return 0.5 * (1.0 + math.erf(x / math.sqrt(2.0)))
+
+
+def black_scholes(S, K, r, sigma, T, is_call):
+    d1 = (math.log(S / K) + (r + 0.5 * sigma ** 2) * T) / (sigma * math.sqrt(T))
+    d2 = d1 - sigma * math.sqrt(T)
+    if is_call:
+        return S * normal_cdf(d1) - K * math.exp(-r * T) * normal_cdf(d2)
+    return K * math.exp(-r * T) * normal_cdf(-d2) - S * normal_cdf(-d1)
+
+
+def test_european_uses_closed_form(ctx):
+    """European options under GBM should never be simulated"""
+    ffi, mco, context = ctx
+    result = ffi.new("mco_price_result_t*")
+    
+    status = mco.mco_price(context, EUROPEAN, CALL, 100.0, 100.0, 0.05, 0.2, 1.0, 1e-4, result)
+    
+    assert status == MCO_OK
+    assert result.method == ANALYTIC
+    assert result.num_paths == 0
+    assert abs(result.price - black_scholes(100.0, 100.0, 0.05, 0.2, 1.0, True)) < 1e-10
+
+
+def test_american_call_equals_european(ctx):
+    """Without dividends the American call is priced in closed form"""
+    ffi, mco, context = ctx
+    result = ffi.new("mco_price_result_t*")
+    
+    status = mco.mco_price(context, AMERICAN, CALL, 100.0, 110.0, 0.05, 0.3, 0.5, 0.01, result)
+    
+    assert status == MCO_OK
+    assert result.method == ANALYTIC
+    assert abs(result.price - black_scholes(100.0, 110.0, 0.05, 0.3, 0.5, True)) < 1e-10
+
+
+def test_american_put_prefers_tree(ctx):
+    """American put should go to the tree, sized to the tolerance"""
+    ffi, mco, context = ctx
+    loose = ffi.new("mco_price_result_t*")
+    tight = ffi.new("mco_price_result_t*")
+    
+    assert mco.mco_price(context, AMERICAN, PUT, 100.0, 100.0, 0.05, 0.2, 1.0, 0.1, loose) == MCO_OK
+    assert mco.mco_price(context, AMERICAN, PUT, 100.0, 100.0, 0.05, 0.2, 1.0, 0.01, tight) == MCO_OK
+    
+    assert loose.method == TREE
+    assert tight.method == TREE
+    assert tight.num_steps > loose.num_steps
+    
+    reference = mco.mco_binomial_american_put_steps(context, 100.0, 100.0, 0.05, 0.2, 1.0, 2000)
+    assert abs(loose.price - reference) < 0.1
+    assert abs(tight.price - reference) < 0.01
+
+
+def test_non_gbm_model_falls_back_to_lsm(ctx):
+    """Tree and closed forms are GBM-only; other models must simulate"""
+    ffi, mco, context = ctx
+    result = ffi.new("mco_price_result_t*")
+    mco.mco_context_set_model(context, 1)
+    
+    status = mco.mco_price(context, AMERICAN, PUT, 100.0, 100.0, 0.05, 0.2, 1.0, 0.1, result)
+    
+    assert status == MCO_OK
+    assert result.method == LSM
+    assert result.num_paths >= 1000
+    assert 5.0 < result.price < 7.0
+
+
+def test_invalid_inputs(ctx):
+    """Bad tolerance, style or option data should return an error code"""
+    ffi, mco, context = ctx
+    result = ffi.new("mco_price_result_t*")
+    
+    assert mco.mco_price(context, EUROPEAN, CALL, 100.0, 100.0, 0.05, 0.2, 1.0, 0.0, result) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_price(context, 7, CALL, 100.0, 100.0, 0.05, 0.2, 1.0, 0.01, result) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_price(context, EUROPEAN, CALL, -1.0, 100.0, 0.05, 0.2, 1.0, 0.01, result) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_price(context, EUROPEAN, CALL, 100.0, 100.0, 0.05, 0.2, 1.0, 0.01, ffi.NULL) == MCO_ERROR_INVALID_ARGUMENT
@@ -0,0 +1,99 @@
+import math
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+BOX_MULLER, ZIGGURAT = 0, 1
+STREAM_SEQUENTIAL = 1
+
+
+def black_scholes_call(S, K, r, sigma, T):
+    N = lambda x: 0.5 * (1.0 + math.erf(x / math.sqrt(2.0)))
+    d1 = (math.log(S / K) + (r + 0.5 * sigma ** 2) * T) / (sigma * math.sqrt(T))
+    return S * N(d1) - K * math.exp(-r * T) * N(d1 - sigma * math.sqrt(T))
+
+
+def test_normal_method_selection(ctx):
+    """Both methods are accepted, anything else is rejected"""
+    ffi, mco, context = ctx
+    assert mco.mco_context_set_normal_method(context, ZIGGURAT) == MCO_OK
+    assert mco.mco_context_set_normal_method(context, BOX_MULLER) == MCO_OK
+    assert mco.mco_context_set_normal_method(context, 2) == MCO_ERROR_INVALID_ARGUMENT
+
+
+def test_ziggurat_prices_across_strikes(ctx):
+    """Single-step calls over a range of strikes probe the whole distribution, tails included"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 400000)
+    mco.mco_context_set_num_steps(context, 1)
+    mco.mco_context_set_normal_method(context, ZIGGURAT)
+    mco.mco_context_set_seed(context, 17)
+
+    for strike in (60.0, 80.0, 100.0, 120.0, 160.0):
+        price = mco.mco_european_call(context, 100.0, strike, 0.05, 0.25, 1.0)
+        expected = black_scholes_call(100.0, strike, 0.05, 0.25, 1.0)
+        assert abs(price - expected) < 0.08, (strike, price, expected)
+
+
+def test_ziggurat_paths_reproducible(ctx):
+    """Seeded ziggurat prices repeat, differ from Box-Muller and do not depend on threads"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_num_steps(context, 20)
+    mco.mco_context_set_antithetic(context, 1)
+    mco.mco_context_set_reproducible(context, 1)
+
+    def prices(method, threads, stream_mode=0):
+        mco.mco_context_set_normal_method(context, method)
+        mco.mco_context_set_num_threads(context, threads)
+        mco.mco_context_set_stream_mode(context, stream_mode)
+        values = []
+        for price in (lambda: mco.mco_european_call(context, 100.0, 100.0, 0.05, 0.2, 1.0),
+                      lambda: mco.mco_asian_arithmetic_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 20),
+                      lambda: mco.mco_lookback_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 1),
+                      lambda: mco.mco_american_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 20)):
+            mco.mco_context_set_seed(context, 5)
+            values.append(price())
+        return values
+
+    ziggurat = prices(ZIGGURAT, 1)
+    box_muller = prices(BOX_MULLER, 1)
+    assert all(z != b for z, b in zip(ziggurat, box_muller))
+    assert all(abs(z - b) < 0.05 * b for z, b in zip(ziggurat, box_muller))
+    assert prices(ZIGGURAT, 3) == ziggurat
+    assert prices(ZIGGURAT, 3, STREAM_SEQUENTIAL) == prices(ZIGGURAT, 1, STREAM_SEQUENTIAL)
+
+
+def test_inverse_normal_cdf_accuracy(ctx):
+    """AS241 agrees with the reference to double precision, deep tails included"""
+    from statistics import NormalDist
+    ffi, mco, context = ctx
+    probabilities = [1e-300, 1e-100, 1e-20, 1e-10, 1e-5, 0.001, 0.02, 0.075, 0.3, 0.5,
+                     0.7, 0.925, 0.99, 1 - 1e-10, 1 - 2 ** -53]
+    probabilities += [(i + 0.5) / 1000 for i in range(1000)]
+    count = len(probabilities)
+    p = ffi.new("double[]", probabilities)
+    x = ffi.new("double[]", count)
+
+    for refine in (0, 1):
+        assert mco.mco_inverse_normal_cdf(p, count, refine, x) == MCO_OK
+        for i, prob in enumerate(probabilities):
+            expected = NormalDist().inv_cdf(prob)
+            assert abs(x[i] - expected) <= 4e-15 * max(1.0, abs(expected)), (prob, x[i], expected)
+
+    # Refined values solve Phi(x) = p to within rounding of the CDF
+    for i, prob in enumerate(probabilities):
+        tail = min(prob, 1.0 - prob)
+        cdf = 0.5 * math.erfc(-x[i] / math.sqrt(2.0)) if x[i] < 0 else 1.0 - 0.5 * math.erfc(x[i] / math.sqrt(2.0))
+        assert abs(cdf - prob) <= 1e-13 * tail + 1e-16, (prob, cdf)
+
+
+def test_inverse_normal_cdf_edges(ctx):
+    """0 and 1 map to infinities, values outside [0, 1] to NaN, in place is allowed"""
+    ffi, mco, context = ctx
+    values = ffi.new("double[]", [0.0, 1.0, -0.5, 1.5, 0.5])
+    assert mco.mco_inverse_normal_cdf(values, 5, 1, values) == MCO_OK
+    assert values[0] == -math.inf and values[1] == math.inf
+    assert math.isnan(values[2]) and math.isnan(values[3])
+    assert values[4] == 0.0
+    assert mco.mco_inverse_normal_cdf(ffi.NULL, 5, 0, values) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_inverse_normal_cdf(ffi.NULL, 0, 0, ffi.NULL) == MCO_OK
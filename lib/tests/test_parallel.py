@@ -0,0 +1,305 @@
+import math
+import pytest
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+MCO_ERROR_UNSUPPORTED = -2
+AFFINITY_NONE, AFFINITY_COMPACT, AFFINITY_SPREAD = 0, 1, 2
+UP_AND_OUT = 0
+EUROPEAN, LOOKBACK = 0, 4
+MONTE_CARLO = 3
+STREAM_BLOCKS, STREAM_SEQUENTIAL = 0, 1
+
+
+def test_topology(lib):
+    """At least one CPU on one node; the per-node counts add up"""
+    ffi, mco = lib
+    topology = ffi.new("mco_topology_t*")
+    assert mco.mco_get_topology(topology) == MCO_OK
+    assert topology.num_cpus >= 1
+    assert 1 <= topology.num_nodes <= topology.num_cpus
+    counts = [mco.mco_topology_node_cpus(node) for node in range(topology.num_nodes)]
+    assert sum(counts) == topology.num_cpus
+    assert mco.mco_topology_node_cpus(topology.num_nodes) == 0
+    assert mco.mco_get_topology(ffi.NULL) == MCO_ERROR_INVALID_ARGUMENT
+
+
+def test_thread_settings(ctx):
+    """Thread count round-trips; unknown affinity modes are rejected"""
+    ffi, mco, context = ctx
+    assert mco.mco_context_get_num_threads(context) == 1
+    mco.mco_context_set_num_threads(context, 4)
+    assert mco.mco_context_get_num_threads(context) == 4
+    for mode in (AFFINITY_NONE, AFFINITY_COMPACT, AFFINITY_SPREAD):
+        assert mco.mco_context_set_thread_affinity(context, mode) == MCO_OK
+    assert mco.mco_context_set_thread_affinity(context, 3) == MCO_ERROR_INVALID_ARGUMENT
+
+
+@pytest.mark.parametrize("threads,affinity", [
+    (2, AFFINITY_NONE), (3, AFFINITY_COMPACT), (0, AFFINITY_SPREAD),
+])
+def test_results_independent_of_threads(ctx, threads, affinity):
+    """A seeded price is the same on one thread and on a pinned pool"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_num_steps(context, 20)
+    mco.mco_context_set_antithetic(context, 1)
+
+    pricers = [
+        lambda: mco.mco_european_call(context, 100.0, 100.0, 0.05, 0.2, 1.0),
+        lambda: mco.mco_barrier_call(context, 100.0, 100.0, 0.05, 0.2, 1.0,
+                                     120.0, UP_AND_OUT, 0.0),
+        lambda: mco.mco_lookback_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 1),
+        lambda: mco.mco_american_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 20),
+    ]
+
+    def prices():
+        values = []
+        for price in pricers:
+            mco.mco_context_set_seed(context, 11)
+            values.append(price())
+        return values
+
+    serial = prices()
+    mco.mco_context_set_num_threads(context, threads)
+    assert mco.mco_context_set_thread_affinity(context, affinity) == MCO_OK
+    parallel = prices()
+
+    for s, p in zip(serial, parallel):
+        assert p > 0.0
+        assert abs(s - p) < 1e-9 * s
+
+
+@pytest.mark.parametrize("threads", [2, 3, 0])
+def test_reproducible_mode_is_bit_identical(ctx, threads):
+    """Fixed-order reductions give exactly the serial result on any thread count"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 50000)
+    mco.mco_context_set_num_steps(context, 8)
+    mco.mco_context_set_reproducible(context, 1)
+
+    pricers = [
+        lambda: mco.mco_european_call(context, 100.0, 100.0, 0.05, 0.2, 1.0),
+        lambda: mco.mco_lookback_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 0),
+        lambda: mco.mco_asian_arithmetic_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 12),
+    ]
+
+    def prices():
+        values = []
+        for price in pricers:
+            mco.mco_context_set_seed(context, 21)
+            values.append(price())
+        return values
+
+    serial = prices()
+    mco.mco_context_set_num_threads(context, threads)
+    for _ in range(3):
+        assert prices() == serial
+
+
+def test_seed_uses_all_64_bits(ctx):
+    """Seeds round-trip exactly; seeds differing above bit 32 give different paths"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 2000)
+    mco.mco_context_set_num_steps(context, 4)
+
+    for seed in (0, 5, 2 ** 32 + 5, 2 ** 64 - 1):
+        mco.mco_context_set_seed(context, seed)
+        assert mco.mco_context_get_seed(context) == seed
+
+    def prices(seed):
+        values = []
+        for price in (lambda: mco.mco_european_call(context, 100.0, 100.0, 0.05, 0.2, 1.0),
+                      lambda: mco.mco_american_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 4)):
+            mco.mco_context_set_seed(context, seed)
+            values.append(price())
+        return values
+
+    low = prices(5)
+    assert prices(5) == low
+    high = prices(2 ** 32 + 5)
+    assert all(a != b for a, b in zip(low, high))
+    assert prices(0) == prices(0)
+
+
+def mixed_batch(ffi, count):
+    """A few lookbacks (many path blocks each) among small Europeans"""
+    instruments = ffi.new("mco_instrument_t[]", count)
+    for i in range(count):
+        inst = instruments[i]
+        inst.kind = LOOKBACK if i < 4 else EUROPEAN
+        inst.option_type = i % 2
+        inst.method = MONTE_CARLO
+        inst.spot = 100.0
+        inst.strike = 90.0 + i % 20
+        inst.rate = 0.05
+        inst.volatility = 0.2
+        inst.time_to_maturity = 1.0
+        if inst.kind == LOOKBACK:
+            inst.params.lookback.fixed_strike = 1
+    return instruments
+
+
+def test_nested_batch_independent_of_threads(ctx):
+    """Instruments and their path blocks share the pool; results match the serial run"""
+    ffi, mco, context = ctx
+    count = 200
+    instruments = mixed_batch(ffi, count)
+    results = ffi.new("mco_price_result_t[]", count)
+    mco.mco_context_set_num_simulations(context, 5000)
+    mco.mco_context_set_num_steps(context, 10)
+
+    def prices(threads):
+        mco.mco_context_set_num_threads(context, threads)
+        mco.mco_context_set_seed(context, 3)
+        assert mco.mco_price_instruments(context, instruments, count, results) == MCO_OK
+        return [results[i].price for i in range(count)]
+
+    serial = prices(1)
+    for threads in (2, 0):
+        for s, p in zip(serial, prices(threads)):
+            assert abs(s - p) < 1e-9 * s
+
+    # Each instrument has its own stream: pricing one alone gives the same value
+    mco.mco_context_set_num_threads(context, 1)
+    mco.mco_context_set_seed(context, 3)
+    assert mco.mco_price_instruments(context, instruments, 1, results) == MCO_OK
+    assert results[0].price == serial[0]
+
+
+def test_batch_slices_match_whole_batch(ctx):
+    """Slices priced from their offset reproduce the whole batch, not its first slice"""
+    ffi, mco, context = ctx
+    count, chunk = 12, 4
+    instruments = mixed_batch(ffi, count)
+    for i in range(count):
+        instruments[i].strike = 100.0
+    whole = ffi.new("mco_price_result_t[]", count)
+    sliced = ffi.new("mco_price_result_t[]", count)
+    mco.mco_context_set_num_simulations(context, 2000)
+    mco.mco_context_set_num_steps(context, 5)
+    mco.mco_context_set_num_threads(context, 2)
+
+    mco.mco_context_set_seed(context, 11)
+    assert mco.mco_price_instruments(context, instruments, count, whole) == MCO_OK
+    for offset in range(0, count, chunk):
+        n = min(chunk, count - offset)
+        mco.mco_context_set_seed(context, 11)
+        assert mco.mco_price_instruments_from(
+            context, instruments + offset, n, offset, sliced + offset) == MCO_OK
+    for i in range(count):
+        assert abs(sliced[i].price - whole[i].price) < 1e-9 * whole[i].price
+    # Same contract at the same slice position, different streams
+    assert whole[4].price != whole[8].price
+
+    mco.mco_context_set_stream_mode(context, STREAM_SEQUENTIAL)
+    assert mco.mco_price_instruments_from(context, instruments, 1, 1, sliced) == \
+        MCO_ERROR_UNSUPPORTED
+    assert sliced[0].status == MCO_ERROR_UNSUPPORTED
+
+
+def test_nested_batch_errors_stay_per_instrument(ctx):
+    """A failing instrument does not stop the rest of a parallel batch"""
+    ffi, mco, context = ctx
+    count = 50
+    instruments = mixed_batch(ffi, count)
+    instruments[2].volatility = -1.0
+    results = ffi.new("mco_price_result_t[]", count)
+    mco.mco_context_set_num_simulations(context, 2000)
+    mco.mco_context_set_num_steps(context, 5)
+    mco.mco_context_set_num_threads(context, 3)
+
+    assert mco.mco_price_instruments(context, instruments, count, results) == \
+        MCO_ERROR_INVALID_ARGUMENT
+    assert results[2].status == MCO_ERROR_INVALID_ARGUMENT
+    for i in range(count):
+        if i != 2:
+            assert results[i].status == MCO_OK and results[i].price > 0.0
+
+
+def mt19937_64(seed):
+    """Reference 64-bit Mersenne Twister (Matsumoto-Nishimura) yielding std::mt19937_64 outputs"""
+    n, m, mask = 312, 156, 2 ** 64 - 1
+    state = [seed & mask]
+    for i in range(1, n):
+        state.append((6364136223846793005 * (state[-1] ^ (state[-1] >> 62)) + i) & mask)
+    while True:
+        for i in range(n):
+            x = (state[i] & 0xFFFFFFFF80000000) | (state[(i + 1) % n] & 0x7FFFFFFF)
+            state[i] = state[(i + m) % n] ^ (x >> 1) ^ (0xB5026F5AA96619E9 if x & 1 else 0)
+        for x in state:
+            x ^= (x >> 29) & 0x5555555555555555
+            x ^= (x << 17) & 0x71D67FFFEDA60000 & mask
+            x ^= (x << 37) & 0xFFF7EEE000000000 & mask
+            x ^= x >> 43
+            yield x
+
+
+def test_sequential_stream_reproduces_serial_loop(ctx):
+    """Sequential mode prices exactly as one loop over the seeded Mersenne Twister"""
+    ffi, mco, context = ctx
+    paths, steps = 3000, 3
+    mco.mco_context_set_num_simulations(context, paths)
+    mco.mco_context_set_num_steps(context, steps)
+    mco.mco_context_set_num_threads(context, 3)
+    assert mco.mco_context_set_stream_mode(context, STREAM_SEQUENTIAL) == MCO_OK
+    assert mco.mco_context_set_stream_mode(context, 2) == MCO_ERROR_INVALID_ARGUMENT
+    mco.mco_context_set_seed(context, 2024)
+    price = mco.mco_european_call(context, 100.0, 100.0, 0.05, 0.2, 1.0)
+
+    rng = mt19937_64(2024)
+    uniform = lambda: float(next(rng)) / 2.0 ** 64
+    dt = 1.0 / steps
+    drift = (0.05 - 0.5 * 0.2 * 0.2) * dt
+    diffusion = 0.2 * math.sqrt(dt)
+    total = 0.0
+    for _ in range(paths):
+        spot = 100.0
+        for _ in range(steps):
+            u1, u2 = uniform(), uniform()
+            z = math.sqrt(-2.0 * math.log(u1)) * math.cos(2.0 * math.pi * u2)
+            spot = spot * math.exp(drift + diffusion * z)
+        total += max(spot - 100.0, 0.0)
+    assert price == math.exp(-0.05) * (total / paths)
+
+
+def test_sequential_stream_independent_of_threads(ctx):
+    """Workers jump to their share of the sequence; the context's generator ends where a serial run leaves it"""
+    ffi, mco, context = ctx
+    # Blocks of 1024 paths take over 2^20 outputs each, so workers really jump
+    mco.mco_context_set_num_simulations(context, 5000)
+    mco.mco_context_set_num_steps(context, 600)
+    mco.mco_context_set_antithetic(context, 1)
+    mco.mco_context_set_stream_mode(context, STREAM_SEQUENTIAL)
+
+    def prices(threads):
+        mco.mco_context_set_num_threads(context, threads)
+        mco.mco_context_set_seed(context, 99)
+        return [
+            mco.mco_european_call(context, 100.0, 100.0, 0.05, 0.2, 1.0),
+            mco.mco_lookback_put(context, 100.0, 100.0, 0.05, 0.2, 1.0, 1),
+            mco.mco_asian_arithmetic_call(context, 100.0, 100.0, 0.05, 0.2, 1.0, 600),
+            mco.mco_european_call(context, 100.0, 100.0, 0.05, 0.2, 1.0),
+        ]
+
+    serial = prices(1)
+    assert serial[0] != serial[3]
+    for threads in (2, 3, 0):
+        assert prices(threads) == serial
+
+    mco.mco_context_set_stream_mode(context, STREAM_BLOCKS)
+    assert prices(1)[0] != serial[0]
+
+
+@pytest.mark.parametrize("counter,key,expected", [
+    ((0, 0, 0, 0), 0, (0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8)),
+    ((0xffffffff,) * 4, 0xffffffffffffffff, (0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd)),
+    ((0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344), 0x299f31d0a4093822,
+     (0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1)),
+])
+def test_philox_known_answers(lib, counter, key, expected):
+    """Random123 known-answer vectors for Philox4x32-10; every BLOCKS stream depends on these"""
+    ffi, mco = lib
+    out = ffi.new("uint32_t[4]")
+    assert mco.mco_philox4x32(ffi.new("uint32_t[4]", counter), key, out) == MCO_OK
+    assert tuple(out) == expected
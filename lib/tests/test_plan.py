@@ -0,0 +1,286 @@
+import pytest
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+MCO_ERROR_UNSUPPORTED = -2
+
+EUROPEAN, AMERICAN, ASIAN, BARRIER, LOOKBACK = 0, 1, 2, 3, 4
+CALL, PUT = 0, 1
+AUTO, ANALYTIC, TREE, MC = 0, 1, 2, 3
+
+
+def make_instrument(ffi, kind, option_type=CALL, method=AUTO, tolerance=0.01):
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = kind
+    inst.option_type = option_type
+    inst.method = method
+    inst.spot = 100.0
+    inst.strike = 100.0
+    inst.rate = 0.05
+    inst.volatility = 0.2
+    inst.time_to_maturity = 1.0
+    inst.tolerance = tolerance
+    if kind == ASIAN:
+        inst.params.asian.num_observations = 12
+    return inst
+
+
+def prepare(ffi, mco, context, inst):
+    plan = ffi.new("mco_plan_t**")
+    assert mco.mco_plan_prepare(context, inst, plan) == MCO_OK
+    return plan[0]
+
+
+def execute(ffi, mco, plan, spot, rate=0.05, volatility=0.2):
+    market = ffi.new("mco_market_t*", {"spot": spot, "rate": rate, "volatility": volatility})
+    result = ffi.new("mco_price_result_t*")
+    status = mco.mco_plan_execute(plan, market, result)
+    return status, result
+
+
+def test_plan_matches_direct_pricing(ctx):
+    """Executing a plan prices as mco_price_instrument would with the same market"""
+    ffi, mco, context = ctx
+    plan = prepare(ffi, mco, context, make_instrument(ffi, EUROPEAN, method=ANALYTIC))
+    direct = ffi.new("mco_price_result_t*")
+    for spot, vol in ((90.0, 0.15), (100.0, 0.2), (112.0, 0.3)):
+        status, result = execute(ffi, mco, plan, spot, volatility=vol)
+        inst = make_instrument(ffi, EUROPEAN, method=ANALYTIC)
+        inst.spot, inst.volatility = spot, vol
+        assert mco.mco_price_instrument(context, inst, direct) == MCO_OK
+        assert status == MCO_OK and result.price == direct.price
+    mco.mco_plan_free(plan)
+
+
+def test_plan_uses_common_random_numbers(ctx):
+    """Monte Carlo executions repeat exactly and move smoothly with the market"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_num_steps(context, 12)
+    plan = prepare(ffi, mco, context, make_instrument(ffi, ASIAN, method=MC))
+
+    base = execute(ffi, mco, plan, 100.0)[1].price
+    assert execute(ffi, mco, plan, 100.0)[1].price == base
+
+    # The bumped prices share their paths, so the difference quotient is a clean delta
+    up = execute(ffi, mco, plan, 100.5)[1].price
+    down = execute(ffi, mco, plan, 99.5)[1].price
+    assert down < base < up
+    assert 0.45 < (up - down) / 1.0 < 0.7
+    mco.mco_plan_free(plan)
+
+
+def test_plan_snapshots_context_and_method(ctx):
+    """Later context changes do not reach the plan; automatic selection happens once"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 10000)
+    mc_plan = prepare(ffi, mco, context, make_instrument(ffi, ASIAN, method=MC))
+    auto_plan = prepare(ffi, mco, context, make_instrument(ffi, AMERICAN, PUT, AUTO, tolerance=0.01))
+    first = execute(ffi, mco, mc_plan, 100.0)[1].price
+    auto_first = execute(ffi, mco, auto_plan, 100.0)[1]
+
+    mco.mco_context_set_num_simulations(context, 500)
+    mco.mco_context_set_seed(context, 999)
+    result = execute(ffi, mco, mc_plan, 100.0)[1]
+    assert result.price == first and result.num_paths == 10000
+
+    moved = execute(ffi, mco, auto_plan, 100.0, volatility=0.4)[1]
+    assert moved.method == auto_first.method == TREE
+    assert moved.num_steps == auto_first.num_steps
+    assert moved.price > auto_first.price
+    mco.mco_plan_free(mc_plan)
+    mco.mco_plan_free(auto_plan)
+
+
+def test_plans_with_different_threads(ctx):
+    """Plans pinning different pools interleave without disturbing each other"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_reproducible(context, 1)
+    inst = make_instrument(ffi, BARRIER, method=MC)
+    inst.params.barrier.barrier_level = 130.0
+
+    mco.mco_context_set_num_threads(context, 1)
+    serial = prepare(ffi, mco, context, inst)
+    mco.mco_context_set_num_threads(context, 3)
+    threaded = prepare(ffi, mco, context, inst)
+
+    first = [execute(ffi, mco, p, 100.0)[1].price for p in (serial, threaded)]
+    for _ in range(3):
+        assert [execute(ffi, mco, p, 100.0)[1].price for p in (serial, threaded)] == first
+    mco.mco_plan_free(serial)
+    mco.mco_plan_free(threaded)
+
+
+def test_plan_errors(ctx):
+    """Bad contracts fail at prepare, bad markets and methods at execute"""
+    ffi, mco, context = ctx
+    plan = ffi.new("mco_plan_t**")
+    bad = make_instrument(ffi, ASIAN, method=MC)
+    bad.params.asian.num_observations = 0
+    assert mco.mco_plan_prepare(context, bad, plan) == MCO_ERROR_INVALID_ARGUMENT   # no observations
+    assert plan[0] == ffi.NULL
+
+    analytic_asian = prepare(ffi, mco, context, make_instrument(ffi, ASIAN, method=ANALYTIC))
+    assert execute(ffi, mco, analytic_asian, 100.0)[0] == MCO_ERROR_UNSUPPORTED
+
+    vanilla = prepare(ffi, mco, context, make_instrument(ffi, EUROPEAN, method=ANALYTIC))
+    status, result = execute(ffi, mco, vanilla, -1.0)
+    assert status == MCO_ERROR_INVALID_ARGUMENT and result.status == MCO_ERROR_INVALID_ARGUMENT
+    assert execute(ffi, mco, vanilla, 100.0)[0] == MCO_OK
+    mco.mco_plan_free(analytic_asian)
+    mco.mco_plan_free(vanilla)
+
+
+def stats(ffi, mco, plan):
+    out = ffi.new("mco_plan_stats_t*")
+    assert mco.mco_plan_get_stats(plan, out) == MCO_OK
+    return out
+
+
+def test_plan_reweights_cached_paths(ctx):
+    """Small rate and volatility moves reprice the cached paths by likelihood ratio"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 40000)
+    plan = prepare(ffi, mco, context, make_instrument(ffi, ASIAN, method=MC))
+    assert mco.mco_plan_set_reweighting(plan, 0.5) == MCO_OK
+
+    base = execute(ffi, mco, plan, 100.0)[1].price
+    assert stats(ffi, mco, plan).simulations == 1
+    assert execute(ffi, mco, plan, 100.0)[1].price == base
+
+    moves = ((0.052, 0.2), (0.05, 0.205), (0.055, 0.21))
+    reweighted = []
+    for rate, vol in moves:
+        status, result = execute(ffi, mco, plan, 100.0, rate, vol)
+        s = stats(ffi, mco, plan)
+        assert status == MCO_OK and s.reweighted == 1 and s.simulations == 1
+        assert 0.5 * 40000 < s.effective_sample_size < 40000
+        reweighted.append((result.price, result.error_estimate))
+
+    # Fresh simulations on the same stream see the same paths
+    assert mco.mco_plan_set_reweighting(plan, 0.0) == MCO_OK
+    for (rate, vol), (price, error) in zip(moves, reweighted):
+        fresh = execute(ffi, mco, plan, 100.0, rate, vol)[1].price
+        assert fresh > base
+        assert abs(price - fresh) < 0.5 * error
+    mco.mco_plan_free(plan)
+
+
+def test_plan_resimulates_when_weights_degenerate(ctx):
+    """Spot moves, large volatility moves and non-path-wise products simulate afresh"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    plan = prepare(ffi, mco, context, make_instrument(ffi, ASIAN, method=MC))
+    assert mco.mco_plan_set_reweighting(plan, 0.8) == MCO_OK
+    execute(ffi, mco, plan, 100.0)
+    execute(ffi, mco, plan, 101.0)
+    assert stats(ffi, mco, plan).simulations == 2
+    execute(ffi, mco, plan, 101.0, volatility=0.3)
+    s = stats(ffi, mco, plan)
+    assert s.simulations == 3 and s.reweighted == 0 and s.effective_sample_size == 20000
+    assert execute(ffi, mco, plan, 101.0, volatility=-0.3)[0] == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_plan_set_reweighting(plan, 1.5) == MCO_ERROR_INVALID_ARGUMENT
+    mco.mco_plan_free(plan)
+
+    # Bridge-corrected barrier payoffs depend on the volatility: never reweighted
+    inst = make_instrument(ffi, BARRIER, method=MC)
+    inst.params.barrier.barrier_level = 130.0
+    barrier = prepare(ffi, mco, context, inst)
+    assert mco.mco_plan_set_reweighting(barrier, 0.5) == MCO_OK
+    execute(ffi, mco, barrier, 100.0)
+    execute(ffi, mco, barrier, 100.0, volatility=0.201)
+    s = stats(ffi, mco, barrier)
+    assert s.simulations == 2 and s.reweighted == 0 and s.effective_sample_size == 0.0
+    mco.mco_plan_free(barrier)
+
+
+@pytest.mark.parametrize("kind", [EUROPEAN, ASIAN, BARRIER, LOOKBACK])
+def test_plan_workspace_is_invisible(ctx, kind):
+    """Reusing the kernel's grid, tables and buffers prices as a fresh plan on the same stream"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 5000)
+    mco.mco_context_set_num_steps(context, 8)
+    inst = make_instrument(ffi, kind, method=MC)
+    if kind == BARRIER:
+        inst.params.barrier.barrier_level = 130.0
+        inst.params.barrier.continuous = 1
+
+    mco.mco_context_set_seed(context, 5)
+    reused = prepare(ffi, mco, context, inst)
+    first = execute(ffi, mco, reused, 100.0)[1].price
+    moved = execute(ffi, mco, reused, 103.0, 0.04, 0.25)[1].price
+    assert execute(ffi, mco, reused, 100.0)[1].price == first
+
+    mco.mco_context_set_seed(context, 5)
+    fresh = prepare(ffi, mco, context, inst)
+    assert execute(ffi, mco, fresh, 103.0, 0.04, 0.25)[1].price == moved
+    mco.mco_plan_free(reused)
+    mco.mco_plan_free(fresh)
+
+
+def test_batch_greeks_at_zero_volatility(ctx):
+    """Vega falls back to a one-sided bump instead of dividing by a zero bump"""
+    import math
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 5000)
+    instruments = ffi.new("mco_instrument_t[1]")
+    instruments[0] = make_instrument(ffi, EUROPEAN, method=MC)[0]
+    instruments[0].strike = 105.0
+    instruments[0].volatility = 0.0
+    results = ffi.new("mco_price_result_t[1]")
+    greeks = ffi.new("mco_greeks_t[1]")
+    assert mco.mco_price_instruments_greeks(context, instruments, 1, results, greeks) == MCO_OK
+    assert math.isfinite(greeks[0].vega) and greeks[0].vega > 0.0
+    assert math.isfinite(greeks[0].delta) and math.isfinite(greeks[0].rho)
+
+
+def test_batch_greeks_match_black_scholes(ctx):
+    """Bumped analytic Greeks agree with the closed forms"""
+    import math
+    ffi, mco, context = ctx
+    instruments = ffi.new("mco_instrument_t[2]")
+    for i, option_type in enumerate((CALL, PUT)):
+        instruments[i] = make_instrument(ffi, EUROPEAN, option_type, ANALYTIC)[0]
+    results = ffi.new("mco_price_result_t[2]")
+    greeks = ffi.new("mco_greeks_t[2]")
+    assert mco.mco_price_instruments_greeks(context, instruments, 2, results, greeks) == MCO_OK
+
+    s, k, r, v, t = 100.0, 100.0, 0.05, 0.2, 1.0
+    d1 = (math.log(s / k) + (r + 0.5 * v * v) * t) / (v * math.sqrt(t))
+    d2 = d1 - v * math.sqrt(t)
+    pdf = math.exp(-0.5 * d1 * d1) / math.sqrt(2 * math.pi)
+    cdf = lambda x: 0.5 * math.erfc(-x / math.sqrt(2))
+    df = math.exp(-r * t)
+    expected = (
+        (cdf(d1), k * t * df * cdf(d2)),
+        (cdf(d1) - 1, -k * t * df * cdf(-d2)),
+    )
+    for i, (delta, rho) in enumerate(expected):
+        assert results[i].status == MCO_OK
+        assert abs(greeks[i].delta - delta) < 1e-3
+        assert abs(greeks[i].gamma - pdf / (s * v * math.sqrt(t))) < 1e-4
+        assert abs(greeks[i].vega - s * pdf * math.sqrt(t)) < 1e-2
+        assert abs(greeks[i].rho - rho) < 1e-3
+
+
+def test_batch_greeks_on_common_random_numbers(ctx):
+    """Monte Carlo Greeks are smooth, and failed rows carry NaN Greeks"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    instruments = ffi.new("mco_instrument_t[2]")
+    instruments[0] = make_instrument(ffi, ASIAN, method=MC)[0]
+    instruments[1] = make_instrument(ffi, ASIAN, method=MC)[0]
+    instruments[1].params.asian.num_observations = 0
+    results = ffi.new("mco_price_result_t[2]")
+    greeks = ffi.new("mco_greeks_t[2]")
+    assert mco.mco_price_instruments_greeks(context, instruments, 2, results, greeks) == MCO_ERROR_INVALID_ARGUMENT
+
+    # Independent paths per bump would swamp a 1-point difference with noise
+    assert results[0].status == MCO_OK
+    assert 0.5 < greeks[0].delta < 0.7
+    assert 0.0 < greeks[0].gamma < 0.05
+    assert 15.0 < greeks[0].vega < 30.0
+    assert 20.0 < greeks[0].rho < 35.0
+    assert results[1].status == MCO_ERROR_INVALID_ARGUMENT
+    assert greeks[1].delta != greeks[1].delta
@@ -0,0 +1,157 @@
+import math
+
+MCO_OK = 0
+MCO_ERROR_INVALID_ARGUMENT = -1
+
+EUROPEAN, BARRIER, WINDOW_BARRIER = 0, 3, 7
+CALL = 0
+ANALYTIC, MC = 1, 3
+
+
+def make_instrument(ffi, kind, method):
+    inst = ffi.new("mco_instrument_t*")
+    inst.kind = kind
+    inst.option_type = CALL
+    inst.method = method
+    inst.spot = 100.0
+    inst.strike = 100.0
+    inst.rate = 0.05
+    inst.volatility = 0.2
+    inst.time_to_maturity = 1.0
+    return inst
+
+
+def make_domain(ffi, spot=(70.0, 130.0, 24), volatility=(0.1, 0.4, 12), time=(0.5, 1.5, 10)):
+    domain = ffi.new("mco_proxy_domain_t*")
+    for axis, (lower, upper, nodes) in ((domain.spot, spot), (domain.volatility, volatility),
+                                        (domain.time_to_maturity, time)):
+        axis.lower, axis.upper, axis.nodes = lower, upper, nodes
+    return domain
+
+
+def black_scholes_call(S, K, r, sigma, T):
+    """Price, delta, gamma, vega and theta (-dV/dT)"""
+    N = lambda x: 0.5 * math.erfc(-x / math.sqrt(2.0))
+    d1 = (math.log(S / K) + (r + 0.5 * sigma ** 2) * T) / (sigma * math.sqrt(T))
+    d2 = d1 - sigma * math.sqrt(T)
+    density = math.exp(-0.5 * d1 * d1) / math.sqrt(2.0 * math.pi)
+    price = S * N(d1) - K * math.exp(-r * T) * N(d2)
+    theta = -S * density * sigma / (2.0 * math.sqrt(T)) - r * K * math.exp(-r * T) * N(d2)
+    return price, N(d1), density / (S * sigma * math.sqrt(T)), S * density * math.sqrt(T), theta
+
+
+def test_proxy_reproduces_price_and_greeks(ctx):
+    """A proxy of the closed form matches Black-Scholes across the domain"""
+    ffi, mco, context = ctx
+    proxy = ffi.new("mco_proxy_t**")
+    assert mco.mco_proxy_build(context, make_instrument(ffi, EUROPEAN, ANALYTIC),
+                               make_domain(ffi), proxy) == MCO_OK
+
+    value = ffi.new("mco_proxy_value_t*")
+    for spot in (72.0, 85.0, 100.0, 117.0, 129.0):
+        for vol in (0.12, 0.25, 0.38):
+            for T in (0.55, 1.0, 1.4):
+                assert mco.mco_proxy_evaluate(proxy[0], spot, vol, T, value) == MCO_OK
+                price, delta, gamma, vega, theta = black_scholes_call(spot, 100.0, 0.05, vol, T)
+                assert abs(value.price - price) < max(value.error_estimate, 1e-4)
+                assert abs(value.delta - delta) < 1e-4
+                assert abs(value.gamma - gamma) < 1e-4
+                assert abs(value.vega - vega) < 5e-3
+                assert abs(value.theta - theta) < 1e-3
+    mco.mco_proxy_free(proxy[0])
+
+
+def test_proxy_of_monte_carlo_has_smooth_greeks(ctx):
+    """Nodes share their random numbers, so even a noisy pricer gives usable deltas"""
+    ffi, mco, context = ctx
+    mco.mco_context_set_num_simulations(context, 20000)
+    mco.mco_context_set_num_steps(context, 25)
+    barrier = make_instrument(ffi, BARRIER, MC)
+    barrier.params.barrier.barrier_level = 150.0
+    barrier.params.barrier.barrier_type = 0
+    barrier.params.barrier.continuous = 0
+
+    proxy = ffi.new("mco_proxy_t**")
+    domain = make_domain(ffi, spot=(80.0, 120.0, 9), volatility=(0.0, 0.0, 0), time=(0.0, 0.0, 0))
+    assert mco.mco_proxy_build(context, barrier, domain, proxy) == MCO_OK
+
+    # BGK-corrected closed form for the same discrete monitoring
+    barrier.method = ANALYTIC
+    result = ffi.new("mco_price_result_t*")
+
+    def analytic(spot):
+        barrier.spot = spot
+        mco.mco_price_instrument(context, barrier, result)
+        return result.price
+
+    value = ffi.new("mco_proxy_value_t*")
+    for spot in (85.0, 100.0, 115.0):
+        assert mco.mco_proxy_evaluate(proxy[0], spot, 0.0, 0.0, value) == MCO_OK
+        assert abs(value.price - analytic(spot)) < 0.3
+        delta = (analytic(spot + 0.01) - analytic(spot - 0.01)) / 0.02
+        assert abs(value.delta - delta) < 0.03
+        assert math.isnan(value.vega) and math.isnan(value.theta)
+        # The barrier kernel reports no standard error, so neither can the proxy
+        assert math.isnan(value.error_estimate)
+    mco.mco_proxy_free(proxy[0])
+
+
+def test_proxy_survives_serialization(ctx):
+    """A deserialized proxy evaluates bit for bit like the original"""
+    ffi, mco, context = ctx
+    proxy = ffi.new("mco_proxy_t**")
+    domain = make_domain(ffi, spot=(80.0, 120.0, 12), volatility=(0.15, 0.3, 6), time=(0.0, 0.0, 0))
+    assert mco.mco_proxy_build(context, make_instrument(ffi, EUROPEAN, ANALYTIC), domain, proxy) == MCO_OK
+
+    size = ffi.new("size_t*")
+    assert mco.mco_proxy_serialize(proxy[0], ffi.NULL, 0, size) == MCO_OK
+    image = ffi.new("unsigned char[]", size[0])
+    assert mco.mco_proxy_serialize(proxy[0], image, size[0] - 1, size) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_proxy_serialize(proxy[0], image, size[0], size) == MCO_OK
+    data = bytes(ffi.buffer(image, size[0]))
+
+    loaded = ffi.new("mco_proxy_t**")
+    assert mco.mco_proxy_deserialize(data, len(data), loaded) == MCO_OK
+    a, b = ffi.new("mco_proxy_value_t*"), ffi.new("mco_proxy_value_t*")
+    for spot, vol in ((81.0, 0.16), (100.0, 0.2), (119.5, 0.29)):
+        mco.mco_proxy_evaluate(proxy[0], spot, vol, 7.0, a)
+        mco.mco_proxy_evaluate(loaded[0], spot, vol, 7.0, b)
+        assert (a.price, a.delta, a.gamma, a.vega, a.error_estimate) == \
+               (b.price, b.delta, b.gamma, b.vega, b.error_estimate)
+
+    assert mco.mco_proxy_deserialize(data[:-1], len(data) - 1, loaded) == MCO_ERROR_INVALID_ARGUMENT
+    assert loaded[0] == ffi.NULL
+    corrupt = b"X" + data[1:]
+    assert mco.mco_proxy_deserialize(corrupt, len(corrupt), loaded) == MCO_ERROR_INVALID_ARGUMENT
+    mco.mco_proxy_free(proxy[0])
+
+
+def test_proxy_domain_checks(ctx):
+    """Malformed domains are rejected and evaluation does not extrapolate"""
+    ffi, mco, context = ctx
+    inst = make_instrument(ffi, EUROPEAN, ANALYTIC)
+    proxy = ffi.new("mco_proxy_t**")
+    for bad in (make_domain(ffi, spot=(80.0, 120.0, 1)),
+                make_domain(ffi, spot=(120.0, 80.0, 8)),
+                make_domain(ffi, volatility=(0.0, 0.4, 8)),
+                make_domain(ffi, time=(0.5, 1.5, 65)),
+                make_domain(ffi, spot=(0, 0, 0), volatility=(0, 0, 0), time=(0, 0, 0))):
+        assert mco.mco_proxy_build(context, inst, bad, proxy) == MCO_ERROR_INVALID_ARGUMENT
+        assert proxy[0] == ffi.NULL
+
+    # The window would not move with the maturity
+    window = make_instrument(ffi, WINDOW_BARRIER, MC)
+    window.params.window_barrier.barrier_level = 130.0
+    window.params.window_barrier.window_start = 0.2
+    window.params.window_barrier.window_end = 0.4
+    assert mco.mco_proxy_build(context, window, make_domain(ffi, time=(0.5, 1.5, 4)),
+                               proxy) == MCO_ERROR_INVALID_ARGUMENT
+    assert proxy[0] == ffi.NULL
+
+    domain = make_domain(ffi, spot=(80.0, 120.0, 8), volatility=(0.1, 0.3, 4), time=(0.5, 1.5, 4))
+    assert mco.mco_proxy_build(context, inst, domain, proxy) == MCO_OK
+    value = ffi.new("mco_proxy_value_t*")
+    assert mco.mco_proxy_evaluate(proxy[0], 120.0, 0.3, 1.5, value) == MCO_OK
+    assert mco.mco_proxy_evaluate(proxy[0], 121.0, 0.2, 1.0, value) == MCO_ERROR_INVALID_ARGUMENT
+    assert mco.mco_proxy_evaluate(proxy[0], 100.0, 0.05, 1.0, value) == MCO_ERROR_INVALID_ARGUMENT
+    mco.mco_proxy_free(proxy[0])
@@ -0,0 +1,86 @@
+import os
+import sys
+import threading
+import time
+
+import pytest
+
+np = pytest.importorskip("numpy")
+sys.path.insert(0, os.path.join(os.path.dirname(__file__), "..", "python"))
+mco = pytest.importorskip("mcoptions", reason="Extension not built. Run ./build.sh --python first")
+
+
+def test_prices_columns_in_one_call():
+    """Array columns and broadcast scalars price as the C API does, without copies"""
+    n = 1000
+    strikes = np.repeat(np.linspace(80.0, 120.0, n // 2), 2)
+    out = mco.price(kind=mco.EUROPEAN, option_type=np.arange(n) % 2, method=mco.ANALYTIC,
+                    spot=100.0, strike=strikes, rate=0.05, volatility=0.2,
+                    time_to_maturity=1.0)
+    price = np.asarray(out["price"])
+    assert price.shape == (n,) and price.dtype == np.float64
+    assert not price.flags.owndata   # A view on the returned memory
+    assert (np.asarray(out["status"]) == mco.OK).all()
+    assert (np.asarray(out["method"]) == mco.ANALYTIC).all()
+
+    calls, puts = price[0::2], price[1::2]
+    assert (np.diff(calls) < 0).all() and (np.diff(puts) > 0).all()
+    parity = calls - puts - (100.0 - strikes[0::2] * np.exp(-0.05))
+    assert np.abs(parity).max() < 1e-10
+
+
+def test_reads_strided_and_mixed_type_columns():
+    """Non-contiguous and non-double buffers are read in place"""
+    spots = np.arange(80.0, 121.0, 5.0)
+    strided = mco.price(kind=mco.EUROPEAN, method=mco.ANALYTIC, spot=spots[::2],
+                        strike=np.full(5, 100, dtype=np.int32), rate=np.float32(0.05),
+                        volatility=np.full(5, 0.2, dtype=np.float32), time_to_maturity=1.0)
+    dense = mco.price(kind=mco.EUROPEAN, method=mco.ANALYTIC, spot=spots[::2].copy(),
+                      strike=100.0, rate=0.05, volatility=0.2, time_to_maturity=1.0)
+    assert np.allclose(np.asarray(strided["price"]), np.asarray(dense["price"]), rtol=1e-6)
+
+
+def test_greeks_and_per_row_status():
+    """greeks=True adds sensitivity columns; bad rows fail alone"""
+    out = mco.price(kind=mco.ASIAN, method=mco.MONTE_CARLO, spot=np.array([100.0, -1.0]),
+                    strike=100.0, rate=0.05, volatility=0.2, time_to_maturity=1.0,
+                    num_observations=12, num_simulations=20000, seed=7, greeks=True)
+    status = np.asarray(out["status"])
+    assert list(status) == [mco.OK, mco.ERROR_INVALID_ARGUMENT]
+    assert 0.5 < out["delta"][0] < 0.7 and out["vega"][0] > 0.0
+    assert np.isnan(out["price"][1]) and np.isnan(out["delta"][1])
+    assert out["num_paths"][0] == 20000
+
+
+def test_rejects_bad_arguments():
+    with pytest.raises(TypeError):
+        mco.price(spot=np.zeros((2, 2)))
+    with pytest.raises(ValueError):
+        mco.price(spot=np.zeros(2), strike=np.zeros(3))
+    with pytest.raises(TypeError):
+        mco.price(spot_price=100.0)
+    with pytest.raises(TypeError):
+        mco.price(spot="100")
+
+
+def test_releases_the_gil():
+    """Another Python thread keeps running while a batch prices"""
+    ticks = []
+    done = threading.Event()
+
+    def count():
+        while not done.is_set():
+            ticks.append(time.perf_counter())
+            time.sleep(0.001)
+
+    counter = threading.Thread(target=count)
+    counter.start()
+    start = time.perf_counter()
+    mco.price(kind=mco.ASIAN, method=mco.MONTE_CARLO, spot=np.full(8, 100.0), strike=100.0,
+              rate=0.05, volatility=0.2, time_to_maturity=1.0, num_observations=12,
+              num_simulations=100000)
+    end = time.perf_counter()
+    done.set()
+    counter.join()
+    assert end - start > 0.05
+    assert sum(start < t < end for t in ticks) >= 5
@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""
+Asynchronous batch client for the Monte Carlo Options Pricing Service
+
+Splits large instrument sets into PriceInstruments batches and keeps up to
+`max_concurrency` of them in flight on one grpc.aio channel, so a risk job
+is limited by the server rather than by round trips. Columns in and out can
+be pandas DataFrames or dicts of NumPy arrays.
+
+    async with AsyncMcOptionsClient(max_concurrency=16) as client:
+        priced = await client.price_frame(df, config=simulation_config(num_simulations=50000))
+
+Run as a script to price a CSV file, or a generated book when no file is
+given:
+
+    python3 client/async_client.py book.csv priced.csv --concurrency 16
+"""
+
+import argparse
+import asyncio
+import sys
+import time
+
+import grpc
+import numpy as np
+
+sys.path.insert(0, '../build')
+
+import mcoptions_pb2
+import mcoptions_pb2_grpc
+
+
+# Instrument fields accepted as columns; enum fields also take names
+SCALAR_FIELDS = [
+    'kind', 'option_type', 'method', 'spot', 'strike', 'rate', 'volatility',
+    'time_to_maturity', 'tolerance', 'num_exercise_points', 'num_observations',
+    'barrier_level', 'barrier_type', 'rebate', 'fixed_strike', 'lower_barrier',
+    'upper_barrier', 'knock_in', 'window_start', 'window_end', 'excursion_window',
+    'notional', 'autocall_barrier', 'coupon_barrier', 'coupon_rate', 'memory',
+    'knock_in_barrier', 'put_strike', 'start_time', 'local_floor', 'local_cap',
+    'global_floor', 'global_cap', 'continuous_monitoring',
+]
+REPEATED_FIELDS = ['exercise_dates', 'observation_dates', 'reset_dates']
+
+ENUMS = {
+    'kind': (mcoptions_pb2.InstrumentKind, 'INSTRUMENT_'),
+    'option_type': (mcoptions_pb2.OptionType, 'OPTION_'),
+    'method': (mcoptions_pb2.PricingMethod, 'METHOD_'),
+    'barrier_type': (mcoptions_pb2.BarrierType, ''),
+}
+
+# Result columns, in AutoPriceResponse order
+RESULT_COLUMNS = [
+    ('price', np.float64), ('error_estimate', np.float64), ('method', np.int32),
+    ('num_paths', np.uint64), ('num_steps', np.uint64),
+    ('computation_time_ms', np.float64), ('error_message', object),
+]
+
+
+def simulation_config(num_simulations=100000, num_steps=252, seed=None, antithetic=False,
+                      control_variates=False, stratified_sampling=False, reproducible=False):
+    """SimulationConfig shared by every instrument of a call"""
+    config = mcoptions_pb2.SimulationConfig(
+        num_simulations=num_simulations,
+        num_steps=num_steps,
+        antithetic_enabled=antithetic,
+        control_variates_enabled=control_variates,
+        stratified_sampling_enabled=stratified_sampling,
+        reproducible=reproducible,
+    )
+    if seed is not None:
+        config.seed = seed
+    return config
+
+
+def _enum_value(field, value):
+    enum, prefix = ENUMS[field]
+    if isinstance(value, str):
+        name = value.upper()
+        return enum.Value(name if name.startswith(prefix) else prefix + name)
+    return int(value)
+
+
+def instruments_from_columns(columns):
+    """
+    Builds Instrument messages from a DataFrame or a mapping of column name
+    to array or scalar. Scalars apply to every row; list-valued columns fill
+    the repeated date fields. Unknown columns are ignored.
+    """
+    names = [n for n in SCALAR_FIELDS + REPEATED_FIELDS if n in columns]
+    rows = None
+    values = {}
+    for name in names:
+        column = columns[name]
+        if name in SCALAR_FIELDS and np.ndim(column) == 0:
+            values[name] = column
+            continue
+        # tolist() turns NumPy scalars into Python ones in a single pass
+        values[name] = column.tolist() if hasattr(column, 'tolist') else list(column)
+        if rows is not None and len(values[name]) != rows:
+            raise ValueError(f"column '{name}' has {len(values[name])} rows, expected {rows}")
+        rows = len(values[name])
+    if rows is None:
+        rows = 1
+
+    for name in names:
+        if name in ENUMS:
+            value = values[name]
+            values[name] = ([_enum_value(name, v) for v in value] if isinstance(value, list)
+                            else _enum_value(name, value))
+
+    instruments = []
+    for i in range(rows):
+        instrument = mcoptions_pb2.Instrument()
+        for name in names:
+            value = values[name]
+            if isinstance(value, list) and name in SCALAR_FIELDS:
+                value = value[i]
+            if name in REPEATED_FIELDS:
+                getattr(instrument, name).extend(value[i])
+            else:
+                setattr(instrument, name, value)
+        instruments.append(instrument)
+    return instruments
+
+
+def results_to_columns(results):
+    """Dict of NumPy arrays, one per AutoPriceResponse field"""
+    return {name: np.array([getattr(r, name) for r in results], dtype=dtype)
+            for name, dtype in RESULT_COLUMNS}
+
+
+class AsyncMcOptionsClient:
+    """
+    grpc.aio client that prices instrument sets in concurrent batches
+
+    `chunk_size` instruments go into each PriceInstruments call and at most
+    `max_concurrency` calls are in flight. The server prices the instruments
+    of one call in parallel on its worker pool, so a few chunks per server
+    core keep it busy without queueing the whole book at once. Each chunk
+    carries its offset as first_index, so a seeded book prices as one batch
+    whatever the chunk size. The sequential stream cannot start mid-batch;
+    with config.sequential_stream the book goes in a single call.
+    """
+
+    def __init__(self, server_address='localhost:50051', max_concurrency=8, chunk_size=500,
+                 config=None, timeout=None):
+        if max_concurrency < 1 or chunk_size < 1:
+            raise ValueError("max_concurrency and chunk_size must be positive")
+        self.channel = grpc.aio.insecure_channel(server_address, options=[
+            ('grpc.max_send_message_length', -1),
+            ('grpc.max_receive_message_length', -1),
+        ])
+        self.stub = mcoptions_pb2_grpc.McOptionsServiceStub(self.channel)
+        self.max_concurrency = max_concurrency
+        self.chunk_size = chunk_size
+        self.config = config if config is not None else simulation_config()
+        self.timeout = timeout
+
+    async def __aenter__(self):
+        return self
+
+    async def __aexit__(self, *exc):
+        await self.close()
+
+    async def close(self):
+        await self.channel.close()
+
+    async def price_chunks(self, instruments, config=None):
+        """
+        Async generator of (offset, results) per chunk, in completion order.
+        Lets a caller consume results while later chunks are still priced.
+        Any failed call raises its grpc.aio.AioRpcError after cancelling the rest.
+        """
+        config = config if config is not None else self.config
+        instruments = list(instruments)
+        semaphore = asyncio.Semaphore(self.max_concurrency)
+        chunk_size = max(len(instruments), 1) if config.sequential_stream else self.chunk_size
+
+        async def call(offset):
+            async with semaphore:
+                request = mcoptions_pb2.InstrumentBatchRequest(
+                    instruments=instruments[offset:offset + chunk_size], config=config,
+                    first_index=offset)
+                response = await self.stub.PriceInstruments(request, timeout=self.timeout)
+                return offset, response.results
+
+        tasks = [asyncio.ensure_future(call(offset))
+                 for offset in range(0, len(instruments), chunk_size)]
+        try:
+            for finished in asyncio.as_completed(tasks):
+                yield await finished
+        finally:
+            for task in tasks:
+                task.cancel()
+            await asyncio.gather(*tasks, return_exceptions=True)
+
+    async def price_instruments(self, instruments, config=None):
+        """AutoPriceResponse per instrument, in input order"""
+        instruments = list(instruments)
+        results = [None] * len(instruments)
+        async for offset, chunk in self.price_chunks(instruments, config):
+            results[offset:offset + len(chunk)] = chunk
+        return results
+
+    async def price_frame(self, frame, config=None):
+        """
+        Prices the rows of a DataFrame, or of a dict of arrays, and returns
+        the same kind of object with the RESULT_COLUMNS added. A DataFrame is
+        copied; a dict is extended in place. Rows that failed on the server
+        have a non-empty error_message.
+        """
+        results = results_to_columns(
+            await self.price_instruments(instruments_from_columns(frame), config))
+        if hasattr(frame, 'assign'):
+            return frame.assign(**results)
+        frame.update(results)
+        return frame
+
+    async def subscribe(self, instruments, config=None):
+        """Async iterator over the PriceUpdate stream of MarketInstruments"""
+        request = mcoptions_pb2.SubscriptionRequest(
+            instruments=list(instruments),
+            config=config if config is not None else self.config)
+        async for update in self.stub.Subscribe(request):
+            yield update
+
+
+def generated_book(rows, seed=1):
+    """European and Asian options around spot 100 with random terms"""
+    rng = np.random.default_rng(seed)
+    return {
+        'kind': rng.choice([mcoptions_pb2.INSTRUMENT_EUROPEAN, mcoptions_pb2.INSTRUMENT_ASIAN], rows),
+        'option_type': rng.integers(0, 2, rows),
+        'spot': 100.0,
+        'strike': rng.uniform(80.0, 120.0, rows),
+        'rate': 0.05,
+        'volatility': rng.uniform(0.1, 0.4, rows),
+        'time_to_maturity': rng.uniform(0.25, 2.0, rows),
+        'tolerance': 0.05,
+        'num_observations': 12,
+    }
+
+
+async def run(args):
+    config = simulation_config(num_simulations=args.num_simulations, num_steps=args.num_steps,
+                               seed=args.seed, antithetic=args.antithetic)
+    if args.input:
+        import pandas as pd
+        frame = pd.read_csv(args.input)
+    else:
+        frame = generated_book(args.rows)
+
+    async with AsyncMcOptionsClient(args.address, args.concurrency, args.chunk_size, config) as client:
+        start = time.perf_counter()
+        priced = await client.price_frame(frame)
+        elapsed = time.perf_counter() - start
+
+    rows = len(priced['price'])
+    failed = int(sum(1 for message in priced['error_message'] if message))
+    print(f"Priced {rows} instruments in {elapsed:.2f}s ({rows / elapsed:.0f}/s), {failed} failed")
+    if args.output:
+        priced.to_csv(args.output, index=False)
+        print(f"Wrote {args.output}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('input', nargs='?', help="CSV with one Instrument field per column")
+    parser.add_argument('output', nargs='?', help="CSV to write with result columns added")
+    parser.add_argument('--address', default='localhost:50051')
+    parser.add_argument('--concurrency', type=int, default=8, help="Batches in flight")
+    parser.add_argument('--chunk-size', type=int, default=500, help="Instruments per batch")
+    parser.add_argument('--rows', type=int, default=10000, help="Generated book size without input")
+    parser.add_argument('--num-simulations', type=int, default=100000)
+    parser.add_argument('--num-steps', type=int, default=252)
+    parser.add_argument('--seed', type=int)
+    parser.add_argument('--antithetic', action='store_true')
+    args = parser.parse_args()
+    if args.output and not args.input:
+        parser.error("an output file needs an input file")
+    asyncio.run(run(args))
+
+
+if __name__ == '__main__':
+    main()
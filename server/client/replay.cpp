@@ -0,0 +1,540 @@
+// Replays calls captured with mcoptions_server --record against a server and
+// compares the responses and latencies with the recording.
+//
+// Calls go out at their recorded times, scaled by --speed, whatever the
+// server's response times (open loop), so a slower build shows up as higher
+// latency rather than as a lower request rate. Requests are sent as raw
+// bytes through a generic stub, so every unary RPC replays without per-method
+// code; streaming calls (Subscribe) are skipped. A call that failed when
+// recorded must fail with the same status code.
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/generic/generic_stub.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/text_format.h>
+#include "mcoptions.pb.h"
+#include "request_recorder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const char* kService = "mcoptions.McOptionsService";
+
+struct Options {
+    std::vector<std::string> files;
+    std::string address = "localhost:50051";
+    double speed = 1.0;              // 0 = as fast as max_in_flight allows
+    size_t max_in_flight = 256;
+    double tolerance = 1e-9;         // Relative, for seeded floating-point fields
+    size_t limit = 0;                // 0 = every call
+    std::string csv;
+    bool info = false;
+};
+
+struct Call {
+    uint64_t at_ns;                  // Since the start of the earliest recording
+    uint64_t service_ns;
+    grpc::StatusCode code;           // As returned when recorded
+    std::string method;
+    std::string request;
+    std::string response;
+};
+
+struct Outcome {
+    uint64_t latency_ns = 0;
+    uint64_t lag_ns = 0;             // How late the call was sent
+    grpc::StatusCode code = grpc::StatusCode::UNKNOWN;
+    std::string error;
+    std::string response;
+};
+
+// Calls of every file on one timeline (one file per pre-fork worker)
+std::vector<Call> load_calls(const std::vector<std::string>& files, size_t* skipped) {
+    std::vector<std::unique_ptr<mcoptions::recorder::RecordingReader>> readers;
+    int64_t start = INT64_MAX;
+    for (const auto& file : files) {
+        readers.push_back(std::make_unique<mcoptions::recorder::RecordingReader>(file));
+        start = std::min(start, readers.back()->start_unix_ns());
+    }
+
+    std::vector<Call> calls;
+    *skipped = 0;
+    for (auto& reader : readers) {
+        uint64_t offset = static_cast<uint64_t>(reader->start_unix_ns() - start);
+        mcoptions::recorder::RecordedCall recorded;
+        while (reader->next(recorded)) {
+            if (recorded.method == "Subscribe") {
+                ++*skipped;
+                continue;
+            }
+            calls.push_back(Call{offset + recorded.arrival_ns, recorded.service_ns,
+                                 static_cast<grpc::StatusCode>(recorded.status_code),
+                                 std::move(recorded.method), std::move(recorded.request),
+                                 std::move(recorded.response)});
+        }
+    }
+    std::stable_sort(calls.begin(), calls.end(),
+                     [](const Call& a, const Call& b) { return a.at_ns < b.at_ns; });
+    return calls;
+}
+
+const google::protobuf::MethodDescriptor* find_method(const std::string& name) {
+    const auto* service = google::protobuf::DescriptorPool::generated_pool()->FindServiceByName(kService);
+    return service ? service->FindMethodByName(name) : nullptr;
+}
+
+std::unique_ptr<Message> parse(const Descriptor* type, const std::string& bytes) {
+    std::unique_ptr<Message> message(
+        google::protobuf::MessageFactory::generated_factory()->GetPrototype(type)->New());
+    if (!message->ParseFromString(bytes)) return nullptr;
+    return message;
+}
+
+// True if any SimulationConfig in the request carries a seed
+bool seeded(const Message& message) {
+    const Descriptor* type = message.GetDescriptor();
+    const Reflection* reflection = message.GetReflection();
+    if (type->full_name() == "mcoptions.SimulationConfig") {
+        return reflection->HasField(message, type->FindFieldByName("seed"));
+    }
+    for (int i = 0; i < type->field_count(); ++i) {
+        const FieldDescriptor* field = type->field(i);
+        if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) continue;
+        if (field->is_repeated()) {
+            for (int j = 0; j < reflection->FieldSize(message, field); ++j) {
+                if (seeded(reflection->GetRepeatedMessage(message, field, j))) return true;
+            }
+        } else if (reflection->HasField(message, field) &&
+                   seeded(reflection->GetMessage(message, field))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+double get_double(const Message& m, const FieldDescriptor* f, int index) {
+    const Reflection* r = m.GetReflection();
+    if (f->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT) {
+        return index < 0 ? r->GetFloat(m, f) : r->GetRepeatedFloat(m, f, index);
+    }
+    return index < 0 ? r->GetDouble(m, f) : r->GetRepeatedDouble(m, f, index);
+}
+
+std::string field_text(const Message& m, const FieldDescriptor* f, int index) {
+    if (f->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE || f->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT) {
+        std::ostringstream ss;
+        ss << std::setprecision(17) << get_double(m, f, index);
+        return ss.str();
+    }
+    std::string text;
+    google::protobuf::TextFormat::PrintFieldValueToString(m, f, index, &text);
+    return text;
+}
+
+/*
+ * Path of the first field where a replayed response differs from the
+ * recorded one, or "" if none. Timings (*time_ms) are ignored. With a seed
+ * every other field must match, floating-point ones to the relative
+ * tolerance. Without one only discrete fields (strings, enums, flags) must
+ * match, and a price only within four combined standard errors when the
+ * message has an error_estimate.
+ */
+class Comparator {
+public:
+    Comparator(bool seeded, double tolerance) : seeded_(seeded), tolerance_(tolerance) {}
+
+    std::string compare(const Message& a, const Message& b, const std::string& prefix = "") const {
+        const Descriptor* type = a.GetDescriptor();
+        const Reflection* r = a.GetReflection();
+        for (int i = 0; i < type->field_count(); ++i) {
+            const FieldDescriptor* f = type->field(i);
+            std::string name = prefix + f->name();
+            if (ends_with(f->name(), "time_ms")) continue;
+            if (!f->is_repeated()) {
+                std::string diff = compare_value(a, b, f, -1, name);
+                if (!diff.empty()) return diff;
+                continue;
+            }
+            int na = r->FieldSize(a, f);
+            int nb = b.GetReflection()->FieldSize(b, f);
+            if (na != nb) {
+                return name + ": " + std::to_string(na) + " vs " + std::to_string(nb) + " entries";
+            }
+            for (int j = 0; j < na; ++j) {
+                std::string diff = compare_value(a, b, f, j, name + "[" + std::to_string(j) + "]");
+                if (!diff.empty()) return diff;
+            }
+        }
+        return "";
+    }
+
+private:
+    std::string compare_value(const Message& a, const Message& b, const FieldDescriptor* f,
+                              int index, const std::string& name) const {
+        const Reflection* ra = a.GetReflection();
+        const Reflection* rb = b.GetReflection();
+        switch (f->cpp_type()) {
+            case FieldDescriptor::CPPTYPE_MESSAGE: {
+                const Message& ma = index < 0 ? ra->GetMessage(a, f) : ra->GetRepeatedMessage(a, f, index);
+                const Message& mb = index < 0 ? rb->GetMessage(b, f) : rb->GetRepeatedMessage(b, f, index);
+                return compare(ma, mb, name + ".");
+            }
+            case FieldDescriptor::CPPTYPE_DOUBLE:
+            case FieldDescriptor::CPPTYPE_FLOAT: {
+                double x = get_double(a, f, index);
+                double y = get_double(b, f, index);
+                if (seeded_ ? close(x, y) : within_error(a, b, f, x, y)) return "";
+                break;
+            }
+            case FieldDescriptor::CPPTYPE_INT32:
+            case FieldDescriptor::CPPTYPE_INT64:
+            case FieldDescriptor::CPPTYPE_UINT32:
+            case FieldDescriptor::CPPTYPE_UINT64:
+                // Path counts of adaptive methods follow the sampled variance
+                if (!seeded_ || field_text(a, f, index) == field_text(b, f, index)) return "";
+                break;
+            default:
+                if (field_text(a, f, index) == field_text(b, f, index)) return "";
+                break;
+        }
+        return name + ": " + field_text(a, f, index) + " vs " + field_text(b, f, index);
+    }
+
+    bool close(double x, double y) const {
+        if (std::isnan(x) || std::isnan(y)) return std::isnan(x) && std::isnan(y);
+        return std::fabs(x - y) <= tolerance_ * std::max({1.0, std::fabs(x), std::fabs(y)});
+    }
+
+    bool within_error(const Message& a, const Message& b, const FieldDescriptor* f,
+                      double x, double y) const {
+        if (f->name() != "price") return true;
+        const FieldDescriptor* error = a.GetDescriptor()->FindFieldByName("error_estimate");
+        if (!error || error->is_repeated()) return true;
+        double ea = get_double(a, error, -1);
+        double eb = get_double(b, error, -1);
+        if (!(ea > 0.0) || !(eb > 0.0)) return true;
+        return std::fabs(x - y) <= 4.0 * std::sqrt(ea * ea + eb * eb);
+    }
+
+    bool seeded_;
+    double tolerance_;
+};
+
+class Replayer {
+public:
+    Replayer(std::shared_ptr<grpc::Channel> channel, size_t max_in_flight)
+        : stub_(channel), max_in_flight_(max_in_flight) {
+        completions_ = std::thread([this] { drain(); });
+    }
+
+    ~Replayer() {
+        cq_.Shutdown();
+        completions_.join();
+    }
+
+    void run(const std::vector<Call>& calls, double speed, std::vector<Outcome>& outcomes) {
+        outcomes_ = &outcomes;
+        outcomes.assign(calls.size(), Outcome());
+        Clock::time_point start = Clock::now() + std::chrono::milliseconds(100);
+        for (size_t i = 0; i < calls.size(); ++i) {
+            Clock::time_point due = start;
+            if (speed > 0.0) {
+                due += std::chrono::nanoseconds(static_cast<int64_t>(calls[i].at_ns / speed));
+                std::this_thread::sleep_until(due);
+            }
+            // Market updates change what later calls see: keep them in order
+            bool barrier = calls[i].method == "UpdateMarketData";
+            wait_until_in_flight(barrier ? 0 : max_in_flight_ - 1);
+            Clock::time_point now = Clock::now();
+            outcomes[i].lag_ns = speed > 0.0 && now > due ?
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - due).count()) : 0;
+            issue(i, calls[i]);
+            if (barrier) wait_until_in_flight(0);
+        }
+        wait_until_in_flight(0);
+    }
+
+private:
+    struct Pending {
+        size_t index;
+        grpc::ClientContext context;
+        grpc::ByteBuffer response;
+        grpc::Status status;
+        std::unique_ptr<grpc::GenericClientAsyncResponseReader> reader;
+        Clock::time_point sent;
+    };
+
+    void issue(size_t index, const Call& call) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++in_flight_;
+        }
+        auto* pending = new Pending;
+        pending->index = index;
+        grpc::Slice slice(call.request);
+        grpc::ByteBuffer request(&slice, 1);
+        pending->sent = Clock::now();
+        pending->reader = stub_.PrepareUnaryCall(&pending->context,
+            std::string("/") + kService + "/" + call.method, request, &cq_);
+        pending->reader->StartCall();
+        pending->reader->Finish(&pending->response, &pending->status, pending);
+    }
+
+    void drain() {
+        void* tag;
+        bool ok;
+        while (cq_.Next(&tag, &ok)) {
+            std::unique_ptr<Pending> pending(static_cast<Pending*>(tag));
+            Outcome& outcome = (*outcomes_)[pending->index];
+            outcome.latency_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - pending->sent).count());
+            outcome.code = pending->status.error_code();
+            outcome.error = pending->status.error_message();
+            std::vector<grpc::Slice> slices;
+            if (pending->status.ok() && pending->response.Dump(&slices).ok()) {
+                for (const auto& s : slices) {
+                    outcome.response.append(reinterpret_cast<const char*>(s.begin()), s.size());
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --in_flight_;
+            }
+            idle_.notify_all();
+        }
+    }
+
+    void wait_until_in_flight(size_t limit) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [&] { return in_flight_ <= limit; });
+    }
+
+    grpc::GenericStub stub_;
+    grpc::CompletionQueue cq_;
+    size_t max_in_flight_;
+    std::vector<Outcome>* outcomes_ = nullptr;
+    std::thread completions_;
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    size_t in_flight_ = 0;
+};
+
+double percentile_ms(std::vector<uint64_t>& values, double q) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(q * values.size()));
+    return values[index] / 1e6;
+}
+
+struct Distribution {
+    std::vector<uint64_t> recorded;   // Server handler time in the recording
+    std::vector<uint64_t> replayed;   // Round trip seen by this client
+};
+
+void print_distributions(std::map<std::string, Distribution>& methods, bool replayed) {
+    std::cout << std::left << std::setw(20) << "method" << std::right << std::setw(8) << "calls"
+              << std::setw(12) << "rec p50" << std::setw(12) << "rec p99";
+    if (replayed) {
+        std::cout << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99"
+                  << std::setw(12) << "max" << std::setw(9) << "p50 x";
+    }
+    std::cout << "   (ms)" << std::endl;
+    for (auto& [method, d] : methods) {
+        double rec50 = percentile_ms(d.recorded, 0.5);
+        std::cout << std::left << std::setw(20) << method << std::right << std::setw(8) << d.recorded.size()
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << rec50 << std::setw(12) << percentile_ms(d.recorded, 0.99);
+        if (replayed) {
+            double p50 = percentile_ms(d.replayed, 0.5);
+            std::cout << std::setw(12) << p50 << std::setw(12) << percentile_ms(d.replayed, 0.9)
+                      << std::setw(12) << percentile_ms(d.replayed, 0.99)
+                      << std::setw(12) << percentile_ms(d.replayed, 1.0)
+                      << std::setw(9) << std::setprecision(2) << (rec50 > 0.0 ? p50 / rec50 : 0.0);
+        }
+        std::cout << std::endl;
+    }
+}
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " RECORDING... [--address HOST:PORT] [--speed X]" << std::endl;
+    std::cout << "       [--max-in-flight N] [--tolerance T] [--limit N] [--csv PATH] [--info]" << std::endl;
+    std::cout << "  RECORDING        Files written by mcoptions_server --record (all workers' files" << std::endl;
+    std::cout << "                   are merged on one timeline)" << std::endl;
+    std::cout << "  --address        Server to replay against (default localhost:50051)" << std::endl;
+    std::cout << "  --speed          Rate relative to the recording, 2 = twice as fast;" << std::endl;
+    std::cout << "                   0 = as fast as --max-in-flight allows (default 1)" << std::endl;
+    std::cout << "  --max-in-flight  Calls outstanding at once (default 256)" << std::endl;
+    std::cout << "  --tolerance      Relative tolerance for seeded prices (default 1e-9)" << std::endl;
+    std::cout << "  --limit          Replay only the first N calls" << std::endl;
+    std::cout << "  --csv            Write one line per call: latencies, status, match" << std::endl;
+    std::cout << "  --info           Summarise the recording without a server" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--address" && i + 1 < argc) {
+            options.address = argv[++i];
+        } else if (arg == "--speed" && i + 1 < argc) {
+            options.speed = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--max-in-flight" && i + 1 < argc) {
+            options.max_in_flight = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            options.tolerance = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--limit" && i + 1 < argc) {
+            options.limit = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--csv" && i + 1 < argc) {
+            options.csv = argv[++i];
+        } else if (arg == "--info") {
+            options.info = true;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    if (options.files.empty() || options.speed < 0.0 || options.max_in_flight == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Call> calls;
+    size_t skipped = 0;
+    try {
+        calls = load_calls(options.files, &skipped);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (options.limit > 0 && calls.size() > options.limit) calls.resize(options.limit);
+    for (const auto& call : calls) {
+        if (!find_method(call.method)) {
+            std::cerr << "Recording has an unknown method: " << call.method << std::endl;
+            return 1;
+        }
+    }
+
+    double span_s = calls.empty() ? 0.0 : (calls.back().at_ns - calls.front().at_ns) / 1e9;
+    std::cout << "Recording: " << calls.size() << " calls over " << std::fixed << std::setprecision(3)
+              << span_s << " s";
+    if (span_s > 0.0) std::cout << " (" << std::setprecision(1) << calls.size() / span_s << "/s)";
+    if (skipped > 0) std::cout << ", " << skipped << " streaming calls skipped";
+    std::cout << std::endl << std::endl;
+
+    std::map<std::string, Distribution> methods;
+    for (const auto& call : calls) methods[call.method].recorded.push_back(call.service_ns);
+    if (options.info) {
+        print_distributions(methods, false);
+        return 0;
+    }
+
+    grpc::ChannelArguments args;
+    args.SetMaxReceiveMessageSize(-1);
+    args.SetMaxSendMessageSize(-1);
+    auto channel = grpc::CreateCustomChannel(options.address, grpc::InsecureChannelCredentials(), args);
+
+    std::vector<Outcome> outcomes;
+    Clock::time_point begin = Clock::now();
+    {
+        Replayer replayer(channel, options.max_in_flight);
+        replayer.run(calls, options.speed, outcomes);
+    }
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    size_t failed = 0, mismatched = 0, unseeded = 0;
+    std::vector<std::string> differences(calls.size());
+    std::vector<uint64_t> lags;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        const Call& call = calls[i];
+        const Outcome& outcome = outcomes[i];
+        lags.push_back(outcome.lag_ns);
+        if (outcome.code != call.code) {
+            ++failed;
+            differences[i] = "status " + std::to_string(outcome.code) + " (recorded " +
+                             std::to_string(call.code) + "): " + outcome.error;
+            continue;
+        }
+        methods[call.method].replayed.push_back(outcome.latency_ns);
+        if (outcome.code != grpc::StatusCode::OK) continue;  // Failed as recorded
+
+        const auto* method = find_method(call.method);
+        auto request = parse(method->input_type(), call.request);
+        auto recorded = parse(method->output_type(), call.response);
+        auto replayed = parse(method->output_type(), outcome.response);
+        if (!request || !recorded || !replayed) {
+            differences[i] = "unparsable message";
+        } else {
+            bool has_seed = seeded(*request);
+            if (!has_seed) ++unseeded;
+            differences[i] = Comparator(has_seed, options.tolerance).compare(*recorded, *replayed);
+        }
+        if (!differences[i].empty()) ++mismatched;
+    }
+
+    std::cout << "Replayed in " << std::setprecision(3) << elapsed_s << " s";
+    if (elapsed_s > 0.0) std::cout << " (" << std::setprecision(1) << calls.size() / elapsed_s << "/s)";
+    std::cout << ", send lag p99 " << std::setprecision(3) << percentile_ms(lags, 0.99)
+              << " ms, max " << percentile_ms(lags, 1.0) << " ms" << std::endl;
+    std::cout << "Results: " << calls.size() - failed - mismatched << " match, " << mismatched
+              << " differ, " << failed << " failed (" << unseeded
+              << " unseeded, compared loosely)" << std::endl << std::endl;
+    print_distributions(methods, true);
+
+    size_t shown = 0;
+    for (size_t i = 0; i < calls.size() && shown < 10; ++i) {
+        if (differences[i].empty()) continue;
+        if (shown++ == 0) std::cout << std::endl << "Differences:" << std::endl;
+        std::cout << "  #" << i << " " << calls[i].method << ": " << differences[i] << std::endl;
+    }
+
+    if (!options.csv.empty()) {
+        std::ofstream csv(options.csv);
+        csv << "index,method,arrival_ms,recorded_ms,replayed_ms,lag_ms,recorded_status,status,difference\n";
+        csv << std::setprecision(6);
+        for (size_t i = 0; i < calls.size(); ++i) {
+            std::string difference = differences[i];
+            std::replace(difference.begin(), difference.end(), ',', ';');
+            csv << i << "," << calls[i].method << "," << calls[i].at_ns / 1e6 << ","
+                << calls[i].service_ns / 1e6 << "," << outcomes[i].latency_ns / 1e6 << ","
+                << outcomes[i].lag_ns / 1e6 << "," << calls[i].code << "," << outcomes[i].code << ","
+                << difference << "\n";
+        }
+        std::cout << std::endl << "Wrote " << options.csv << std::endl;
+    }
+
+    return failed == 0 && mismatched == 0 ? 0 : 2;
+}
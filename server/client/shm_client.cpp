@@ -0,0 +1,79 @@
+// Prices a batch of European options over the server's shared-memory ring
+// and reports the round-trip latency. Start the server with --shm first.
+#include "shm_ring.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    std::string name = "/mcoptions";
+    size_t batch = 1;
+    size_t repeats = 10000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--batch" && i + 1 < argc) batch = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--repeats" && i + 1 < argc) repeats = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0] << " [NAME] [--batch N] [--repeats N]" << std::endl;
+            std::cout << "  NAME       Ring name given to mcoptions_server --shm (default /mcoptions)" << std::endl;
+            std::cout << "  --batch    Instruments per request (default 1)" << std::endl;
+            std::cout << "  --repeats  Requests to time (default 10000)" << std::endl;
+            return 0;
+        } else {
+            name = arg;
+        }
+    }
+    if (batch == 0 || repeats == 0) {
+        std::cerr << "--batch and --repeats must be positive" << std::endl;
+        return 1;
+    }
+
+    try {
+        mcoptions::shm::RingClient client(name);
+        if (batch > client.slot_capacity()) {
+            std::cerr << "--batch exceeds the ring's slot capacity of " << client.slot_capacity()
+                      << std::endl;
+            return 1;
+        }
+
+        std::vector<mco_instrument_t> instruments(batch);
+        for (size_t i = 0; i < batch; ++i) {
+            mco_instrument_t& inst = instruments[i];
+            inst = mco_instrument_t{};
+            inst.kind = MCO_INSTRUMENT_EUROPEAN;
+            inst.option_type = i % 2 ? MCO_PUT : MCO_CALL;
+            inst.method = MCO_METHOD_ANALYTIC;
+            inst.spot = 100.0;
+            inst.strike = 80.0 + 40.0 * i / batch;
+            inst.rate = 0.05;
+            inst.volatility = 0.2;
+            inst.time_to_maturity = 1.0;
+        }
+        std::vector<mco_price_result_t> results(batch);
+        mcoptions::shm::RingConfig config{};
+
+        int status = client.price(instruments.data(), batch, results.data(), config);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < repeats && status != mcoptions::shm::SERVER_LOST; ++r) {
+            status = client.price(instruments.data(), batch, results.data(), config);
+        }
+        if (status == mcoptions::shm::SERVER_LOST) {
+            std::cerr << "The server went away" << std::endl;
+            return 1;
+        }
+        auto end = std::chrono::steady_clock::now();
+        double us = std::chrono::duration<double, std::micro>(end - start).count() / repeats;
+
+        std::cout << "Status " << status << ", first price " << std::fixed << std::setprecision(4)
+                  << results[0].price << std::endl;
+        std::cout << std::setprecision(2) << us << " us per request of " << batch
+                  << " instrument(s), " << us * 1000.0 / batch << " ns per instrument" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
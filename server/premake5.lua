@@ -20,6 +20,10 @@ project "mcoptions_server"
     files {
         "server/main.cpp",
         "server/mcoptions_service.hpp",
+        "server/shm_ring.hpp",
+        "server/result_cache.hpp",
+        "server/prefork.hpp",
+        "server/request_recorder.hpp",
         "generated/mcoptions.pb.cc",
         "generated/mcoptions.grpc.pb.cc"
     }
@@ -53,7 +57,7 @@ project "mcoptions_server"
     }
     
     filter "system:linux"
-        links { "m" }
+        links { "m", "rt" }
 
 project "mcoptions_client"
     kind "ConsoleApp"
@@ -90,3 +94,60 @@ project "mcoptions_client"
         "pthread",
         "dl"
     }
+
+project "mcoptions_shm_client"
+    kind "ConsoleApp"
+    targetdir "build"
+    objdir "build/obj"
+    
+    files {
+        "client/shm_client.cpp",
+        "server/shm_ring.hpp"
+    }
+    
+    includedirs {
+        "server",
+        "../lib/include"
+    }
+    
+    links {
+        "pthread",
+        "rt"
+    }
+
+project "mcoptions_replay"
+    kind "ConsoleApp"
+    targetdir "build"
+    objdir "build/obj"
+    
+    files {
+        "client/replay.cpp",
+        "server/request_recorder.hpp",
+        "generated/mcoptions.pb.cc"
+    }
+    
+    includedirs {
+        "generated",
+        "server",
+        "/usr/include",
+        "/usr/local/include"
+    }
+    
+    libdirs {
+        "/usr/lib",
+        "/usr/local/lib",
+        "/usr/lib/x86_64-linux-gnu"
+    }
+    
+    links {
+        "grpc++",
+        "grpc",
+        "gpr",
+        "protobuf",
+        "absl_synchronization",
+        "absl_strings",
+        "absl_base",
+        "absl_time",
+        "pthread",
+        "dl"
+    }
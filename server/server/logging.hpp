@@ -29,12 +29,16 @@ inline std::string format_config(const SimulationConfig& config) {
     std::stringstream ss;
     ss << "Sims: " << config.num_simulations() 
        << ", Steps: " << config.num_steps();
-    if (config.antithetic_enabled() || config.control_variates_enabled() || config.stratified_sampling_enabled()) {
+    if (config.antithetic_enabled() || config.control_variates_enabled() ||
+        config.stratified_sampling_enabled() || config.reproducible() ||
+        config.sequential_stream()) {
         ss << " [";
         bool first = true;
         if (config.antithetic_enabled()) { ss << "AV"; first = false; }
         if (config.control_variates_enabled()) { if (!first) ss << ","; ss << "CV"; first = false; }
-        if (config.stratified_sampling_enabled()) { if (!first) ss << ","; ss << "SS"; }
+        if (config.stratified_sampling_enabled()) { if (!first) ss << ","; ss << "SS"; first = false; }
+        if (config.reproducible()) { if (!first) ss << ","; ss << "REPRO"; first = false; }
+        if (config.sequential_stream()) { if (!first) ss << ","; ss << "SEQ"; }
         ss << "]";
     }
     return ss.str();
@@ -53,12 +57,38 @@ inline void log_result(double price, long duration_ms) {
               << COLOR_RESET << std::endl << std::endl;
 }
 
+inline void log_method_choice(const std::string& method, uint64_t steps, uint64_t paths) {
+    std::cout << "  Method: " << COLOR_GREEN << method << COLOR_RESET
+              << " (steps=" << steps << ", paths=" << paths << ")" << std::endl;
+}
+
 inline void log_batch_complete(long duration_ms) {
     std::cout << "  " << COLOR_YELLOW << "Batch completed" << COLOR_RESET 
               << COLOR_BLUE << " (total time: " << duration_ms << "ms)" 
               << COLOR_RESET << std::endl << std::endl;
 }
 
+inline void log_market_update(uint64_t version, const std::string& error) {
+    if (version == 0) {
+        std::cout << "  " << COLOR_YELLOW << "Rejected: " << error << COLOR_RESET
+                  << std::endl << std::endl;
+        return;
+    }
+    std::cout << "  " << COLOR_YELLOW << "Market version " << version << COLOR_RESET
+              << std::endl << std::endl;
+}
+
+inline void log_repricing(size_t repriced, size_t total, long duration_ms) {
+    std::cout << "  " << COLOR_YELLOW << "Subscription repriced " << repriced << "/" << total
+              << COLOR_RESET << COLOR_BLUE << " (" << duration_ms << "ms)"
+              << COLOR_RESET << std::endl << std::endl;
+}
+
+inline void log_cache_hits(size_t hits, size_t total) {
+    std::cout << "  " << COLOR_YELLOW << "Shared cache: " << hits << "/" << total
+              << " served" << COLOR_RESET << std::endl;
+}
+
 } // namespace logging
 } // namespace mcoptions
 
@@ -1,9 +1,15 @@
 #include "mcoptions_service.hpp"
+#include "shm_ring.hpp"
+#include "result_cache.hpp"
+#include "prefork.hpp"
+#include "request_recorder.hpp"
 #include <iostream>
 #include <memory>
 #include <string>
 #include <csignal>
 #include <atomic>
+#include <cstdlib>
+#include <unistd.h>
 
 // Global server pointer for signal handler
 std::unique_ptr<grpc::Server> g_server;
@@ -27,23 +33,102 @@ void SignalHandler(int signal) {
     }
 }
 
-void RunServer(const std::string& server_address) {
-    McOptionsServiceImpl service;
+// Local transports for clients on the same host
+struct LocalTransports {
+    std::string unix_socket;      // gRPC over a Unix domain socket
+    std::string shm_name;         // Shared-memory ring, see shm_ring.hpp
+    uint32_t shm_slots = 16;
+    uint32_t shm_capacity = 1024;
+};
+
+void PrintRecorderStats(const mcoptions::recorder::RequestRecorder& recorder) {
+    auto stats = recorder.stats();
+    std::cout << "Recorded " << stats.records << " calls (" << stats.dropped << " dropped, "
+              << stats.bytes << " bytes) to " << recorder.path() << std::endl;
+}
+
+// `worker` is the pre-fork worker index, or -1 for a single-process server.
+// A non-empty `record_path` captures every call; workers append ".<index>".
+void RunServer(const std::string& server_address, const LocalTransports& local,
+               mcoptions::cache::SharedResultCache* cache, const std::string& record_path,
+               int worker) {
+    std::unique_ptr<mcoptions::recorder::RequestRecorder> recorder;
+    if (!record_path.empty()) {
+        try {
+            recorder = std::make_unique<mcoptions::recorder::RequestRecorder>(
+                worker >= 0 ? record_path + "." + std::to_string(worker) : record_path);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return;
+        }
+    }
+    // Market data lives in the process; workers would each hold a different store
+    McOptionsServiceImpl service(cache, recorder.get(), worker < 0);
     
     grpc::ServerBuilder builder;
+    // Workers share the port; the kernel spreads connections across them
+    builder.AddChannelArgument(GRPC_ARG_ALLOW_REUSEPORT, worker >= 0 ? 1 : 0);
     builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
+    if (!local.unix_socket.empty()) {
+        unlink(local.unix_socket.c_str());
+        builder.AddListeningPort("unix:" + local.unix_socket, grpc::InsecureServerCredentials());
+    }
     builder.RegisterService(&service);
     
+    const auto& engine = mcoptions::handlers::engine_settings();
+    std::unique_ptr<mcoptions::shm::RingServer> ring;
+    if (!local.shm_name.empty()) {
+        ring = std::make_unique<mcoptions::shm::RingServer>(
+            local.shm_name, local.shm_slots, local.shm_capacity, engine.num_threads, engine.affinity);
+    }
+    
     g_server = builder.BuildAndStart();
+    if (!g_server) {
+        std::cerr << "Could not listen on " << server_address << std::endl;
+        return;
+    }
     
     // Register signal handlers
     std::signal(SIGINT, SignalHandler);
     std::signal(SIGTERM, SignalHandler);
     
+    if (worker >= 0) {
+        mco_topology_t topology;
+        mco_get_topology(&topology);
+        std::cout << "Worker " << worker << " (pid " << getpid() << ") serving on "
+                  << topology.num_cpus << " CPU(s)" << std::endl;
+        g_server->Wait();
+        if (recorder) PrintRecorderStats(*recorder);
+        return;
+    }
+    
     std::cout << COLOR_GREEN << "============================================" << COLOR_RESET << std::endl;
     std::cout << COLOR_GREEN << "  Monte Carlo Options Pricing Server" << COLOR_RESET << std::endl;
     std::cout << COLOR_GREEN << "============================================" << COLOR_RESET << std::endl;
     std::cout << "Server listening on " << COLOR_CYAN << server_address << COLOR_RESET << std::endl;
+    if (!local.unix_socket.empty()) {
+        std::cout << "Unix socket: " << COLOR_CYAN << "unix:" << local.unix_socket << COLOR_RESET << std::endl;
+    }
+    if (ring) {
+        std::cout << "Shared-memory ring: " << COLOR_CYAN << local.shm_name << COLOR_RESET
+                  << " (" << local.shm_slots << " slots x " << local.shm_capacity
+                  << " instruments)" << std::endl;
+    }
+    
+    mco_topology_t topology;
+    mco_get_topology(&topology);
+    static const char* affinity_names[] = {"none", "compact", "spread"};
+    std::cout << "Engine: " << topology.num_cpus << " CPUs on " << topology.num_nodes
+              << " NUMA node(s), threads per request = ";
+    if (engine.num_threads == 0) std::cout << "all";
+    else std::cout << engine.num_threads;
+    std::cout << ", affinity = " << affinity_names[engine.affinity] << std::endl;
+    if (cache) {
+        std::cout << "Result cache: " << cache->stats().entries << " entries" << std::endl;
+    }
+    if (recorder) {
+        std::cout << "Recording calls to " << COLOR_CYAN << recorder->path() << COLOR_RESET << std::endl;
+    }
     std::cout << std::endl;
     std::cout << "Available endpoints:" << std::endl;
     std::cout << "  - PriceEuropeanCall/Put" << std::endl;
@@ -53,23 +138,145 @@ void RunServer(const std::string& server_address) {
     std::cout << "  - PriceLookbackCall/Put" << std::endl;
     std::cout << "  - PriceBermudanCall/Put" << std::endl;
     std::cout << "  - PriceBatch" << std::endl;
+    std::cout << "  - Price (automatic method selection)" << std::endl;
+    std::cout << "  - PriceInstrument / PriceInstruments (generic descriptor)" << std::endl;
+    std::cout << "  - UpdateMarketData / PriceWithMarket (market objects by ID)" << std::endl;
+    std::cout << "  - Subscribe (streaming repricing on market updates)" << std::endl;
     std::cout << std::endl;
     
     g_server->Wait();
+    if (ring) ring->stop();
     
+    if (cache) {
+        auto stats = cache->stats();
+        std::cout << std::endl << "Result cache: " << stats.hits << " hits, " << stats.misses
+                  << " misses, " << stats.stores << " stores" << std::endl;
+    }
+    if (recorder) PrintRecorderStats(*recorder);
     std::cout << std::endl;
     std::cout << COLOR_GREEN << "✓ Server shutdown complete" << COLOR_RESET << std::endl;
     std::cout << COLOR_GREEN << "============================================" << COLOR_RESET << std::endl;
 }
 
+void PrintUsage(const char* program) {
+    std::cout << "Usage: " << program << " [address] [--threads N] [--affinity none|compact|spread]" << std::endl;
+    std::cout << "       [--unix PATH] [--shm NAME] [--shm-slots N] [--shm-capacity N]" << std::endl;
+    std::cout << "       [--workers N] [--cache N] [--record PATH]" << std::endl;
+    std::cout << "  address         Listening address (default 0.0.0.0:50051)" << std::endl;
+    std::cout << "  --threads       Engine worker threads per request, 0 = all CPUs (default 1)" << std::endl;
+    std::cout << "  --affinity      Worker pinning across NUMA nodes (default none)" << std::endl;
+    std::cout << "  --unix          Also serve gRPC on this Unix domain socket" << std::endl;
+    std::cout << "  --shm           Also serve batch pricing on a shared-memory ring, e.g. /mcoptions" << std::endl;
+    std::cout << "  --shm-slots     Requests in flight on the ring (default 16)" << std::endl;
+    std::cout << "  --shm-capacity  Instruments per ring request (default 1024)" << std::endl;
+    std::cout << "  --workers       Pre-fork N supervised server processes sharing the port," << std::endl;
+    std::cout << "                  each pinned to its own CPUs (default 0 = single process);" << std::endl;
+    std::cout << "                  market-data RPCs need a single process" << std::endl;
+    std::cout << "  --cache         Entries of the deterministic-result cache shared by all" << std::endl;
+    std::cout << "                  processes (default 0 = off)" << std::endl;
+    std::cout << "  --record        Capture every call to PATH for mcoptions_replay" << std::endl;
+    std::cout << "                  (PATH.<worker> per process with --workers)" << std::endl;
+}
+
 int main(int argc, char** argv) {
     std::string server_address = "0.0.0.0:50051";
+    auto& engine = mcoptions::handlers::engine_settings();
+    LocalTransports local;
+    size_t workers = 0;
+    size_t cache_entries = 0;
+    std::string record_path;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            return 0;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            engine.num_threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--affinity" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "none") engine.affinity = MCO_AFFINITY_NONE;
+            else if (mode == "compact") engine.affinity = MCO_AFFINITY_COMPACT;
+            else if (mode == "spread") engine.affinity = MCO_AFFINITY_SPREAD;
+            else {
+                std::cerr << "Unknown affinity: " << mode << std::endl;
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--unix" && i + 1 < argc) {
+            local.unix_socket = argv[++i];
+        } else if (arg == "--shm" && i + 1 < argc) {
+            local.shm_name = argv[++i];
+            if (local.shm_name[0] != '/') local.shm_name = "/" + local.shm_name;
+        } else if (arg == "--shm-slots" && i + 1 < argc) {
+            local.shm_slots = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--shm-capacity" && i + 1 < argc) {
+            local.shm_capacity = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workers = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cache_entries = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--record" && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            PrintUsage(argv[0]);
+            return 1;
+        } else {
+            server_address = arg;
+        }
+    }
+    
+    if (!local.shm_name.empty() && (local.shm_slots == 0 || local.shm_capacity == 0)) {
+        std::cerr << "--shm-slots and --shm-capacity must be positive" << std::endl;
+        return 1;
+    }
+    
+    if (workers > 0 && (!local.unix_socket.empty() || !local.shm_name.empty())) {
+        std::cerr << "--unix and --shm serve one process; they cannot be combined with --workers"
+                  << std::endl;
+        return 1;
+    }
+    
+    // Mapped before forking so every worker shares it
+    std::unique_ptr<mcoptions::cache::SharedResultCache> cache;
+    if (cache_entries > 0) {
+        cache = std::make_unique<mcoptions::cache::SharedResultCache>(cache_entries);
+    }
     
-    if (argc > 1) {
-        server_address = argv[1];
+    if (workers == 0) {
+        RunServer(server_address, local, cache.get(), record_path, -1);
+        return 0;
     }
     
-    RunServer(server_address);
+    // Nothing below may start gRPC or the library before the fork
+    auto cpu_sets = mcoptions::prefork::worker_cpu_sets(workers);
+    std::cout << COLOR_GREEN << "============================================" << COLOR_RESET << std::endl;
+    std::cout << COLOR_GREEN << "  Monte Carlo Options Pricing Server" << COLOR_RESET << std::endl;
+    std::cout << COLOR_GREEN << "============================================" << COLOR_RESET << std::endl;
+    std::cout << "Supervisor " << getpid() << ": " << workers << " workers on "
+              << COLOR_CYAN << server_address << COLOR_RESET << std::endl;
+    for (size_t w = 0; w < workers; ++w) {
+        std::cout << "  worker " << w << " -> CPUs " << mcoptions::prefork::format_cpus(cpu_sets[w])
+                  << std::endl;
+    }
+    if (cache) std::cout << "Result cache: " << cache->stats().entries << " entries, shared" << std::endl;
+    if (!record_path.empty()) std::cout << "Recording calls to " << record_path << ".<worker>" << std::endl;
+    std::cout << std::endl;
+    
+    mcoptions::prefork::supervise(workers, [&](size_t w) {
+        if (!mcoptions::prefork::pin_process(cpu_sets[w])) {
+            std::cerr << "Worker " << w << " could not pin to its CPUs" << std::endl;
+        }
+        RunServer(server_address, local, cache.get(), record_path, static_cast<int>(w));
+        return 0;
+    });
     
+    if (cache) {
+        auto stats = cache->stats();
+        std::cout << "Result cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                  << stats.stores << " stores" << std::endl;
+    }
+    std::cout << COLOR_GREEN << "✓ All workers stopped" << COLOR_RESET << std::endl;
     return 0;
 }
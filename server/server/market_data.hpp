@@ -0,0 +1,385 @@
+#ifndef MCOPTIONS_MARKET_DATA_HPP
+#define MCOPTIONS_MARKET_DATA_HPP
+
+#include "mcoptions.h"
+#include "mcoptions.grpc.pb.h"
+#include "request_handlers.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace mcoptions {
+namespace market {
+
+// Market inputs for one instrument, read from the store at one version
+struct ResolvedMarket {
+    double spot = 0.0;
+    double rate = 0.0;
+    double volatility = 0.0;
+    bool has_model = false;
+    ModelParams model;
+    uint64_t model_version = 0;  // Version of the referenced model object, 0 if none
+};
+
+namespace detail {
+
+// Index i with points[i] <= x < points[i + 1] and the weight of points[i + 1];
+// flat beyond the ends
+inline void bracket(const google::protobuf::RepeatedField<double>& points, double x,
+                    int* index, double* weight) {
+    int n = points.size();
+    if (n == 1 || x <= points[0]) {
+        *index = 0;
+        *weight = 0.0;
+        return;
+    }
+    if (x >= points[n - 1]) {
+        *index = n - 2;
+        *weight = 1.0;
+        return;
+    }
+    int i = static_cast<int>(std::upper_bound(points.begin(), points.end(), x) - points.begin()) - 1;
+    *index = i;
+    *weight = (x - points[i]) / (points[i + 1] - points[i]);
+}
+
+inline double curve_rate(const RateCurve& curve, double tenor) {
+    int i;
+    double w;
+    bracket(curve.tenors(), tenor, &i, &w);
+    if (curve.tenors_size() == 1) return curve.zero_rates(0);
+    return (1.0 - w) * curve.zero_rates(i) + w * curve.zero_rates(i + 1);
+}
+
+inline double surface_vol(const VolSurface& surface, double expiry, double strike) {
+    int e, k;
+    double we, wk;
+    bracket(surface.expiries(), expiry, &e, &we);
+    bracket(surface.strikes(), strike, &k, &wk);
+    int columns = surface.strikes_size();
+    int e1 = surface.expiries_size() > 1 ? e + 1 : e;
+    int k1 = columns > 1 ? k + 1 : k;
+    auto at = [&](int row, int column) { return surface.vols(row * columns + column); };
+    return (1.0 - we) * ((1.0 - wk) * at(e, k) + wk * at(e, k1)) +
+           we * ((1.0 - wk) * at(e1, k) + wk * at(e1, k1));
+}
+
+inline bool increasing(const google::protobuf::RepeatedField<double>& points) {
+    for (int i = 0; i < points.size(); ++i) {
+        if (!std::isfinite(points[i]) || (i > 0 && points[i] <= points[i - 1])) return false;
+    }
+    return true;
+}
+
+inline std::string validate(const MarketObject& object) {
+    if (object.id().empty()) return "Market object without an ID";
+    switch (object.value_case()) {
+        case MarketObject::kSpot:
+            if (!(object.spot() > 0.0) || !std::isfinite(object.spot())) return "Spot must be positive";
+            break;
+        case MarketObject::kCurve: {
+            const RateCurve& curve = object.curve();
+            if (curve.tenors_size() == 0 || curve.tenors_size() != curve.zero_rates_size()) {
+                return "Curve needs one zero rate per tenor";
+            }
+            if (!increasing(curve.tenors())) return "Curve tenors must be strictly increasing";
+            for (double rate : curve.zero_rates()) {
+                if (!std::isfinite(rate)) return "Curve rates must be finite";
+            }
+            break;
+        }
+        case MarketObject::kVolSurface: {
+            const VolSurface& surface = object.vol_surface();
+            if (surface.expiries_size() == 0 || surface.strikes_size() == 0 ||
+                surface.vols_size() != surface.expiries_size() * surface.strikes_size()) {
+                return "Surface needs expiries x strikes volatilities";
+            }
+            if (!increasing(surface.expiries()) || !increasing(surface.strikes())) {
+                return "Surface axes must be strictly increasing";
+            }
+            for (double vol : surface.vols()) {
+                if (!(vol > 0.0) || !std::isfinite(vol)) return "Surface volatilities must be positive";
+            }
+            break;
+        }
+        case MarketObject::kModel: {
+            const ModelParams& model = object.model();
+            if (model.model() == MODEL_SABR &&
+                (!(model.sabr_alpha() > 0.0) || model.sabr_beta() < 0.0 || model.sabr_beta() > 1.0 ||
+                 !(std::fabs(model.sabr_rho()) < 1.0) || model.sabr_nu() < 0.0)) {
+                return "SABR needs alpha > 0, beta in [0, 1], |rho| < 1 and nu >= 0";
+            }
+            break;
+        }
+        case MarketObject::VALUE_NOT_SET:
+            break;  // Removal
+    }
+    return "";
+}
+
+} // namespace detail
+
+/**
+ * In-server market data: spots, zero curves, volatility surfaces and model
+ * parameters keyed by ID.
+ *
+ * Every accepted update bumps the store version and stamps the objects it
+ * touched with it, so a reader that remembers the version it priced at can
+ * tell whether any object it references has changed since. Removing an ID
+ * keeps its stamp, which makes removal a change like any other.
+ */
+class MarketDataStore {
+public:
+    // Applies all objects or none; returns the new version, or 0 with `error` set
+    uint64_t update(const MarketDataUpdate& update, std::string* error) {
+        for (const auto& object : update.objects()) {
+            std::string problem = detail::validate(object);
+            if (!problem.empty()) {
+                *error = object.id().empty() ? problem : object.id() + ": " + problem;
+                return 0;
+            }
+        }
+        uint64_t version;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            version = ++version_;
+            for (const auto& object : update.objects()) {
+                Slot& slot = objects_[object.id()];
+                slot.object = object;
+                slot.version = version;
+            }
+        }
+        changed_.notify_all();
+        return version;
+    }
+
+    uint64_t version() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return version_;
+    }
+
+    // Latest version at which any object referenced by `refs` changed
+    uint64_t last_change(const MarketRefs& refs) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t latest = 0;
+        for (const std::string* id : {&refs.spot_id(), &refs.curve_id(),
+                                      &refs.vol_surface_id(), &refs.model_id()}) {
+            if (id->empty()) continue;
+            auto it = objects_.find(*id);
+            if (it != objects_.end()) latest = std::max(latest, it->second.version);
+        }
+        return latest;
+    }
+
+    // Blocks until the version passes `seen` or `timeout` elapses; returns the version
+    uint64_t wait_for_update(uint64_t seen, std::chrono::milliseconds timeout) const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait_for(lock, timeout, [&] { return version_ > seen; });
+        return version_;
+    }
+
+    // Market inputs for `item`: referenced objects replace the instrument's own
+    // spot, rate and volatility. The curve is read at maturity and the surface
+    // at maturity and strike. Returns false with `error` set for a missing or
+    // mistyped reference.
+    bool resolve(const MarketInstrument& item, ResolvedMarket* out, uint64_t* version,
+                 std::string* error) const {
+        const Instrument& inst = item.instrument();
+        const MarketRefs& refs = item.market();
+        out->spot = inst.spot();
+        out->rate = inst.rate();
+        out->volatility = inst.volatility();
+        out->has_model = false;
+        out->model_version = 0;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        *version = version_;
+        const MarketObject* object;
+        if (!refs.spot_id().empty()) {
+            if (!(object = find(refs.spot_id(), MarketObject::kSpot, "spot", error))) return false;
+            out->spot = object->spot();
+        }
+        if (!refs.curve_id().empty()) {
+            if (!(object = find(refs.curve_id(), MarketObject::kCurve, "curve", error))) return false;
+            out->rate = detail::curve_rate(object->curve(), inst.time_to_maturity());
+        }
+        if (!refs.vol_surface_id().empty()) {
+            if (!(object = find(refs.vol_surface_id(), MarketObject::kVolSurface,
+                                "volatility surface", error))) {
+                return false;
+            }
+            out->volatility = detail::surface_vol(object->vol_surface(), inst.time_to_maturity(),
+                                                  surface_strike(inst, out->spot));
+        }
+        if (!refs.model_id().empty()) {
+            if (!(object = find(refs.model_id(), MarketObject::kModel, "model", error))) return false;
+            out->has_model = true;
+            out->model = object->model();
+            out->model_version = objects_.at(refs.model_id()).version;
+        }
+        return true;
+    }
+
+private:
+    struct Slot {
+        MarketObject object;
+        uint64_t version = 0;
+    };
+
+    // Absolute strike for the surface lookup: forward starts quote a ratio
+    // and cliquets have no strike, so those read at the money
+    static double surface_strike(const Instrument& inst, double spot) {
+        switch (inst.kind()) {
+            case INSTRUMENT_FORWARD_START: return inst.strike() * spot;
+            case INSTRUMENT_CLIQUET: return spot;
+            default: return inst.strike();
+        }
+    }
+
+    const MarketObject* find(const std::string& id, MarketObject::ValueCase type,
+                             const char* type_name, std::string* error) const {
+        auto it = objects_.find(id);
+        if (it == objects_.end() || it->second.object.value_case() == MarketObject::VALUE_NOT_SET) {
+            *error = "Unknown market object: " + id;
+            return nullptr;
+        }
+        if (it->second.object.value_case() != type) {
+            *error = "Market object " + id + " is not a " + type_name;
+            return nullptr;
+        }
+        return &it->second.object;
+    }
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable changed_;
+    std::map<std::string, Slot> objects_;
+    uint64_t version_ = 0;
+};
+
+inline void apply_market(const ResolvedMarket& market, mco_instrument_t* instrument) {
+    instrument->spot = market.spot;
+    instrument->rate = market.rate;
+    instrument->volatility = market.volatility;
+}
+
+inline void apply_model(const ResolvedMarket& market, mco_context_t* ctx) {
+    if (!market.has_model) return;
+    mco_context_set_model(ctx, market.model.model() == MODEL_SABR ? 1 : 0);
+    mco_context_set_sabr_params(ctx, market.model.sabr_alpha(), market.model.sabr_beta(),
+                                market.model.sabr_rho(), market.model.sabr_nu());
+}
+
+/**
+ * One streaming subscription: a set of instruments priced against the store.
+ *
+ * Each entry keeps a prepared plan, so a tick only patches spot, rate and
+ * volatility and reprices on the plan's fixed random stream; price moves
+ * between updates come from the market alone. A plan is prepared on the
+ * first successful resolution and again when the referenced model object
+ * changes, since the model is part of the plan's context.
+ */
+class Subscription {
+public:
+    Subscription(const MarketDataStore& store, const SubscriptionRequest& request)
+        : store_(store), config_(request.config()) {
+        entries_.reserve(request.instruments_size());
+        for (const auto& item : request.instruments()) {
+            entries_.push_back(Entry{&item, nullptr, 0, 0});
+        }
+    }
+
+    ~Subscription() {
+        for (auto& entry : entries_) mco_plan_free(entry.plan);
+    }
+
+    Subscription(const Subscription&) = delete;
+    Subscription& operator=(const Subscription&) = delete;
+
+    size_t size() const { return entries_.size(); }
+
+    // Entries whose referenced objects changed since they were last priced
+    std::vector<size_t> affected() const {
+        std::vector<size_t> out;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (store_.last_change(entries_[i].item->market()) > entries_[i].priced_at) {
+                out.push_back(i);
+            }
+        }
+        return out;
+    }
+
+    void reprice(size_t index, PriceUpdate* update) {
+        Entry& entry = entries_[index];
+        auto start = std::chrono::high_resolution_clock::now();
+        AutoPriceResponse* response = update->mutable_result();
+        update->set_index(static_cast<uint32_t>(index));
+
+        ResolvedMarket market;
+        std::string error;
+        bool resolved = store_.resolve(*entry.item, &market, &entry.priced_at, &error);
+        update->set_market_version(entry.priced_at);
+        if (!resolved) {
+            response->set_error_message(error);
+            return;
+        }
+
+        if (entry.plan && entry.model_version != market.model_version) {
+            mco_plan_free(entry.plan);
+            entry.plan = nullptr;
+        }
+        if (!entry.plan) {
+            auto ctx = mco_context_new();
+            handlers::apply_config(ctx, config_);
+            apply_model(market, ctx);
+            mco_instrument_t instrument = handlers::to_mco_instrument(entry.item->instrument());
+            apply_market(market, &instrument);
+            int status = mco_plan_prepare(ctx, &instrument, &entry.plan);
+            mco_context_free(ctx);
+            if (status != MCO_OK) {
+                response->set_error_message("Invalid instrument (status " + std::to_string(status) + ")");
+                return;
+            }
+            entry.model_version = market.model_version;
+        }
+
+        mco_market_t inputs = {market.spot, market.rate, market.volatility};
+        mco_price_result_t result;
+        mco_plan_execute(entry.plan, &inputs, &result);
+        auto end = std::chrono::high_resolution_clock::now();
+        response->set_computation_time_ms(
+            std::chrono::duration<double, std::milli>(end - start).count());
+        handlers::fill_price_response(result, response);
+    }
+
+private:
+    struct Entry {
+        const MarketInstrument* item;  // Owned by the request, which outlives the stream
+        mco_plan_t* plan;
+        uint64_t priced_at;            // Store version of the last resolution
+        uint64_t model_version;        // Model object version the plan was prepared with
+    };
+
+    const MarketDataStore& store_;
+    SimulationConfig config_;
+    std::vector<Entry> entries_;
+};
+
+inline std::string format_market_refs(const MarketRefs& refs) {
+    std::stringstream ss;
+    ss << "Spot=" << (refs.spot_id().empty() ? "-" : refs.spot_id())
+       << ", Curve=" << (refs.curve_id().empty() ? "-" : refs.curve_id())
+       << ", Surface=" << (refs.vol_surface_id().empty() ? "-" : refs.vol_surface_id())
+       << ", Model=" << (refs.model_id().empty() ? "-" : refs.model_id());
+    return ss.str();
+}
+
+} // namespace market
+} // namespace mcoptions
+
+#endif
@@ -6,19 +6,35 @@
 #include "mcoptions.h"
 #include "logging.hpp"
 #include "request_handlers.hpp"
+#include "market_data.hpp"
+#include "result_cache.hpp"
+#include "request_recorder.hpp"
 #include <chrono>
 #include <memory>
+#include <vector>
 
 using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
+using grpc::ServerWriter;
 using grpc::Status;
 
 class McOptionsServiceImpl final : public mcoptions::McOptionsService::Service {
 public:
+    // `cache` may be shared with other server processes; null disables caching.
+    // A non-null `recorder` captures every call (see request_recorder.hpp).
+    // Without `market_data` the market-data RPCs fail with FAILED_PRECONDITION:
+    // the store is per process, so pre-fork workers would each see only the
+    // updates the kernel happened to route to them.
+    explicit McOptionsServiceImpl(mcoptions::cache::SharedResultCache* cache = nullptr,
+                                  mcoptions::recorder::RequestRecorder* recorder = nullptr,
+                                  bool market_data = true)
+        : cache_(cache), recorder_(recorder), market_data_(market_data) {}
+    
     Status PriceEuropeanCall(ServerContext* context,
                             const mcoptions::EuropeanRequest* request,
                             mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceEuropeanCall", *request, response);
         mcoptions::logging::log_request("PriceEuropeanCall", 
             mcoptions::handlers::format_european_params(request));
         
@@ -43,6 +59,7 @@ public:
     Status PriceEuropeanPut(ServerContext* context,
                            const mcoptions::EuropeanRequest* request,
                            mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceEuropeanPut", *request, response);
         mcoptions::logging::log_request("PriceEuropeanPut", 
             mcoptions::handlers::format_european_params(request));
         
@@ -67,6 +84,7 @@ public:
     Status PriceAmericanCall(ServerContext* context,
                             const mcoptions::AmericanRequest* request,
                             mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceAmericanCall", *request, response);
         mcoptions::logging::log_request("PriceAmericanCall", 
             mcoptions::handlers::format_american_params(request));
         
@@ -92,6 +110,7 @@ public:
     Status PriceAmericanPut(ServerContext* context,
                            const mcoptions::AmericanRequest* request,
                            mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceAmericanPut", *request, response);
         mcoptions::logging::log_request("PriceAmericanPut", 
             mcoptions::handlers::format_american_params(request));
         
@@ -117,6 +136,7 @@ public:
     Status PriceAsianCall(ServerContext* context,
                          const mcoptions::AsianRequest* request,
                          mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceAsianCall", *request, response);
         mcoptions::logging::log_request("PriceAsianCall", 
             mcoptions::handlers::format_asian_params(request));
         
@@ -142,6 +162,7 @@ public:
     Status PriceAsianPut(ServerContext* context,
                         const mcoptions::AsianRequest* request,
                         mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceAsianPut", *request, response);
         mcoptions::logging::log_request("PriceAsianPut", 
             mcoptions::handlers::format_asian_params(request));
         
@@ -167,6 +188,7 @@ public:
     Status PriceBarrierCall(ServerContext* context,
                            const mcoptions::BarrierRequest* request,
                            mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceBarrierCall", *request, response);
         mcoptions::logging::log_request("PriceBarrierCall", 
             mcoptions::handlers::format_barrier_params(request));
         
@@ -193,6 +215,7 @@ public:
     Status PriceBarrierPut(ServerContext* context,
                           const mcoptions::BarrierRequest* request,
                           mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceBarrierPut", *request, response);
         mcoptions::logging::log_request("PriceBarrierPut", 
             mcoptions::handlers::format_barrier_params(request));
         
@@ -219,6 +242,7 @@ public:
     Status PriceLookbackCall(ServerContext* context,
                             const mcoptions::LookbackRequest* request,
                             mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceLookbackCall", *request, response);
         mcoptions::logging::log_request("PriceLookbackCall", 
             mcoptions::handlers::format_lookback_params(request));
         
@@ -244,6 +268,7 @@ public:
     Status PriceLookbackPut(ServerContext* context,
                            const mcoptions::LookbackRequest* request,
                            mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceLookbackPut", *request, response);
         mcoptions::logging::log_request("PriceLookbackPut", 
             mcoptions::handlers::format_lookback_params(request));
         
@@ -269,6 +294,7 @@ public:
     Status PriceBermudanCall(ServerContext* context,
                             const mcoptions::BermudanRequest* request,
                             mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceBermudanCall", *request, response);
         mcoptions::logging::log_request("PriceBermudanCall", 
             mcoptions::handlers::format_bermudan_params(request));
         
@@ -295,6 +321,7 @@ public:
     Status PriceBermudanPut(ServerContext* context,
                            const mcoptions::BermudanRequest* request,
                            mcoptions::PriceResponse* response) override {
+        auto recording = record("PriceBermudanPut", *request, response);
         mcoptions::logging::log_request("PriceBermudanPut", 
             mcoptions::handlers::format_bermudan_params(request));
         
@@ -321,6 +348,7 @@ public:
     Status PriceBatch(ServerContext* context,
                      const mcoptions::BatchRequest* request,
                      mcoptions::BatchResponse* response) override {
+        auto recording = record("PriceBatch", *request, response);
         mcoptions::logging::log_request("PriceBatch", 
             "Calls=" + std::to_string(request->european_calls_size()) + 
             ", Puts=" + std::to_string(request->european_puts_size()));
@@ -329,16 +357,163 @@ public:
         auto ctx = mco_context_new();
         mcoptions::handlers::apply_config(ctx, request->config());
         
+        // One engine job for the whole batch so the options spread over the pool
+        std::vector<mco_instrument_t> instruments;
+        instruments.reserve(request->european_calls_size() + request->european_puts_size());
         for (const auto& req : request->european_calls()) {
-            double price = mco_european_call(ctx, req.spot(), req.strike(),
-                req.rate(), req.volatility(), req.time_to_maturity());
-            response->add_european_call_prices(price);
+            instruments.push_back(mcoptions::handlers::to_mco_european(req, MCO_CALL));
         }
-        
         for (const auto& req : request->european_puts()) {
-            double price = mco_european_put(ctx, req.spot(), req.strike(),
-                req.rate(), req.volatility(), req.time_to_maturity());
-            response->add_european_put_prices(price);
+            instruments.push_back(mcoptions::handlers::to_mco_european(req, MCO_PUT));
+        }
+        std::vector<mco_price_result_t> results(instruments.size());
+        mco_price_instruments(ctx, instruments.data(), instruments.size(), results.data());
+        
+        for (size_t i = 0; i < results.size(); ++i) {
+            double price = results[i].status == MCO_OK ? results[i].price : -1.0;
+            if (i < static_cast<size_t>(request->european_calls_size())) {
+                response->add_european_call_prices(price);
+            } else {
+                response->add_european_put_prices(price);
+            }
+        }
+        
+        mco_context_free(ctx);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        
+        response->set_total_computation_time_ms(duration.count());
+        mcoptions::logging::log_batch_complete(duration.count());
+        
+        return Status::OK;
+    }
+    
+    Status Price(ServerContext* context,
+                const mcoptions::AutoPriceRequest* request,
+                mcoptions::AutoPriceResponse* response) override {
+        auto recording = record("Price", *request, response);
+        mcoptions::logging::log_request("Price", 
+            mcoptions::handlers::format_auto_params(request));
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        mco_price_result_t result = {};
+        mcoptions::cache::CacheKey key{};
+        bool hit = cache_lookup("Price", request->SerializeAsString(), &key, &result);
+        int status = result.status;
+        if (!hit) {
+            auto ctx = mco_context_new();
+            mcoptions::handlers::apply_config(ctx, request->config());
+            status = mco_price(ctx, static_cast<int>(request->exercise_style()),
+                static_cast<int>(request->option_type()), request->spot(), request->strike(),
+                request->rate(), request->volatility(), request->time_to_maturity(),
+                request->tolerance(), &result);
+            mco_context_free(ctx);
+            if (cache_) cache_->store(key, result);
+        } else {
+            mcoptions::logging::log_cache_hits(1, 1);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        
+        response->set_computation_time_ms(duration.count());
+        mcoptions::handlers::fill_price_response(result, response);
+        if (status != MCO_OK) {
+            return Status::OK;
+        }
+        
+        mcoptions::logging::log_method_choice(mcoptions::handlers::method_name(result.method),
+            result.num_steps, result.num_paths);
+        mcoptions::logging::log_result(result.price, duration.count());
+        
+        return Status::OK;
+    }
+    
+    Status PriceInstrument(ServerContext* context,
+                          const mcoptions::InstrumentRequest* request,
+                          mcoptions::AutoPriceResponse* response) override {
+        auto recording = record("PriceInstrument", *request, response);
+        mcoptions::logging::log_request("PriceInstrument", 
+            mcoptions::handlers::format_instrument_params(request));
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        mco_price_result_t result = {};
+        mcoptions::cache::CacheKey key{};
+        bool hit = cache_lookup("Instrument",
+            request->instrument().SerializeAsString() + request->config().SerializeAsString(),
+            &key, &result);
+        int status = result.status;
+        if (!hit) {
+            auto ctx = mco_context_new();
+            mcoptions::handlers::apply_config(ctx, request->config());
+            mco_instrument_t instrument = mcoptions::handlers::to_mco_instrument(request->instrument());
+            status = mco_price_instrument(ctx, &instrument, &result);
+            mco_context_free(ctx);
+            if (cache_) cache_->store(key, result);
+        } else {
+            mcoptions::logging::log_cache_hits(1, 1);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        
+        response->set_computation_time_ms(duration.count());
+        mcoptions::handlers::fill_price_response(result, response);
+        if (status != MCO_OK) {
+            return Status::OK;
+        }
+        
+        mcoptions::logging::log_method_choice(mcoptions::handlers::method_name(result.method),
+            result.num_steps, result.num_paths);
+        mcoptions::logging::log_result(result.price, duration.count());
+        
+        return Status::OK;
+    }
+    
+    Status PriceInstruments(ServerContext* context,
+                           const mcoptions::InstrumentBatchRequest* request,
+                           mcoptions::InstrumentBatchResponse* response) override {
+        auto recording = record("PriceInstruments", *request, response);
+        mcoptions::logging::log_request("PriceInstruments", 
+            "Instruments=" + std::to_string(request->instruments_size()));
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        auto ctx = mco_context_new();
+        mcoptions::handlers::apply_config(ctx, request->config());
+        
+        std::vector<mco_instrument_t> instruments;
+        instruments.reserve(request->instruments_size());
+        for (const auto& inst : request->instruments()) {
+            instruments.push_back(mcoptions::handlers::to_mco_instrument(inst));
+        }
+        std::vector<mco_price_result_t> results(instruments.size());
+        
+        // Cache hits stay in the batch as invalid placeholders that fail at
+        // once, so the other instruments keep their positions and with them
+        // their random streams
+        std::vector<mcoptions::cache::CacheKey> keys(cache_ ? instruments.size() : 0);
+        std::vector<mco_price_result_t> cached(keys.size());
+        std::vector<char> hits(keys.size(), 0);
+        std::string config = cache_ ? request->config().SerializeAsString() : std::string();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            hits[i] = cache_lookup("Instrument",
+                request->instruments(static_cast<int>(i)).SerializeAsString() + config,
+                &keys[i], &cached[i]);
+            if (hits[i]) instruments[i].kind = -1;
+        }
+        mco_price_instruments_from(ctx, instruments.data(), instruments.size(),
+                                   request->first_index(), results.data());
+        size_t num_hits = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (hits[i]) {
+                results[i] = cached[i];
+                ++num_hits;
+            } else {
+                cache_->store(keys[i], results[i]);
+            }
+        }
+        if (num_hits > 0) mcoptions::logging::log_cache_hits(num_hits, results.size());
+        
+        for (const auto& result : results) {
+            mcoptions::handlers::fill_price_response(result, response->add_results());
         }
         
         mco_context_free(ctx);
@@ -350,6 +525,144 @@ public:
         
         return Status::OK;
     }
+    
+    Status UpdateMarketData(ServerContext* context,
+                           const mcoptions::MarketDataUpdate* request,
+                           mcoptions::MarketDataAck* response) override {
+        auto recording = record("UpdateMarketData", *request, response);
+        if (!market_data_) return market_data_unavailable(recording);
+        mcoptions::logging::log_request("UpdateMarketData", 
+            "Objects=" + std::to_string(request->objects_size()));
+        
+        std::string error;
+        uint64_t version = market_.update(*request, &error);
+        response->set_version(version);
+        if (version == 0) {
+            response->set_error_message(error);
+            mcoptions::logging::log_market_update(0, error);
+            return Status::OK;
+        }
+        
+        mcoptions::logging::log_market_update(version, "");
+        return Status::OK;
+    }
+    
+    Status PriceWithMarket(ServerContext* context,
+                          const mcoptions::MarketInstrumentRequest* request,
+                          mcoptions::AutoPriceResponse* response) override {
+        auto recording = record("PriceWithMarket", *request, response);
+        if (!market_data_) return market_data_unavailable(recording);
+        const mcoptions::MarketInstrument& item = request->instrument();
+        mcoptions::logging::log_request("PriceWithMarket", 
+            std::string(mcoptions::handlers::instrument_name(item.instrument().kind())) + " | " +
+            mcoptions::market::format_market_refs(item.market()) + " | " +
+            mcoptions::logging::format_config(request->config()));
+        
+        auto start = std::chrono::high_resolution_clock::now();
+        mcoptions::market::ResolvedMarket market;
+        uint64_t version;
+        std::string error;
+        if (!market_.resolve(item, &market, &version, &error)) {
+            response->set_error_message(error);
+            return Status::OK;
+        }
+        
+        auto ctx = mco_context_new();
+        mcoptions::handlers::apply_config(ctx, request->config());
+        mcoptions::market::apply_model(market, ctx);
+        
+        mco_instrument_t instrument = mcoptions::handlers::to_mco_instrument(item.instrument());
+        mcoptions::market::apply_market(market, &instrument);
+        mco_price_result_t result;
+        int status = mco_price_instrument(ctx, &instrument, &result);
+        
+        mco_context_free(ctx);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        
+        response->set_computation_time_ms(duration.count());
+        mcoptions::handlers::fill_price_response(result, response);
+        if (status != MCO_OK) {
+            return Status::OK;
+        }
+        
+        mcoptions::logging::log_method_choice(mcoptions::handlers::method_name(result.method),
+            result.num_steps, result.num_paths);
+        mcoptions::logging::log_result(result.price, duration.count());
+        
+        return Status::OK;
+    }
+    
+    // Streams a price for every entry, then waits for market updates and
+    // streams new prices for the entries whose referenced objects changed.
+    // Runs until the client cancels or the server shuts down.
+    Status Subscribe(ServerContext* context,
+                    const mcoptions::SubscriptionRequest* request,
+                    ServerWriter<mcoptions::PriceUpdate>* writer) override {
+        auto recording = record("Subscribe", *request, nullptr);
+        if (!market_data_) return market_data_unavailable(recording);
+        mcoptions::logging::log_request("Subscribe", 
+            "Instruments=" + std::to_string(request->instruments_size()) + " | " +
+            mcoptions::logging::format_config(request->config()));
+        
+        mcoptions::market::Subscription subscription(market_, *request);
+        uint64_t seen = market_.version();
+        std::vector<size_t> affected(subscription.size());
+        for (size_t i = 0; i < affected.size(); ++i) affected[i] = i;
+        
+        while (!context->IsCancelled()) {
+            if (!affected.empty()) {
+                auto start = std::chrono::high_resolution_clock::now();
+                for (size_t index : affected) {
+                    mcoptions::PriceUpdate update;
+                    subscription.reprice(index, &update);
+                    if (!writer->Write(update)) {
+                        return Status::OK;  // Client went away
+                    }
+                }
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+                mcoptions::logging::log_repricing(affected.size(), subscription.size(), duration.count());
+            }
+            
+            // Short waits so cancellation and shutdown are noticed promptly
+            uint64_t version = market_.wait_for_update(seen, std::chrono::milliseconds(250));
+            if (version == seen) {
+                affected.clear();
+                continue;
+            }
+            seen = version;
+            affected = subscription.affected();
+        }
+        
+        return Status::OK;
+    }
+
+private:
+    mcoptions::recorder::Recording record(const char* method,
+                                          const google::protobuf::Message& request,
+                                          const google::protobuf::Message* response) {
+        return mcoptions::recorder::Recording(recorder_, method, request, response);
+    }
+    
+    static Status market_data_unavailable(mcoptions::recorder::Recording& recording) {
+        recording.set_status(grpc::StatusCode::FAILED_PRECONDITION);
+        return Status(grpc::StatusCode::FAILED_PRECONDITION,
+                      "Market data is not served with --workers: each worker would have its own store");
+    }
+    
+    // Hashes the request bytes into *key and looks it up; false without a cache
+    bool cache_lookup(const char* tag, const std::string& bytes,
+                      mcoptions::cache::CacheKey* key, mco_price_result_t* result) {
+        if (!cache_) return false;
+        *key = mcoptions::cache::hash_key(tag, bytes);
+        return cache_->lookup(*key, result);
+    }
+    
+    mcoptions::market::MarketDataStore market_;
+    mcoptions::cache::SharedResultCache* cache_;
+    mcoptions::recorder::RequestRecorder* recorder_;
+    bool market_data_;
 };
 
 #endif
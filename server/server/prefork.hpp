@@ -0,0 +1,226 @@
+#ifndef MCOPTIONS_PREFORK_HPP
+#define MCOPTIONS_PREFORK_HPP
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace mcoptions {
+namespace prefork {
+
+/**
+ * Pre-fork mode: a supervisor process forks N workers that each run a full
+ * server on the same port (the kernel balances connections across their
+ * SO_REUSEPORT listeners) and restarts any worker that dies.
+ *
+ * The supervisor must not touch gRPC or the pricing library before forking:
+ * both start threads and cache the CPU topology, which a child would inherit
+ * in an unusable state. Each worker pins itself to its CPU set first, so the
+ * library then sees only those CPUs (--threads 0 means the worker's CPUs).
+ */
+
+// Parses sysfs cpu lists such as "0-3,8-11"
+inline std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+// Allowed CPUs grouped by NUMA node; one group when sysfs has no nodes
+inline std::vector<std::vector<int>> node_cpu_sets() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        for (int cpu = 0; cpu < static_cast<int>(std::thread::hardware_concurrency()); ++cpu) {
+            CPU_SET(cpu, &allowed);
+        }
+    }
+
+    std::vector<std::vector<int>> nodes;
+    for (int node = 0; node < 1024; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) continue;
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(line)) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) nodes.push_back(std::move(cpus));
+    }
+    if (nodes.empty()) {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        nodes.push_back(std::move(cpus));
+    }
+    return nodes;
+}
+
+/*
+ * CPU set of each worker. With at least as many workers as nodes, workers
+ * go round-robin to nodes and split their node's CPUs evenly, so no worker
+ * straddles two nodes. With fewer, each worker takes whole nodes. A worker
+ * that would get no CPU (more workers than CPUs) shares its node's CPUs.
+ */
+inline std::vector<std::vector<int>> worker_cpu_sets(size_t workers) {
+    std::vector<std::vector<int>> nodes = node_cpu_sets();
+    std::vector<std::vector<int>> sets(workers);
+    if (workers < nodes.size()) {
+        for (size_t node = 0; node < nodes.size(); ++node) {
+            auto& set = sets[node % workers];
+            set.insert(set.end(), nodes[node].begin(), nodes[node].end());
+        }
+        return sets;
+    }
+    for (size_t node = 0; node < nodes.size(); ++node) {
+        std::vector<size_t> members;
+        for (size_t w = node; w < workers; w += nodes.size()) members.push_back(w);
+        const auto& cpus = nodes[node];
+        for (size_t m = 0; m < members.size(); ++m) {
+            size_t begin = m * cpus.size() / members.size();
+            size_t end = (m + 1) * cpus.size() / members.size();
+            if (begin == end) {
+                sets[members[m]] = cpus;
+            } else {
+                sets[members[m]].assign(cpus.begin() + begin, cpus.begin() + end);
+            }
+        }
+    }
+    return sets;
+}
+
+inline bool pin_process(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+inline std::string format_cpus(const std::vector<int>& cpus) {
+    std::stringstream ss;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (i > 0) ss << ",";
+        ss << cpus[i];
+        if (j > i) ss << "-" << cpus[j];
+        i = j + 1;
+    }
+    return ss.str();
+}
+
+namespace detail {
+
+inline volatile std::sig_atomic_t& stop_requested() {
+    static volatile std::sig_atomic_t flag = 0;
+    return flag;
+}
+
+inline void on_stop_signal(int) { stop_requested() = 1; }
+
+} // namespace detail
+
+/*
+ * Forks `workers` processes running run_worker(index) and restarts any that
+ * exits before shutdown. SIGINT / SIGTERM stop the supervisor, which passes
+ * SIGTERM on and waits for every worker. A worker that dies within a second
+ * of starting is restarted after a one-second pause, so a worker that cannot
+ * start does not spin the supervisor.
+ */
+inline int supervise(size_t workers, const std::function<int(size_t)>& run_worker) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<pid_t> pids(workers, -1);
+    std::vector<Clock::time_point> started(workers);
+
+    struct sigaction action = {};
+    action.sa_handler = detail::on_stop_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    auto spawn = [&](size_t index) {
+        std::cout.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::signal(SIGINT, SIG_DFL);
+            std::signal(SIGTERM, SIG_DFL);
+            std::cout.flush();
+            _exit(run_worker(index));
+        }
+        if (pid < 0) {
+            std::cerr << "fork failed for worker " << index << std::endl;
+            return;
+        }
+        pids[index] = pid;
+        started[index] = Clock::now();
+    };
+
+    for (size_t i = 0; i < workers; ++i) spawn(i);
+
+    size_t alive = workers;
+    bool forwarded = false;
+    while (alive > 0) {
+        if (detail::stop_requested() && !forwarded) {
+            for (pid_t child : pids) {
+                if (child > 0) kill(child, SIGTERM);
+            }
+            forwarded = true;
+        }
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno != EINTR) break;
+            continue;
+        }
+
+        size_t index = 0;
+        while (index < workers && pids[index] != pid) ++index;
+        if (index == workers) continue;
+        pids[index] = -1;
+        --alive;
+        if (detail::stop_requested()) continue;
+
+        std::cerr << "Worker " << index << " (pid " << pid << ") ";
+        if (WIFSIGNALED(status)) std::cerr << "killed by signal " << WTERMSIG(status);
+        else std::cerr << "exited with status " << WEXITSTATUS(status);
+        std::cerr << ", restarting" << std::endl;
+
+        if (Clock::now() - started[index] < std::chrono::seconds(1)) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            if (detail::stop_requested()) continue;
+        }
+        spawn(index);
+        if (pids[index] > 0) ++alive;
+    }
+    return 0;
+}
+
+} // namespace prefork
+} // namespace mcoptions
+
+#endif
@@ -10,19 +10,37 @@
 namespace mcoptions {
 namespace handlers {
 
+// Engine settings from the command line; written once in main() before serving
+struct EngineSettings {
+    size_t num_threads = 1;
+    int affinity = MCO_AFFINITY_NONE;
+};
+
+inline EngineSettings& engine_settings() {
+    static EngineSettings settings;
+    return settings;
+}
+
 inline void apply_config(mco_context_t* ctx, const SimulationConfig& config) {
+    const EngineSettings& engine = engine_settings();
+    mco_context_set_num_threads(ctx, engine.num_threads);
+    mco_context_set_thread_affinity(ctx, engine.affinity);
+
     if (config.num_simulations() > 0) {
         mco_context_set_num_simulations(ctx, config.num_simulations());
     }
     if (config.num_steps() > 0) {
         mco_context_set_num_steps(ctx, config.num_steps());
     }
-    if (config.seed() > 0) {
+    if (config.has_seed()) {
         mco_context_set_seed(ctx, config.seed());
     }
     mco_context_set_antithetic(ctx, config.antithetic_enabled());
     mco_context_set_control_variates(ctx, config.control_variates_enabled());
     mco_context_set_stratified_sampling(ctx, config.stratified_sampling_enabled());
+    mco_context_set_reproducible(ctx, config.reproducible());
+    mco_context_set_stream_mode(ctx, config.sequential_stream() ? MCO_STREAM_SEQUENTIAL
+                                                                : MCO_STREAM_BLOCKS);
 }
 
 inline std::string format_european_params(const EuropeanRequest* request) {
@@ -84,6 +102,169 @@ inline std::string format_bermudan_params(const BermudanRequest* request) {
     return ss.str();
 }
 
+inline std::string format_auto_params(const AutoPriceRequest* request) {
+    std::stringstream ss;
+    ss << (request->exercise_style() == EXERCISE_AMERICAN ? "American" : "European")
+       << " " << (request->option_type() == OPTION_PUT ? "Put" : "Call")
+       << ", S=" << request->spot() << ", K=" << request->strike() 
+       << ", r=" << request->rate() << ", σ=" << request->volatility() 
+       << ", T=" << request->time_to_maturity() 
+       << ", Tol=" << request->tolerance() << " | " 
+       << logging::format_config(request->config());
+    return ss.str();
+}
+
+inline const char* instrument_name(int kind) {
+    switch (kind) {
+        case MCO_INSTRUMENT_EUROPEAN: return "European";
+        case MCO_INSTRUMENT_AMERICAN: return "American";
+        case MCO_INSTRUMENT_ASIAN: return "Asian";
+        case MCO_INSTRUMENT_BARRIER: return "Barrier";
+        case MCO_INSTRUMENT_LOOKBACK: return "Lookback";
+        case MCO_INSTRUMENT_BERMUDAN: return "Bermudan";
+        case MCO_INSTRUMENT_DOUBLE_BARRIER: return "Double Barrier";
+        case MCO_INSTRUMENT_WINDOW_BARRIER: return "Window Barrier";
+        case MCO_INSTRUMENT_PARISIAN: return "Parisian";
+        case MCO_INSTRUMENT_AUTOCALLABLE: return "Autocallable";
+        case MCO_INSTRUMENT_FORWARD_START: return "Forward Start";
+        case MCO_INSTRUMENT_CLIQUET: return "Cliquet";
+        default: return "Unknown";
+    }
+}
+
+inline std::string format_instrument_params(const InstrumentRequest* request) {
+    const Instrument& inst = request->instrument();
+    std::stringstream ss;
+    ss << instrument_name(inst.kind())
+       << " " << (inst.option_type() == OPTION_PUT ? "Put" : "Call")
+       << ", S=" << inst.spot() << ", K=" << inst.strike() 
+       << ", r=" << inst.rate() << ", σ=" << inst.volatility() 
+       << ", T=" << inst.time_to_maturity() 
+       << ", Method=" << inst.method() << " | " 
+       << logging::format_config(request->config());
+    return ss.str();
+}
+
+// Descriptor for a legacy European request, priced by Monte Carlo like
+// mco_european_call / mco_european_put
+inline mco_instrument_t to_mco_european(const EuropeanRequest& request, int option_type) {
+    mco_instrument_t out = {};
+    out.kind = MCO_INSTRUMENT_EUROPEAN;
+    out.option_type = option_type;
+    out.method = MCO_METHOD_MONTE_CARLO;
+    out.spot = request.spot();
+    out.strike = request.strike();
+    out.rate = request.rate();
+    out.volatility = request.volatility();
+    out.time_to_maturity = request.time_to_maturity();
+    return out;
+}
+
+// The returned descriptor borrows date arrays from `inst`, which must
+// outlive the pricing call
+inline mco_instrument_t to_mco_instrument(const Instrument& inst) {
+    mco_instrument_t out = {};
+    out.kind = static_cast<int>(inst.kind());
+    out.option_type = static_cast<int>(inst.option_type());
+    out.method = static_cast<int>(inst.method());
+    out.spot = inst.spot();
+    out.strike = inst.strike();
+    out.rate = inst.rate();
+    out.volatility = inst.volatility();
+    out.time_to_maturity = inst.time_to_maturity();
+    out.tolerance = inst.tolerance();
+    
+    switch (inst.kind()) {
+        case INSTRUMENT_AMERICAN:
+            out.params.american.num_exercise_points = inst.num_exercise_points();
+            break;
+        case INSTRUMENT_ASIAN:
+            out.params.asian.num_observations = inst.num_observations();
+            break;
+        case INSTRUMENT_BARRIER:
+            out.params.barrier.barrier_level = inst.barrier_level();
+            out.params.barrier.barrier_type = static_cast<int>(inst.barrier_type());
+            out.params.barrier.rebate = inst.rebate();
+            out.params.barrier.continuous = inst.continuous_monitoring() ? 1 : 0;
+            break;
+        case INSTRUMENT_LOOKBACK:
+            out.params.lookback.fixed_strike = inst.fixed_strike() ? 1 : 0;
+            out.params.lookback.continuous = inst.continuous_monitoring() ? 1 : 0;
+            break;
+        case INSTRUMENT_BERMUDAN:
+            out.params.bermudan.exercise_dates = inst.exercise_dates().data();
+            out.params.bermudan.num_dates = inst.exercise_dates_size();
+            break;
+        case INSTRUMENT_DOUBLE_BARRIER:
+            out.params.double_barrier.lower_barrier = inst.lower_barrier();
+            out.params.double_barrier.upper_barrier = inst.upper_barrier();
+            out.params.double_barrier.knock_in = inst.knock_in() ? 1 : 0;
+            out.params.double_barrier.rebate = inst.rebate();
+            break;
+        case INSTRUMENT_WINDOW_BARRIER:
+            out.params.window_barrier.barrier_level = inst.barrier_level();
+            out.params.window_barrier.barrier_type = static_cast<int>(inst.barrier_type());
+            out.params.window_barrier.window_start = inst.window_start();
+            out.params.window_barrier.window_end = inst.window_end();
+            out.params.window_barrier.rebate = inst.rebate();
+            break;
+        case INSTRUMENT_PARISIAN:
+            out.params.parisian.barrier_level = inst.barrier_level();
+            out.params.parisian.barrier_type = static_cast<int>(inst.barrier_type());
+            out.params.parisian.window = inst.excursion_window();
+            out.params.parisian.rebate = inst.rebate();
+            break;
+        case INSTRUMENT_AUTOCALLABLE:
+            out.params.autocallable.notional = inst.notional();
+            out.params.autocallable.autocall_barrier = inst.autocall_barrier();
+            out.params.autocallable.coupon_barrier = inst.coupon_barrier();
+            out.params.autocallable.coupon_rate = inst.coupon_rate();
+            out.params.autocallable.memory = inst.memory() ? 1 : 0;
+            out.params.autocallable.knock_in_barrier = inst.knock_in_barrier();
+            out.params.autocallable.put_strike = inst.put_strike();
+            out.params.autocallable.observation_dates = inst.observation_dates().data();
+            out.params.autocallable.num_observations = inst.observation_dates_size();
+            break;
+        case INSTRUMENT_FORWARD_START:
+            out.params.forward_start.start_time = inst.start_time();
+            break;
+        case INSTRUMENT_CLIQUET:
+            out.params.cliquet.reset_dates = inst.reset_dates().data();
+            out.params.cliquet.num_resets = inst.reset_dates_size();
+            out.params.cliquet.local_floor = inst.local_floor();
+            out.params.cliquet.local_cap = inst.local_cap();
+            out.params.cliquet.global_floor = inst.global_floor();
+            out.params.cliquet.global_cap = inst.global_cap();
+            out.params.cliquet.notional = inst.notional();
+            break;
+        default:
+            break;
+    }
+    return out;
+}
+
+inline void fill_price_response(const mco_price_result_t& result, AutoPriceResponse* response) {
+    if (result.status != MCO_OK) {
+        response->set_error_message("Pricing failed (status " + std::to_string(result.status) + ")");
+        return;
+    }
+    response->set_price(result.price);
+    response->set_error_estimate(result.error_estimate);
+    response->set_method(static_cast<PricingMethod>(result.method));
+    response->set_num_paths(result.num_paths);
+    response->set_num_steps(result.num_steps);
+}
+
+inline const char* method_name(int method) {
+    switch (method) {
+        case MCO_METHOD_ANALYTIC: return "Analytic";
+        case MCO_METHOD_BINOMIAL_TREE: return "Binomial Tree";
+        case MCO_METHOD_MONTE_CARLO: return "Monte Carlo";
+        case MCO_METHOD_LSM: return "LSM";
+        default: return "Auto";
+    }
+}
+
 } // namespace handlers
 } // namespace mcoptions
 
@@ -0,0 +1,291 @@
+#ifndef MCOPTIONS_REQUEST_RECORDER_HPP
+#define MCOPTIONS_REQUEST_RECORDER_HPP
+
+#include <google/protobuf/message.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace mcoptions {
+namespace recorder {
+
+/**
+ * Capture of the requests a server receives, for client/replay.cpp
+ *
+ * Handlers append one record per call to an in-memory buffer; a background
+ * thread writes the buffer out every 100 ms or once it holds 1 MB, so a
+ * handler pays for serialising its messages and one short lock, never for
+ * I/O. If the disk falls behind and the buffer reaches its limit, records
+ * are dropped (and counted) rather than slow the server down.
+ *
+ * File layout, little-endian as written by the host:
+ *
+ *   FileHeader                                       24 bytes
+ *   per call: RecordHeader                           32 bytes
+ *             method name, request bytes, response bytes
+ *
+ * Arrival is when the handler started, relative to the start of the
+ * recording; service time is the handler's own time. The status is the
+ * grpc::StatusCode the handler returned (0 = OK; files written before it
+ * was recorded read as all OK). A streaming call (Subscribe) is recorded
+ * with an empty response when its stream ends.
+ */
+
+constexpr char RECORDING_MAGIC[8] = {'M', 'C', 'O', 'R', 'E', 'C', 'O', 'D'};
+constexpr uint32_t RECORDING_VERSION = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t start_unix_ns;     // Wall clock at the start of the recording
+};
+
+struct RecordHeader {
+    uint64_t arrival_ns;       // Since start_unix_ns
+    uint64_t service_ns;
+    uint32_t method_size;
+    uint32_t request_size;
+    uint32_t response_size;
+    uint32_t status_code;      // grpc::StatusCode returned by the handler
+};
+
+static_assert(sizeof(FileHeader) == 24, "FileHeader layout is part of the file format");
+static_assert(sizeof(RecordHeader) == 32, "RecordHeader layout is part of the file format");
+
+struct RecorderStats {
+    uint64_t records;
+    uint64_t dropped;
+    uint64_t bytes;
+};
+
+class RequestRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // `max_buffer` bounds the bytes waiting for the writer thread
+    explicit RequestRecorder(const std::string& path, size_t max_buffer = 64 << 20)
+        : path_(path), max_buffer_(max_buffer), start_(Clock::now()) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) throw std::runtime_error("Could not open recording " + path);
+        FileHeader header = {};
+        std::memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+        header.version = RECORDING_VERSION;
+        header.start_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        std::fwrite(&header, sizeof(header), 1, file_);
+        bytes_ = sizeof(header);
+        writer_ = std::thread([this] { write_loop(); });
+    }
+
+    RequestRecorder(const RequestRecorder&) = delete;
+    RequestRecorder& operator=(const RequestRecorder&) = delete;
+
+    // Writes out everything recorded so far
+    ~RequestRecorder() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        writer_.join();
+        std::fclose(file_);
+    }
+
+    // `response` may be null (streaming calls)
+    void record(const char* method, Clock::time_point arrival, Clock::time_point done,
+                const google::protobuf::Message& request,
+                const google::protobuf::Message* response, uint32_t status_code = 0) {
+        // Serialised outside the lock, into a buffer each thread keeps
+        thread_local std::string scratch;
+        size_t method_size = std::strlen(method);
+        size_t request_size = request.ByteSizeLong();
+        size_t response_size = response ? response->ByteSizeLong() : 0;
+        scratch.resize(sizeof(RecordHeader) + method_size + request_size + response_size);
+
+        RecordHeader header = {};
+        header.arrival_ns = nanoseconds(arrival - start_);
+        header.service_ns = nanoseconds(done - arrival);
+        header.method_size = static_cast<uint32_t>(method_size);
+        header.request_size = static_cast<uint32_t>(request_size);
+        header.response_size = static_cast<uint32_t>(response_size);
+        header.status_code = status_code;
+        char* out = &scratch[0];
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        std::memcpy(out, method, method_size);
+        out += method_size;
+        request.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(out));
+        out += request_size;
+        if (response) response->SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(out));
+
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_.size() + scratch.size() > max_buffer_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            pending_.append(scratch);
+            wake = pending_.size() >= kFlushBytes;
+        }
+        records_.fetch_add(1, std::memory_order_relaxed);
+        if (wake) wake_.notify_one();
+    }
+
+    RecorderStats stats() const {
+        return RecorderStats{records_.load(std::memory_order_relaxed),
+                             dropped_.load(std::memory_order_relaxed),
+                             bytes_.load(std::memory_order_relaxed)};
+    }
+
+    const std::string& path() const { return path_; }
+
+private:
+    static constexpr size_t kFlushBytes = 1 << 20;
+
+    static uint64_t nanoseconds(Clock::duration d) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    void write_loop() {
+        std::string batch;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait_for(lock, std::chrono::milliseconds(100),
+                           [this] { return stopping_ || pending_.size() >= kFlushBytes; });
+            batch.swap(pending_);
+            bool last = stopping_;
+            lock.unlock();
+            if (!batch.empty()) {
+                std::fwrite(batch.data(), 1, batch.size(), file_);
+                std::fflush(file_);
+                bytes_.fetch_add(batch.size(), std::memory_order_relaxed);
+                batch.clear();
+            }
+            lock.lock();
+            if (last && pending_.empty()) return;
+        }
+    }
+
+    std::string path_;
+    size_t max_buffer_;
+    Clock::time_point start_;
+    std::FILE* file_ = nullptr;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::string pending_;
+    bool stopping_ = false;
+    std::thread writer_;
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> bytes_{0};
+};
+
+/**
+ * Records one call when it goes out of scope
+ *
+ *     auto recording = record("Price", *request, response);
+ *
+ * A handler that fails sets the status code it returns, which is otherwise
+ * recorded as OK. Does nothing without a recorder.
+ */
+class Recording {
+public:
+    Recording(RequestRecorder* recorder, const char* method,
+              const google::protobuf::Message& request,
+              const google::protobuf::Message* response)
+        : recorder_(recorder), method_(method), request_(request), response_(response),
+          arrival_(recorder ? RequestRecorder::Clock::now() : RequestRecorder::Clock::time_point()) {}
+
+    Recording(const Recording&) = delete;
+    Recording& operator=(const Recording&) = delete;
+
+    ~Recording() {
+        if (!recorder_) return;
+        recorder_->record(method_, arrival_, RequestRecorder::Clock::now(), request_, response_,
+                          status_code_);
+    }
+
+    void set_status(int code) { status_code_ = static_cast<uint32_t>(code); }
+
+private:
+    RequestRecorder* recorder_;
+    const char* method_;
+    const google::protobuf::Message& request_;
+    const google::protobuf::Message* response_;
+    RequestRecorder::Clock::time_point arrival_;
+    uint32_t status_code_ = 0;
+};
+
+/**
+ * Sequential reader of a recording
+ */
+struct RecordedCall {
+    uint64_t arrival_ns;
+    uint64_t service_ns;
+    uint32_t status_code;
+    std::string method;
+    std::string request;
+    std::string response;
+};
+
+class RecordingReader {
+public:
+    explicit RecordingReader(const std::string& path) : path_(path) {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (!file_) throw std::runtime_error("Could not open recording " + path);
+        if (std::fread(&header_, sizeof(header_), 1, file_) != 1 ||
+            std::memcmp(header_.magic, RECORDING_MAGIC, sizeof(header_.magic)) != 0) {
+            std::fclose(file_);
+            throw std::runtime_error("Not a request recording: " + path);
+        }
+        if (header_.version != RECORDING_VERSION) {
+            std::fclose(file_);
+            throw std::runtime_error("Unsupported recording version: " + path);
+        }
+    }
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    ~RecordingReader() { std::fclose(file_); }
+
+    int64_t start_unix_ns() const { return header_.start_unix_ns; }
+
+    // False at the end; a record cut short by a crash also ends the file
+    bool next(RecordedCall& call) {
+        RecordHeader header;
+        if (std::fread(&header, sizeof(header), 1, file_) != 1) return false;
+        call.arrival_ns = header.arrival_ns;
+        call.service_ns = header.service_ns;
+        call.status_code = header.status_code;
+        return read(call.method, header.method_size) &&
+               read(call.request, header.request_size) &&
+               read(call.response, header.response_size);
+    }
+
+private:
+    bool read(std::string& out, uint32_t size) {
+        out.resize(size);
+        return size == 0 || std::fread(&out[0], 1, size, file_) == size;
+    }
+
+    std::string path_;
+    std::FILE* file_ = nullptr;
+    FileHeader header_;
+};
+
+} // namespace recorder
+} // namespace mcoptions
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef MCOPTIONS_RESULT_CACHE_HPP
+#define MCOPTIONS_RESULT_CACHE_HPP
+
+#include "mcoptions.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+
+namespace mcoptions {
+namespace cache {
+
+/**
+ * Price cache shared by every server process
+ *
+ * The table lives in an anonymous shared mapping created before the workers
+ * fork, so all of them read and fill the same entries. Only deterministic
+ * results are kept (no simulated paths): a Monte Carlo price depends on the
+ * stream position of its request and is not a function of the request alone.
+ *
+ * Entries are found by a 128-bit hash of the request bytes, in buckets of
+ * four. Each entry is a seqlock: a writer makes the sequence odd, writes and
+ * makes it even again; a reader retries nothing and treats an odd or moved
+ * sequence as a miss. Writers never wait either, so a worker that dies
+ * mid-write only loses that entry, it cannot block the others.
+ */
+
+struct CacheKey {
+    uint64_t hi;
+    uint64_t lo;
+};
+
+// Two independent 64-bit FNV-1a streams over the tag and the request bytes
+inline CacheKey hash_key(const char* tag, const std::string& bytes) {
+    uint64_t hi = 0xcbf29ce484222325ull;
+    uint64_t lo = 0x84222325cbf29ce4ull;
+    auto mix = [&](unsigned char c) {
+        hi = (hi ^ c) * 0x100000001b3ull;
+        lo = (lo ^ c) * 0x00000100000001b3ull + 0x9e3779b97f4a7c15ull;
+    };
+    for (const char* p = tag; *p; ++p) mix(static_cast<unsigned char>(*p));
+    mix(0);
+    for (char c : bytes) mix(static_cast<unsigned char>(c));
+    // Key (0, 0) marks an empty entry
+    if (hi == 0 && lo == 0) lo = 1;
+    return CacheKey{hi, lo};
+}
+
+inline bool cacheable(const mco_price_result_t& result) {
+    return result.status == MCO_OK && result.num_paths == 0;
+}
+
+struct CacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    size_t entries;
+};
+
+class SharedResultCache {
+public:
+    // `entries` is rounded up to a multiple of the bucket size
+    explicit SharedResultCache(size_t entries) {
+        if (entries == 0) throw std::invalid_argument("A cache needs at least one entry");
+        num_buckets_ = (entries + BUCKET - 1) / BUCKET;
+        bytes_ = sizeof(Header) + num_buckets_ * BUCKET * sizeof(Entry);
+        void* base = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) throw std::runtime_error("Could not map the result cache");
+        // Anonymous mappings are zero-filled: every entry starts empty and unlocked
+        header_ = new (base) Header;
+        entries_ = reinterpret_cast<Entry*>(static_cast<char*>(base) + sizeof(Header));
+    }
+
+    SharedResultCache(const SharedResultCache&) = delete;
+    SharedResultCache& operator=(const SharedResultCache&) = delete;
+
+    ~SharedResultCache() { munmap(header_, bytes_); }
+
+    bool lookup(const CacheKey& key, mco_price_result_t* result) {
+        Entry* bucket = bucket_of(key);
+        for (size_t i = 0; i < BUCKET; ++i) {
+            Entry& entry = bucket[i];
+            uint32_t before = entry.sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            CacheKey stored{entry.key_hi, entry.key_lo};
+            mco_price_result_t copy;
+            std::memcpy(&copy, &entry.result, sizeof(copy));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (entry.sequence.load(std::memory_order_relaxed) != before) continue;
+            if (stored.hi == key.hi && stored.lo == key.lo) {
+                *result = copy;
+                header_->hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        header_->misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Keeps the result if it is cacheable; skips the store rather than wait for a writer
+    void store(const CacheKey& key, const mco_price_result_t& result) {
+        if (!cacheable(result)) return;
+        Entry* bucket = bucket_of(key);
+        // Same key, then an empty entry, then a victim picked by the key's low bits
+        Entry* target = &bucket[(key.lo >> 32) % BUCKET];
+        for (size_t i = 0; i < BUCKET; ++i) {
+            if (bucket[i].key_hi == key.hi && bucket[i].key_lo == key.lo) {
+                target = &bucket[i];
+                break;
+            }
+            if (bucket[i].key_hi == 0 && bucket[i].key_lo == 0) {
+                target = &bucket[i];
+                break;
+            }
+        }
+
+        uint32_t sequence = target->sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) ||
+            !target->sequence.compare_exchange_strong(sequence, sequence + 1,
+                                                      std::memory_order_acquire)) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        target->key_hi = key.hi;
+        target->key_lo = key.lo;
+        std::memcpy(&target->result, &result, sizeof(result));
+        target->sequence.store(sequence + 2, std::memory_order_release);
+        header_->stores.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    CacheStats stats() const {
+        return CacheStats{header_->hits.load(std::memory_order_relaxed),
+                          header_->misses.load(std::memory_order_relaxed),
+                          header_->stores.load(std::memory_order_relaxed),
+                          num_buckets_ * BUCKET};
+    }
+
+private:
+    static constexpr size_t BUCKET = 4;
+
+    struct alignas(64) Header {
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> stores;
+    };
+
+    struct alignas(64) Entry {
+        std::atomic<uint32_t> sequence;
+        uint64_t key_hi;
+        uint64_t key_lo;
+        mco_price_result_t result;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared atomics must be lock-free");
+
+    Entry* bucket_of(const CacheKey& key) const {
+        return entries_ + (key.hi % num_buckets_) * BUCKET;
+    }
+
+    Header* header_ = nullptr;
+    Entry* entries_ = nullptr;
+    size_t num_buckets_ = 0;
+    size_t bytes_ = 0;
+};
+
+} // namespace cache
+} // namespace mcoptions
+
+#endif
@@ -0,0 +1,510 @@
+#ifndef MCOPTIONS_SHM_RING_HPP
+#define MCOPTIONS_SHM_RING_HPP
+
+#include "mcoptions.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace mcoptions {
+namespace shm {
+
+/**
+ * Shared-memory batch pricing channel for clients on the server's host
+ *
+ * A POSIX shared-memory segment holds a ring of request slots. A client
+ * claims a free slot, writes mco_instrument_t records straight into it and
+ * rings the doorbell. The server thread prices the slot in place with
+ * mco_price_instruments, so results land in the slot too and the client
+ * reads them where they are. Nothing is serialised and, while both sides
+ * are busy, nothing enters the kernel: each side spins briefly on the
+ * shared words and only then sleeps on them with a futex.
+ *
+ * Segment layout, all offsets from the start of the mapping:
+ *
+ *   RingHeader                                      64 bytes
+ *   num_slots x slot_bytes, each slot:
+ *     SlotHeader                                   128 bytes
+ *     slot_capacity x mco_instrument_t
+ *     slot_capacity x mco_price_result_t
+ *
+ * Both sides must use the same mcoptions.h. Instruments whose parameters
+ * point to caller memory (Bermudan, autocallable, cliquet) cannot cross
+ * the process boundary and are rejected with MCO_ERROR_INVALID_ARGUMENT.
+ *
+ * A server thread stamps the header with the monotonic clock every
+ * HEARTBEAT_PERIOD_MS. A client that finds server_alive cleared, or the
+ * stamp older than SERVER_TIMEOUT_MS, stops waiting with SERVER_LOST. That
+ * covers a server that crashed as well as one that restarted: the restart
+ * unlinks the name and creates a new segment, and the old mapping is never
+ * stamped again. Reconnect with a new RingClient.
+ */
+
+constexpr uint32_t RING_MAGIC = 0x524f434d;  // "MCOR"
+constexpr uint32_t RING_VERSION = 2;
+
+constexpr int64_t HEARTBEAT_PERIOD_MS = 100;
+constexpr int64_t SERVER_TIMEOUT_MS = 2000;
+
+// Status of RingClient calls once the server is gone; not an mco_status_t
+constexpr int SERVER_LOST = -100;
+
+// Slot states; a slot moves FREE -> WRITING -> REQUEST -> DONE -> FREE
+constexpr uint32_t SLOT_FREE = 0;
+constexpr uint32_t SLOT_WRITING = 1;   // Claimed by a client
+constexpr uint32_t SLOT_REQUEST = 2;   // Published to the server
+constexpr uint32_t SLOT_DONE = 3;      // Results written
+
+// Simulation settings of one slot; mirrors SimulationConfig
+struct RingConfig {
+    uint64_t num_simulations;   // 0 = library default
+    uint64_t num_steps;         // 0 = library default
+    uint64_t seed;
+    uint32_t has_seed;
+    uint32_t antithetic;
+    uint32_t control_variates;
+    uint32_t stratified_sampling;
+    uint32_t reproducible;
+    uint32_t sequential_stream;
+};
+
+struct alignas(64) RingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_slots;
+    uint32_t slot_capacity;     // Instruments per slot
+    uint64_t slot_bytes;
+    std::atomic<uint32_t> doorbell;         // Bumped after every publish
+    std::atomic<uint32_t> server_sleeping;  // Clients wake the server only when set
+    std::atomic<uint32_t> server_alive;
+    uint32_t reserved;
+    std::atomic<int64_t> heartbeat_ms;      // Monotonic clock of the last stamp
+};
+
+struct alignas(64) SlotHeader {
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> client_sleeping;  // The server wakes the client only when set
+    uint32_t count;
+    int32_t status;             // Batch status of mco_price_instruments
+    double compute_us;          // Server-side pricing time
+    RingConfig config;
+};
+
+static_assert(sizeof(RingHeader) == 64, "RingHeader is part of the wire layout");
+static_assert(sizeof(SlotHeader) == 128, "SlotHeader is part of the wire layout");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared atomics must be lock-free");
+static_assert(std::atomic<int64_t>::is_always_lock_free, "Shared atomics must be lock-free");
+
+// CLOCK_MONOTONIC is host-wide, so both sides read the same clock
+inline int64_t monotonic_ms() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+inline size_t slot_bytes(uint32_t capacity) {
+    size_t bytes = sizeof(SlotHeader) +
+                   capacity * (sizeof(mco_instrument_t) + sizeof(mco_price_result_t));
+    return (bytes + 63) / 64 * 64;
+}
+
+inline size_t segment_bytes(uint32_t num_slots, uint32_t capacity) {
+    return sizeof(RingHeader) + num_slots * slot_bytes(capacity);
+}
+
+inline bool crosses_processes(int kind) {
+    return kind == MCO_INSTRUMENT_BERMUDAN || kind == MCO_INSTRUMENT_AUTOCALLABLE ||
+           kind == MCO_INSTRUMENT_CLIQUET;
+}
+
+// Shared (not process-private) futex operations on a word of the mapping
+inline void futex_wait(std::atomic<uint32_t>* word, uint32_t expected, long timeout_us) {
+    timespec timeout{timeout_us / 1000000, (timeout_us % 1000000) * 1000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout,
+            nullptr, 0);
+}
+
+inline void futex_wake(std::atomic<uint32_t>* word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+}
+
+/*
+ * Waits until `word` differs from `value` or stop() returns true: spins for
+ * up to `spins` reads, then raises `sleeping` and sleeps on the word,
+ * asking stop() again every 100 ms. The other side changes the word before
+ * it reads `sleeping`, and only makes the wake-up syscall when it is set,
+ * so a busy peer never enters the kernel. Returns false if stopped.
+ */
+template <typename Stop>
+bool wait_while(std::atomic<uint32_t>* word, uint32_t value, int spins,
+                std::atomic<uint32_t>* sleeping, Stop&& stop) {
+    for (int i = 0; i < spins; ++i) {
+        if (word->load(std::memory_order_acquire) != value) return true;
+    }
+    sleeping->store(1, std::memory_order_seq_cst);
+    bool changed = true;
+    while (word->load(std::memory_order_seq_cst) == value) {
+        if (stop()) {
+            changed = false;
+            break;
+        }
+        futex_wait(word, value, 100000);
+    }
+    sleeping->store(0, std::memory_order_relaxed);
+    return changed;
+}
+
+// Spinning only pays when the peer runs on another CPU meanwhile
+inline int spin_limit() {
+    static const int spins = std::thread::hardware_concurrency() > 1 ? 100000 : 0;
+    return spins;
+}
+
+// Changes `word` and wakes its waiter if it went to sleep
+inline void store_and_wake(std::atomic<uint32_t>* word, uint32_t value,
+                           std::atomic<uint32_t>* sleeping) {
+    word->store(value, std::memory_order_seq_cst);
+    if (sleeping->load(std::memory_order_seq_cst)) futex_wake(word);
+}
+
+// One mapping of a named segment; the creator unlinks the name on destruction
+class Segment {
+public:
+    static Segment create(const std::string& name, size_t bytes) {
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open failed for " + name);
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("ftruncate failed for " + name);
+        }
+        return Segment(name, fd, bytes, true);
+    }
+
+    static Segment open(const std::string& name) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) throw std::runtime_error("No shared-memory ring named " + name);
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(RingHeader)) {
+            close(fd);
+            throw std::runtime_error("Shared-memory ring " + name + " is not initialised");
+        }
+        return Segment(name, fd, static_cast<size_t>(info.st_size), false);
+    }
+
+    Segment(Segment&& other) noexcept
+        : name_(std::move(other.name_)), base_(other.base_), bytes_(other.bytes_),
+          owner_(other.owner_) {
+        other.base_ = nullptr;
+        other.owner_ = false;
+    }
+
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+    Segment& operator=(Segment&&) = delete;
+
+    ~Segment() {
+        if (base_) munmap(base_, bytes_);
+        if (owner_) shm_unlink(name_.c_str());
+    }
+
+    char* data() const { return static_cast<char*>(base_); }
+    size_t size() const { return bytes_; }
+
+private:
+    Segment(std::string name, int fd, size_t bytes, bool owner)
+        : name_(std::move(name)), bytes_(bytes), owner_(owner) {
+        base_ = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            if (owner_) shm_unlink(name_.c_str());
+            throw std::runtime_error("mmap failed for " + name_);
+        }
+    }
+
+    std::string name_;
+    void* base_ = nullptr;
+    size_t bytes_ = 0;
+    bool owner_ = false;
+};
+
+// Typed views of one slot in a mapping
+struct SlotView {
+    SlotHeader* header;
+    mco_instrument_t* instruments;
+    mco_price_result_t* results;
+};
+
+inline SlotView slot_at(char* base, const RingHeader* ring, uint32_t index) {
+    char* slot = base + sizeof(RingHeader) + index * ring->slot_bytes;
+    auto* instruments = reinterpret_cast<mco_instrument_t*>(slot + sizeof(SlotHeader));
+    auto* results = reinterpret_cast<mco_price_result_t*>(instruments + ring->slot_capacity);
+    return SlotView{reinterpret_cast<SlotHeader*>(slot), instruments, results};
+}
+
+/**
+ * Server side: creates the segment and prices published slots on one
+ * thread, in ring order. Each batch runs on the engine's worker pool with
+ * the thread count and affinity given here.
+ */
+class RingServer {
+public:
+    RingServer(const std::string& name, uint32_t num_slots, uint32_t slot_capacity,
+               size_t num_threads, int affinity)
+        : segment_(Segment::create(name, checked_bytes(num_slots, slot_capacity))),
+          num_threads_(num_threads), affinity_(affinity) {
+        std::memset(segment_.data(), 0, segment_.size());
+        ring_ = new (segment_.data()) RingHeader;
+        ring_->num_slots = num_slots;
+        ring_->slot_capacity = slot_capacity;
+        ring_->slot_bytes = slot_bytes(slot_capacity);
+        ring_->version = RING_VERSION;
+        ring_->server_alive.store(1, std::memory_order_relaxed);
+        ring_->heartbeat_ms.store(monotonic_ms(), std::memory_order_relaxed);
+        // Clients check the magic last: it marks the header as complete
+        std::atomic_thread_fence(std::memory_order_release);
+        ring_->magic = RING_MAGIC;
+        thread_ = std::thread([this] { serve(); });
+        heartbeat_ = std::thread([this] { beat(); });
+    }
+
+    ~RingServer() {
+        stop();
+        if (context_) mco_context_free(context_);
+    }
+
+    void stop() {
+        if (!thread_.joinable()) return;
+        stopping_.store(true);
+        futex_wake(&ring_->doorbell);
+        thread_.join();
+        heartbeat_.join();
+        ring_->server_alive.store(0, std::memory_order_release);
+    }
+
+    uint64_t batches_served() const { return served_.load(std::memory_order_relaxed); }
+
+private:
+
+    static size_t checked_bytes(uint32_t num_slots, uint32_t slot_capacity) {
+        if (num_slots == 0 || slot_capacity == 0) {
+            throw std::invalid_argument("A ring needs at least one slot of one instrument");
+        }
+        return segment_bytes(num_slots, slot_capacity);
+    }
+
+    // Stamps the header on its own thread, so a long batch does not look like a hang
+    void beat() {
+        while (!stopping_.load(std::memory_order_relaxed)) {
+            ring_->heartbeat_ms.store(monotonic_ms(), std::memory_order_release);
+            std::this_thread::sleep_for(std::chrono::milliseconds(HEARTBEAT_PERIOD_MS));
+        }
+    }
+
+    void serve() {
+        uint32_t next = 0;
+        while (!stopping_.load(std::memory_order_relaxed)) {
+            // Read the doorbell before scanning: a publish the scan misses changes it
+            uint32_t seen = ring_->doorbell.load(std::memory_order_seq_cst);
+
+            // Serve every published slot, starting after the last one served
+            bool served = false;
+            for (uint32_t n = 0; n < ring_->num_slots; ++n) {
+                uint32_t index = (next + n) % ring_->num_slots;
+                SlotView slot = slot_at(segment_.data(), ring_, index);
+                if (slot.header->state.load(std::memory_order_acquire) != SLOT_REQUEST) continue;
+                price(slot);
+                next = index + 1;
+                served = true;
+            }
+            if (!served) {
+                wait_while(&ring_->doorbell, seen, spin_limit(), &ring_->server_sleeping,
+                           [this] { return stopping_.load(std::memory_order_relaxed); });
+            }
+        }
+    }
+
+    void price(SlotView slot) {
+        auto start = std::chrono::steady_clock::now();
+        SlotHeader* header = slot.header;
+        uint32_t count = header->count;
+        if (count > ring_->slot_capacity) {
+            header->status = MCO_ERROR_INVALID_ARGUMENT;
+            count = 0;
+        } else {
+            header->status = MCO_OK;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            if (crosses_processes(slot.instruments[i].kind)) {
+                // Never dereference another process's pointers
+                std::memset(&slot.instruments[i].params, 0, sizeof(slot.instruments[i].params));
+                slot.instruments[i].kind = -1;
+            }
+        }
+
+        // Creating a context costs more than an analytic price: keep one per config
+        if (!context_ || std::memcmp(&context_config_, &header->config, sizeof(RingConfig)) != 0) {
+            if (context_) mco_context_free(context_);
+            context_ = mco_context_new();
+            context_config_ = header->config;
+            apply(context_, context_config_);
+        }
+        int status = mco_price_instruments(context_, slot.instruments, count, slot.results);
+        if (header->status == MCO_OK) header->status = status;
+
+        auto end = std::chrono::steady_clock::now();
+        header->compute_us = std::chrono::duration<double, std::micro>(end - start).count();
+        served_.fetch_add(1, std::memory_order_relaxed);
+        store_and_wake(&header->state, SLOT_DONE, &header->client_sleeping);
+    }
+
+    void apply(mco_context_t* ctx, const RingConfig& config) const {
+        mco_context_set_num_threads(ctx, num_threads_);
+        mco_context_set_thread_affinity(ctx, affinity_);
+        if (config.num_simulations > 0) mco_context_set_num_simulations(ctx, config.num_simulations);
+        if (config.num_steps > 0) mco_context_set_num_steps(ctx, config.num_steps);
+        if (config.has_seed) mco_context_set_seed(ctx, config.seed);
+        mco_context_set_antithetic(ctx, config.antithetic != 0);
+        mco_context_set_control_variates(ctx, config.control_variates != 0);
+        mco_context_set_stratified_sampling(ctx, config.stratified_sampling != 0);
+        mco_context_set_reproducible(ctx, config.reproducible != 0);
+        mco_context_set_stream_mode(ctx, config.sequential_stream ? MCO_STREAM_SEQUENTIAL
+                                                                  : MCO_STREAM_BLOCKS);
+    }
+
+    Segment segment_;
+    RingHeader* ring_ = nullptr;
+    size_t num_threads_;
+    int affinity_;
+    mco_context_t* context_ = nullptr;     // Only touched by the serving thread
+    RingConfig context_config_{};
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> served_{0};
+    std::thread thread_;
+    std::thread heartbeat_;
+};
+
+/**
+ * Client side: maps an existing ring. Safe to share between threads; each
+ * call holds one slot for its duration.
+ *
+ * acquire() / submit() / wait() / release() let the caller build the batch
+ * directly in shared memory; price() copies from and to caller arrays.
+ * Once the server is lost (see above) acquire() throws, and wait() and
+ * price() return SERVER_LOST.
+ */
+class RingClient {
+public:
+    explicit RingClient(const std::string& name) : segment_(Segment::open(name)) {
+        ring_ = reinterpret_cast<RingHeader*>(segment_.data());
+        uint32_t magic = ring_->magic;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (magic != RING_MAGIC || ring_->version != RING_VERSION ||
+            segment_.size() < segment_bytes(ring_->num_slots, ring_->slot_capacity) ||
+            ring_->slot_bytes != slot_bytes(ring_->slot_capacity)) {
+            throw std::runtime_error("Shared-memory ring " + name + " has another layout");
+        }
+    }
+
+    uint32_t slot_capacity() const { return ring_->slot_capacity; }
+
+    // Whether the server has neither stopped nor missed its heartbeats
+    bool server_alive() const {
+        return ring_->server_alive.load(std::memory_order_acquire) &&
+               monotonic_ms() - ring_->heartbeat_ms.load(std::memory_order_acquire) <
+                   SERVER_TIMEOUT_MS;
+    }
+
+    // Claims a free slot, spinning (then yielding) while all are busy
+    SlotView acquire() {
+        SlotView slot{};
+        if (!try_acquire(slot)) throw std::runtime_error("Shared-memory ring server is gone");
+        return slot;
+    }
+
+    // Publishes `count` instruments already written to the slot
+    void submit(SlotView slot, uint32_t count, const RingConfig& config) {
+        slot.header->count = count;
+        slot.header->config = config;
+        slot.header->state.store(SLOT_REQUEST, std::memory_order_seq_cst);
+        ring_->doorbell.fetch_add(1, std::memory_order_seq_cst);
+        if (ring_->server_sleeping.load(std::memory_order_seq_cst)) futex_wake(&ring_->doorbell);
+    }
+
+    // Blocks until the server has priced the slot; returns the batch status or SERVER_LOST
+    int wait(SlotView slot) {
+        if (!wait_while(&slot.header->state, SLOT_REQUEST, spin_limit(),
+                        &slot.header->client_sleeping, [this] { return !server_alive(); })) {
+            return SERVER_LOST;
+        }
+        return slot.header->status;
+    }
+
+    void release(SlotView slot) { slot.header->state.store(SLOT_FREE, std::memory_order_release); }
+
+    /*
+     * Same contract as mco_price_instruments, plus SERVER_LOST. The batch is
+     * priced as one call, so it must fit a slot: a larger one gets
+     * MCO_ERROR_INVALID_ARGUMENT. Splitting it would restart the batch
+     * positions, and with them the random streams of seeded instruments.
+     */
+    int price(const mco_instrument_t* instruments, size_t count, mco_price_result_t* results,
+              const RingConfig& config) {
+        if (count > ring_->slot_capacity) return MCO_ERROR_INVALID_ARGUMENT;
+        SlotView slot{};
+        if (!try_acquire(slot)) return SERVER_LOST;
+        uint32_t n = static_cast<uint32_t>(count);
+        std::memcpy(slot.instruments, instruments, n * sizeof(mco_instrument_t));
+        submit(slot, n, config);
+        int status = wait(slot);
+        if (status == SERVER_LOST) return status;
+        std::memcpy(results, slot.results, n * sizeof(mco_price_result_t));
+        release(slot);
+        return status;
+    }
+
+private:
+
+    bool try_acquire(SlotView& claimed) {
+        uint32_t start = hint_.fetch_add(1, std::memory_order_relaxed);
+        for (uint64_t attempt = 0;; ++attempt) {
+            for (uint32_t n = 0; n < ring_->num_slots; ++n) {
+                SlotView slot = slot_at(segment_.data(), ring_, (start + n) % ring_->num_slots);
+                uint32_t expected = SLOT_FREE;
+                if (slot.header->state.compare_exchange_strong(expected, SLOT_WRITING,
+                                                               std::memory_order_acquire)) {
+                    claimed = slot;
+                    return true;
+                }
+            }
+            if (!server_alive()) return false;
+            if (attempt > 64) std::this_thread::yield();
+        }
+    }
+
+    Segment segment_;
+    RingHeader* ring_ = nullptr;
+    std::atomic<uint32_t> hint_{0};
+};
+
+} // namespace shm
+} // namespace mcoptions
+
+#endif